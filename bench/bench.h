@@ -0,0 +1,287 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/*
+  Utilities shared by the benchmark programs.
+
+  Every benchmark prints results as tab-separated values, with a header line
+  then a line per measurement, so the output of several runs can be compared
+  by other tools.  Inputs are generated from a fixed seed, so every run of the
+  same version measures exactly the same work.
+*/
+
+#ifndef SERD_BENCH_H
+#define SERD_BENCH_H
+
+#include "serd_config.h"
+
+#include "serd/serd.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define USTR(s) ((const uint8_t*)(s))
+
+/// A generated statement, which owns every node except the datatype and lang
+typedef struct {
+  SerdNode        graph;
+  SerdNode        subject;
+  SerdNode        predicate;
+  SerdNode        object;
+  const SerdNode* datatype;
+  const SerdNode* lang;
+} BenchStatement;
+
+/// A generated set of statements to read or write
+typedef struct {
+  BenchStatement* statements;
+  size_t          n_statements;
+  SerdNode        xsd_decimal;
+  SerdNode        xsd_integer;
+  SerdNode        en;
+} BenchCorpus;
+
+/// Prefixes used in the corpus, which are defined in the generated documents
+static const char* const bench_prefixes[][2] = {
+  {"eg", "http://example.org/data/"},
+  {"v", "http://example.org/vocab#"},
+  {"xsd", "http://www.w3.org/2001/XMLSchema#"}};
+
+/// Words used to make literal text
+static const char* const bench_words[] = {"alpha",
+                                          "bravo",
+                                          "charlie",
+                                          "delta",
+                                          "echo",
+                                          "\"foxtrot\"",
+                                          "golf\n",
+                                          "hotel",
+                                          "caf\xc3\xa9",
+                                          "juliett"};
+
+#define BENCH_N_WORDS (sizeof(bench_words) / sizeof(bench_words[0]))
+
+/// Return a time in seconds, for measuring intervals
+static inline double
+bench_time(void)
+{
+#if USE_CLOCK_GETTIME
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#else
+  return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+/// Return the next number from a simple deterministic generator
+static inline uint32_t
+bench_rand(uint32_t* const state)
+{
+  // Xorshift (Marsaglia 2003)
+  *state ^= *state << 13u;
+  *state ^= *state >> 17u;
+  *state ^= *state << 5u;
+  return *state;
+}
+
+/// Return the size given as the first argument, or `default_size`
+static inline size_t
+bench_size(const int argc, char** const argv, const size_t default_size)
+{
+  const long size = argc > 1 ? strtol(argv[1], NULL, 10) : 0;
+
+  return size > 0 ? (size_t)size : default_size;
+}
+
+/// Print the header of the benchmark output
+static inline void
+bench_print_header(void)
+{
+  printf("benchmark\titems\tbytes\tseconds\tns_per_item\n");
+}
+
+/// Print the results of one benchmark, which processed items and bytes
+static inline void
+bench_print(const char* const name,
+            const size_t      n_items,
+            const size_t      n_bytes,
+            const double      seconds)
+{
+  printf("%s\t%zu\t%zu\t%.6f\t%.2f\n",
+         name,
+         n_items,
+         n_bytes,
+         seconds,
+         n_items ? seconds * 1e9 / (double)n_items : 0.0);
+}
+
+/// A SerdSink that counts and discards everything
+static inline size_t
+bench_count_sink(const void* const buf, const size_t len, void* const stream)
+{
+  (void)buf;
+
+  *(size_t*)stream += len;
+  return len;
+}
+
+static inline SerdNode
+bench_node(const SerdType type, const char* const str)
+{
+  const SerdNode node = serd_node_from_string(type, USTR(str));
+
+  return serd_node_copy(&node);
+}
+
+/// Generate a corpus with literals of many kinds and a few graphs
+static inline BenchCorpus
+bench_corpus_new(const size_t n_statements)
+{
+  BenchCorpus corpus = {
+    (BenchStatement*)calloc(n_statements, sizeof(BenchStatement)),
+    n_statements,
+    serd_node_from_string(SERD_URI,
+                          USTR("http://www.w3.org/2001/XMLSchema#decimal")),
+    serd_node_from_string(SERD_URI,
+                          USTR("http://www.w3.org/2001/XMLSchema#integer")),
+    serd_node_from_string(SERD_LITERAL, USTR("en"))};
+
+  uint32_t seed = 1u;
+  char     buf[256];
+  for (size_t i = 0u; i < n_statements; ++i) {
+    BenchStatement* const s = &corpus.statements[i];
+    const uint32_t        r = bench_rand(&seed);
+
+    snprintf(buf, sizeof(buf), "http://example.org/data/graph%zu", i / 1000u);
+    s->graph = bench_node(SERD_URI, buf);
+
+    // Describe each subject with several statements, like most real data
+    if (r % 8u) {
+      snprintf(buf, sizeof(buf), "http://example.org/data/thing%zu", i / 4u);
+      s->subject = bench_node(SERD_URI, buf);
+    } else {
+      snprintf(buf, sizeof(buf), "b%zu", i / 4u);
+      s->subject = bench_node(SERD_BLANK, buf);
+    }
+
+    snprintf(buf, sizeof(buf), "http://example.org/vocab#p%u", (r >> 3u) % 8u);
+    s->predicate = bench_node(SERD_URI, buf);
+
+    const uint32_t o = bench_rand(&seed);
+    switch (o % 5u) {
+    case 0:
+      snprintf(buf, sizeof(buf), "http://example.org/data/thing%u", o % 1000u);
+      s->object = bench_node(SERD_URI, buf);
+      break;
+    case 1:
+      snprintf(buf, sizeof(buf), "%u", o % 100000u);
+      s->object   = bench_node(SERD_LITERAL, buf);
+      s->datatype = &corpus.xsd_integer;
+      break;
+    case 2:
+      snprintf(buf, sizeof(buf), "%u.%03u", o % 1000u, (o >> 10u) % 1000u);
+      s->object   = bench_node(SERD_LITERAL, buf);
+      s->datatype = &corpus.xsd_decimal;
+      break;
+    default:
+      buf[0] = '\0';
+      for (uint32_t w = 0u; w < 2u + o % 8u; ++w) {
+        strcat(buf, w ? " " : "");
+        strcat(buf, bench_words[bench_rand(&seed) % BENCH_N_WORDS]);
+      }
+
+      s->object = bench_node(SERD_LITERAL, buf);
+      s->lang   = (o % 5u == 3u) ? &corpus.en : NULL;
+    }
+  }
+
+  return corpus;
+}
+
+static inline void
+bench_corpus_free(BenchCorpus* const corpus)
+{
+  for (size_t i = 0u; i < corpus->n_statements; ++i) {
+    BenchStatement* const s = &corpus->statements[i];
+
+    serd_node_free(&s->graph);
+    serd_node_free(&s->subject);
+    serd_node_free(&s->predicate);
+    serd_node_free(&s->object);
+  }
+
+  free(corpus->statements);
+}
+
+/// Return a new env with the corpus prefixes
+static inline SerdEnv*
+bench_env_new(void)
+{
+  SerdEnv* const env = serd_env_new(NULL);
+
+  for (size_t i = 0u; i < sizeof(bench_prefixes) / sizeof(*bench_prefixes);
+       ++i) {
+    serd_env_set_prefix_from_strings(
+      env, USTR(bench_prefixes[i][0]), USTR(bench_prefixes[i][1]));
+  }
+
+  return env;
+}
+
+/// Write the corpus prefixes and statements to `writer`
+static inline SerdStatus
+bench_corpus_write(const BenchCorpus* const corpus,
+                   SerdWriter* const        writer,
+                   const SerdSyntax         syntax)
+{
+  for (size_t i = 0u; i < sizeof(bench_prefixes) / sizeof(*bench_prefixes);
+       ++i) {
+    const SerdNode name =
+      serd_node_from_string(SERD_LITERAL, USTR(bench_prefixes[i][0]));
+    const SerdNode uri =
+      serd_node_from_string(SERD_URI, USTR(bench_prefixes[i][1]));
+
+    serd_writer_set_prefix(writer, &name, &uri);
+  }
+
+  // Only write graphs in syntaxes that support them
+  const bool quads =
+    syntax == SERD_NQUADS || syntax == SERD_TRIG || syntax == SERD_BINARY;
+
+  SerdStatus st = SERD_SUCCESS;
+  for (size_t i = 0u; !st && i < corpus->n_statements; ++i) {
+    const BenchStatement* const s = &corpus->statements[i];
+
+    st = serd_writer_write_statement(writer,
+                                     0,
+                                     quads ? &s->graph : NULL,
+                                     &s->subject,
+                                     &s->predicate,
+                                     &s->object,
+                                     s->datatype,
+                                     s->lang);
+  }
+
+  return st ? st : serd_writer_finish(writer);
+}
+
+#endif // SERD_BENCH_H
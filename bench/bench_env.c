@@ -0,0 +1,106 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#define _POSIX_C_SOURCE 200809L /* for clock_gettime */
+
+#include "bench.h"
+
+#include "serd/serd.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Number of prefixes defined in the environment
+#define N_PREFIXES 32u
+
+/// Number of characters in each generated string, including the null
+#define STRING_SIZE 64u
+
+int
+main(int argc, char** argv)
+{
+  const size_t n_names = bench_size(argc, argv, 1000000u);
+
+  SerdEnv* const env = serd_env_new(NULL);
+  char           name[16];
+  char           uri[STRING_SIZE];
+  for (unsigned i = 0u; i < N_PREFIXES; ++i) {
+    snprintf(name, sizeof(name), "ns%u", i);
+    snprintf(uri, sizeof(uri), "http://example.org/namespace%u/", i);
+    serd_env_set_prefix_from_strings(env, USTR(name), USTR(uri));
+  }
+
+  // Generate CURIEs and the URIs they expand to
+  SerdNode* const curies   = (SerdNode*)calloc(n_names, sizeof(SerdNode));
+  SerdNode* const uris     = (SerdNode*)calloc(n_names, sizeof(SerdNode));
+  char* const     strs     = (char*)calloc(2u * n_names, STRING_SIZE);
+  uint32_t        seed     = 3u;
+  size_t          sizes[2] = {0u, 0u}; // Total size of CURIEs and URIs
+  for (size_t i = 0u; i < n_names; ++i) {
+    const uint32_t r      = bench_rand(&seed);
+    char* const    curie  = strs + 2u * i * STRING_SIZE;
+    char* const    expand = curie + STRING_SIZE;
+
+    snprintf(curie, STRING_SIZE, "ns%u:name%u", r % N_PREFIXES, r >> 16u);
+    snprintf(expand,
+             STRING_SIZE,
+             "http://example.org/namespace%u/name%u",
+             r % N_PREFIXES,
+             r >> 16u);
+
+    curies[i] = serd_node_from_string(SERD_CURIE, USTR(curie));
+    uris[i]   = serd_node_from_string(SERD_URI, USTR(expand));
+    sizes[0] += curies[i].n_bytes;
+    sizes[1] += uris[i].n_bytes;
+  }
+
+  bench_print_header();
+
+  // Expand CURIEs
+  size_t n_expanded = 0u;
+  double start      = bench_time();
+  for (size_t i = 0u; i < n_names; ++i) {
+    SerdChunk prefix = {NULL, 0u};
+    SerdChunk suffix = {NULL, 0u};
+    if (!serd_env_expand(env, &curies[i], &prefix, &suffix)) {
+      ++n_expanded;
+    }
+  }
+
+  bench_print("env/expand", n_expanded, sizes[0], bench_time() - start);
+
+  // Qualify URIs
+  size_t n_qualified = 0u;
+  start              = bench_time();
+  for (size_t i = 0u; i < n_names; ++i) {
+    SerdNode  prefix = SERD_NODE_NULL;
+    SerdChunk suffix = {NULL, 0u};
+    if (serd_env_qualify(env, &uris[i], &prefix, &suffix)) {
+      ++n_qualified;
+    }
+  }
+
+  bench_print("env/qualify", n_qualified, sizes[1], bench_time() - start);
+
+  free(strs);
+  free(uris);
+  free(curies);
+  serd_env_free(env);
+  return 0;
+}
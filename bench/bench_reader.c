@@ -0,0 +1,132 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#define _POSIX_C_SOURCE 200809L /* for clock_gettime */
+
+#include "bench.h"
+
+#include "serd/serd.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/// A document in memory to read as a stream
+typedef struct {
+  const uint8_t* buf;
+  size_t         size;
+  size_t         offset;
+} Document;
+
+static size_t
+document_read(void* buf, size_t size, size_t nmemb, void* stream)
+{
+  Document* const doc = (Document*)stream;
+  size_t          len = size * nmemb;
+  if (len > doc->size - doc->offset) {
+    len = doc->size - doc->offset;
+  }
+
+  memcpy(buf, doc->buf + doc->offset, len);
+  doc->offset += len;
+  return len / size;
+}
+
+static int
+document_error(void* stream)
+{
+  (void)stream;
+  return 0;
+}
+
+static SerdStatus
+count_statement(void*              handle,
+                SerdStatementFlags flags,
+                const SerdNode*    graph,
+                const SerdNode*    subject,
+                const SerdNode*    predicate,
+                const SerdNode*    object,
+                const SerdNode*    object_datatype,
+                const SerdNode*    object_lang)
+{
+  (void)flags;
+  (void)graph;
+  (void)subject;
+  (void)predicate;
+  (void)object;
+  (void)object_datatype;
+  (void)object_lang;
+
+  ++*(size_t*)handle;
+  return SERD_SUCCESS;
+}
+
+static void
+bench_read(const BenchCorpus* const corpus,
+           const char* const        name,
+           const SerdSyntax         syntax,
+           const SerdStyle          style)
+{
+  // Generate the document to read
+  SerdChunk         chunk  = {NULL, 0u};
+  SerdEnv* const    env    = bench_env_new();
+  SerdWriter* const writer = serd_writer_new(
+    syntax, style | SERD_STYLE_BULK, env, NULL, serd_chunk_sink, &chunk);
+
+  bench_corpus_write(corpus, writer, syntax);
+  serd_writer_free(writer);
+  serd_env_free(env);
+
+  // Read it from memory, so only parsing is measured
+  size_t            n_statements = 0u;
+  const size_t      size         = chunk.len;
+  uint8_t* const    buf          = serd_chunk_sink_finish(&chunk);
+  Document          doc          = {buf, size, 0u};
+  SerdReader* const reader       = serd_reader_new(
+    syntax, &n_statements, NULL, NULL, NULL, count_statement, NULL);
+
+  const double     start = bench_time();
+  const SerdStatus st    = serd_reader_read_source(
+    reader, document_read, document_error, &doc, NULL, 4096u);
+
+  const double seconds = bench_time() - start;
+
+  if (st || n_statements != corpus->n_statements) {
+    fprintf(stderr, "%s: failed to read document (%d)\n", name, (int)st);
+  }
+
+  bench_print(name, n_statements, size, seconds);
+  serd_reader_free(reader);
+  serd_free(buf);
+}
+
+int
+main(int argc, char** argv)
+{
+  BenchCorpus corpus = bench_corpus_new(bench_size(argc, argv, 200000u));
+
+  const SerdStyle abbrev = (SerdStyle)(SERD_STYLE_ABBREVIATED |
+                                       SERD_STYLE_CURIED);
+
+  bench_print_header();
+  bench_read(&corpus, "read/turtle", SERD_TURTLE, abbrev);
+  bench_read(&corpus, "read/trig", SERD_TRIG, abbrev);
+  bench_read(&corpus, "read/ntriples", SERD_NTRIPLES, (SerdStyle)0);
+  bench_read(&corpus, "read/nquads", SERD_NQUADS, (SerdStyle)0);
+  bench_read(&corpus, "read/binary", SERD_BINARY, (SerdStyle)0);
+
+  bench_corpus_free(&corpus);
+  return 0;
+}
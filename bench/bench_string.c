@@ -0,0 +1,148 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#define _POSIX_C_SOURCE 200809L /* for clock_gettime */
+
+#include "bench.h"
+
+#include "serd/serd.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/// Number of characters in each generated number string, including the null
+#define NUMBER_SIZE 32u
+
+/// Size of each blob to encode and decode as base64
+#define BLOB_SIZE 1024u
+
+int
+main(int argc, char** argv)
+{
+  const size_t n_numbers = bench_size(argc, argv, 1000000u);
+
+  // Generate numbers, and the decimal strings to parse
+  double* const  doubles  = (double*)calloc(n_numbers, sizeof(double));
+  int64_t* const integers = (int64_t*)calloc(n_numbers, sizeof(int64_t));
+  char* const    strings  = (char*)calloc(n_numbers, NUMBER_SIZE);
+  uint32_t       seed     = 4u;
+  size_t         size     = 0u;
+  for (size_t i = 0u; i < n_numbers; ++i) {
+    const uint32_t r = bench_rand(&seed);
+    const uint32_t f = bench_rand(&seed);
+
+    integers[i] = (int64_t)r * (r % 2u ? 1 : -1);
+    doubles[i]  = (double)integers[i] / (double)(1u << (f % 24u));
+    size += (size_t)snprintf(strings + i * NUMBER_SIZE,
+                             NUMBER_SIZE,
+                             "%.*f",
+                             (int)(f % 12u),
+                             doubles[i]);
+  }
+
+  bench_print_header();
+
+  // Parse decimal strings
+  size_t n_parsed = 0u;
+  double start    = bench_time();
+  for (size_t i = 0u; i < n_numbers; ++i) {
+    char* const str = strings + i * NUMBER_SIZE;
+    char*       end = NULL;
+
+    serd_strtod(str, &end);
+    n_parsed += (size_t)(end - str);
+  }
+
+  bench_print("string/strtod", n_numbers, size, bench_time() - start);
+  if (n_parsed != size) {
+    fprintf(stderr, "string/strtod: parsed %zu of %zu bytes\n", n_parsed, size);
+  }
+
+  // Format doubles as decimals
+  size  = 0u;
+  start = bench_time();
+  for (size_t i = 0u; i < n_numbers; ++i) {
+    SerdNode node = serd_node_new_decimal(doubles[i], 8u);
+    size += node.n_bytes;
+    serd_node_free(&node);
+  }
+
+  bench_print("string/decimal", n_numbers, size, bench_time() - start);
+
+  // Format doubles as canonical xsd:double strings
+  size  = 0u;
+  start = bench_time();
+  for (size_t i = 0u; i < n_numbers; ++i) {
+    SerdNode node = serd_node_new_double(doubles[i]);
+    size += node.n_bytes;
+    serd_node_free(&node);
+  }
+
+  bench_print("string/double", n_numbers, size, bench_time() - start);
+
+  // Format integers
+  size  = 0u;
+  start = bench_time();
+  for (size_t i = 0u; i < n_numbers; ++i) {
+    SerdNode node = serd_node_new_integer(integers[i]);
+    size += node.n_bytes;
+    serd_node_free(&node);
+  }
+
+  bench_print("string/integer", n_numbers, size, bench_time() - start);
+
+  // Encode and decode base64
+  const size_t   n_blobs = n_numbers / 128u + 1u;
+  SerdNode*      blobs   = (SerdNode*)calloc(n_blobs, sizeof(SerdNode));
+  uint8_t* const data    = (uint8_t*)calloc(n_blobs, BLOB_SIZE);
+  for (size_t i = 0u; i < n_blobs * BLOB_SIZE; ++i) {
+    data[i] = (uint8_t)bench_rand(&seed);
+  }
+
+  start = bench_time();
+  for (size_t i = 0u; i < n_blobs; ++i) {
+    blobs[i] = serd_node_new_blob(data + i * BLOB_SIZE, BLOB_SIZE, false);
+  }
+
+  bench_print(
+    "string/base64_encode", n_blobs, n_blobs * BLOB_SIZE, bench_time() - start);
+
+  size  = 0u;
+  start = bench_time();
+  for (size_t i = 0u; i < n_blobs; ++i) {
+    size_t      blob_size = 0u;
+    void* const blob =
+      serd_base64_decode(blobs[i].buf, blobs[i].n_bytes, &blob_size);
+
+    size += blobs[i].n_bytes;
+    serd_free(blob);
+  }
+
+  bench_print("string/base64_decode", n_blobs, size, bench_time() - start);
+
+  for (size_t i = 0u; i < n_blobs; ++i) {
+    serd_node_free(&blobs[i]);
+  }
+
+  free(data);
+  free(blobs);
+  free(strings);
+  free(integers);
+  free(doubles);
+  return 0;
+}
@@ -0,0 +1,123 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#define _POSIX_C_SOURCE 200809L /* for clock_gettime */
+
+#include "bench.h"
+
+#include "serd/serd.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Number of characters in each generated URI string, including the null
+#define URI_SIZE 96u
+
+/// Generate absolute URIs if `absolute` is true, otherwise references
+static char*
+generate_uris(const size_t n_uris, const bool absolute, size_t* const size)
+{
+  static const char* const starts[] = {"", "../", "../../", "./", "/"};
+
+  char*    uris = (char*)calloc(n_uris, URI_SIZE);
+  uint32_t seed = 2u;
+
+  *size = 0u;
+  for (size_t i = 0u; i < n_uris; ++i) {
+    const uint32_t r   = bench_rand(&seed);
+    char* const    uri = uris + i * URI_SIZE;
+
+    if (absolute) {
+      snprintf(uri,
+               URI_SIZE,
+               "http://host%u.example.org:8080/path/to/dir%u/file%u.ttl",
+               r % 16u,
+               (r >> 4u) % 64u,
+               (r >> 10u) % 1024u);
+    } else {
+      snprintf(uri,
+               URI_SIZE,
+               "%sdir%u/file%u%s",
+               starts[r % 5u],
+               (r >> 4u) % 64u,
+               (r >> 10u) % 1024u,
+               (r >> 20u) % 2u ? "?query=value#fragment" : "#id");
+    }
+
+    *size += strlen(uri);
+  }
+
+  return uris;
+}
+
+int
+main(int argc, char** argv)
+{
+  const size_t n_uris = bench_size(argc, argv, 1000000u);
+
+  size_t      abs_size = 0u;
+  size_t      rel_size = 0u;
+  char* const absolute = generate_uris(n_uris, true, &abs_size);
+  char* const relative = generate_uris(n_uris, false, &rel_size);
+  SerdURI*    parsed   = (SerdURI*)calloc(n_uris, sizeof(SerdURI));
+  SerdURI*    refs     = (SerdURI*)calloc(n_uris, sizeof(SerdURI));
+
+  bench_print_header();
+
+  // Parse absolute URIs
+  double start = bench_time();
+  for (size_t i = 0u; i < n_uris; ++i) {
+    serd_uri_parse(USTR(absolute + i * URI_SIZE), &parsed[i]);
+  }
+
+  bench_print("uri/parse", n_uris, abs_size, bench_time() - start);
+
+  // Resolve references against a base URI
+  for (size_t i = 0u; i < n_uris; ++i) {
+    serd_uri_parse(USTR(relative + i * URI_SIZE), &refs[i]);
+  }
+
+  SerdURI base = SERD_URI_NULL;
+  serd_uri_parse(USTR("http://example.org/a/b/c/d;p?q"), &base);
+
+  start = bench_time();
+  for (size_t i = 0u; i < n_uris; ++i) {
+    SerdURI resolved = SERD_URI_NULL;
+    serd_uri_resolve(&refs[i], &base, &resolved);
+    refs[i] = resolved;
+  }
+
+  bench_print("uri/resolve", n_uris, rel_size, bench_time() - start);
+
+  // Serialise parsed and resolved URIs
+  size_t size = 0u;
+  start       = bench_time();
+  for (size_t i = 0u; i < n_uris; ++i) {
+    serd_uri_serialise(&parsed[i], bench_count_sink, &size);
+    serd_uri_serialise(&refs[i], bench_count_sink, &size);
+  }
+
+  bench_print("uri/serialise", 2u * n_uris, size, bench_time() - start);
+
+  free(refs);
+  free(parsed);
+  free(relative);
+  free(absolute);
+  return 0;
+}
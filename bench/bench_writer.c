@@ -0,0 +1,93 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#define _POSIX_C_SOURCE 200809L /* for clock_gettime */
+
+#include "bench.h"
+
+#include "serd/serd.h"
+
+#include <stdio.h>
+
+static void
+bench_write(const BenchCorpus* const corpus,
+            const char* const        name,
+            const SerdSyntax         syntax,
+            const SerdStyle          style)
+{
+  size_t            size   = 0u;
+  SerdEnv* const    env    = bench_env_new();
+  SerdWriter* const writer =
+    serd_writer_new(syntax, style, env, NULL, bench_count_sink, &size);
+
+  if (!writer) {
+    fprintf(stderr, "%s: style not supported\n", name);
+    serd_env_free(env);
+    return;
+  }
+
+  const double     start   = bench_time();
+  const SerdStatus st      = bench_corpus_write(corpus, writer, syntax);
+  const double     seconds = bench_time() - start;
+
+  if (st) {
+    fprintf(stderr, "%s: failed to write document (%d)\n", name, (int)st);
+  }
+
+  bench_print(name, corpus->n_statements, size, seconds);
+  serd_writer_free(writer);
+  serd_env_free(env);
+}
+
+int
+main(int argc, char** argv)
+{
+  BenchCorpus corpus = bench_corpus_new(bench_size(argc, argv, 200000u));
+
+  const SerdStyle none   = (SerdStyle)0;
+  const SerdStyle bulk   = SERD_STYLE_BULK;
+  const SerdStyle abbrev = (SerdStyle)(SERD_STYLE_ABBREVIATED |
+                                       SERD_STYLE_CURIED | SERD_STYLE_BULK);
+
+  bench_print_header();
+  bench_write(&corpus, "write/ntriples", SERD_NTRIPLES, none);
+  bench_write(&corpus, "write/ntriples/bulk", SERD_NTRIPLES, bulk);
+  bench_write(&corpus,
+              "write/ntriples/ascii",
+              SERD_NTRIPLES,
+              (SerdStyle)(SERD_STYLE_ASCII | SERD_STYLE_BULK));
+  bench_write(&corpus, "write/ntriples/async", SERD_NTRIPLES, SERD_STYLE_ASYNC);
+  bench_write(&corpus, "write/nquads/bulk", SERD_NQUADS, bulk);
+  bench_write(&corpus, "write/turtle/bulk", SERD_TURTLE, abbrev);
+  bench_write(&corpus,
+              "write/turtle/resolved",
+              SERD_TURTLE,
+              (SerdStyle)(abbrev | SERD_STYLE_RESOLVED));
+  bench_write(&corpus, "write/trig/bulk", SERD_TRIG, abbrev);
+  bench_write(&corpus, "write/binary/bulk", SERD_BINARY, bulk);
+  bench_write(&corpus,
+              "write/ntriples/gzip",
+              SERD_NTRIPLES,
+              (SerdStyle)(SERD_STYLE_GZIP | SERD_STYLE_BULK));
+  bench_write(&corpus,
+              "write/ntriples/zstd",
+              SERD_NTRIPLES,
+              (SerdStyle)(SERD_STYLE_ZSTD | SERD_STYLE_BULK));
+
+  bench_corpus_free(&corpus);
+  return 0;
+}
@@ -96,6 +96,18 @@ typedef struct SerdReaderImpl SerdReader;
 /// Streaming serialiser that writes a text stream as statements are pushed
 typedef struct SerdWriterImpl SerdWriter;
 
+/// Byte source that reads ahead from another source in the background
+typedef struct SerdPrefetchImpl SerdPrefetch;
+
+/// Table of interned nodes with integer IDs
+typedef struct SerdDictionaryImpl SerdDictionary;
+
+/// Positions in a document where reading can be resumed
+typedef struct SerdIndexImpl SerdIndex;
+
+/// Sorter that passes on statements in order without duplicates
+typedef struct SerdSorterImpl SerdSorter;
+
 /// Return status code
 typedef enum {
   SERD_SUCCESS,        ///< No error
@@ -114,7 +126,8 @@ typedef enum {
   SERD_TURTLE   = 1, ///< Terse triples http://www.w3.org/TR/turtle
   SERD_NTRIPLES = 2, ///< Line-based triples http://www.w3.org/TR/n-triples/
   SERD_NQUADS   = 3, ///< Line-based quads http://www.w3.org/TR/n-quads/
-  SERD_TRIG     = 4  ///< Terse quads http://www.w3.org/TR/trig/
+  SERD_TRIG     = 4, ///< Terse quads http://www.w3.org/TR/trig/
+  SERD_BINARY   = 5  ///< Compact binary statements for fast reloading
 } SerdSyntax;
 
 /// Flags indicating inline abbreviation information for a statement
@@ -189,7 +202,8 @@ typedef enum {
 /// Flags indicating certain string properties relevant to serialisation
 typedef enum {
   SERD_HAS_NEWLINE = 1u << 0u, ///< Contains line breaks ('\\n' or '\\r')
-  SERD_HAS_QUOTE   = 1u << 1u  ///< Contains quotes ('"')
+  SERD_HAS_QUOTE   = 1u << 1u, ///< Contains quotes ('"')
+  SERD_IS_CHUNKED  = 1u << 2u  ///< String was passed to a SerdLiteralSink
 } SerdNodeFlag;
 
 /// Bitwise OR of SerdNodeFlag values
@@ -204,6 +218,21 @@ typedef struct {
   SerdType                     type;    ///< Node type
 } SerdNode;
 
+/// The type of a native numeric value
+typedef enum {
+  SERD_NUMBER_NONE    = 0, ///< Not a number
+  SERD_NUMBER_INTEGER = 1, ///< Integer, from xsd:integer or a derived type
+  SERD_NUMBER_DECIMAL = 2, ///< Decimal, from xsd:decimal
+  SERD_NUMBER_DOUBLE  = 3  ///< Floating point, from xsd:double or xsd:float
+} SerdNumberType;
+
+/// The native value of a numeric literal
+typedef struct {
+  SerdNumberType type;    ///< Type of number
+  int64_t        integer; ///< Value of an integer, or zero
+  double         real;    ///< Value as a double, for any type of number
+} SerdNumber;
+
 /// An unterminated string fragment
 typedef struct {
   const uint8_t* SERD_NULLABLE buf; ///< Start of chunk
@@ -249,6 +278,9 @@ typedef enum {
   SERD_STYLE_RESOLVED    = 1u << 2u, ///< Resolve URIs against base URI.
   SERD_STYLE_CURIED      = 1u << 3u, ///< Shorten URIs into CURIEs.
   SERD_STYLE_BULK        = 1u << 4u, ///< Write output in pages.
+  SERD_STYLE_ASYNC       = 1u << 5u, ///< Write pages in a background thread.
+  SERD_STYLE_GZIP        = 1u << 6u, ///< Compress output with gzip.
+  SERD_STYLE_ZSTD        = 1u << 7u, ///< Compress output with zstd.
 } SerdStyle;
 
 /**
@@ -262,6 +294,100 @@ SERD_API
 void
 serd_free(void* SERD_NULLABLE ptr);
 
+/**
+   @defgroup serd_allocator Allocator
+   @{
+*/
+
+/// Function to allocate `size` bytes of memory, like malloc()
+typedef void* (*SerdMallocFunc)(void* SERD_NULLABLE handle, size_t size);
+
+/// Function to resize memory at `ptr` to `size` bytes, like realloc()
+typedef void* (*SerdReallocFunc)(void* SERD_NULLABLE handle,
+                                 void* SERD_NULLABLE ptr,
+                                 size_t              size);
+
+/// Function to free memory at `ptr`, like free()
+typedef void (*SerdFreeFunc)(void* SERD_NULLABLE handle,
+                             void* SERD_NULLABLE ptr);
+
+/**
+   A memory allocator.
+
+   This can be passed to the constructors of objects to use a custom allocator
+   for everything they allocate internally, for example to use a separate
+   arena for each thread.  Memory that is returned to the caller, such as
+   nodes returned by serd_env_expand_node(), is still allocated with the
+   standard C allocator so that it can be freed with serd_free().
+
+   Either all of the functions must be set, or none of them, in which case the
+   standard C allocator is used.
+*/
+typedef struct {
+  void* SERD_NULLABLE           handle;       ///< Passed to every function
+  SerdMallocFunc SERD_NULLABLE  malloc_func;  ///< Allocate memory
+  SerdReallocFunc SERD_NULLABLE realloc_func; ///< Resize memory
+  SerdFreeFunc SERD_NULLABLE    free_func;    ///< Free memory
+} SerdAllocator;
+
+/**
+   @}
+   @defgroup serd_arena Arena
+   @{
+*/
+
+/**
+   A region of memory for many short-lived allocations.
+
+   Allocating from an arena is just a pointer increment, and everything
+   allocated from it is released at once with serd_arena_reset().  This is
+   useful for building many nodes, for example a batch of statements, without
+   allocating and freeing each one.
+*/
+typedef struct SerdArenaImpl SerdArena;
+
+/**
+   Create a new arena.
+
+   @param allocator Allocator for the arena's blocks, or NULL to use the
+   standard C allocator.
+
+   @param block_size Size of each block of memory, or 0 for a default.
+   Allocations larger than half of this are allocated separately.
+*/
+SERD_API
+SerdArena* SERD_ALLOCATED
+serd_arena_new(const SerdAllocator* SERD_NULLABLE allocator, size_t block_size);
+
+/// Free `arena` and everything allocated from it
+SERD_API
+void
+serd_arena_free(SerdArena* SERD_NULLABLE arena);
+
+/**
+   Allocate `size` bytes from `arena`.
+
+   The returned memory is suitably aligned for any basic type, and is valid
+   until the arena is reset or freed.  It must not be freed separately.
+*/
+SERD_API
+void* SERD_ALLOCATED
+serd_arena_alloc(SerdArena* SERD_NONNULL arena, size_t size);
+
+/**
+   Release everything allocated from `arena`.
+
+   All memory previously returned from the arena becomes invalid, but the
+   arena keeps its blocks to reuse for future allocations.
+*/
+SERD_API
+void
+serd_arena_reset(SerdArena* SERD_NONNULL arena);
+
+/**
+   @}
+*/
+
 /**
    @defgroup serd_string String Utilities
    @{
@@ -291,7 +417,8 @@ serd_strlen(const uint8_t* SERD_NONNULL  str,
 
    The API of this function is identical to the standard C strtod function,
    except this function is locale-independent and always matches the lexical
-   format used in the Turtle grammar (the decimal point is always ".").
+   format used in the Turtle grammar (the decimal point is always ".").  The
+   result is always the nearest double, with ties rounded to even.
 */
 SERD_API
 double
@@ -352,6 +479,66 @@ typedef size_t (*SerdSink)(const void* SERD_NONNULL buf,
                            size_t                   len,
                            void* SERD_NONNULL       stream);
 
+/**
+   Create a source that reads ahead from another source.
+
+   The returned prefetcher reads from `read_func` in blocks of `block_size`
+   bytes on a background thread, filling one block while the other is being
+   consumed, so reading from slow streams like pipes or network filesystems
+   does not stall parsing.  The block size can be much larger than the page
+   size used by the reader, for example several megabytes.
+
+   To use it, pass serd_prefetch_read() and serd_prefetch_error() as the
+   functions and the prefetcher as the stream to
+   serd_reader_start_source_stream() or serd_reader_read_source().  The first
+   short read of the underlying source is taken as the end of input.
+
+   If threads are not supported, the underlying source is read synchronously
+   when more input is needed.
+
+   @return A new prefetcher, or null if `block_size` is zero.
+*/
+SERD_API
+SerdPrefetch* SERD_ALLOCATED
+serd_prefetch_new(SerdSource SERD_NONNULL          read_func,
+                  SerdStreamErrorFunc SERD_NONNULL error_func,
+                  void* SERD_NONNULL               stream,
+                  size_t                           block_size);
+
+/**
+   Read from a prefetcher.
+
+   This is a SerdSource for reading from a SerdPrefetch, which must be passed
+   as `stream`.
+*/
+SERD_API
+size_t
+serd_prefetch_read(void* SERD_NONNULL buf,
+                   size_t             size,
+                   size_t             nmemb,
+                   void* SERD_NONNULL stream);
+
+/**
+   Return the error status of a prefetcher.
+
+   This is a SerdStreamErrorFunc for reading from a SerdPrefetch, which must be
+   passed as `stream`.  It returns the error status of the underlying stream
+   once the end of input has been reached.
+*/
+SERD_API
+int
+serd_prefetch_error(void* SERD_NONNULL stream);
+
+/**
+   Free a prefetcher.
+
+   This stops the background thread, waiting for any read in progress to
+   finish.  The underlying stream is not closed.
+*/
+SERD_API
+void
+serd_prefetch_free(SerdPrefetch* SERD_NULLABLE prefetch);
+
 /**
    @}
    @defgroup serd_uri URI
@@ -534,12 +721,10 @@ serd_node_new_relative_uri(const SerdURI* SERD_NONNULL  uri,
 
    The resulting node will always contain a `.', start with a digit, and end
    with a digit (i.e. will have a leading and/or trailing `0' if necessary).
-   It will never be in scientific notation.  A maximum of `frac_digits` digits
-   will be written after the decimal point, but trailing zeros will
-   automatically be omitted (except one if `d` is a round integer).
-
-   Note that about 16 and 8 fractional digits are required to precisely
-   represent a double and float, respectively.
+   It will never be in scientific notation.  The shortest digits that read
+   back as exactly `d` are written, but rounded to a maximum of `frac_digits`
+   digits after the decimal point, with ties rounded away from zero.  Trailing
+   zeros are omitted (except one if the result is a round integer).
 
    @param d The value for the new node.
    @param frac_digits The maximum number of digits after the decimal place.
@@ -548,6 +733,18 @@ SERD_API
 SerdNode
 serd_node_new_decimal(double d, unsigned frac_digits);
 
+/**
+   Create a new node by serialising `d` into a canonical xsd:double string.
+
+   The resulting node will be in scientific notation with a single digit
+   before the decimal point, like "1.25E3", or one of "INF", "-INF", or "NaN".
+   The shortest digits that read back as exactly `d` are written, so a
+   round-trip through serd_strtod() is lossless.
+*/
+SERD_API
+SerdNode
+serd_node_new_double(double d);
+
 /// Create a new node by serialising `i` into an xsd:integer string
 SERD_API
 SerdNode
@@ -576,6 +773,92 @@ SERD_API
 SerdNode
 serd_node_copy(const SerdNode* SERD_NULLABLE node);
 
+/**
+   @defgroup serd_node_arena Arena Node Construction
+
+   Variants of the node constructors that allocate from a SerdArena.
+
+   The returned nodes are valid until the arena is reset or freed, and must
+   not be freed with serd_node_free().  If `arena` is NULL, these are
+   equivalent to the functions they are named after.
+
+   @{
+*/
+
+/// Like serd_node_copy(), but allocates from `arena`
+SERD_API
+SerdNode
+serd_node_copy_in(SerdArena* SERD_NULLABLE     arena,
+                  const SerdNode* SERD_NULLABLE node);
+
+/// Like serd_node_new_uri_from_string(), but allocates from `arena`
+SERD_API
+SerdNode
+serd_node_new_uri_from_string_in(SerdArena* SERD_NULLABLE     arena,
+                                 const uint8_t* SERD_NULLABLE str,
+                                 const SerdURI* SERD_NULLABLE base,
+                                 SerdURI* SERD_NULLABLE       out);
+
+/// Like serd_node_new_uri(), but allocates from `arena`
+SERD_API
+SerdNode
+serd_node_new_uri_in(SerdArena* SERD_NULLABLE     arena,
+                     const SerdURI* SERD_NONNULL  uri,
+                     const SerdURI* SERD_NULLABLE base,
+                     SerdURI* SERD_NULLABLE       out);
+
+/// Like serd_node_new_relative_uri(), but allocates from `arena`
+SERD_API
+SerdNode
+serd_node_new_relative_uri_in(SerdArena* SERD_NULLABLE     arena,
+                              const SerdURI* SERD_NONNULL  uri,
+                              const SerdURI* SERD_NULLABLE base,
+                              const SerdURI* SERD_NULLABLE root,
+                              SerdURI* SERD_NULLABLE       out);
+
+/// Like serd_node_new_decimal(), but allocates from `arena`
+SERD_API
+SerdNode
+serd_node_new_decimal_in(SerdArena* SERD_NULLABLE arena,
+                         double                   d,
+                         unsigned                 frac_digits);
+
+/// Like serd_node_new_double(), but allocates from `arena`
+SERD_API
+SerdNode
+serd_node_new_double_in(SerdArena* SERD_NULLABLE arena, double d);
+
+/// Like serd_node_new_integer(), but allocates from `arena`
+SERD_API
+SerdNode
+serd_node_new_integer_in(SerdArena* SERD_NULLABLE arena, int64_t i);
+
+/**
+   @}
+*/
+
+/**
+   Return the native value of a numeric literal.
+
+   This parses the string of a literal with an XSD numeric datatype, such as
+   those read from abbreviated numbers in Turtle.  The value isn't stored in
+   the node, so the string is parsed again every time this is called.
+   Integers, including those with a derived datatype like xsd:long, are parsed
+   to `int64_t` without checking the range of the derived type.  Decimals and
+   doubles are parsed to the nearest double, and xsd:float literals are parsed
+   as doubles as well.
+
+   @param node A null-terminated literal node.
+   @param datatype The datatype of `node`, which must be an expanded URI.
+   @return The value of `node`, with type #SERD_NUMBER_NONE if `node` is not a
+   valid literal of a numeric datatype, or is an integer too large for 64
+   bits.
+*/
+SERD_PURE_API
+SerdNumber
+serd_node_get_number(const SerdNode* SERD_NULLABLE node,
+                     const SerdNode* SERD_NULLABLE datatype);
+
 /// Return true iff `a` is equal to `b`
 SERD_PURE_API
 bool
@@ -639,6 +922,32 @@ typedef SerdStatus (*SerdStatementSink)(
   const SerdNode* SERD_NULLABLE object_datatype,
   const SerdNode* SERD_NULLABLE object_lang);
 
+/**
+   A statement.
+
+   This is used to pass several statements at once to a SerdBatchSink.
+*/
+typedef struct {
+  SerdStatementFlags            flags;           ///< Statement flags
+  const SerdNode* SERD_NULLABLE graph;           ///< Graph, or null
+  const SerdNode* SERD_NONNULL  subject;         ///< Subject
+  const SerdNode* SERD_NONNULL  predicate;       ///< Predicate
+  const SerdNode* SERD_NONNULL  object;          ///< Object
+  const SerdNode* SERD_NULLABLE object_datatype; ///< Object datatype, or null
+  const SerdNode* SERD_NULLABLE object_lang;     ///< Object language, or null
+} SerdStatement;
+
+/**
+   Sink (callback) for batches of statements
+
+   Called with several consecutive RDF statements in the serialisation.  The
+   statements, and the nodes they refer to, are only valid until this returns.
+*/
+typedef SerdStatus (*SerdBatchSink)(
+  void* SERD_NULLABLE               handle,
+  const SerdStatement* SERD_NONNULL statements,
+  size_t                            n_statements);
+
 /**
    Sink (callback) for anonymous node end markers
 
@@ -649,6 +958,33 @@ typedef SerdStatus (*SerdStatementSink)(
 typedef SerdStatus (*SerdEndSink)(void* SERD_NULLABLE          handle,
                                   const SerdNode* SERD_NONNULL node);
 
+/**
+   Sink (callback) for pieces of long literals
+
+   Called with consecutive pieces of the string of a literal that is too long
+   to read into memory at once, along with the start of the statement that it
+   is the object of.  Each piece is a literal node which ends on a character
+   boundary, and is only valid until this returns.
+*/
+typedef SerdStatus (*SerdLiteralSink)(void* SERD_NULLABLE           handle,
+                                      SerdStatementFlags            flags,
+                                      const SerdNode* SERD_NULLABLE graph,
+                                      const SerdNode* SERD_NONNULL  subject,
+                                      const SerdNode* SERD_NONNULL  predicate,
+                                      const SerdNode* SERD_NONNULL  piece);
+
+/**
+   Filter (callback) that decides which statements are read.
+
+   Called with the predicate of statements as soon as it has been read, and
+   the graph, which is null for the default graph, or a node with type
+   #SERD_NOTHING if it is not known yet.  Returns true if the statement should
+   be read and passed to the sinks, or false if it should be skipped.
+*/
+typedef bool (*SerdFilterFunc)(void* SERD_NULLABLE           handle,
+                               const SerdNode* SERD_NULLABLE graph,
+                               const SerdNode* SERD_NONNULL  predicate);
+
 /**
    @}
    @defgroup serd_env Environment
@@ -660,6 +996,29 @@ SERD_API
 SerdEnv* SERD_ALLOCATED
 serd_env_new(const SerdNode* SERD_NULLABLE base_uri);
 
+/**
+   Create a new environment that uses a custom allocator.
+
+   The allocator is copied, but its handle must remain valid until the
+   environment is freed.  If `allocator` is null, this is equivalent to
+   serd_env_new().
+*/
+SERD_API
+SerdEnv* SERD_ALLOCATED
+serd_env_new_with_allocator(const SerdAllocator* SERD_NULLABLE allocator,
+                            const SerdNode* SERD_NULLABLE      base_uri);
+
+/**
+   Return a copy of `env` with the same base URI and prefixes.
+
+   The copy uses the same allocator as `env`, and is independent of it, so
+   this can be used to take a snapshot of an environment, for example to
+   start reading or writing several documents with the same prefixes.
+*/
+SERD_API
+SerdEnv* SERD_ALLOCATED
+serd_env_copy(const SerdEnv* SERD_NULLABLE env);
+
 /// Free `env`
 SERD_API
 void
@@ -735,6 +1094,233 @@ serd_env_foreach(const SerdEnv* SERD_NONNULL env,
                  SerdPrefixSink SERD_NONNULL func,
                  void* SERD_NULLABLE         handle);
 
+/**
+   @}
+   @defgroup serd_dictionary Dictionary
+   @{
+*/
+
+/**
+   ID of a node in a dictionary.
+
+   IDs are assigned consecutively from 1 as nodes are added, and never change,
+   so a dictionary can be exported by getting every node from 1 up to its size.
+   Zero is never a valid ID, and is used for "no node".
+*/
+typedef uint64_t SerdNodeID;
+
+/**
+   Sink (callback) for statements with interned nodes
+
+   Called for every RDF statement in the serialisation, like SerdStatementSink,
+   but with node IDs from a dictionary instead of nodes.  Absent nodes, such as
+   the datatype of a plain literal, have ID zero.
+*/
+typedef SerdStatus (*SerdIDSink)(void* SERD_NULLABLE handle,
+                                 SerdStatementFlags  flags,
+                                 SerdNodeID          graph,
+                                 SerdNodeID          subject,
+                                 SerdNodeID          predicate,
+                                 SerdNodeID          object,
+                                 SerdNodeID          object_datatype,
+                                 SerdNodeID          object_lang);
+
+/// Create a new empty dictionary
+SERD_API
+SerdDictionary* SERD_ALLOCATED
+serd_dictionary_new(void);
+
+/// Free `dictionary`
+SERD_API
+void
+serd_dictionary_free(SerdDictionary* SERD_NULLABLE dictionary);
+
+/// Return the number of nodes in `dictionary`, which is also the largest ID
+SERD_PURE_API
+size_t
+serd_dictionary_size(const SerdDictionary* SERD_NONNULL dictionary);
+
+/**
+   Return the ID of `node`, adding a copy of it to `dictionary` if necessary.
+
+   Nodes are equal if they have the same type and string.  Returns zero if
+   `node` is null or has no type.
+*/
+SERD_API
+SerdNodeID
+serd_dictionary_intern(SerdDictionary* SERD_NONNULL  dictionary,
+                       const SerdNode* SERD_NULLABLE node);
+
+/// Return the ID of `node`, or zero if it is not in `dictionary`
+SERD_PURE_API
+SerdNodeID
+serd_dictionary_find(const SerdDictionary* SERD_NONNULL dictionary,
+                     const SerdNode* SERD_NULLABLE      node);
+
+/**
+   Return the node with the given `id`, or null if there is none.
+
+   The returned node is owned by the dictionary, and is only valid until
+   another node is added to it.
+*/
+SERD_PURE_API
+const SerdNode* SERD_NULLABLE
+serd_dictionary_get(const SerdDictionary* SERD_NONNULL dictionary,
+                    SerdNodeID                         id);
+
+/**
+   @}
+   @defgroup serd_index Index
+   @{
+*/
+
+/**
+   A position in a line-based document where reading can be resumed.
+
+   This is the start of a statement, and enough state to continue reading
+   from there as if the document had been read from the beginning.
+*/
+typedef struct {
+  uint64_t offset;       ///< Byte offset of the start of a statement
+  uint64_t n_statements; ///< Number of statements before `offset`
+  unsigned line;         ///< Line number at `offset`, starting from 1
+} SerdCheckpoint;
+
+/**
+   Create a new empty index.
+
+   When used with serd_reader_set_index(), a checkpoint is added every
+   `interval` statements, so `interval` must be at least 1.
+*/
+SERD_API
+SerdIndex* SERD_ALLOCATED
+serd_index_new(uint64_t interval);
+
+/// Free `index`
+SERD_API
+void
+serd_index_free(SerdIndex* SERD_NULLABLE index);
+
+/// Return the number of statements between checkpoints in `index`
+SERD_PURE_API
+uint64_t
+serd_index_interval(const SerdIndex* SERD_NONNULL index);
+
+/// Return the number of checkpoints in `index`
+SERD_PURE_API
+size_t
+serd_index_size(const SerdIndex* SERD_NONNULL index);
+
+/// Return the checkpoint at position `i` in `index`, or null
+SERD_PURE_API
+const SerdCheckpoint* SERD_NULLABLE
+serd_index_get(const SerdIndex* SERD_NONNULL index, size_t i);
+
+/**
+   Return the last checkpoint at or before a statement, or null.
+
+   This returns the checkpoint to resume reading from to get every statement
+   from number `n_statements` (counting from zero) onwards.
+*/
+SERD_PURE_API
+const SerdCheckpoint* SERD_NULLABLE
+serd_index_find(const SerdIndex* SERD_NONNULL index, uint64_t n_statements);
+
+/**
+   Write `index` to `file`.
+
+   The index is written as text, which can be loaded with serd_index_read().
+*/
+SERD_API
+SerdStatus
+serd_index_write(const SerdIndex* SERD_NONNULL index, FILE* SERD_NONNULL file);
+
+/// Read an index written by serd_index_write(), or return null on error
+SERD_API
+SerdIndex* SERD_ALLOCATED
+serd_index_read(FILE* SERD_NONNULL file);
+
+/**
+   @}
+   @defgroup serd_sorter Sorter
+   @{
+*/
+
+/**
+   Create a new sorter.
+
+   Statements written to the sorter are passed to `sink` by
+   serd_sorter_finish(), sorted and without duplicates.  At most about
+   `max_bytes` of statements are kept in memory, and the rest are sorted in
+   runs that are written to temporary files and merged at the end, so any
+   number of statements can be sorted with a fixed amount of memory.
+
+   @param env Environment used to expand CURIEs and relative URIs as
+   statements are written, so they are sorted by absolute URI, or null.
+   @param max_bytes Maximum number of bytes to use for statements in memory,
+   or zero for no limit.
+   @param sink Sink to be called with statements in order.
+   @param handle Handle to pass to `sink`.
+*/
+SERD_API
+SerdSorter* SERD_ALLOCATED
+serd_sorter_new(const SerdEnv* SERD_NULLABLE   env,
+                size_t                         max_bytes,
+                SerdStatementSink SERD_NONNULL sink,
+                void* SERD_NULLABLE            handle);
+
+/// Free `sorter` and any temporary files it is using
+SERD_API
+void
+serd_sorter_free(SerdSorter* SERD_NULLABLE sorter);
+
+/**
+   Set a function to be called when errors occur.
+
+   The `error_sink` will be called with `error_handle` as its first argument.
+   If no error function is set, errors are printed to stderr.
+*/
+SERD_API
+void
+serd_sorter_set_error_sink(SerdSorter* SERD_NONNULL    sorter,
+                           SerdErrorSink SERD_NULLABLE error_sink,
+                           void* SERD_NULLABLE         error_handle);
+
+/// Return the number of sorted runs written to temporary files so far
+SERD_PURE_API
+size_t
+serd_sorter_n_runs(const SerdSorter* SERD_NONNULL sorter);
+
+/**
+   Add a statement to be sorted.
+
+   This has the same signature as SerdStatementSink, so a sorter can be used
+   directly as the sink of a reader.  Statement flags are ignored, since
+   anonymous nodes and lists can not be written inline once sorted.
+*/
+SERD_API
+SerdStatus
+serd_sorter_write_statement(SerdSorter* SERD_NONNULL      sorter,
+                            SerdStatementFlags            flags,
+                            const SerdNode* SERD_NULLABLE graph,
+                            const SerdNode* SERD_NONNULL  subject,
+                            const SerdNode* SERD_NONNULL  predicate,
+                            const SerdNode* SERD_NONNULL  object,
+                            const SerdNode* SERD_NULLABLE datatype,
+                            const SerdNode* SERD_NULLABLE lang);
+
+/**
+   Pass every statement written so far to the sink in order.
+
+   Statements are ordered by graph, subject, predicate, object, datatype, then
+   language, where nodes are ordered by type and then string, and a missing
+   node comes first.  Statements that are exactly equal are only passed once.
+   The sorter is empty afterwards, and can be used again.
+*/
+SERD_API
+SerdStatus
+serd_sorter_finish(SerdSorter* SERD_NONNULL sorter);
+
 /**
    @}
    @defgroup serd_reader Reader
@@ -752,6 +1338,26 @@ serd_reader_new(SerdSyntax          syntax,
                 SerdStatementSink SERD_NULLABLE statement_sink,
                 SerdEndSink SERD_NULLABLE       end_sink);
 
+/**
+   Create a new RDF reader that uses a custom allocator.
+
+   The allocator is copied, but its handle must remain valid until the reader
+   is freed.  If `allocator` is null, this is equivalent to serd_reader_new().
+   Note that serd_reader_read_parallel() uses the allocator from several
+   threads, so it must be thread-safe in that case.
+*/
+SERD_API
+SerdReader* SERD_ALLOCATED
+serd_reader_new_with_allocator(
+  const SerdAllocator* SERD_NULLABLE allocator,
+  SerdSyntax                         syntax,
+  void* SERD_NULLABLE                handle,
+  void (*SERD_NULLABLE free_handle)(void* SERD_NULLABLE),
+  SerdBaseSink SERD_NULLABLE      base_sink,
+  SerdPrefixSink SERD_NULLABLE    prefix_sink,
+  SerdStatementSink SERD_NULLABLE statement_sink,
+  SerdEndSink SERD_NULLABLE       end_sink);
+
 /**
    Enable or disable strict parsing
 
@@ -763,6 +1369,35 @@ SERD_API
 void
 serd_reader_set_strict(SerdReader* SERD_NONNULL reader, bool strict);
 
+/**
+   Enable or disable lazy tracking of line and column numbers.
+
+   By default, the reader updates the line and column as it reads every byte.
+   When lazy, only the position in the input is tracked, and line and column
+   numbers are counted from the buffered input when they are needed, for
+   errors and index checkpoints.  This makes reading input without errors
+   faster, but errors more expensive.  The reported positions are the same
+   either way.  This has no effect when reading a byte at a time.
+*/
+SERD_API
+void
+serd_reader_set_lazy_positions(SerdReader* SERD_NONNULL reader, bool lazy);
+
+/**
+   Enable or disable validation only.
+
+   When only validating, the input is checked as usual and errors are reported,
+   but no sinks are called, and statements are only counted in the reader
+   statistics.  Nodes are never passed anywhere, so blank node IDs are not
+   generated.  Since prefixed names are otherwise expanded by the sink, the
+   reader keeps track of defined prefixes itself, so undefined prefixes are
+   still reported as errors.
+*/
+SERD_API
+void
+serd_reader_set_validate_only(SerdReader* SERD_NONNULL reader,
+                              bool                     validate_only);
+
 /**
    Set a function to be called when errors occur during reading.
 
@@ -775,11 +1410,160 @@ serd_reader_set_error_sink(SerdReader* SERD_NONNULL    reader,
                            SerdErrorSink SERD_NULLABLE error_sink,
                            void* SERD_NULLABLE         error_handle);
 
+/**
+   Set a function that decides which statements are read.
+
+   The filter is called with the predicate of statements as soon as it has
+   been read, before the object.  If it returns false, the objects of that
+   predicate are skipped over without being read, so reading only a few
+   predicates from a large document is much faster than filtering in the
+   statement sink.  Any statements in anonymous nodes and collections in
+   skipped objects are skipped as well.  Statements in the objects that are
+   read are filtered in the same way, except for the rdf:first and rdf:rest
+   statements of collections, which are always read since their predicates
+   are not in the document.
+
+   In NQuads, the graph is written after the object, so the filter is first
+   called with a graph of type #SERD_NOTHING when the predicate is read.  If
+   it returns true, then the filter is called again once the graph has been
+   read (with null for the default graph), and the statement is dropped if it
+   returns false.
+
+   Nodes are passed as they are read, so the predicate may be a CURIE or
+   relative URI, like in the statement sink.  When reading in parallel, the
+   filter is called from the reader threads, possibly at the same time.
+
+   @param reader The reader to set the filter of.
+   @param filter The filter to call, or null to read every statement.
+   @param handle Opaque handle passed to `filter`.
+*/
+SERD_API
+void
+serd_reader_set_filter(SerdReader* SERD_NONNULL     reader,
+                       SerdFilterFunc SERD_NULLABLE filter,
+                       void* SERD_NULLABLE          handle);
+
+/**
+   Set a function to be called with batches of statements.
+
+   If this is set, statements are collected and passed to `batch_sink` up to
+   `max_batch` at a time, instead of being passed to the statement sink one at
+   a time.  This avoids the overhead of a call per statement, and lets the
+   handler process several statements at once.
+
+   Statements are always delivered in order with respect to other events: any
+   pending statements are passed to `batch_sink` before the base, prefix, or
+   end sink is called, and before reading returns.
+
+   Setting `batch_sink` to null, or `max_batch` to zero, restores the default
+   behaviour of calling the statement sink for every statement.
+*/
+SERD_API
+void
+serd_reader_set_batch_sink(SerdReader* SERD_NONNULL    reader,
+                           size_t                      max_batch,
+                           SerdBatchSink SERD_NULLABLE batch_sink);
+
+/**
+   Set a function to be called with pieces of long literals.
+
+   Literals are normally read entirely into memory before the statement is
+   emitted, so a huge literal makes the reader stack grow to at least its
+   size.  If this is set, then once the string of a literal reaches
+   `max_bytes`, it is passed to `literal_sink` and discarded, and so on until
+   the end of the string.  Each piece except the last is at least `max_bytes`
+   long.  The statement is then emitted as usual, but its object is an empty
+   placeholder with the #SERD_IS_CHUNKED flag, so the memory used is limited
+   regardless of the length of literals.  Shorter literals are read as usual.
+
+   The sink is called with the reader handle, and in order with respect to
+   other events, so the pieces of a literal are always followed by its
+   statement, which has the datatype or language of the literal.  A writer
+   can stream literals this way by using serd_writer_write_literal_piece() as
+   the literal sink, with serd_writer_write_statement() as the statement sink.
+   If there is an error, pieces may have been passed for a statement that is
+   never emitted.
+
+   Literals are always read whole from NQuads, since the graph follows the
+   object, and from binary input, and when reading in parallel or from
+   several inputs.
+
+   Setting `literal_sink` to null, or `max_bytes` to zero, restores the
+   default behaviour.
+*/
+SERD_API
+void
+serd_reader_set_literal_sink(SerdReader* SERD_NONNULL      reader,
+                             size_t                        max_bytes,
+                             SerdLiteralSink SERD_NULLABLE literal_sink);
+
+/**
+   Set a dictionary to intern nodes in, and a sink for interned statements.
+
+   If `id_sink` is not null, then every node in every statement is interned in
+   `dictionary`, and the statement is passed to `id_sink` with node IDs
+   instead of to the statement or batch sink.  The dictionary is not owned by
+   the reader, so it may be shared by several readers to give nodes the same
+   IDs across several inputs, but it must outlive them, and readers that share
+   it must not be used concurrently.
+
+   Setting `dictionary` or `id_sink` to null restores the default behaviour.
+*/
+SERD_API
+void
+serd_reader_set_dictionary(SerdReader* SERD_NONNULL      reader,
+                           SerdDictionary* SERD_NULLABLE dictionary,
+                           SerdIDSink SERD_NULLABLE      id_sink);
+
+/**
+   Set an index to add checkpoints to while reading.
+
+   If `index` is not null, then while reading NTriples or NQuads from an
+   uncompressed file or string, a checkpoint is added to `index` at the start
+   of a statement every serd_index_interval() statements.  Checkpoints are
+   only added after the last one in the index, so an index can be built over
+   several reads of the same file, for example after resuming with
+   serd_reader_read_file_handle_at(), but should not be shared between files.
+   The index is not owned by the reader, and must outlive it.
+*/
+SERD_API
+void
+serd_reader_set_index(SerdReader* SERD_NONNULL reader,
+                      SerdIndex* SERD_NULLABLE index);
+
 /// Return the `handle` passed to serd_reader_new()
 SERD_PURE_API
 void* SERD_NULLABLE
 serd_reader_get_handle(const SerdReader* SERD_NONNULL reader);
 
+/**
+   Statistics about what a reader has done.
+
+   Counts are the totals of every read since the reader was created, including
+   the one in progress, if any.
+*/
+typedef struct {
+  uint64_t n_bytes;         ///< Number of input bytes consumed
+  uint64_t n_statements;    ///< Number of statements emitted
+  uint64_t n_nodes;         ///< Number of nodes pushed to the stack
+  uint64_t n_pages;         ///< Number of pages read from a stream
+  uint64_t read_time;       ///< Nanoseconds spent waiting for page reads
+  uint64_t n_errors;        ///< Number of errors reported
+  uint64_t n_recoveries;    ///< Number of times reading continued after errors
+  size_t   peak_stack_size; ///< Peak size of the node stack in bytes
+} SerdReaderStats;
+
+/**
+   Return statistics about what `reader` has done.
+
+   The read time is only measured on systems with a monotonic clock, and is
+   zero elsewhere.  Recoveries happen in lax mode, where reading skips to the
+   next line after an invalid statement.
+*/
+SERD_PURE_API
+SerdReaderStats
+serd_reader_get_stats(const SerdReader* SERD_NONNULL reader);
+
 /**
    Set a prefix to be added to all blank node identifiers.
 
@@ -806,7 +1590,12 @@ void
 serd_reader_set_default_graph(SerdReader* SERD_NONNULL      reader,
                               const SerdNode* SERD_NULLABLE graph);
 
-/// Read a file at a given `uri`
+/**
+   Read a file at a given `uri`.
+
+   The file is read like serd_reader_read_file_handle(), so it may be
+   compressed.
+*/
 SERD_API
 SerdStatus
 serd_reader_read_file(SerdReader* SERD_NONNULL    reader,
@@ -859,13 +1648,135 @@ SERD_API
 SerdStatus
 serd_reader_end_stream(SerdReader* SERD_NONNULL reader);
 
-/// Read `file`
+/**
+   Read `file`.
+
+   If the file starts with gzip or zstd magic bytes, then it is decompressed
+   while reading, which requires that serd was built with zlib or libzstd,
+   respectively.
+*/
 SERD_API
 SerdStatus
 serd_reader_read_file_handle(SerdReader* SERD_NONNULL     reader,
                              FILE* SERD_NONNULL           file,
                              const uint8_t* SERD_NULLABLE name);
 
+/**
+   Read `file` starting from a checkpoint.
+
+   This seeks to the offset of `checkpoint` in `file`, which must be seekable
+   and uncompressed, and reads from there like serd_reader_read_file_handle(),
+   with line numbers and statement counts continuing from the checkpoint.
+   Only NTriples and NQuads can be resumed like this.
+
+   @return #SERD_ERR_BAD_ARG if the reader syntax is not line-based or the
+   file can not be seeked, otherwise the status of reading.
+*/
+SERD_API
+SerdStatus
+serd_reader_read_file_handle_at(SerdReader* SERD_NONNULL           reader,
+                                FILE* SERD_NONNULL                 file,
+                                const uint8_t* SERD_NULLABLE       name,
+                                const SerdCheckpoint* SERD_NONNULL checkpoint);
+
+/**
+   Read `file` by mapping it into memory.
+
+   This reads directly from the mapped file contents, which avoids copying
+   input into an intermediate buffer and lets the system read ahead.  Reading
+   starts at the current position in `file`.  If `file` can not be mapped, for
+   example because it is a pipe, or is compressed, then this falls back to
+   reading it like serd_reader_read_file_handle().
+*/
+SERD_API
+SerdStatus
+serd_reader_read_mapped_file_handle(SerdReader* SERD_NONNULL     reader,
+                                    FILE* SERD_NONNULL           file,
+                                    const uint8_t* SERD_NULLABLE name);
+
+/**
+   Read `file` with several threads.
+
+   The file is mapped into memory and split into chunks at line boundaries,
+   and each chunk is read by one of `n_threads` worker threads with its own
+   reader, using the same options as `reader`.
+
+   For NTriples and NQuads, if `ordered` is true, then statements are emitted
+   to the sink of `reader` in input order, on the calling thread.  Otherwise,
+   statements are emitted as they are read, in no particular order, from the
+   worker threads.  Either way, calls to the sink are never concurrent, so it
+   need not be thread-safe.
+
+   For Turtle and TriG, the directives at the start of the document are read
+   first, then the rest is split at lines that end with a dot, which usually
+   end a statement.  Since this is only a guess, any chunk that did not start
+   at a statement, or that contains a directive or an error, is read again
+   serially.  Statements are always emitted in input order, so this is only
+   faster for documents that are mostly independent statements at the top
+   level, and not, for example, a few large graphs.
+
+   Blank node labels are preserved (with any prefix set with
+   serd_reader_add_blank_prefix()) so the same label in different chunks
+   refers to the same node, but generated blank node IDs include the chunk
+   number so they are unique across chunks.  Errors are reported with correct
+   line numbers, but may be reported before statements that precede them.
+
+   If `n_threads` is less than 2, the syntax is binary, threads are not
+   supported, or `file` can not be mapped or is compressed, then this falls
+   back to reading serially like serd_reader_read_mapped_file_handle().
+*/
+SERD_API
+SerdStatus
+serd_reader_read_parallel(SerdReader* SERD_NONNULL     reader,
+                          FILE* SERD_NONNULL           file,
+                          const uint8_t* SERD_NULLABLE name,
+                          unsigned                     n_threads,
+                          bool                         ordered);
+
+/// An input file for serd_reader_read_inputs()
+typedef struct {
+  const uint8_t* SERD_NONNULL   path;         ///< Path of file to read
+  FILE* SERD_NULLABLE           file;         ///< Open file, or null for path
+  SerdSyntax                    syntax;       ///< Syntax, or 0 for reader's
+  const SerdNode* SERD_NULLABLE base;         ///< Base URI, or null
+  const SerdNode* SERD_NULLABLE graph;        ///< Default graph, or null
+  const uint8_t* SERD_NULLABLE  blank_prefix; ///< Blank prefix, or null
+} SerdInput;
+
+/**
+   Read several input files into the sinks of `reader`.
+
+   Each input is read by one of `n_threads` reader threads, with its own
+   reader that uses the same options as `reader`, except that the syntax,
+   default graph, and blank node prefix of the input are used if they are set.
+   Statements are passed in batches through a bounded queue to the calling
+   thread, which emits them to the sink of `reader`, so the sink need not be
+   thread-safe.  Errors are reported to the error sink of `reader` from the
+   reader threads, but never concurrently.  Statements from each input are
+   emitted in order, but the inputs are interleaved in no particular order.
+
+   Since every input has its own base URI and prefixes, all URIs are expanded
+   to absolute URIs before they are emitted, and the base and prefix sinks of
+   `reader` are not called.  Statement flags and the end sink are not used
+   either, since anonymous nodes from several inputs may be interleaved.
+   Generated blank node IDs include the input number so they are unique, and
+   labels like `b1` are renamed as in Turtle, even in NTriples inputs, so they
+   never clash with them.  Otherwise, blank node labels are preserved, so the
+   same label in different inputs refers to the same node unless the inputs
+   have different blank prefixes.
+
+   If `n_threads` is less than 2 or threads are not supported, then the inputs
+   are read one at a time in order.  If an input can not be read, then reading
+   continues with the others, and the first error is returned.  If the sink
+   returns an error, then reading stops and that error is returned.
+*/
+SERD_API
+SerdStatus
+serd_reader_read_inputs(SerdReader* SERD_NONNULL      reader,
+                        const SerdInput* SERD_NONNULL inputs,
+                        size_t                        n_inputs,
+                        unsigned                      n_threads);
+
 /// Read a user-specified byte source
 SERD_API
 SerdStatus
@@ -876,24 +1787,82 @@ serd_reader_read_source(SerdReader* SERD_NONNULL         reader,
                         const uint8_t* SERD_NULLABLE     name,
                         size_t                           page_size);
 
-/// Read `utf8`
+/**
+   Read `utf8`.
+
+   This can not be used for #SERD_BINARY, which may contain null bytes.
+*/
 SERD_API
 SerdStatus
 serd_reader_read_string(SerdReader* SERD_NONNULL    reader,
                         const uint8_t* SERD_NONNULL utf8);
 
+/**
+   Read the statements in a piece of input that has arrived so far.
+
+   This is a push interface for reading, as an alternative to reading from a
+   source that must block until more input is available, for example to read
+   from many non-blocking sockets in an event loop.  Every complete statement
+   in the input fed so far is read and passed to the sinks.  Any incomplete
+   statement at the end is copied and kept by the reader, and is read when the
+   rest of it is fed later.  Complete statements are read directly from `buf`,
+   so this only copies input when a statement is split between calls.
+
+   The first call starts a new document, which continues until `is_last` is
+   true, or an error occurs.  This can not be used while reading from another
+   source, or for #SERD_BINARY.
+
+   @param reader The reader to feed.
+   @param buf Input bytes, which only need to be valid during this call.
+   @param len Number of bytes in `buf`.
+   @param is_last True iff this is the end of the document, in which case any
+   incomplete statement at the end is read as well, and is an error.
+
+   @return #SERD_SUCCESS if all of the complete statements were read, or an
+   error.
+*/
+SERD_API
+SerdStatus
+serd_reader_feed(SerdReader* SERD_NONNULL     reader,
+                 const uint8_t* SERD_NULLABLE buf,
+                 size_t                       len,
+                 bool                         is_last);
+
 /// Free `reader`
 SERD_API
 void
 serd_reader_free(SerdReader* SERD_NULLABLE reader);
 
+/**
+   Reset `reader` to read a new document.
+
+   This closes any source that is being read, discards any statements that
+   have not been passed to the batch sink, and resets everything that is
+   specific to a document, like statistics and generated blank node IDs.  The
+   sinks and options of the reader are kept, and so is its allocated memory,
+   so this is cheaper than creating a new reader for every document.
+*/
+SERD_API
+SerdStatus
+serd_reader_reset(SerdReader* SERD_NONNULL reader);
+
 /**
    @}
    @defgroup serd_writer Writer
    @{
 */
 
-/// Create a new RDF writer
+/**
+   Create a new RDF writer.
+
+   If `style` has #SERD_STYLE_GZIP or #SERD_STYLE_ZSTD, then the output is
+   compressed before being passed to `ssink`.  Each call to
+   serd_writer_finish() ends a compressed frame, so the output so far is a
+   complete compressed file.  Compression is only supported if serd was built
+   with zlib or libzstd, respectively.
+
+   @return A new writer, or null if the requested compression is not supported.
+*/
 SERD_API
 SerdWriter* SERD_ALLOCATED
 serd_writer_new(SerdSyntax                   syntax,
@@ -903,6 +1872,22 @@ serd_writer_new(SerdSyntax                   syntax,
                 SerdSink SERD_NONNULL        ssink,
                 void* SERD_NULLABLE          stream);
 
+/**
+   Create a new RDF writer that uses a custom allocator.
+
+   The allocator is copied, but its handle must remain valid until the writer
+   is freed.  If `allocator` is null, this is equivalent to serd_writer_new().
+*/
+SERD_API
+SerdWriter* SERD_ALLOCATED
+serd_writer_new_with_allocator(const SerdAllocator* SERD_NULLABLE allocator,
+                               SerdSyntax                         syntax,
+                               SerdStyle                          style,
+                               SerdEnv* SERD_NONNULL              env,
+                               const SerdURI* SERD_NULLABLE       base_uri,
+                               SerdSink SERD_NONNULL              ssink,
+                               void* SERD_NULLABLE                stream);
+
 /// Free `writer`
 SERD_API
 void
@@ -913,6 +1898,18 @@ SERD_PURE_API
 SerdEnv* SERD_NONNULL
 serd_writer_get_env(SerdWriter* SERD_NONNULL writer);
 
+/// Statistics about what a writer has done since it was created
+typedef struct {
+  uint64_t n_bytes;      ///< Number of bytes of output, before compression
+  uint64_t n_statements; ///< Number of statements written
+  uint64_t n_escapes;    ///< Number of escapes written in strings and names
+} SerdWriterStats;
+
+/// Return statistics about what `writer` has done
+SERD_PURE_API
+SerdWriterStats
+serd_writer_get_stats(const SerdWriter* SERD_NONNULL writer);
+
 /**
    A convenience sink function for writing to a FILE*.
 
@@ -961,6 +1958,26 @@ serd_writer_set_error_sink(SerdWriter* SERD_NONNULL   writer,
                            SerdErrorSink SERD_NONNULL error_sink,
                            void* SERD_NULLABLE        error_handle);
 
+/**
+   Set a window of statements to regroup before writing.
+
+   By default, statements are written in the order they are given, so only
+   consecutive statements with the same subject are abbreviated.  With a
+   window, up to `max_statements` statements are buffered, then written grouped
+   by graph, subject, and predicate, in the order each group first appeared.
+   The window is written early if the buffered statements and their index use
+   `max_bytes` of memory, and before anything that depends on order: anonymous
+   nodes, lists, prefix and base URI changes, and finishing.
+
+   This only has an effect when writing Turtle or TriG.  A zero limit disables
+   the window, which is the default.
+*/
+SERD_API
+void
+serd_writer_set_reorder_window(SerdWriter* SERD_NONNULL writer,
+                               size_t                   max_statements,
+                               size_t                   max_bytes);
+
 /**
    Set a prefix to be removed from matching blank node identifiers
 
@@ -1011,6 +2028,12 @@ serd_writer_set_prefix(SerdWriter* SERD_NONNULL     writer,
 /**
    Write a statement.
 
+   If a literal is being written in pieces, and the object of this statement
+   has the #SERD_IS_CHUNKED flag, then this only finishes the literal with the
+   graph, datatype, and language of the statement.  Otherwise, the literal is
+   finished with any it was started with first, as if
+   serd_writer_end_literal() was called.
+
    Note this function can be safely casted to SerdStatementSink.
 */
 SERD_API
@@ -1024,6 +2047,68 @@ serd_writer_write_statement(SerdWriter* SERD_NONNULL      writer,
                             const SerdNode* SERD_NULLABLE datatype,
                             const SerdNode* SERD_NULLABLE lang);
 
+/**
+   Write several statements.
+
+   This writes each statement in order, and stops at the first error.  Note
+   this function can be safely casted to SerdBatchSink.
+*/
+SERD_API
+SerdStatus
+serd_writer_write_statements(SerdWriter* SERD_NONNULL          writer,
+                             const SerdStatement* SERD_NONNULL statements,
+                             size_t                            n_statements);
+
+/**
+   Start writing a statement with an object literal that is written in pieces.
+
+   This writes a statement like serd_writer_write_statement(), but stops after
+   the string of `object`, which is the first piece of the literal and may be
+   empty.  The rest of the string is written by calling
+   serd_writer_write_literal_piece() any number of times, then the statement
+   is finished by serd_writer_end_literal(), or by writing a statement with a
+   #SERD_IS_CHUNKED object as a reader does.  No other statements may be
+   written in between.
+
+   Since the string is not known in advance, it is always written as a short
+   string with escapes, and never abbreviated as a number.  This is not
+   supported by the binary syntax.
+*/
+SERD_API
+SerdStatus
+serd_writer_begin_literal(SerdWriter* SERD_NONNULL      writer,
+                          SerdStatementFlags            flags,
+                          const SerdNode* SERD_NULLABLE graph,
+                          const SerdNode* SERD_NONNULL  subject,
+                          const SerdNode* SERD_NONNULL  predicate,
+                          const SerdNode* SERD_NONNULL  object,
+                          const SerdNode* SERD_NULLABLE datatype,
+                          const SerdNode* SERD_NULLABLE lang);
+
+/**
+   Write the next piece of a literal.
+
+   If no literal is being written, then this starts one like
+   serd_writer_begin_literal(), with a datatype or language that is only
+   known when the literal is finished by writing its statement.  Otherwise,
+   the statement nodes are ignored and `piece` is added to the string.
+
+   Note this function can be safely casted to SerdLiteralSink.
+*/
+SERD_API
+SerdStatus
+serd_writer_write_literal_piece(SerdWriter* SERD_NONNULL      writer,
+                                SerdStatementFlags            flags,
+                                const SerdNode* SERD_NULLABLE graph,
+                                const SerdNode* SERD_NONNULL  subject,
+                                const SerdNode* SERD_NONNULL  predicate,
+                                const SerdNode* SERD_NONNULL  piece);
+
+/// Finish a literal and statement started by serd_writer_begin_literal()
+SERD_API
+SerdStatus
+serd_writer_end_literal(SerdWriter* SERD_NONNULL writer);
+
 /**
    Mark the end of an anonymous node's description.
 
@@ -1038,12 +2123,34 @@ serd_writer_end_anon(SerdWriter* SERD_NONNULL      writer,
    Finish a write
 
    This flushes any pending output, for example terminating punctuation, so
-   that the output is a complete document.
+   that the output is a complete document.  If the writer was created with
+   #SERD_STYLE_ASYNC, this waits until all output has been written to the
+   sink, which is otherwise called from a background thread.
 */
 SERD_API
 SerdStatus
 serd_writer_finish(SerdWriter* SERD_NONNULL writer);
 
+/**
+   Finish the current document, and reset `writer` to write a new one.
+
+   This finishes the output like serd_writer_finish(), then resets everything
+   that is specific to a document, like statistics and any unfinished
+   anonymous nodes, so the following output starts as if the writer was new.
+   The sink, style, and options of the writer are kept, and so is its
+   allocated memory.
+
+   @param writer The writer to reset.
+
+   @param env The environment to use from now on, or null to keep using the
+   current one.  The base URI of the writer is set to the base URI of this
+   environment, so a copy of an environment made with serd_env_copy() can be
+   used to start every document with the same base URI and prefixes.
+*/
+SERD_API
+SerdStatus
+serd_writer_reset(SerdWriter* SERD_NONNULL writer, SerdEnv* SERD_NULLABLE env);
+
 /**
    @}
    @}
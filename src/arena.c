@@ -0,0 +1,160 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "memory.h"
+
+#include "serd/serd.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Default size of a block of memory
+#define DEFAULT_BLOCK_SIZE 4096u
+
+/// Alignment of every allocation, which is enough for any basic type
+#define ALIGNMENT 16u
+
+/// A block of memory, followed immediately by its data
+typedef struct ArenaBlockImpl {
+  struct ArenaBlockImpl* next; ///< Next block in the list
+  size_t                 size; ///< Size of data in bytes
+} ArenaBlock;
+
+/// Size of a block header, padded so that block data is aligned
+#define HEADER_SIZE \
+  ((sizeof(ArenaBlock) + ALIGNMENT - 1u) & ~(size_t)(ALIGNMENT - 1u))
+
+struct SerdArenaImpl {
+  SerdAllocator allocator;  ///< Allocator for blocks
+  size_t        block_size; ///< Size of regular blocks
+  ArenaBlock*   blocks;     ///< Regular blocks, which are kept on reset
+  ArenaBlock*   current;    ///< Regular block currently being allocated from
+  size_t        head;       ///< Number of bytes used in current block
+  ArenaBlock*   large;      ///< Large allocations, which are freed on reset
+};
+
+static inline uint8_t*
+block_data(ArenaBlock* const block)
+{
+  return (uint8_t*)block + HEADER_SIZE;
+}
+
+static ArenaBlock*
+new_block(const SerdAllocator* allocator, const size_t size)
+{
+  ArenaBlock* const block =
+    (ArenaBlock*)serd_amalloc(allocator, HEADER_SIZE + size);
+
+  if (block) {
+    block->next = NULL;
+    block->size = size;
+  }
+
+  return block;
+}
+
+static void
+free_blocks(const SerdAllocator* allocator, ArenaBlock* block)
+{
+  while (block) {
+    ArenaBlock* const next = block->next;
+    serd_afree(allocator, block);
+    block = next;
+  }
+}
+
+SerdArena*
+serd_arena_new(const SerdAllocator* allocator, const size_t block_size)
+{
+  SerdArena* const arena =
+    (SerdArena*)serd_acalloc(allocator, 1, sizeof(SerdArena));
+
+  if (arena) {
+    if (allocator) {
+      arena->allocator = *allocator;
+    }
+
+    arena->block_size = block_size ? block_size : DEFAULT_BLOCK_SIZE;
+  }
+
+  return arena;
+}
+
+void
+serd_arena_free(SerdArena* arena)
+{
+  if (!arena) {
+    return;
+  }
+
+  const SerdAllocator allocator = arena->allocator;
+
+  free_blocks(&allocator, arena->large);
+  free_blocks(&allocator, arena->blocks);
+  serd_afree(&allocator, arena);
+}
+
+void*
+serd_arena_alloc(SerdArena* const arena, const size_t size)
+{
+  const size_t padded = (size + ALIGNMENT - 1u) & ~(size_t)(ALIGNMENT - 1u);
+
+  if (padded > arena->block_size / 2u) {
+    // Large allocation, put it in its own block
+    ArenaBlock* const block = new_block(&arena->allocator, padded);
+    if (!block) {
+      return NULL;
+    }
+
+    block->next  = arena->large;
+    arena->large = block;
+    return block_data(block);
+  }
+
+  if (!arena->current || arena->head + padded > arena->current->size) {
+    // Move to the next block, allocating a new one if necessary
+    ArenaBlock* next = arena->current ? arena->current->next : arena->blocks;
+    if (!next) {
+      if (!(next = new_block(&arena->allocator, arena->block_size))) {
+        return NULL;
+      }
+
+      if (arena->current) {
+        arena->current->next = next;
+      } else {
+        arena->blocks = next;
+      }
+    }
+
+    arena->current = next;
+    arena->head    = 0u;
+  }
+
+  uint8_t* const ptr = block_data(arena->current) + arena->head;
+
+  arena->head += padded;
+  return ptr;
+}
+
+void
+serd_arena_reset(SerdArena* const arena)
+{
+  free_blocks(&arena->allocator, arena->large);
+
+  arena->current = NULL;
+  arena->head    = 0u;
+  arena->large   = NULL;
+}
@@ -23,4 +23,10 @@
 #  define SERD_MALLOC_FUNC
 #endif
 
+#ifdef __GNUC__
+#  define SERD_ALWAYS_INLINE_FUNC __attribute__((always_inline))
+#else
+#  define SERD_ALWAYS_INLINE_FUNC
+#endif
+
 #endif // SERD_ATTRIBUTES_H
@@ -0,0 +1,417 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "binary.h"
+#include "byte_source.h"
+#include "memory.h"
+#include "reader.h"
+#include "serd_internal.h"
+#include "stack.h"
+
+#include "serd/serd.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/// A node read from a record, which is either on the stack or a term
+typedef struct {
+  Ref    ref;  ///< Node on the stack, or 0
+  size_t term; ///< Term ID, or 0
+} BinaryNode;
+
+static SerdStatus
+bad_end(SerdReader* const reader)
+{
+  return r_err(reader, SERD_ERR_BAD_SYNTAX, "unexpected end of input\n");
+}
+
+/// Read `n` bytes into `dst`, copying directly from the buffer if possible
+static SerdStatus
+read_raw(SerdReader* const reader, uint8_t* const dst, const size_t n)
+{
+  SerdByteSource* const source = &reader->source;
+  SerdStatus            st     = SERD_SUCCESS;
+
+  for (size_t i = 0u; i < n;) {
+    if (source->eof) {
+      return bad_end(reader);
+    }
+
+    const size_t n_buffered = serd_byte_source_n_buffered(source);
+    if (n_buffered) {
+      const size_t n_copy = MIN(n_buffered, n - i);
+      memcpy(dst + i, source->read_buf + source->read_head, n_copy);
+      st = serd_byte_source_skip(source, n_copy);
+      i += n_copy;
+    } else {
+      dst[i++] = serd_byte_source_peek(source);
+      st       = serd_byte_source_advance(source);
+    }
+
+    if (st > SERD_FAILURE) {
+      return r_err(reader, st, "read error\n");
+    }
+  }
+
+  return SERD_SUCCESS;
+}
+
+static inline SerdStatus
+read_byte(SerdReader* const reader, uint8_t* const byte)
+{
+  SerdByteSource* const source = &reader->source;
+  if (source->eof) {
+    return bad_end(reader);
+  }
+
+  *byte               = serd_byte_source_peek(source);
+  const SerdStatus st = serd_byte_source_advance(source);
+  return st > SERD_FAILURE ? r_err(reader, st, "read error\n") : SERD_SUCCESS;
+}
+
+static SerdStatus
+read_varint(SerdReader* const reader, uint64_t* const value)
+{
+  *value = 0u;
+  for (unsigned i = 0u; i < SERD_BINARY_MAX_VARINT; ++i) {
+    uint8_t          byte = 0u;
+    const SerdStatus st   = read_byte(reader, &byte);
+    if (st) {
+      return st;
+    }
+
+    *value |= (uint64_t)(byte & 0x7Fu) << (7u * i);
+    if (!(byte & 0x80u)) {
+      return SERD_SUCCESS;
+    }
+  }
+
+  return r_err(reader, SERD_ERR_BAD_SYNTAX, "invalid integer\n");
+}
+
+/// Read a varint that is a size in memory
+static SerdStatus
+read_size(SerdReader* const reader, size_t* const size)
+{
+  uint64_t         value = 0u;
+  const SerdStatus st    = read_varint(reader, &value);
+  if (!st && value >= SIZE_MAX / 2u) {
+    return r_err(reader, SERD_ERR_BAD_SYNTAX, "invalid size\n");
+  }
+
+  *size = (size_t)value;
+  return st;
+}
+
+/**
+   Read a string of `n_bytes` bytes onto the end of the node at `ref`.
+
+   The length comes from the input, so the string is read a page at a time,
+   and memory is only allocated for bytes that are actually there.
+*/
+static SerdStatus
+read_string(SerdReader* const reader, const Ref ref, const size_t n_bytes)
+{
+  SERD_STACK_ASSERT_TOP(reader, ref);
+
+  for (size_t i = 0u; i < n_bytes;) {
+    const size_t n = MIN(n_bytes - i, SERD_PAGE_SIZE);
+
+    // Read over the terminator, then terminate the string again
+    uint8_t* const   dst  = (uint8_t*)serd_stack_push(&reader->stack, n) - 1;
+    SerdNode* const  node = (SerdNode*)(reader->stack.buf + ref);
+    const SerdStatus st   = read_raw(reader, dst, n);
+
+    dst[n] = '\0';
+    node->n_bytes += n;
+    if (st) {
+      return st;
+    }
+
+    i += n;
+  }
+
+  return SERD_SUCCESS;
+}
+
+/// Add a term like `node` to the table and return the buffer for its string
+static uint8_t*
+add_term(SerdReader* const reader, const SerdNode* const node)
+{
+  if (!reader->term_arena) {
+    reader->term_arena = serd_arena_new(&reader->allocator, 0u);
+  }
+
+  if (reader->n_terms == reader->terms_size) {
+    reader->terms_size = reader->terms_size ? reader->terms_size * 2u : 256u;
+    reader->terms      = (SerdNode*)serd_arealloc(
+      &reader->allocator, reader->terms, reader->terms_size * sizeof(SerdNode));
+  }
+
+  uint8_t* const buf =
+    (uint8_t*)serd_arena_alloc(reader->term_arena, node->n_bytes + 1u);
+
+  SerdNode* const term = &reader->terms[reader->n_terms++];
+  *term                = *node;
+  term->buf            = buf;
+  buf[node->n_bytes]   = '\0';
+  return buf;
+}
+
+static SerdStatus
+read_node(SerdReader* const reader, BinaryNode* const out)
+{
+  SerdStatus st     = SERD_SUCCESS;
+  uint8_t    header = 0u;
+
+  out->ref  = 0u;
+  out->term = 0u;
+  if ((st = read_byte(reader, &header)) || !header) {
+    return st;
+  }
+
+  if (header == SERD_BINARY_REF) {
+    uint64_t id = 0u;
+    if ((st = read_varint(reader, &id))) {
+      return st;
+    }
+
+    if (!id || id > reader->n_terms) {
+      return r_err(reader, SERD_ERR_BAD_SYNTAX, "undefined term\n");
+    }
+
+    out->term = (size_t)id;
+    return SERD_SUCCESS;
+  }
+
+  const unsigned type = header & ~SERD_BINARY_DEFINE;
+  if (type < SERD_LITERAL || type > SERD_BLANK) {
+    return r_err(reader, SERD_ERR_BAD_SYNTAX, "invalid node type %u\n", type);
+  }
+
+  uint64_t flags   = 0u;
+  size_t   n_chars = 0u;
+  size_t   n_bytes = 0u;
+  if ((st = read_varint(reader, &flags)) ||
+      (st = read_size(reader, &n_chars)) ||
+      (st = read_size(reader, &n_bytes))) {
+    return st;
+  }
+
+  if (n_chars > n_bytes) {
+    return r_err(reader, SERD_ERR_BAD_SYNTAX, "invalid node length\n");
+  }
+
+  // Read the string onto the stack, then move it to the term table if needed
+  const Ref ref = push_node(reader, (SerdType)type, "", 0u);
+  if ((st = read_string(reader, ref, n_bytes))) {
+    pop_node(reader, ref);
+    return st;
+  }
+
+  SerdNode* const node = deref(reader, ref);
+  node->n_chars        = n_chars;
+  node->flags          = (SerdNodeFlags)flags;
+
+  if (header & SERD_BINARY_DEFINE) {
+    uint8_t* const buf = add_term(reader, node);
+
+    memcpy(buf, node->buf, n_bytes);
+    pop_node(reader, ref);
+    out->term = reader->n_terms;
+    return SERD_SUCCESS;
+  }
+
+  out->ref = ref;
+  return SERD_SUCCESS;
+}
+
+static const SerdNode*
+get_node(SerdReader* const reader, const BinaryNode* const node)
+{
+  return node->term ? &reader->terms[node->term - 1u]
+                    : deref(reader, node->ref);
+}
+
+/// Read `n_nodes` nodes, stopping at the first error
+static SerdStatus
+read_nodes(SerdReader* const reader,
+           BinaryNode* const nodes,
+           const unsigned    n_nodes)
+{
+  for (unsigned i = 0u; i < n_nodes; ++i) {
+    const SerdStatus st = read_node(reader, &nodes[i]);
+    if (st) {
+      return st;
+    }
+  }
+
+  return SERD_SUCCESS;
+}
+
+/// Pop the nodes of a record from the stack, in reverse order
+static void
+pop_nodes(SerdReader* const       reader,
+          const BinaryNode* const nodes,
+          const unsigned          n_nodes)
+{
+  for (unsigned i = n_nodes; i > 0u; --i) {
+    pop_node(reader, nodes[i - 1u].ref);
+  }
+}
+
+static SerdStatus
+read_header(SerdReader* const reader)
+{
+  uint8_t          magic[SERD_BINARY_MAGIC_LEN];
+  const SerdStatus st = read_raw(reader, magic, SERD_BINARY_MAGIC_LEN);
+  if (st) {
+    return st;
+  }
+
+  if (memcmp(magic, SERD_BINARY_MAGIC, SERD_BINARY_MAGIC_LEN)) {
+    return r_err(reader, SERD_ERR_BAD_SYNTAX, "invalid binary header\n");
+  }
+
+  // Start a new term table
+  reader->n_terms = 0u;
+  if (reader->term_arena) {
+    serd_arena_reset(reader->term_arena);
+  }
+
+  return SERD_SUCCESS;
+}
+
+static SerdStatus
+read_statement_record(SerdReader* const reader)
+{
+  BinaryNode nodes[6] = {
+    {0u, 0u}, {0u, 0u}, {0u, 0u}, {0u, 0u}, {0u, 0u}, {0u, 0u}};
+  uint64_t   flags = 0u;
+  SerdStatus st    = SERD_SUCCESS;
+
+  if (!(st = read_varint(reader, &flags)) &&
+      !(st = read_nodes(reader, nodes, 6u))) {
+    const SerdNode* graph = get_node(reader, &nodes[0]);
+    if (!graph && reader->default_graph.buf) {
+      graph = &reader->default_graph;
+    }
+
+    const SerdNode* const subject   = get_node(reader, &nodes[1]);
+    const SerdNode* const predicate = get_node(reader, &nodes[2]);
+    const SerdNode* const object    = get_node(reader, &nodes[3]);
+    if (!subject || !predicate || !object) {
+      st = r_err(reader, SERD_ERR_BAD_SYNTAX, "incomplete statement\n");
+    } else {
+      st = sink_statement(reader,
+                          (SerdStatementFlags)flags,
+                          graph,
+                          subject,
+                          predicate,
+                          object,
+                          get_node(reader, &nodes[4]),
+                          get_node(reader, &nodes[5]));
+      ++reader->stats.n_statements;
+    }
+  }
+
+  pop_nodes(reader, nodes, 6u);
+  return st;
+}
+
+static SerdStatus
+read_event_record(SerdReader* const reader, const uint8_t tag)
+{
+  BinaryNode     nodes[2] = {{0u, 0u}, {0u, 0u}};
+  const unsigned n_nodes  = (tag == 'p') ? 2u : 1u;
+  SerdStatus     st       = read_nodes(reader, nodes, n_nodes);
+
+  const SerdNode* const first  = st ? NULL : get_node(reader, &nodes[0]);
+  const SerdNode* const second = st ? NULL : get_node(reader, &nodes[1]);
+  if (!st && (!first || (n_nodes == 2u && !second))) {
+    st = r_err(reader, SERD_ERR_BAD_SYNTAX, "missing node\n");
+  }
+
+  if (!st) {
+    // Pass any batched statements first to preserve the order of events
+    st = flush_batch(reader);
+  }
+
+  if (!st && reader->validate_only) {
+    if (tag == 'p') {
+      st = serd_env_set_prefix(reader->prefixes, first, second);
+    }
+  } else if (!st) {
+    if (tag == 'b' && reader->base_sink) {
+      st = reader->base_sink(reader->handle, first);
+    } else if (tag == 'p' && reader->prefix_sink) {
+      st = reader->prefix_sink(reader->handle, first, second);
+    } else if (tag == 'e' && reader->end_sink) {
+      st = reader->end_sink(reader->handle, first);
+    }
+  }
+
+  pop_nodes(reader, nodes, n_nodes);
+  return st;
+}
+
+SerdStatus
+read_binary_statement(SerdReader* const reader)
+{
+  const int c = peek_byte(reader);
+  if (c == EOF) {
+    return SERD_FAILURE;
+  }
+
+  switch (c) {
+  case 'S': // Start of SERD_BINARY_MAGIC
+    return read_header(reader);
+  case 't':
+    eat_byte_safe(reader, c);
+    return read_statement_record(reader);
+  case 'b':
+  case 'p':
+  case 'e':
+    eat_byte_safe(reader, c);
+    return read_event_record(reader, (uint8_t)c);
+  default:
+    break;
+  }
+
+  return r_err(reader, SERD_ERR_BAD_SYNTAX, "invalid record type %d\n", c);
+}
+
+SerdStatus
+read_binaryDoc(SerdReader* const reader)
+{
+  const int c = peek_byte(reader);
+  if (c == EOF) {
+    return SERD_SUCCESS;
+  }
+
+  if (c != 'S') {
+    return r_err(reader, SERD_ERR_BAD_SYNTAX, "missing binary header\n");
+  }
+
+  SerdStatus st = SERD_SUCCESS;
+  while (!(st = read_binary_statement(reader))) {
+  }
+
+  return st > SERD_FAILURE ? st : SERD_SUCCESS;
+}
@@ -0,0 +1,75 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef SERD_BINARY_H
+#define SERD_BINARY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+  Binary syntax.
+
+  This is a simple length-prefixed encoding of reader events, which can be
+  read back without escaping, UTF-8 validation, or searching for delimiters.
+  A document is a header followed by a sequence of records:
+
+  - Header: The 8 bytes of SERD_BINARY_MAGIC, which also clears the term table.
+  - Statement: 't', flags, then graph, subject, predicate, object, datatype,
+    and language nodes.
+  - Base: 'b', then the base URI node.
+  - Prefix: 'p', then the name and URI nodes.
+  - End: 'e', then the node of the anonymous node that ended.
+
+  Integers are unsigned LEB128 varints.  A node starts with a byte that is
+  either 0 for no node, SERD_BINARY_REF followed by the ID of a term defined
+  earlier, or the node type optionally ORed with SERD_BINARY_DEFINE.  The
+  type is followed by the node flags, the number of characters, the number
+  of bytes, and the bytes themselves, without a null terminator.  A node
+  with SERD_BINARY_DEFINE is also added to the term table, where terms are
+  numbered from 1 in the order they are defined.
+*/
+
+/// Magic bytes at the start of a binary document, including the version
+#define SERD_BINARY_MAGIC "SERDBIN\001"
+
+/// Length of SERD_BINARY_MAGIC
+#define SERD_BINARY_MAGIC_LEN 8u
+
+/// Node header bit that means the node is a reference to a term
+#define SERD_BINARY_REF 0x80u
+
+/// Node header bit that means the node is added to the term table
+#define SERD_BINARY_DEFINE 0x40u
+
+/// Maximum size of an encoded varint
+#define SERD_BINARY_MAX_VARINT 10u
+
+/// Encode `value` into `buf` and return the number of bytes written
+static inline size_t
+serd_binary_encode_varint(uint8_t* const buf, uint64_t value)
+{
+  size_t n = 0u;
+  while (value >= 0x80u) {
+    buf[n++] = (uint8_t)(value | 0x80u);
+    value >>= 7u;
+  }
+
+  buf[n++] = (uint8_t)value;
+  return n;
+}
+
+#endif // SERD_BINARY_H
@@ -0,0 +1,243 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#define _POSIX_C_SOURCE 200809L /* for pthreads */
+
+#include "byte_sink.h"
+
+#include "memory.h"
+#include "serd_config.h"
+
+#include "serd/serd.h"
+
+#if USE_PTHREAD
+#  include <pthread.h>
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Number of blocks that rotate between the writer and the sink thread
+#define N_ASYNC_BLOCKS 4u
+
+/**
+   A block of output.
+
+   Each block is owned by either the writer or the sink thread, according to
+   `full` which is protected by the mutex.  The writer fills empty blocks and
+   marks them full, the sink thread writes full blocks and marks them empty.
+*/
+typedef struct {
+  uint8_t* buf;  ///< Block data
+  size_t   size; ///< Number of bytes in buf
+  bool     full; ///< True iff filled by the writer
+} OutBlock;
+
+struct SerdAsyncSinkImpl {
+  SerdSink sink;                   ///< Underlying sink function
+  void*    stream;                 ///< Underlying stream
+  OutBlock blocks[N_ASYNC_BLOCKS]; ///< Ring of blocks
+  unsigned cur;                    ///< Index of the block being filled
+#if USE_PTHREAD
+  pthread_t       thread; ///< Background sink thread
+  pthread_mutex_t mutex;  ///< Mutex for block ownership and exit
+  pthread_cond_t  cond;   ///< Signalled when a block changes hands
+  bool            exit;   ///< True iff the sink thread should stop
+#endif
+};
+
+#if USE_PTHREAD
+
+static void*
+async_sink_run(void* const arg)
+{
+  SerdAsyncSink* const async = (SerdAsyncSink*)arg;
+
+  for (unsigned i = 0u;; i = (i + 1u) % N_ASYNC_BLOCKS) {
+    OutBlock* const block = &async->blocks[i];
+
+    // Wait until the writer has filled this block
+    pthread_mutex_lock(&async->mutex);
+    while (!block->full && !async->exit) {
+      pthread_cond_wait(&async->cond, &async->mutex);
+    }
+
+    const bool stop = !block->full;
+    pthread_mutex_unlock(&async->mutex);
+    if (stop) {
+      break;
+    }
+
+    // Write without holding the lock, so the writer can continue meanwhile
+    async->sink(block->buf, block->size, async->stream);
+
+    pthread_mutex_lock(&async->mutex);
+    block->full = false;
+    pthread_cond_broadcast(&async->cond);
+    pthread_mutex_unlock(&async->mutex);
+  }
+
+  return NULL;
+}
+
+static SerdAsyncSink*
+async_sink_new(const SerdAllocator* const allocator,
+               const SerdSink             sink,
+               void* const                stream,
+               const size_t               block_size)
+{
+  SerdAsyncSink* const async =
+    (SerdAsyncSink*)serd_acalloc(allocator, 1, sizeof(SerdAsyncSink));
+
+  async->sink   = sink;
+  async->stream = stream;
+  for (unsigned i = 0u; i < N_ASYNC_BLOCKS; ++i) {
+    async->blocks[i].buf =
+      (uint8_t*)serd_aallocate_buffer(allocator, block_size);
+  }
+
+  pthread_mutex_init(&async->mutex, NULL);
+  pthread_cond_init(&async->cond, NULL);
+  return async;
+}
+
+static void
+async_sink_free(const SerdAllocator* const allocator,
+                SerdAsyncSink* const       async)
+{
+  pthread_cond_destroy(&async->cond);
+  pthread_mutex_destroy(&async->mutex);
+
+  for (unsigned i = 0u; i < N_ASYNC_BLOCKS; ++i) {
+    serd_afree_buffer(allocator, async->blocks[i].buf);
+  }
+
+  serd_afree(allocator, async);
+}
+
+#endif
+
+SerdByteSink
+serd_byte_sink_new(const SerdAllocator* allocator,
+                   SerdSink             sink,
+                   void*                stream,
+                   size_t               block_size,
+                   bool                 async)
+{
+  SerdByteSink bsink = {allocator, sink, stream, NULL, 0, block_size, NULL};
+
+  if (block_size <= 1) {
+    return bsink;
+  }
+
+#if USE_PTHREAD
+  if (async) {
+    SerdAsyncSink* const a =
+      async_sink_new(allocator, sink, stream, block_size);
+
+    if (!pthread_create(&a->thread, NULL, async_sink_run, a)) {
+      bsink.async = a;
+      bsink.buf   = a->blocks[0].buf;
+      return bsink;
+    }
+
+    async_sink_free(allocator, a); // Fall back to writing synchronously
+  }
+#else
+  (void)async;
+#endif
+
+  bsink.buf = (uint8_t*)serd_aallocate_buffer(allocator, block_size);
+  return bsink;
+}
+
+void
+serd_byte_sink_emit(SerdByteSink* bsink)
+{
+#if USE_PTHREAD
+  SerdAsyncSink* const async = bsink->async;
+  if (async) {
+    // Hand the current block to the sink thread
+    pthread_mutex_lock(&async->mutex);
+    async->blocks[async->cur].size = bsink->size;
+    async->blocks[async->cur].full = true;
+    pthread_cond_broadcast(&async->cond);
+
+    // Wait until the next block has been written
+    async->cur            = (async->cur + 1u) % N_ASYNC_BLOCKS;
+    OutBlock* const block = &async->blocks[async->cur];
+    while (block->full) {
+      pthread_cond_wait(&async->cond, &async->mutex);
+    }
+    pthread_mutex_unlock(&async->mutex);
+
+    bsink->buf  = block->buf;
+    bsink->size = 0;
+    return;
+  }
+#endif
+
+  bsink->sink(bsink->buf, bsink->size, bsink->stream);
+  bsink->size = 0;
+}
+
+void
+serd_byte_sink_flush(SerdByteSink* bsink)
+{
+  if (bsink->block_size > 1 && bsink->size > 0) {
+    serd_byte_sink_emit(bsink);
+  }
+
+#if USE_PTHREAD
+  SerdAsyncSink* const async = bsink->async;
+  if (async) {
+    // Wait until every block has been written
+    pthread_mutex_lock(&async->mutex);
+    for (unsigned i = 0u; i < N_ASYNC_BLOCKS; ++i) {
+      while (async->blocks[i].full) {
+        pthread_cond_wait(&async->cond, &async->mutex);
+      }
+    }
+    pthread_mutex_unlock(&async->mutex);
+  }
+#endif
+}
+
+void
+serd_byte_sink_free(SerdByteSink* bsink)
+{
+  serd_byte_sink_flush(bsink);
+
+#if USE_PTHREAD
+  SerdAsyncSink* const async = bsink->async;
+  if (async) {
+    pthread_mutex_lock(&async->mutex);
+    async->exit = true;
+    pthread_cond_broadcast(&async->cond);
+    pthread_mutex_unlock(&async->mutex);
+    pthread_join(async->thread, NULL);
+
+    async_sink_free(bsink->allocator, async);
+    bsink->async = NULL;
+    bsink->buf   = NULL;
+    return;
+  }
+#endif
+
+  serd_afree_buffer(bsink->allocator, bsink->buf);
+  bsink->buf = NULL;
+}
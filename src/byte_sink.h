@@ -18,50 +18,54 @@
 #define SERD_BYTE_SINK_H
 
 #include "serd_internal.h"
-#include "system.h"
 
 #include "serd/serd.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
+/// Size of each block when writing in a background thread
+#define SERD_ASYNC_BLOCK_SIZE (16u * SERD_PAGE_SIZE)
+
+/// Background thread that writes full blocks to the sink
+typedef struct SerdAsyncSinkImpl SerdAsyncSink;
+
 typedef struct SerdByteSinkImpl {
-  SerdSink sink;
-  void*    stream;
-  uint8_t* buf;
-  size_t   size;
-  size_t   block_size;
+  const SerdAllocator* allocator;
+  SerdSink             sink;
+  void*                stream;
+  uint8_t*             buf;
+  size_t               size;
+  size_t               block_size;
+  SerdAsyncSink*       async;
 } SerdByteSink;
 
-static inline SerdByteSink
-serd_byte_sink_new(SerdSink sink, void* stream, size_t block_size)
-{
-  SerdByteSink bsink = {sink, stream, NULL, 0, block_size};
+/**
+   Create a new byte sink.
 
-  if (block_size > 1) {
-    bsink.buf = (uint8_t*)serd_allocate_buffer(block_size);
-  }
+   If `block_size` is 1, every write goes directly to `sink`.  Otherwise,
+   output is buffered in blocks and, if `async` is true, written by a
+   background thread while the next block is being filled.
+*/
+SerdByteSink
+serd_byte_sink_new(const SerdAllocator* allocator,
+                   SerdSink             sink,
+                   void*                stream,
+                   size_t               block_size,
+                   bool                 async);
 
-  return bsink;
-}
+/// Write the current block to the sink and start a new one
+void
+serd_byte_sink_emit(SerdByteSink* bsink);
 
-static inline void
-serd_byte_sink_flush(SerdByteSink* bsink)
-{
-  if (bsink->block_size > 1 && bsink->size > 0) {
-    bsink->sink(bsink->buf, bsink->size, bsink->stream);
-    bsink->size = 0;
-  }
-}
+/// Write any buffered output, and wait for it to be written if asynchronous
+void
+serd_byte_sink_flush(SerdByteSink* bsink);
 
-static inline void
-serd_byte_sink_free(SerdByteSink* bsink)
-{
-  serd_byte_sink_flush(bsink);
-  serd_free_aligned(bsink->buf);
-  bsink->buf = NULL;
-}
+void
+serd_byte_sink_free(SerdByteSink* bsink);
 
 static inline size_t
 serd_byte_sink_write(const void* buf, size_t len, SerdByteSink* bsink)
@@ -87,8 +91,7 @@ serd_byte_sink_write(const void* buf, size_t len, SerdByteSink* bsink)
 
     // Flush page if buffer is full
     if (bsink->size == bsink->block_size) {
-      bsink->sink(bsink->buf, bsink->block_size, bsink->stream);
-      bsink->size = 0;
+      serd_byte_sink_emit(bsink);
     }
   }
 
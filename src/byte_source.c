@@ -16,6 +16,8 @@
 
 #include "byte_source.h"
 
+#include "compress.h"
+#include "memory.h"
 #include "system.h"
 
 #include "serd/serd.h"
@@ -24,13 +26,89 @@
 #include <stdint.h>
 #include <string.h>
 
+/// Update the lazy cursor up to `end` by scanning the buffered input
+static void
+update_cursor(SerdByteSource* const source, size_t end)
+{
+  if (source->buf_size && end > source->buf_size) {
+    end = source->buf_size; // Past the end of the input
+  }
+
+  const size_t start = (size_t)(source->cur_offset - source->offset);
+  if (start >= end) {
+    return;
+  }
+
+  const uint8_t* const last       = source->read_buf + end;
+  const uint8_t*       line_start = source->read_buf + start;
+  const uint8_t*       p          = line_start;
+  bool                 new_line   = false;
+  while ((p = (const uint8_t*)memchr(p, '\n', (size_t)(last - p)))) {
+    ++source->cur.line;
+    line_start = ++p;
+    new_line   = true;
+  }
+
+  const unsigned n_cols = (unsigned)(last - line_start);
+
+  source->cur.col    = new_line ? n_cols : source->cur.col + n_cols;
+  source->cur_offset = source->offset + end;
+}
+
+void
+serd_byte_source_set_lazy(SerdByteSource* source, const bool lazy)
+{
+  if (source->lazy && !lazy) {
+    update_cursor(source, source->read_head);
+  }
+
+  source->lazy       = lazy && (!source->from_stream || source->page_size > 1);
+  source->cur_offset = serd_byte_source_offset(source);
+}
+
+Cursor*
+serd_byte_source_cursor(SerdByteSource* source)
+{
+  if (source->lazy) {
+    update_cursor(source, source->read_head);
+  }
+
+  return &source->cur;
+}
+
+void
+serd_byte_source_end_buffer(SerdByteSource* source)
+{
+  if (source->lazy) {
+    // Count the lines in the buffer before it is replaced
+    update_cursor(source, source->read_head);
+  }
+
+  source->offset += source->read_head;
+  source->read_head = 0u;
+  source->read_byte = 0u;
+  source->read_buf  = &source->read_byte;
+  source->eof       = true;
+}
+
 SerdStatus
 serd_byte_source_page(SerdByteSource* source)
 {
+  if (source->lazy) {
+    // Count the lines in this page before it is replaced
+    update_cursor(source, source->read_head);
+  }
+
+  source->offset += source->read_head;
   source->read_head = 0;
-  const size_t n_read =
+
+  const uint64_t start = serd_monotonic_time();
+  const size_t   n_read =
     source->read_func(source->file_buf, 1, source->page_size, source->stream);
 
+  source->read_time += serd_monotonic_time() - start;
+  ++source->n_pages;
+
   if (n_read == 0) {
     source->file_buf[0] = '\0';
     source->eof         = true;
@@ -47,16 +125,18 @@ serd_byte_source_page(SerdByteSource* source)
 }
 
 SerdStatus
-serd_byte_source_open_source(SerdByteSource*     source,
-                             SerdSource          read_func,
-                             SerdStreamErrorFunc error_func,
-                             void*               stream,
-                             const uint8_t*      name,
-                             size_t              page_size)
+serd_byte_source_open_source(SerdByteSource*      source,
+                             const SerdAllocator* allocator,
+                             SerdSource           read_func,
+                             SerdStreamErrorFunc  error_func,
+                             void*                stream,
+                             const uint8_t*       name,
+                             size_t               page_size)
 {
   const Cursor cur = {name, 1, 1};
 
   memset(source, '\0', sizeof(*source));
+  source->allocator   = allocator;
   source->stream      = stream;
   source->from_stream = true;
   source->page_size   = page_size;
@@ -66,7 +146,7 @@ serd_byte_source_open_source(SerdByteSource*     source,
   source->read_func   = read_func;
 
   if (page_size > 1) {
-    source->file_buf = (uint8_t*)serd_allocate_buffer(page_size);
+    source->file_buf = (uint8_t*)serd_aallocate_buffer(allocator, page_size);
     source->read_buf = source->file_buf;
     memset(source->file_buf, '\0', page_size);
   } else {
@@ -82,8 +162,16 @@ serd_byte_source_prepare(SerdByteSource* source)
   source->prepared = true;
 
   if (source->from_stream) {
-    return (source->page_size > 1 ? serd_byte_source_page(source)
-                                  : serd_byte_source_advance(source));
+    if (source->page_size > 1) {
+      return serd_byte_source_page(source);
+    }
+
+    // Read the first byte, which is at the starting offset
+    const uint64_t   offset = source->offset;
+    const SerdStatus st     = serd_byte_source_advance(source);
+
+    source->offset = offset;
+    return st;
   }
 
   return SERD_SUCCESS;
@@ -100,11 +188,63 @@ serd_byte_source_open_string(SerdByteSource* source, const uint8_t* utf8)
   return SERD_SUCCESS;
 }
 
+SerdStatus
+serd_byte_source_open_buffer(SerdByteSource* source,
+                             const uint8_t*  buf,
+                             size_t          size,
+                             const uint8_t*  name)
+{
+  const Cursor cur = {name, 1, 1};
+
+  memset(source, '\0', sizeof(*source));
+  source->cur      = cur;
+  source->read_buf = size ? buf : &source->read_byte;
+  source->buf_size = size;
+  source->eof      = !size;
+  return SERD_SUCCESS;
+}
+
+SerdStatus
+serd_byte_source_open_mapped(SerdByteSource* source,
+                             FILE*           file,
+                             const uint8_t*  name)
+{
+  const long  pos  = ftell(file);
+  size_t      size = 0;
+  const void* map  = serd_map_file(file, &size);
+
+  memset(source, '\0', sizeof(*source));
+  if (!map) {
+    return SERD_FAILURE;
+  }
+
+  // Start at the current position so this behaves like reading from the file
+  const size_t offset = pos > 0 ? (size_t)pos : 0u;
+  if (offset >= size || serd_compression_detect((const uint8_t*)map + offset,
+                                                size - offset)) {
+    // Empty or compressed, so the file must be read as a stream
+    serd_unmap_file(map, size);
+    return SERD_FAILURE;
+  }
+
+  serd_byte_source_open_buffer(
+    source, (const uint8_t*)map + offset, size - offset, name);
+
+  source->map      = map;
+  source->map_size = size;
+  source->offset   = offset;
+  return SERD_SUCCESS;
+}
+
 SerdStatus
 serd_byte_source_close(SerdByteSource* source)
 {
   if (source->page_size > 1) {
-    serd_free_aligned(source->file_buf);
+    serd_afree_buffer(source->allocator, source->file_buf);
+  }
+
+  if (source->map) {
+    serd_unmap_file(source->map, source->map_size);
   }
 
   memset(source, '\0', sizeof(*source));
@@ -32,19 +32,27 @@ typedef struct {
 } Cursor;
 
 typedef struct {
-  SerdSource          read_func;   ///< Read function (e.g. fread)
-  SerdStreamErrorFunc error_func;  ///< Error function (e.g. ferror)
-  void*               stream;      ///< Stream (e.g. FILE)
-  size_t              page_size;   ///< Number of bytes to read at a time
-  size_t              buf_size;    ///< Number of bytes in file_buf
-  Cursor              cur;         ///< Cursor for error reporting
-  uint8_t*            file_buf;    ///< Buffer iff reading pages from a file
-  const uint8_t*      read_buf;    ///< Pointer to file_buf or read_byte
-  size_t              read_head;   ///< Offset into read_buf
-  uint8_t             read_byte;   ///< 1-byte 'buffer' used when not paging
-  bool                from_stream; ///< True iff reading from `stream`
-  bool                prepared;    ///< True iff prepared for reading
-  bool                eof;         ///< True iff end of file reached
+  const SerdAllocator* allocator;   ///< Allocator for file_buf, or null
+  SerdSource           read_func;   ///< Read function (e.g. fread)
+  SerdStreamErrorFunc  error_func;  ///< Error function (e.g. ferror)
+  void*                stream;      ///< Stream (e.g. FILE)
+  size_t               page_size;   ///< Number of bytes to read at a time
+  size_t               buf_size;    ///< Number of bytes in file_buf or buffer
+  Cursor               cur;         ///< Cursor for error reporting
+  uint64_t             cur_offset;  ///< Offset of `cur` if lazy
+  uint8_t*             file_buf;    ///< Buffer iff reading pages from a file
+  const uint8_t*       read_buf;    ///< file_buf, read_byte, or buffer
+  const void*          map;         ///< Mapped file iff reading a mapped file
+  size_t               map_size;    ///< Size of map in bytes
+  uint64_t             offset;      ///< Offset of read_buf in the input
+  uint64_t             n_pages;     ///< Number of pages read from stream
+  uint64_t             read_time;   ///< Nanoseconds spent reading pages
+  size_t               read_head;   ///< Offset into read_buf
+  uint8_t              read_byte;   ///< 1-byte 'buffer' used when not paging
+  bool                 from_stream; ///< True iff reading from `stream`
+  bool                 prepared;    ///< True iff prepared for reading
+  bool                 eof;         ///< True iff end of file reached
+  bool                 lazy;        ///< True iff `cur` is updated on demand
 } SerdByteSource;
 
 SerdStatus
@@ -53,13 +61,32 @@ serd_byte_source_open_file(SerdByteSource* source, FILE* file, bool bulk);
 SerdStatus
 serd_byte_source_open_string(SerdByteSource* source, const uint8_t* utf8);
 
+/// Open a source that reads `size` bytes from `buf`, which need not end in null
 SerdStatus
-serd_byte_source_open_source(SerdByteSource*     source,
-                             SerdSource          read_func,
-                             SerdStreamErrorFunc error_func,
-                             void*               stream,
-                             const uint8_t*      name,
-                             size_t              page_size);
+serd_byte_source_open_buffer(SerdByteSource* source,
+                             const uint8_t*  buf,
+                             size_t          size,
+                             const uint8_t*  name);
+
+/**
+   Open a source that reads the rest of `file` from a memory mapping.
+
+   Returns SERD_FAILURE if the file can not be mapped, in which case `source`
+   is left closed and the file must be read some other way.
+*/
+SerdStatus
+serd_byte_source_open_mapped(SerdByteSource* source,
+                             FILE*           file,
+                             const uint8_t*  name);
+
+SerdStatus
+serd_byte_source_open_source(SerdByteSource*      source,
+                             const SerdAllocator* allocator,
+                             SerdSource           read_func,
+                             SerdStreamErrorFunc  error_func,
+                             void*                stream,
+                             const uint8_t*       name,
+                             size_t               page_size);
 
 SerdStatus
 serd_byte_source_close(SerdByteSource* source);
@@ -70,6 +97,30 @@ serd_byte_source_prepare(SerdByteSource* source);
 SerdStatus
 serd_byte_source_page(SerdByteSource* source);
 
+/**
+   Enable or disable lazy line and column tracking.
+
+   When lazy, only the offset is updated while reading, and the cursor is
+   updated by scanning the buffered input when it is requested.  This is only
+   possible if the input is buffered, so is ignored for byte-at-a-time streams.
+*/
+void
+serd_byte_source_set_lazy(SerdByteSource* source, bool lazy);
+
+/// Return the cursor for the current position, updating it if necessary
+Cursor*
+serd_byte_source_cursor(SerdByteSource* source);
+
+/**
+   Reach the end of a buffer source.
+
+   The byte after a buffer may not be readable, so this switches to reading a
+   null byte in place of the buffer, like the null after the input of other
+   sources.
+*/
+void
+serd_byte_source_end_buffer(SerdByteSource* source);
+
 static inline SERD_PURE_FUNC uint8_t
 serd_byte_source_peek(SerdByteSource* source)
 {
@@ -82,13 +133,15 @@ serd_byte_source_advance(SerdByteSource* source)
 {
   SerdStatus st = SERD_SUCCESS;
 
-  switch (serd_byte_source_peek(source)) {
-  case '\n':
-    ++source->cur.line;
-    source->cur.col = 0;
-    break;
-  default:
-    ++source->cur.col;
+  if (!source->lazy) {
+    switch (serd_byte_source_peek(source)) {
+    case '\n':
+      ++source->cur.line;
+      source->cur.col = 0;
+      break;
+    default:
+      ++source->cur.col;
+    }
   }
 
   const bool was_eof = source->eof;
@@ -101,20 +154,62 @@ serd_byte_source_advance(SerdByteSource* source)
         source->eof = true;
       }
     } else {
+      source->offset += !was_eof; // The end is one past the last byte
       if (!source->read_func(&source->read_byte, 1, 1, source->stream)) {
-        source->eof = true;
+        source->read_byte = 0u;
+        source->eof       = true;
         st =
           source->error_func(source->stream) ? SERD_ERR_UNKNOWN : SERD_FAILURE;
       }
     }
   } else if (!source->eof) {
-    ++source->read_head; // Move to next character in string
-    if (source->read_buf[source->read_head] == '\0') {
-      source->eof = true;
+    ++source->read_head; // Move to next character in string or buffer
+    if (!source->buf_size) {
+      source->eof = source->read_buf[source->read_head] == '\0';
+    } else if (source->read_head == source->buf_size) {
+      serd_byte_source_end_buffer(source);
     }
   }
 
   return (was_eof && source->eof) ? SERD_FAILURE : st;
 }
 
+/// Return the offset of the current byte from the start of the input
+static inline uint64_t
+serd_byte_source_offset(const SerdByteSource* source)
+{
+  return source->offset + source->read_head;
+}
+
+/**
+   Return the number of bytes from the current position that are in memory.
+
+   This is the number of bytes that can be looked at directly in `read_buf`
+   without paging.  It is zero at the end of the input, and for sources that do
+   not know where their buffer ends (strings and byte-at-a-time streams).
+*/
+static inline size_t
+serd_byte_source_n_buffered(const SerdByteSource* source)
+{
+  if (source->eof || (source->from_stream && source->page_size <= 1)) {
+    return 0u;
+  }
+
+  return source->buf_size ? source->buf_size - source->read_head : 0u;
+}
+
+/// Advance past `n` buffered bytes which are known not to contain newlines
+static inline SerdStatus
+serd_byte_source_skip(SerdByteSource* source, const size_t n)
+{
+  assert(n > 0u && n <= serd_byte_source_n_buffered(source));
+
+  source->read_head += n - 1u;
+  if (!source->lazy) {
+    source->cur.col += (unsigned)(n - 1u);
+  }
+
+  return serd_byte_source_advance(source);
+}
+
 #endif // SERD_BYTE_SOURCE_H
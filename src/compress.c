@@ -0,0 +1,511 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "compress.h"
+
+#include "memory.h"
+#include "serd_config.h"
+#include "serd_internal.h"
+
+#include "serd/serd.h"
+
+#if USE_ZLIB
+#  include <zlib.h>
+#endif
+
+#if USE_ZSTD
+#  include <zstd.h>
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/// Size of the buffer for compressed data
+#define COMPRESSED_BUF_SIZE SERD_COMPRESSED_PAGE_SIZE
+
+struct SerdDecoderImpl {
+  const SerdAllocator* allocator;   ///< Allocator for this and in_buf
+  SerdSource           read_func;   ///< Underlying read function
+  SerdStreamErrorFunc  error_func;  ///< Underlying error function
+  void*                stream;      ///< Underlying stream
+  SerdCompression      compression; ///< Detected compression
+  uint8_t              head[SERD_COMPRESSION_MAGIC_LEN]; ///< First bytes
+  size_t               n_head;      ///< Number of bytes in head
+  size_t               head_offset; ///< Number of head bytes passed through
+  uint8_t*             in_buf;      ///< Compressed input
+  size_t               in_size;     ///< Number of bytes in in_buf
+  size_t               in_head;     ///< Offset into in_buf
+  bool                 in_eof;      ///< True iff all input has been read
+  bool                 done;        ///< True iff at the end of a frame
+  bool                 error;       ///< True iff the input is corrupt
+#if USE_ZLIB
+  z_stream zstream; ///< Gzip decompression state
+#endif
+#if USE_ZSTD
+  ZSTD_DCtx* dctx; ///< Zstd decompression state
+#endif
+};
+
+struct SerdEncoderImpl {
+  const SerdAllocator* allocator;   ///< Allocator for this and out_buf
+  SerdCompression      compression; ///< Output compression
+  SerdSink             sink;        ///< Underlying sink
+  void*                stream;      ///< Underlying stream
+  uint8_t*             out_buf;     ///< Compressed output
+  size_t               out_size;    ///< Number of bytes in out_buf
+  bool                 dirty;       ///< True iff written since finishing
+  bool                 finished;    ///< True iff finished at least once
+  bool                 error;       ///< True iff compression failed
+#if USE_ZLIB
+  z_stream zstream; ///< Gzip compression state
+#endif
+#if USE_ZSTD
+  ZSTD_CCtx* cctx; ///< Zstd compression state
+#endif
+};
+
+SerdCompression
+serd_compression_detect(const void* const buf, const size_t size)
+{
+  const uint8_t* const b = (const uint8_t*)buf;
+
+  if (size >= 2u && b[0] == 0x1Fu && b[1] == 0x8Bu) {
+    return SERD_COMPRESSION_GZIP;
+  }
+
+  if (size >= 4u && b[0] == 0x28u && b[1] == 0xB5u && b[2] == 0x2Fu &&
+      b[3] == 0xFDu) {
+    return SERD_COMPRESSION_ZSTD;
+  }
+
+  return SERD_COMPRESSION_NONE;
+}
+
+bool
+serd_compression_supported(const SerdCompression compression)
+{
+  switch (compression) {
+  case SERD_COMPRESSION_NONE:
+    return true;
+  case SERD_COMPRESSION_GZIP:
+    return USE_ZLIB;
+  case SERD_COMPRESSION_ZSTD:
+    return USE_ZSTD;
+  }
+
+  return false;
+}
+
+const char*
+serd_compression_name(const SerdCompression compression)
+{
+  switch (compression) {
+  case SERD_COMPRESSION_NONE:
+    break;
+  case SERD_COMPRESSION_GZIP:
+    return "gzip";
+  case SERD_COMPRESSION_ZSTD:
+    return "zstd";
+  }
+
+  return "uncompressed";
+}
+
+/*
+  Decoder
+*/
+
+/// Read more compressed input if the input buffer is empty
+static void
+refill(SerdDecoder* const decoder)
+{
+  if (decoder->in_head < decoder->in_size || decoder->in_eof) {
+    return;
+  }
+
+  decoder->in_head = 0u;
+  decoder->in_size = decoder->read_func(
+    decoder->in_buf, 1, COMPRESSED_BUF_SIZE, decoder->stream);
+
+  if (decoder->in_size < COMPRESSED_BUF_SIZE) {
+    decoder->in_eof = true;
+    if (decoder->error_func(decoder->stream)) {
+      decoder->error = true;
+    }
+  }
+}
+
+/// Decompress into `buf`, return the number of bytes written
+static size_t
+decode(SerdDecoder* const decoder, uint8_t* const buf, const size_t len)
+{
+#if USE_ZLIB
+  z_stream* const zs = &decoder->zstream;
+#elif !USE_ZSTD
+  (void)buf;
+#endif
+
+  size_t n_read = 0u;
+  while (n_read < len && !decoder->error) {
+    refill(decoder);
+
+    const size_t n_in   = decoder->in_size - decoder->in_head;
+    const bool   at_end = decoder->in_eof && !n_in;
+    if (at_end && decoder->done) {
+      break; // End of input after a complete frame
+    }
+
+    size_t n_out = 0u;
+    if (decoder->compression == SERD_COMPRESSION_GZIP) {
+#if USE_ZLIB
+      const uInt space = (uInt)MIN(len - n_read, (size_t)UINT32_MAX);
+
+      zs->next_in   = decoder->in_buf + decoder->in_head;
+      zs->avail_in  = (uInt)n_in;
+      zs->next_out  = buf + n_read;
+      zs->avail_out = space;
+
+      const int r = inflate(zs, Z_NO_FLUSH);
+
+      decoder->in_head = decoder->in_size - zs->avail_in;
+      n_out            = space - zs->avail_out;
+      if (r == Z_STREAM_END) {
+        decoder->done = true;
+        inflateReset(zs); // Another member may follow
+      } else if (r == Z_OK) {
+        decoder->done = false;
+      } else if (r != Z_BUF_ERROR) {
+        decoder->error = true;
+      }
+#endif
+    } else if (decoder->compression == SERD_COMPRESSION_ZSTD) {
+#if USE_ZSTD
+      ZSTD_inBuffer in = {decoder->in_buf, decoder->in_size, decoder->in_head};
+      ZSTD_outBuffer out = {buf + n_read, len - n_read, 0u};
+
+      const size_t r = ZSTD_decompressStream(decoder->dctx, &out, &in);
+
+      decoder->in_head = in.pos;
+      n_out            = out.pos;
+      if (ZSTD_isError(r)) {
+        decoder->error = true;
+      } else {
+        decoder->done = !r;
+      }
+#endif
+    }
+
+    n_read += n_out;
+    if (at_end && !n_out && !decoder->done) {
+      decoder->error = true; // Truncated
+    }
+  }
+
+  return n_read;
+}
+
+SerdDecoder*
+serd_decoder_new(const SerdAllocator* const allocator,
+                 const SerdSource           read_func,
+                 const SerdStreamErrorFunc  error_func,
+                 void* const                stream)
+{
+  SerdDecoder* const decoder =
+    (SerdDecoder*)serd_acalloc(allocator, 1, sizeof(SerdDecoder));
+
+  decoder->allocator  = allocator;
+  decoder->read_func  = read_func;
+  decoder->error_func = error_func;
+  decoder->stream     = stream;
+  decoder->n_head =
+    read_func(decoder->head, 1, SERD_COMPRESSION_MAGIC_LEN, stream);
+
+  decoder->compression =
+    serd_compression_detect(decoder->head, decoder->n_head);
+  if (decoder->compression == SERD_COMPRESSION_NONE) {
+    return decoder;
+  }
+
+  // Start decompressing from a buffer that begins with the magic bytes
+  decoder->in_buf =
+    (uint8_t*)serd_aallocate_buffer(allocator, COMPRESSED_BUF_SIZE);
+  memcpy(decoder->in_buf, decoder->head, decoder->n_head);
+  decoder->in_size = decoder->n_head;
+  decoder->in_eof  = decoder->n_head < SERD_COMPRESSION_MAGIC_LEN;
+
+  if (decoder->compression == SERD_COMPRESSION_GZIP) {
+#if USE_ZLIB
+    decoder->error = inflateInit2(&decoder->zstream, 15 + 16) != Z_OK;
+#else
+    decoder->error = true;
+#endif
+  } else if (decoder->compression == SERD_COMPRESSION_ZSTD) {
+#if USE_ZSTD
+    decoder->error = !(decoder->dctx = ZSTD_createDCtx());
+#else
+    decoder->error = true;
+#endif
+  }
+
+  return decoder;
+}
+
+SerdCompression
+serd_decoder_compression(const SerdDecoder* const decoder)
+{
+  return decoder->compression;
+}
+
+size_t
+serd_decoder_read(void* const  buf,
+                  const size_t size,
+                  const size_t nmemb,
+                  void* const  stream)
+{
+  SerdDecoder* const decoder = (SerdDecoder*)stream;
+  uint8_t* const     out     = (uint8_t*)buf;
+  const size_t       len     = size * nmemb;
+
+  if (decoder->compression != SERD_COMPRESSION_NONE) {
+    return decode(decoder, out, len) / size;
+  }
+
+  // Pass through the bytes read for detection, then read directly
+  const size_t n_head = MIN(len, decoder->n_head - decoder->head_offset);
+  memcpy(out, decoder->head + decoder->head_offset, n_head);
+  decoder->head_offset += n_head;
+
+  const size_t n_rest =
+    n_head < len
+      ? decoder->read_func(out + n_head, 1, len - n_head, decoder->stream)
+      : 0u;
+
+  return (n_head + n_rest) / size;
+}
+
+int
+serd_decoder_error(void* const stream)
+{
+  SerdDecoder* const decoder = (SerdDecoder*)stream;
+
+  return decoder->error || decoder->error_func(decoder->stream);
+}
+
+void
+serd_decoder_free(SerdDecoder* const decoder)
+{
+  if (!decoder) {
+    return;
+  }
+
+#if USE_ZLIB
+  if (decoder->compression == SERD_COMPRESSION_GZIP) {
+    inflateEnd(&decoder->zstream);
+  }
+#endif
+
+#if USE_ZSTD
+  ZSTD_freeDCtx(decoder->dctx);
+#endif
+
+  serd_afree_buffer(decoder->allocator, decoder->in_buf);
+  serd_afree(decoder->allocator, decoder);
+}
+
+/*
+  Encoder
+*/
+
+/// Write the compressed output buffer to the sink if it is full or `force`
+static void
+drain(SerdEncoder* const encoder, const bool force)
+{
+  if (encoder->out_size == COMPRESSED_BUF_SIZE ||
+      (force && encoder->out_size)) {
+    if (encoder->sink(encoder->out_buf, encoder->out_size, encoder->stream) !=
+        encoder->out_size) {
+      encoder->error = true;
+    }
+
+    encoder->out_size = 0u;
+  }
+}
+
+/**
+   Compress `len` bytes from `buf` into the output buffer.
+
+   If `end` is true, this also ends the current frame, and `buf` may be null.
+*/
+static void
+encode(SerdEncoder* const encoder,
+       const uint8_t*     buf,
+       const size_t       len,
+       const bool         end)
+{
+#if !USE_ZLIB && !USE_ZSTD
+  (void)buf;
+  (void)len;
+  (void)end;
+#endif
+
+  if (encoder->compression == SERD_COMPRESSION_GZIP) {
+#if USE_ZLIB
+    z_stream* const zs = &encoder->zstream;
+
+    zs->next_in  = (Bytef*)buf;
+    zs->avail_in = (uInt)len;
+    for (int r = Z_OK; r == Z_OK && !encoder->error;) {
+      zs->next_out  = encoder->out_buf + encoder->out_size;
+      zs->avail_out = (uInt)(COMPRESSED_BUF_SIZE - encoder->out_size);
+
+      r = deflate(zs, end ? Z_FINISH : Z_NO_FLUSH);
+
+      encoder->out_size = COMPRESSED_BUF_SIZE - zs->avail_out;
+      if (r == Z_STREAM_ERROR) {
+        encoder->error = true;
+      } else if (!end && !zs->avail_in) {
+        r = Z_STREAM_END; // Consumed all input
+      }
+
+      drain(encoder, false);
+    }
+
+    if (end) {
+      deflateReset(zs);
+    }
+#endif
+  } else if (encoder->compression == SERD_COMPRESSION_ZSTD) {
+#if USE_ZSTD
+    ZSTD_inBuffer in = {buf, len, 0u};
+    for (size_t r = 1u; r && !encoder->error;) {
+      ZSTD_outBuffer out = {
+        encoder->out_buf, COMPRESSED_BUF_SIZE, encoder->out_size};
+
+      r = ZSTD_compressStream2(
+        encoder->cctx, &out, &in, end ? ZSTD_e_end : ZSTD_e_continue);
+
+      encoder->out_size = out.pos;
+      if (ZSTD_isError(r)) {
+        encoder->error = true;
+      } else if (!end && in.pos == in.size) {
+        r = 0u; // Consumed all input
+      }
+
+      drain(encoder, false);
+    }
+#endif
+  }
+}
+
+SerdEncoder*
+serd_encoder_new(const SerdAllocator* const allocator,
+                 const SerdCompression      compression,
+                 const SerdSink             sink,
+                 void* const                stream)
+{
+  if (compression == SERD_COMPRESSION_NONE ||
+      !serd_compression_supported(compression)) {
+    return NULL;
+  }
+
+  SerdEncoder* const encoder =
+    (SerdEncoder*)serd_acalloc(allocator, 1, sizeof(SerdEncoder));
+
+  encoder->allocator   = allocator;
+  encoder->compression = compression;
+  encoder->sink        = sink;
+  encoder->stream      = stream;
+  encoder->out_buf =
+    (uint8_t*)serd_aallocate_buffer(allocator, COMPRESSED_BUF_SIZE);
+
+#if USE_ZLIB
+  if (compression == SERD_COMPRESSION_GZIP) {
+    encoder->error = deflateInit2(&encoder->zstream,
+                                  Z_DEFAULT_COMPRESSION,
+                                  Z_DEFLATED,
+                                  15 + 16,
+                                  8,
+                                  Z_DEFAULT_STRATEGY) != Z_OK;
+  }
+#endif
+
+#if USE_ZSTD
+  if (compression == SERD_COMPRESSION_ZSTD) {
+    encoder->error = !(encoder->cctx = ZSTD_createCCtx());
+  }
+#endif
+
+  return encoder;
+}
+
+size_t
+serd_encoder_write(const void* const buf, const size_t len, void* const stream)
+{
+  SerdEncoder* const encoder = (SerdEncoder*)stream;
+  if (encoder->error) {
+    return 0u;
+  }
+
+  // Compress in pieces that fit in a zlib length
+  const uint8_t* in        = (const uint8_t*)buf;
+  size_t         remaining = len;
+  while (remaining && !encoder->error) {
+    const size_t n = MIN(remaining, (size_t)UINT32_MAX);
+
+    encode(encoder, in, n, false);
+    in += n;
+    remaining -= n;
+  }
+
+  encoder->dirty = true;
+  return encoder->error ? 0u : len;
+}
+
+SerdStatus
+serd_encoder_finish(SerdEncoder* const encoder)
+{
+  if (!encoder->error && (encoder->dirty || !encoder->finished)) {
+    encode(encoder, NULL, 0u, true);
+    drain(encoder, true);
+    encoder->dirty    = false;
+    encoder->finished = true;
+  }
+
+  return encoder->error ? SERD_ERR_UNKNOWN : SERD_SUCCESS;
+}
+
+void
+serd_encoder_free(SerdEncoder* const encoder)
+{
+  if (!encoder) {
+    return;
+  }
+
+#if USE_ZLIB
+  if (encoder->compression == SERD_COMPRESSION_GZIP) {
+    deflateEnd(&encoder->zstream);
+  }
+#endif
+
+#if USE_ZSTD
+  ZSTD_freeCCtx(encoder->cctx);
+#endif
+
+  serd_afree_buffer(encoder->allocator, encoder->out_buf);
+  serd_afree(encoder->allocator, encoder);
+}
@@ -0,0 +1,119 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef SERD_COMPRESS_H
+#define SERD_COMPRESS_H
+
+#include "serd/serd.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+  Compressed streams.
+
+  A decoder is a SerdSource that reads from another source, and decompresses
+  the input if it starts with gzip or zstd magic bytes, or passes it through
+  unchanged otherwise.  An encoder is a SerdSink that compresses output and
+  writes it to another sink.  Support for each format depends on the libraries
+  available at compile time.
+*/
+
+/// Size of pages to read from a compressed file
+#define SERD_COMPRESSED_PAGE_SIZE (16u * SERD_PAGE_SIZE)
+
+/// Number of bytes needed to detect the compression of a stream
+#define SERD_COMPRESSION_MAGIC_LEN 4u
+
+typedef enum {
+  SERD_COMPRESSION_NONE, ///< Uncompressed
+  SERD_COMPRESSION_GZIP, ///< Gzip (RFC 1952) (requires zlib)
+  SERD_COMPRESSION_ZSTD, ///< Zstandard (RFC 8878) (requires libzstd)
+} SerdCompression;
+
+typedef struct SerdDecoderImpl SerdDecoder;
+
+typedef struct SerdEncoderImpl SerdEncoder;
+
+/// Return the compression of data that starts with the `size` bytes in `buf`
+SerdCompression
+serd_compression_detect(const void* buf, size_t size);
+
+/// Return true iff `compression` can be read and written
+bool
+serd_compression_supported(SerdCompression compression);
+
+/// Return a human-readable name for `compression`
+const char*
+serd_compression_name(SerdCompression compression);
+
+/**
+   Create a new decoder that reads from `stream`.
+
+   This reads the first few bytes of the stream to detect the compression.
+   The returned decoder may be for an unsupported compression, which can be
+   checked with serd_decoder_compression(), in which case reading fails.
+*/
+SerdDecoder*
+serd_decoder_new(const SerdAllocator* allocator,
+                 SerdSource           read_func,
+                 SerdStreamErrorFunc  error_func,
+                 void*                stream);
+
+/// Return the compression of the input detected by `decoder`
+SerdCompression
+serd_decoder_compression(const SerdDecoder* decoder);
+
+/// Read decompressed data, a SerdSource for use with a SerdDecoder stream
+size_t
+serd_decoder_read(void* buf, size_t size, size_t nmemb, void* stream);
+
+/// Return non-zero if the input is corrupt or could not be read
+int
+serd_decoder_error(void* stream);
+
+void
+serd_decoder_free(SerdDecoder* decoder);
+
+/**
+   Create a new encoder that writes to `sink`.
+
+   Returns null if `compression` is not supported.
+*/
+SerdEncoder*
+serd_encoder_new(const SerdAllocator* allocator,
+                 SerdCompression      compression,
+                 SerdSink             sink,
+                 void*                stream);
+
+/// Compress and write data, a SerdSink for use with a SerdEncoder stream
+size_t
+serd_encoder_write(const void* buf, size_t len, void* stream);
+
+/**
+   Finish the compressed output written so far.
+
+   This ends the current gzip member or zstd frame, so that everything written
+   so far can be decompressed.  Writing more afterwards starts a new one, which
+   decompressors read as a continuation of the same data.
+*/
+SerdStatus
+serd_encoder_finish(SerdEncoder* encoder);
+
+void
+serd_encoder_free(SerdEncoder* encoder);
+
+#endif // SERD_COMPRESS_H
@@ -0,0 +1,229 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "string_utils.h"
+
+#include "serd/serd.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Size of a block of node strings, larger strings get their own block
+#define BLOCK_SIZE 65536u
+
+/**
+   A table of interned nodes.
+
+   Nodes are stored in an array indexed by ID - 1, with their strings in
+   blocks that are never moved, so the strings stay put as the table grows.
+   Nodes are found with an open addressing hash table of IDs.
+*/
+struct SerdDictionaryImpl {
+  SerdNode*   nodes;      ///< Nodes in the order they were added
+  uint32_t*   hashes;     ///< Hash of each node
+  size_t      n_nodes;    ///< Number of nodes
+  size_t      nodes_size; ///< Number of allocated nodes and hashes
+  SerdNodeID* buckets;    ///< Hash table of IDs
+  size_t      n_buckets;  ///< Number of buckets, a power of two or zero
+  uint8_t**   blocks;     ///< Blocks of node strings
+  size_t      n_blocks;   ///< Number of blocks
+  size_t      block_head; ///< Number of bytes used in the last block
+};
+
+static inline uint32_t
+serd_dictionary_hash(const SerdNode* node)
+{
+  return (serd_string_hash(node->buf, node->n_bytes) ^ (uint32_t)node->type) *
+         16777619u;
+}
+
+SerdDictionary*
+serd_dictionary_new(void)
+{
+  return (SerdDictionary*)calloc(1, sizeof(SerdDictionary));
+}
+
+void
+serd_dictionary_free(SerdDictionary* dictionary)
+{
+  if (!dictionary) {
+    return;
+  }
+
+  for (size_t i = 0u; i < dictionary->n_blocks; ++i) {
+    free(dictionary->blocks[i]);
+  }
+
+  free(dictionary->blocks);
+  free(dictionary->buckets);
+  free(dictionary->hashes);
+  free(dictionary->nodes);
+  free(dictionary);
+}
+
+size_t
+serd_dictionary_size(const SerdDictionary* dictionary)
+{
+  return dictionary->n_nodes;
+}
+
+/// Return the bucket for `node` with `hash`, which is empty if it is not found
+static size_t
+serd_dictionary_bucket(const SerdDictionary* dictionary,
+                       const SerdNode*       node,
+                       const uint32_t        hash)
+{
+  const size_t mask = dictionary->n_buckets - 1u;
+  size_t       b    = hash & mask;
+
+  while (dictionary->buckets[b]) {
+    const size_t          index = dictionary->buckets[b] - 1u;
+    const SerdNode* const entry = &dictionary->nodes[index];
+    if (dictionary->hashes[index] == hash && entry->type == node->type &&
+        entry->n_bytes == node->n_bytes &&
+        !memcmp(entry->buf, node->buf, node->n_bytes)) {
+      break;
+    }
+
+    b = (b + 1u) & mask;
+  }
+
+  return b;
+}
+
+SerdNodeID
+serd_dictionary_find(const SerdDictionary* dictionary, const SerdNode* node)
+{
+  if (!node || !node->type || !node->buf || !dictionary->n_buckets) {
+    return 0u;
+  }
+
+  const uint32_t hash = serd_dictionary_hash(node);
+
+  return dictionary->buckets[serd_dictionary_bucket(dictionary, node, hash)];
+}
+
+/// Grow the hash table if necessary to keep it at most half full
+static void
+serd_dictionary_reserve_buckets(SerdDictionary* dictionary, size_t n_nodes)
+{
+  if (n_nodes * 2u <= dictionary->n_buckets) {
+    return;
+  }
+
+  free(dictionary->buckets);
+  dictionary->n_buckets = dictionary->n_buckets ? dictionary->n_buckets * 2u
+                                                : 256u;
+  dictionary->buckets =
+    (SerdNodeID*)calloc(dictionary->n_buckets, sizeof(SerdNodeID));
+
+  const size_t mask = dictionary->n_buckets - 1u;
+  for (size_t i = 0u; i < dictionary->n_nodes; ++i) {
+    size_t b = dictionary->hashes[i] & mask;
+    while (dictionary->buckets[b]) {
+      b = (b + 1u) & mask;
+    }
+
+    dictionary->buckets[b] = i + 1u;
+  }
+}
+
+/// Copy `n_bytes` of `str` into stable storage and null-terminate it
+static uint8_t*
+serd_dictionary_store(SerdDictionary* dictionary,
+                      const uint8_t*  str,
+                      const size_t    n_bytes)
+{
+  const size_t size = n_bytes + 1u;
+  uint8_t*     dst  = NULL;
+
+  if (size > BLOCK_SIZE / 4u) {
+    // Large string, store in its own block before the current one
+    dst = (uint8_t*)malloc(size);
+    dictionary->blocks = (uint8_t**)realloc(
+      dictionary->blocks, (dictionary->n_blocks + 1u) * sizeof(uint8_t*));
+    if (dictionary->n_blocks) {
+      dictionary->blocks[dictionary->n_blocks] =
+        dictionary->blocks[dictionary->n_blocks - 1u];
+      dictionary->blocks[dictionary->n_blocks - 1u] = dst;
+    } else {
+      dictionary->blocks[0]  = dst;
+      dictionary->block_head = BLOCK_SIZE; // No room for small strings
+    }
+
+    ++dictionary->n_blocks;
+  } else {
+    if (!dictionary->n_blocks || dictionary->block_head + size > BLOCK_SIZE) {
+      dictionary->blocks = (uint8_t**)realloc(
+        dictionary->blocks, (dictionary->n_blocks + 1u) * sizeof(uint8_t*));
+      dictionary->blocks[dictionary->n_blocks] = (uint8_t*)malloc(BLOCK_SIZE);
+      dictionary->block_head                   = 0u;
+      ++dictionary->n_blocks;
+    }
+
+    uint8_t* const block = dictionary->blocks[dictionary->n_blocks - 1u];
+
+    dst = block + dictionary->block_head;
+    dictionary->block_head += size;
+  }
+
+  memcpy(dst, str, n_bytes);
+  dst[n_bytes] = '\0';
+  return dst;
+}
+
+SerdNodeID
+serd_dictionary_intern(SerdDictionary* dictionary, const SerdNode* node)
+{
+  if (!node || !node->type || !node->buf) {
+    return 0u;
+  }
+
+  serd_dictionary_reserve_buckets(dictionary, dictionary->n_nodes + 1u);
+
+  const uint32_t hash = serd_dictionary_hash(node);
+  const size_t   b    = serd_dictionary_bucket(dictionary, node, hash);
+  if (dictionary->buckets[b]) {
+    return dictionary->buckets[b];
+  }
+
+  if (dictionary->n_nodes == dictionary->nodes_size) {
+    dictionary->nodes_size =
+      dictionary->nodes_size ? dictionary->nodes_size * 2u : 256u;
+
+    dictionary->nodes = (SerdNode*)realloc(
+      dictionary->nodes, dictionary->nodes_size * sizeof(SerdNode));
+    dictionary->hashes = (uint32_t*)realloc(
+      dictionary->hashes, dictionary->nodes_size * sizeof(uint32_t));
+  }
+
+  SerdNode* const entry = &dictionary->nodes[dictionary->n_nodes];
+  *entry                = *node;
+  entry->buf = serd_dictionary_store(dictionary, node->buf, node->n_bytes);
+
+  dictionary->hashes[dictionary->n_nodes] = hash;
+  dictionary->buckets[b]                  = ++dictionary->n_nodes;
+  return dictionary->n_nodes;
+}
+
+const SerdNode*
+serd_dictionary_get(const SerdDictionary* dictionary, const SerdNodeID id)
+{
+  return (id && id <= dictionary->n_nodes) ? &dictionary->nodes[id - 1u]
+                                           : NULL;
+}
@@ -14,6 +14,9 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include "memory.h"
+#include "string_utils.h"
+
 #include "serd/serd.h"
 
 #include <stdbool.h>
@@ -28,16 +31,31 @@ typedef struct {
 } SerdPrefix;
 
 struct SerdEnvImpl {
-  SerdPrefix* prefixes;
-  size_t      n_prefixes;
-  SerdNode    base_uri_node;
-  SerdURI     base_uri;
+  SerdAllocator allocator;     ///< Allocator for everything the env owns
+  SerdPrefix*   prefixes;      ///< Prefixes in the order they were declared
+  size_t        n_prefixes;    ///< Number of prefixes
+  size_t*       buckets;       ///< Hash table of prefix index + 1 by name
+  size_t        n_buckets;     ///< Number of buckets, a power of two or zero
+  size_t*       by_uri;        ///< Prefix indices sorted by URI
+  SerdNode      base_uri_node; ///< Base URI node
+  SerdURI       base_uri;      ///< Parsed base URI
 };
 
 SerdEnv*
 serd_env_new(const SerdNode* base_uri)
 {
-  SerdEnv* env = (SerdEnv*)calloc(1, sizeof(struct SerdEnvImpl));
+  return serd_env_new_with_allocator(NULL, base_uri);
+}
+
+SerdEnv*
+serd_env_new_with_allocator(const SerdAllocator* allocator,
+                            const SerdNode*      base_uri)
+{
+  SerdEnv* env = (SerdEnv*)serd_acalloc(allocator, 1, sizeof(SerdEnv));
+  if (env && allocator) {
+    env->allocator = *allocator;
+  }
+
   if (env && base_uri) {
     serd_env_set_base_uri(env, base_uri);
   }
@@ -45,6 +63,46 @@ serd_env_new(const SerdNode* base_uri)
   return env;
 }
 
+SerdEnv*
+serd_env_copy(const SerdEnv* env)
+{
+  if (!env) {
+    return NULL;
+  }
+
+  const SerdAllocator* const allocator = &env->allocator;
+  SerdEnv* const copy = (SerdEnv*)serd_acalloc(allocator, 1, sizeof(SerdEnv));
+
+  copy->allocator     = env->allocator;
+  copy->base_uri_node = serd_node_acopy(allocator, &env->base_uri_node);
+  copy->base_uri      = SERD_URI_NULL;
+  if (copy->base_uri_node.buf) {
+    serd_uri_parse(copy->base_uri_node.buf, &copy->base_uri);
+  }
+
+  if (env->n_prefixes) {
+    // Copy the tables directly, since the indices of prefixes are the same
+    copy->n_prefixes = env->n_prefixes;
+    copy->n_buckets  = env->n_buckets;
+    copy->prefixes   = (SerdPrefix*)serd_acalloc(
+      allocator, env->n_prefixes, sizeof(SerdPrefix));
+    copy->buckets =
+      (size_t*)serd_acalloc(allocator, env->n_buckets, sizeof(size_t));
+    copy->by_uri =
+      (size_t*)serd_acalloc(allocator, env->n_prefixes, sizeof(size_t));
+
+    memcpy(copy->buckets, env->buckets, env->n_buckets * sizeof(size_t));
+    memcpy(copy->by_uri, env->by_uri, env->n_prefixes * sizeof(size_t));
+    for (size_t i = 0u; i < env->n_prefixes; ++i) {
+      copy->prefixes[i].name =
+        serd_node_acopy(allocator, &env->prefixes[i].name);
+      copy->prefixes[i].uri = serd_node_acopy(allocator, &env->prefixes[i].uri);
+    }
+  }
+
+  return copy;
+}
+
 void
 serd_env_free(SerdEnv* env)
 {
@@ -52,14 +110,17 @@ serd_env_free(SerdEnv* env)
     return;
   }
 
+  const SerdAllocator allocator = env->allocator;
   for (size_t i = 0; i < env->n_prefixes; ++i) {
-    serd_node_free(&env->prefixes[i].name);
-    serd_node_free(&env->prefixes[i].uri);
+    serd_node_afree(&allocator, &env->prefixes[i].name);
+    serd_node_afree(&allocator, &env->prefixes[i].uri);
   }
 
-  free(env->prefixes);
-  serd_node_free(&env->base_uri_node);
-  free(env);
+  serd_afree(&allocator, env->by_uri);
+  serd_afree(&allocator, env->buckets);
+  serd_afree(&allocator, env->prefixes);
+  serd_node_afree(&allocator, &env->base_uri_node);
+  serd_afree(&allocator, env);
 }
 
 const SerdNode*
@@ -80,19 +141,21 @@ serd_env_set_base_uri(SerdEnv* env, const SerdNode* uri)
   }
 
   if (!uri || !uri->buf) {
-    serd_node_free(&env->base_uri_node);
+    serd_node_afree(&env->allocator, &env->base_uri_node);
     env->base_uri_node = SERD_NODE_NULL;
     env->base_uri      = SERD_URI_NULL;
     return SERD_SUCCESS;
   }
 
   // Resolve base URI and create a new node and URI for it
+  SerdNode resolved = serd_node_new_uri_from_node(uri, &env->base_uri, NULL);
+  SerdNode base_uri_node = serd_node_acopy(&env->allocator, &resolved);
   SerdURI  base_uri;
-  SerdNode base_uri_node =
-    serd_node_new_uri_from_node(uri, &env->base_uri, &base_uri);
+  serd_node_free(&resolved);
+  serd_uri_parse(base_uri_node.buf, &base_uri);
 
   // Replace the current base URI
-  serd_node_free(&env->base_uri_node);
+  serd_node_afree(&env->allocator, &env->base_uri_node);
   env->base_uri_node = base_uri_node;
   env->base_uri      = base_uri;
 
@@ -102,33 +165,194 @@ serd_env_set_base_uri(SerdEnv* env, const SerdNode* uri)
 static inline SERD_PURE_FUNC SerdPrefix*
 serd_env_find(const SerdEnv* env, const uint8_t* name, size_t name_len)
 {
-  for (size_t i = 0; i < env->n_prefixes; ++i) {
-    const SerdNode* const prefix_name = &env->prefixes[i].name;
-    if (prefix_name->n_bytes == name_len) {
-      if (!memcmp(prefix_name->buf, name, name_len)) {
-        return &env->prefixes[i];
-      }
+  if (!env->n_buckets) {
+    return NULL;
+  }
+
+  const size_t mask = env->n_buckets - 1u;
+  for (size_t b = serd_string_hash(name, name_len) & mask; env->buckets[b];
+       b = (b + 1u) & mask) {
+    SerdPrefix* const     prefix      = &env->prefixes[env->buckets[b] - 1u];
+    const SerdNode* const prefix_name = &prefix->name;
+    if (prefix_name->n_bytes == name_len &&
+        !memcmp(prefix_name->buf, name, name_len)) {
+      return prefix;
     }
   }
 
   return NULL;
 }
 
+/// Insert the prefix at `index` into the hash table, which has a free bucket
+static void
+serd_env_insert_bucket(SerdEnv* env, size_t index)
+{
+  const SerdNode* const name = &env->prefixes[index].name;
+  const size_t          mask = env->n_buckets - 1u;
+
+  size_t b = serd_string_hash(name->buf, name->n_bytes) & mask;
+  while (env->buckets[b]) {
+    b = (b + 1u) & mask;
+  }
+
+  env->buckets[b] = index + 1u;
+}
+
+/// Grow the hash table if necessary to keep it at most half full
+static void
+serd_env_reserve_buckets(SerdEnv* env, size_t n_prefixes)
+{
+  if (n_prefixes * 2u <= env->n_buckets) {
+    return;
+  }
+
+  serd_afree(&env->allocator, env->buckets);
+  env->n_buckets = env->n_buckets ? env->n_buckets * 2u : 16u;
+  env->buckets =
+    (size_t*)serd_acalloc(&env->allocator, env->n_buckets, sizeof(size_t));
+  for (size_t i = 0; i < env->n_prefixes; ++i) {
+    serd_env_insert_bucket(env, i);
+  }
+}
+
+/// Compare `buf` to a prefix URI like strcmp, where shorter strings sort first
+static inline int
+serd_env_compare_uri(const SerdNode* prefix_uri, const uint8_t* buf, size_t len)
+{
+  const size_t n   = prefix_uri->n_bytes < len ? prefix_uri->n_bytes : len;
+  const int    cmp = memcmp(prefix_uri->buf, buf, n);
+
+  return cmp ? cmp
+             : (prefix_uri->n_bytes < len ? -1 : prefix_uri->n_bytes > len);
+}
+
+/// Return the index of the first of `n` entries in by_uri greater than `buf`
+static size_t
+serd_env_upper_bound(const SerdEnv* env,
+                     size_t         n,
+                     const uint8_t* buf,
+                     size_t         len)
+{
+  size_t lo = 0u;
+  size_t hi = n;
+  while (lo < hi) {
+    const size_t    mid = lo + (hi - lo) / 2u;
+    const SerdNode* uri = &env->prefixes[env->by_uri[mid]].uri;
+    if (serd_env_compare_uri(uri, buf, len) <= 0) {
+      lo = mid + 1u;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+/// Insert the prefix at `index` into the first `n_indexed` entries of by_uri
+static void
+serd_env_insert_uri(SerdEnv* env, size_t index, size_t n_indexed)
+{
+  const SerdNode* const uri = &env->prefixes[index].uri;
+  const size_t          pos =
+    serd_env_upper_bound(env, n_indexed, uri->buf, uri->n_bytes);
+
+  memmove(env->by_uri + pos + 1u,
+          env->by_uri + pos,
+          (n_indexed - pos) * sizeof(size_t));
+  env->by_uri[pos] = index;
+}
+
+/// Remove the prefix at `index` from the URI index
+static void
+serd_env_remove_uri(SerdEnv* env, size_t index)
+{
+  size_t i = 0u;
+  while (env->by_uri[i] != index) {
+    ++i;
+  }
+
+  memmove(env->by_uri + i,
+          env->by_uri + i + 1u,
+          (env->n_prefixes - i - 1u) * sizeof(size_t));
+}
+
+/**
+   Return the prefix with the longest URI that `buf` starts with.
+
+   If several prefixes have the same URI, the one declared first is returned.
+*/
+static const SerdPrefix*
+serd_env_find_longest(const SerdEnv* env, const uint8_t* buf, size_t len)
+{
+  /* The longest matching prefix is the greatest prefix URI that is less
+     than or equal to the URI.  If that candidate isn't a match, then no
+     prefix can match more than it has in common with the URI, so repeat
+     with the URI cut down to that length until there is a match. */
+
+  for (;;) {
+    size_t k = serd_env_upper_bound(env, env->n_prefixes, buf, len);
+    if (!k) {
+      return NULL;
+    }
+
+    const SerdNode* const uri = &env->prefixes[env->by_uri[--k]].uri;
+
+    size_t common = 0u;
+    while (common < uri->n_bytes && common < len &&
+           uri->buf[common] == buf[common]) {
+      ++common;
+    }
+
+    if (common == uri->n_bytes) {
+      // Found the longest match, return the first declared of any duplicates
+      size_t first = env->by_uri[k];
+      while (k > 0u && !serd_env_compare_uri(
+                         &env->prefixes[env->by_uri[k - 1u]].uri,
+                         uri->buf,
+                         uri->n_bytes)) {
+        if (env->by_uri[--k] < first) {
+          first = env->by_uri[k];
+        }
+      }
+
+      return &env->prefixes[first];
+    }
+
+    len = common;
+  }
+}
+
 static void
 serd_env_add(SerdEnv* env, const SerdNode* name, const SerdNode* uri)
 {
   SerdPrefix* const prefix = serd_env_find(env, name->buf, name->n_bytes);
   if (prefix) {
     if (!serd_node_equals(&prefix->uri, uri)) {
+      const size_t index = (size_t)(prefix - env->prefixes);
+
+      serd_env_remove_uri(env, index);
+
       SerdNode old_prefix_uri = prefix->uri;
-      prefix->uri             = serd_node_copy(uri);
-      serd_node_free(&old_prefix_uri);
+      prefix->uri             = serd_node_acopy(&env->allocator, uri);
+      serd_node_afree(&env->allocator, &old_prefix_uri);
+
+      serd_env_insert_uri(env, index, env->n_prefixes - 1u);
     }
   } else {
-    env->prefixes = (SerdPrefix*)realloc(
-      env->prefixes, (++env->n_prefixes) * sizeof(SerdPrefix));
-    env->prefixes[env->n_prefixes - 1].name = serd_node_copy(name);
-    env->prefixes[env->n_prefixes - 1].uri  = serd_node_copy(uri);
+    const size_t index = env->n_prefixes;
+
+    serd_env_reserve_buckets(env, index + 1u);
+
+    env->prefixes = (SerdPrefix*)serd_arealloc(
+      &env->allocator, env->prefixes, (++env->n_prefixes) * sizeof(SerdPrefix));
+    env->by_uri = (size_t*)serd_arealloc(
+      &env->allocator, env->by_uri, env->n_prefixes * sizeof(size_t));
+
+    env->prefixes[index].name = serd_node_acopy(&env->allocator, name);
+    env->prefixes[index].uri  = serd_node_acopy(&env->allocator, uri);
+
+    serd_env_insert_bucket(env, index);
+    serd_env_insert_uri(env, index, index);
   }
 }
 
@@ -173,19 +397,16 @@ serd_env_qualify(const SerdEnv*  env,
                  SerdNode*       prefix,
                  SerdChunk*      suffix)
 {
-  for (size_t i = 0; i < env->n_prefixes; ++i) {
-    const SerdNode* const prefix_uri = &env->prefixes[i].uri;
-    if (uri->n_bytes >= prefix_uri->n_bytes) {
-      if (!strncmp((const char*)uri->buf,
-                   (const char*)prefix_uri->buf,
-                   prefix_uri->n_bytes)) {
-        *prefix     = env->prefixes[i].name;
-        suffix->buf = uri->buf + prefix_uri->n_bytes;
-        suffix->len = uri->n_bytes - prefix_uri->n_bytes;
-        return true;
-      }
-    }
+  const SerdPrefix* const match =
+    serd_env_find_longest(env, uri->buf, uri->n_bytes);
+
+  if (match) {
+    *prefix     = match->name;
+    suffix->buf = uri->buf + match->uri.n_bytes;
+    suffix->len = uri->n_bytes - match->uri.n_bytes;
+    return true;
   }
+
   return false;
 }
 
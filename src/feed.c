@@ -0,0 +1,409 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "byte_source.h"
+#include "memory.h"
+#include "reader.h"
+#include "serd_internal.h"
+#include "string_utils.h"
+
+#include "serd/serd.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+  Fed input is read a statement at a time, so a split statement is never
+  parsed until the rest of it has arrived.  The end of statements is found by
+  a scanner that only understands enough of the syntax to skip over IRIs,
+  strings, and comments, and to track nesting.  It only needs to find places
+  where a statement definitely ends, since the input is parsed again properly
+  afterwards.  For line-based syntaxes, this is simply the end of a line.
+*/
+
+#define SCAN_END_BEFORE 1u ///< A statement ends before the scanned byte
+#define SCAN_END_AFTER 2u  ///< A statement ends after the scanned byte
+
+/// Return true iff `c` may continue a name or number after a dot
+static bool
+is_name_char(const uint8_t c)
+{
+  return is_alpha(c) || is_digit(c) || c == '_' || c == '-' || c == ':' ||
+         c == '%' || c >= 0x80;
+}
+
+/// Return true iff `word` is a SPARQL-style directive keyword
+static bool
+is_directive_word(const char* const word, const unsigned len)
+{
+  return (len == 4u && !serd_strncasecmp(word, "base", 4u)) ||
+         (len == 6u && !serd_strncasecmp(word, "prefix", 6u));
+}
+
+/// Scan a byte that is not in any token
+static unsigned
+scan_top(ReadFeed* const feed, const uint8_t c)
+{
+  if (feed->escaped) {
+    feed->escaped = false;
+    return 0u;
+  }
+
+  if (feed->at_start) {
+    if (is_space((char)c) || c == 0xEF || c == 0xBB || c == 0xBF) {
+      return 0u; // Whitespace or part of a byte order mark
+    }
+
+    if (c == '#') {
+      feed->state = FEED_COMMENT;
+      return 0u;
+    }
+
+    feed->at_start = false;
+    if (is_alpha(c)) {
+      feed->state    = FEED_WORD;
+      feed->word[0]  = (char)c;
+      feed->word_len = 1u;
+      return 0u;
+    }
+  }
+
+  switch (c) {
+  case '\0':
+    feed->depth    = 0u;
+    feed->at_start = true;
+    return SCAN_END_AFTER;
+  case '#':
+    feed->state = FEED_COMMENT;
+    break;
+  case '<':
+    feed->state = FEED_IRI;
+    break;
+  case '"':
+  case '\'':
+    feed->state    = FEED_QUOTES;
+    feed->quote    = c;
+    feed->n_quotes = 1u;
+    break;
+  case '\\':
+    feed->escaped = true;
+    break;
+  case '(':
+  case '[':
+  case '{':
+    ++feed->depth;
+    break;
+  case ')':
+  case ']':
+    feed->depth -= (feed->depth > 0u);
+    break;
+  case '}':
+    if (feed->depth && !--feed->depth) {
+      feed->at_start = true; // End of a TriG graph
+      return SCAN_END_AFTER;
+    }
+    break;
+  case '.':
+    if (!feed->depth) {
+      feed->state = FEED_DOT;
+    }
+    break;
+  default:
+    break;
+  }
+
+  return 0u;
+}
+
+/// Scan a byte in a string after the opening quotes
+static void
+scan_string(ReadFeed* const feed, const uint8_t c)
+{
+  if (feed->escaped) {
+    feed->escaped = false;
+  } else if (c == '\\') {
+    feed->escaped = true;
+  } else if (c == feed->quote || c == '\n') {
+    feed->state = FEED_TOP;
+  }
+}
+
+/// Scan the next byte of fed input, and return where any statement ends
+static unsigned
+scan_byte(ReadFeed* const feed, const uint8_t c)
+{
+  switch (feed->state) {
+  case FEED_TOP:
+    break;
+
+  case FEED_WORD:
+    if (is_alpha(c)) {
+      if (feed->word_len < sizeof(feed->word)) {
+        feed->word[feed->word_len++] = (char)c;
+      }
+      return 0u;
+    }
+
+    feed->state     = FEED_TOP;
+    feed->directive = (is_space((char)c) || c == '<') &&
+                      is_directive_word(feed->word, feed->word_len);
+    break;
+
+  case FEED_COMMENT:
+    if (c == '\n' || c == '\r') {
+      feed->state = FEED_TOP;
+    }
+    return 0u;
+
+  case FEED_IRI:
+    if (c == '>') {
+      feed->state = FEED_TOP;
+      if (feed->directive) {
+        feed->directive = false;
+        feed->at_start  = true;
+        return SCAN_END_AFTER;
+      }
+    }
+    return 0u;
+
+  case FEED_QUOTES:
+    if (c == feed->quote) {
+      if (++feed->n_quotes == 3u) {
+        feed->state    = FEED_LONG_STRING;
+        feed->n_quotes = 0u;
+      }
+      return 0u;
+    }
+
+    if (feed->n_quotes == 2u) {
+      feed->state = FEED_TOP; // Empty string
+      break;
+    }
+
+    feed->state = FEED_STRING;
+    scan_string(feed, c);
+    return 0u;
+
+  case FEED_STRING:
+    scan_string(feed, c);
+    return 0u;
+
+  case FEED_LONG_STRING:
+    if (feed->escaped) {
+      feed->escaped = false;
+    } else if (c == '\\') {
+      feed->escaped  = true;
+      feed->n_quotes = 0u;
+    } else if (c != feed->quote) {
+      feed->n_quotes = 0u;
+    } else if (++feed->n_quotes == 3u) {
+      feed->state = FEED_TOP;
+    }
+    return 0u;
+
+  case FEED_DOT:
+    if (c == '.') {
+      return 0u; // Several dots in a name
+    }
+
+    feed->state = FEED_TOP;
+    if (!is_name_char(c)) {
+      feed->at_start = true;
+      return SCAN_END_BEFORE | scan_top(feed, c);
+    }
+    break;
+  }
+
+  return scan_top(feed, c);
+}
+
+/**
+   Find where statements end in newly fed input.
+
+   @param first Set to the end of the first statement that ends in `buf`.
+   @param last Set to the end of the last statement that ends in `buf`.
+   @return True iff at least one statement ends in `buf`.
+*/
+static bool
+scan_statements(ReadFeed* const      feed,
+                const SerdSyntax     syntax,
+                const uint8_t* const buf,
+                const size_t         len,
+                size_t* const        first,
+                size_t* const        last)
+{
+  if (syntax == SERD_NTRIPLES || syntax == SERD_NQUADS) {
+    const uint8_t* const nl = (const uint8_t*)memchr(buf, '\n', len);
+    if (!nl) {
+      return false;
+    }
+
+    *first = *last = (size_t)(nl - buf) + 1u;
+    for (size_t i = len; i > *first; --i) {
+      if (buf[i - 1u] == '\n') {
+        *last = i;
+        break;
+      }
+    }
+
+    return true;
+  }
+
+  bool found = false;
+  for (size_t i = 0u; i < len; ++i) {
+    const unsigned end = scan_byte(feed, buf[i]);
+    if (end) {
+      const size_t offset = (end & SCAN_END_AFTER) ? i + 1u : i;
+      if (!found) {
+        *first = (end & SCAN_END_BEFORE) ? i : offset;
+        found  = true;
+      }
+
+      *last = offset;
+    }
+  }
+
+  return found;
+}
+
+/// Append `len` bytes to the incomplete statement kept by the reader
+static void
+keep_input(SerdReader* const    reader,
+           const uint8_t* const buf,
+           const size_t         len)
+{
+  ReadFeed* const feed = &reader->feed;
+  if (!len) {
+    return;
+  }
+
+  if (feed->len + len > feed->size) {
+    size_t size = feed->size ? feed->size : SERD_PAGE_SIZE;
+    while (size < feed->len + len) {
+      size *= 2u;
+    }
+
+    feed->buf  = (uint8_t*)serd_arealloc(&reader->allocator, feed->buf, size);
+    feed->size = size;
+  }
+
+  memcpy(feed->buf + feed->len, buf, len);
+  feed->len += len;
+}
+
+/// Read all of the statements in a piece of fed input
+static SerdStatus
+read_fed(SerdReader* const reader, const uint8_t* const buf, const size_t len)
+{
+  ReadFeed* const       feed   = &reader->feed;
+  SerdByteSource* const source = &reader->source;
+
+  serd_byte_source_open_buffer(source, buf, len, feed->cur.filename);
+  source->cur    = feed->cur;
+  source->offset = feed->offset;
+  serd_byte_source_set_lazy(source, reader->lazy_positions);
+  serd_byte_source_prepare(source);
+  reader->start_offset = feed->offset;
+
+  // Skip any byte order mark, which is always in the first statement
+  if (!feed->offset && len >= 3u && !memcmp(buf, "\xEF\xBB\xBF", 3u)) {
+    serd_byte_source_skip(source, 3u);
+  }
+
+  const SerdStatus st = read_doc(reader);
+
+  feed->cur = *serd_byte_source_cursor(source);
+  feed->offset += len;
+  serd_reader_close_source(reader);
+  return st;
+}
+
+void
+serd_reader_end_feed(SerdReader* const reader)
+{
+  ReadFeed* const feed = &reader->feed;
+
+  feed->len     = 0u;
+  feed->started = false;
+}
+
+SerdStatus
+serd_reader_feed(SerdReader* const    reader,
+                 const uint8_t* const buf,
+                 const size_t         len,
+                 const bool           is_last)
+{
+  ReadFeed* const feed = &reader->feed;
+
+  if (reader->syntax == SERD_BINARY || reader->source.prepared) {
+    return SERD_ERR_BAD_ARG;
+  }
+
+  if (!feed->started) {
+    const Cursor cur = {(const uint8_t*)"(feed)", 1u, 1u};
+
+    feed->offset    = 0u;
+    feed->cur       = cur;
+    feed->state     = FEED_TOP;
+    feed->depth     = 0u;
+    feed->escaped   = false;
+    feed->at_start  = true;
+    feed->directive = false;
+    feed->started   = true;
+  }
+
+  // Find the end of the first and last complete statements in the new input
+  const SerdSyntax syntax = reader->syntax;
+  size_t           first  = 0u;
+  size_t           last   = 0u;
+  if (!len || !scan_statements(feed, syntax, buf, len, &first, &last)) {
+    if (!is_last) {
+      keep_input(reader, buf, len);
+      return SERD_SUCCESS;
+    }
+
+    first = len;
+  }
+
+  if (is_last) {
+    last = len;
+  }
+
+  // Finish reading the statement that was split, if any
+  SerdStatus st = SERD_SUCCESS;
+  if (feed->len) {
+    keep_input(reader, buf, first);
+    st        = read_fed(reader, feed->buf, feed->len);
+    feed->len = 0u;
+  } else {
+    first = 0u;
+  }
+
+  // Read complete statements in place, and keep the end for later
+  if (!st && last > first) {
+    st = read_fed(reader, buf + first, last - first);
+  }
+
+  if (st > SERD_FAILURE || is_last) {
+    serd_reader_end_feed(reader);
+  } else {
+    keep_input(reader, buf + last, len - last);
+  }
+
+  return st > SERD_FAILURE ? st : SERD_SUCCESS;
+}
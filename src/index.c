@@ -0,0 +1,182 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "index.h"
+
+#include "serd/serd.h"
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/// First line of a written index, followed by the interval
+#define INDEX_HEADER "serd-index 1"
+
+/**
+   A sorted array of checkpoints.
+
+   Checkpoints are only ever appended in increasing order, so the array is
+   sorted by both offset and statement number.
+*/
+struct SerdIndexImpl {
+  uint64_t        interval;         ///< Statements between checkpoints
+  SerdCheckpoint* checkpoints;      ///< Checkpoints in document order
+  size_t          n_checkpoints;    ///< Number of checkpoints
+  size_t          checkpoints_size; ///< Number of allocated checkpoints
+};
+
+SerdIndex*
+serd_index_new(const uint64_t interval)
+{
+  SerdIndex* const index = (SerdIndex*)calloc(1, sizeof(SerdIndex));
+
+  index->interval = interval ? interval : 1u;
+  return index;
+}
+
+void
+serd_index_free(SerdIndex* const index)
+{
+  if (index) {
+    free(index->checkpoints);
+    free(index);
+  }
+}
+
+uint64_t
+serd_index_interval(const SerdIndex* const index)
+{
+  return index->interval;
+}
+
+size_t
+serd_index_size(const SerdIndex* const index)
+{
+  return index->n_checkpoints;
+}
+
+const SerdCheckpoint*
+serd_index_get(const SerdIndex* const index, const size_t i)
+{
+  return i < index->n_checkpoints ? &index->checkpoints[i] : NULL;
+}
+
+const SerdCheckpoint*
+serd_index_find(const SerdIndex* const index, const uint64_t n_statements)
+{
+  // Binary search for the first checkpoint after n_statements
+  size_t lo = 0u;
+  size_t hi = index->n_checkpoints;
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2u;
+    if (index->checkpoints[mid].n_statements <= n_statements) {
+      lo = mid + 1u;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo ? &index->checkpoints[lo - 1u] : NULL;
+}
+
+static void
+serd_index_append(SerdIndex* const index, const SerdCheckpoint* checkpoint)
+{
+  if (index->n_checkpoints == index->checkpoints_size) {
+    index->checkpoints_size =
+      index->checkpoints_size ? index->checkpoints_size * 2u : 64u;
+
+    index->checkpoints = (SerdCheckpoint*)realloc(
+      index->checkpoints, index->checkpoints_size * sizeof(SerdCheckpoint));
+  }
+
+  index->checkpoints[index->n_checkpoints++] = *checkpoint;
+}
+
+void
+serd_index_update(SerdIndex* const index, const SerdCheckpoint* checkpoint)
+{
+  if (index->n_checkpoints) {
+    const SerdCheckpoint* const last =
+      &index->checkpoints[index->n_checkpoints - 1u];
+
+    if (checkpoint->n_statements < last->n_statements + index->interval ||
+        checkpoint->offset <= last->offset) {
+      return;
+    }
+  }
+
+  serd_index_append(index, checkpoint);
+}
+
+SerdStatus
+serd_index_write(const SerdIndex* const index, FILE* const file)
+{
+  if (fprintf(file, INDEX_HEADER " %" PRIu64 "\n", index->interval) < 0) {
+    return SERD_ERR_UNKNOWN;
+  }
+
+  for (size_t i = 0u; i < index->n_checkpoints; ++i) {
+    const SerdCheckpoint* const c = &index->checkpoints[i];
+    if (fprintf(file,
+                "%" PRIu64 " %u %" PRIu64 "\n",
+                c->offset,
+                c->line,
+                c->n_statements) < 0) {
+      return SERD_ERR_UNKNOWN;
+    }
+  }
+
+  return SERD_SUCCESS;
+}
+
+SerdIndex*
+serd_index_read(FILE* const file)
+{
+  uint64_t interval = 0u;
+  if (fscanf(file, INDEX_HEADER " %" SCNu64, &interval) != 1 || !interval) {
+    return NULL;
+  }
+
+  SerdIndex* const index = serd_index_new(interval);
+  SerdCheckpoint   c     = {0u, 0u, 0u};
+  int              n     = 0;
+  while ((n = fscanf(file,
+                     "%" SCNu64 " %u %" SCNu64,
+                     &c.offset,
+                     &c.line,
+                     &c.n_statements)) == 3) {
+    const SerdCheckpoint* const last =
+      index->n_checkpoints ? &index->checkpoints[index->n_checkpoints - 1u]
+                           : NULL;
+
+    if (last && (c.offset <= last->offset ||
+                 c.n_statements <= last->n_statements)) {
+      break; // Out of order
+    }
+
+    serd_index_append(index, &c);
+  }
+
+  if (n != EOF) {
+    serd_index_free(index);
+    return NULL;
+  }
+
+  return index;
+}
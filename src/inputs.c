@@ -0,0 +1,545 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#define _POSIX_C_SOURCE 200809L /* for pthreads */
+
+#include "memory.h"
+#include "reader.h"
+#include "serd_config.h"
+#include "serd_internal.h"
+#include "statements.h"
+#include "system.h"
+
+#include "serd/serd.h"
+
+#if USE_PTHREAD
+#  include <pthread.h>
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/// Number of statements passed from a reader thread at once
+#define INPUT_BATCH_SIZE 1024u
+
+/// Number of batches per thread that may wait in the queue to be emitted
+#define QUEUE_PER_THREAD 2u
+
+typedef struct {
+  SerdReader*      reader;   ///< Reader with the sinks and options to use
+  const SerdInput* inputs;   ///< Inputs to read
+  size_t           n_inputs; ///< Number of inputs
+  size_t           next;     ///< Index of the next input to read
+  SerdStatus       status;   ///< First error status from reading an input
+  SerdStatus       sink_st;  ///< Error status from the sink
+  bool             threaded; ///< True iff inputs are read by other threads
+#if USE_PTHREAD
+  SerdStatements* queue;      ///< Ring of batches waiting to be emitted
+  size_t          queue_size; ///< Number of batches in the ring
+  size_t          head;       ///< Index of the first waiting batch
+  size_t          n_queued;   ///< Number of batches waiting
+  size_t          n_running;  ///< Number of reader threads still running
+
+  pthread_mutex_t mutex; ///< Mutex for all of the above and the error sink
+  pthread_cond_t  cond;  ///< Signalled when a batch is queued or emitted
+#endif
+} Inputs;
+
+typedef struct {
+  Inputs*        inputs; ///< Shared state
+  SerdReader*    reader; ///< Reader for the current input
+  SerdEnv*       env;    ///< Environment of the current input
+  SerdStatements batch;  ///< Statements not yet queued
+#if USE_PTHREAD
+  pthread_t thread; ///< Reader thread
+#endif
+} InputReader;
+
+static void
+lock(Inputs* const inputs)
+{
+#if USE_PTHREAD
+  if (inputs->threaded) {
+    pthread_mutex_lock(&inputs->mutex);
+  }
+#else
+  (void)inputs;
+#endif
+}
+
+static void
+unlock(Inputs* const inputs)
+{
+#if USE_PTHREAD
+  if (inputs->threaded) {
+    pthread_mutex_unlock(&inputs->mutex);
+  }
+#else
+  (void)inputs;
+#endif
+}
+
+/// Emit and clear a batch of statements on the calling thread
+static SerdStatus
+emit_batch(Inputs* const inputs, SerdStatements* const batch)
+{
+  const SerdStatus st =
+    serd_statements_emit(batch, sink_statement, inputs->reader);
+
+  serd_statements_clear(batch);
+  return st;
+}
+
+static void
+swap_batches(SerdStatements* const a, SerdStatements* const b)
+{
+  const SerdStatements tmp = *a;
+
+  *a = *b;
+  *b = tmp;
+}
+
+/// Pass on the statements read so far, so `input->batch` is empty
+static SerdStatus
+submit_batch(InputReader* const input)
+{
+  Inputs* const inputs = input->inputs;
+
+  if (!inputs->threaded) {
+    const SerdStatus st = emit_batch(inputs, &input->batch);
+
+    inputs->sink_st = inputs->sink_st ? inputs->sink_st : st;
+    return st ? SERD_ERR_UNKNOWN : SERD_SUCCESS;
+  }
+
+#if USE_PTHREAD
+  SerdStatus st = SERD_SUCCESS;
+
+  pthread_mutex_lock(&inputs->mutex);
+  while (!inputs->sink_st && inputs->n_queued == inputs->queue_size) {
+    pthread_cond_wait(&inputs->cond, &inputs->mutex);
+  }
+
+  if (inputs->sink_st) {
+    serd_statements_clear(&input->batch);
+    st = SERD_ERR_UNKNOWN; // Abort reading since nothing more can be emitted
+  } else {
+    const size_t tail =
+      (inputs->head + inputs->n_queued++) % inputs->queue_size;
+
+    swap_batches(&inputs->queue[tail], &input->batch);
+    pthread_cond_broadcast(&inputs->cond);
+  }
+  pthread_mutex_unlock(&inputs->mutex);
+
+  return st;
+#else
+  return SERD_ERR_INTERNAL;
+#endif
+}
+
+/// Return `node` as an absolute URI, which is stored in `expanded` if needed
+static const SerdNode*
+expand(InputReader* const    input,
+       const SerdNode* const node,
+       SerdNode* const       expanded)
+{
+  if (!node || node->type == SERD_LITERAL || node->type == SERD_BLANK ||
+      (node->type == SERD_URI && serd_uri_string_has_scheme(node->buf))) {
+    return node;
+  }
+
+  if (!(*expanded = serd_env_expand_node(input->env, node)).buf) {
+    r_err(input->reader,
+          SERD_ERR_BAD_CURIE,
+          "undefined namespace prefix `%s'\n",
+          node->buf);
+    return NULL;
+  }
+
+  return expanded;
+}
+
+static SerdStatus
+set_base(void* const handle, const SerdNode* const uri)
+{
+  return serd_env_set_base_uri(((InputReader*)handle)->env, uri);
+}
+
+static SerdStatus
+set_prefix(void* const           handle,
+           const SerdNode* const name,
+           const SerdNode* const uri)
+{
+  return serd_env_set_prefix(((InputReader*)handle)->env, name, uri);
+}
+
+static SerdStatus
+queue_statement(void*              handle,
+                SerdStatementFlags flags,
+                const SerdNode*    graph,
+                const SerdNode*    subject,
+                const SerdNode*    predicate,
+                const SerdNode*    object,
+                const SerdNode*    object_datatype,
+                const SerdNode*    object_lang)
+{
+  (void)flags;
+
+  InputReader* const input = (InputReader*)handle;
+
+  // Expand the nodes to absolute URIs, since the sink has no environment
+  SerdNode expanded[5];
+  memset(expanded, 0, sizeof(expanded));
+
+  const SerdNode* const g = expand(input, graph, &expanded[0]);
+  const SerdNode* const s = expand(input, subject, &expanded[1]);
+  const SerdNode* const p = expand(input, predicate, &expanded[2]);
+  const SerdNode* const o = expand(input, object, &expanded[3]);
+  const SerdNode* const d = expand(input, object_datatype, &expanded[4]);
+
+  SerdStatus st = SERD_SUCCESS;
+  if ((graph && !g) || !s || !p || !o || (object_datatype && !d)) {
+    st = SERD_ERR_BAD_CURIE;
+  } else {
+    // Flags are dropped since anonymous nodes from inputs may be interleaved
+    serd_statements_push(&input->batch, 0u, g, s, p, o, d, object_lang);
+    if (input->batch.n_statements == INPUT_BATCH_SIZE) {
+      st = submit_batch(input);
+    }
+  }
+
+  for (unsigned i = 0u; i < 5u; ++i) {
+    serd_node_free(&expanded[i]);
+  }
+
+  return st;
+}
+
+/// Return true iff `node` must be expanded to be an absolute URI
+static bool
+needs_expansion(const SerdNode* const node)
+{
+  return node && (node->type == SERD_CURIE ||
+                  (node->type == SERD_URI &&
+                   !serd_uri_string_has_scheme(node->buf)));
+}
+
+/// Pass the filter of the base reader absolute URIs, like the sink
+static bool
+filter_input(void* const           handle,
+             const SerdNode* const graph,
+             const SerdNode* const predicate)
+{
+  InputReader* const input = (InputReader*)handle;
+  SerdReader* const  base  = input->inputs->reader;
+
+  SerdNode g = SERD_NODE_NULL;
+  SerdNode p = SERD_NODE_NULL;
+  if ((needs_expansion(graph) &&
+       !(g = serd_env_expand_node(input->env, graph)).buf) ||
+      (needs_expansion(predicate) &&
+       !(p = serd_env_expand_node(input->env, predicate)).buf)) {
+    serd_node_free(&g);
+    return true; // Keep the statement so the sink reports the error
+  }
+
+  const bool accept = base->filter(base->filter_handle,
+                                   g.buf ? &g : graph,
+                                   p.buf ? &p : predicate);
+
+  serd_node_free(&g);
+  serd_node_free(&p);
+  return accept;
+}
+
+static SerdStatus
+forward_error(void* handle, const SerdError* e)
+{
+  Inputs* const inputs = ((InputReader*)handle)->inputs;
+
+  lock(inputs);
+  if (!inputs->sink_st) { // Otherwise, this is only from aborting reading
+    serd_error(inputs->reader->error_sink, inputs->reader->error_handle, e);
+  }
+  unlock(inputs);
+
+  return SERD_SUCCESS;
+}
+
+/// Read the input at `index` with a new reader
+static SerdStatus
+read_input(InputReader* const input, const size_t index)
+{
+  Inputs* const              inputs    = input->inputs;
+  const SerdInput* const     in        = &inputs->inputs[index];
+  SerdReader* const          base      = inputs->reader;
+  const SerdAllocator* const allocator = &base->allocator;
+
+  SerdReader* const reader = serd_reader_new_with_allocator(
+    allocator,
+    in->syntax ? in->syntax : base->syntax,
+    input,
+    NULL,
+    set_base,
+    set_prefix,
+    queue_statement,
+    NULL);
+
+  serd_reader_set_strict(reader, base->strict);
+  serd_reader_set_lazy_positions(reader, base->lazy_positions);
+  serd_reader_set_validate_only(reader, base->validate_only);
+  serd_reader_set_error_sink(reader, forward_error, input);
+  if (base->filter) {
+    serd_reader_set_filter(reader, filter_input, input);
+  }
+  serd_reader_add_blank_prefix(reader,
+                               in->blank_prefix ? in->blank_prefix
+                                                : base->bprefix);
+
+  if (in->graph) {
+    serd_reader_set_default_graph(reader, in->graph);
+  } else if (base->default_graph.buf) {
+    serd_reader_set_default_graph(reader, &base->default_graph);
+  }
+
+  // Generated blank node IDs must be unique across inputs, and labels in any
+  // input must not clash with them, so rename labels like Turtle does
+  snprintf(reader->genid_prefix,
+           sizeof(reader->genid_prefix),
+           "%ui",
+           (unsigned)index);
+
+  reader->rename_labels = true;
+
+  input->reader = reader;
+  input->env    = serd_env_new_with_allocator(allocator, in->base);
+
+  SerdStatus  st   = SERD_SUCCESS;
+  FILE* const file =
+    in->file ? in->file : serd_fopen((const char*)in->path, "rb");
+
+  if (!file) {
+    st = SERD_ERR_UNKNOWN;
+  } else {
+    st = serd_reader_read_file_handle(reader, file, in->path);
+    if (!in->file) {
+      fclose(file);
+    }
+  }
+
+  if (input->batch.n_statements) {
+    const SerdStatus submit_st = submit_batch(input);
+    st                         = st ? st : submit_st;
+  }
+
+  lock(inputs);
+  const SerdStatus label_st =
+    merge_blank_labels(base, reader->seen_genid, reader->seen_renamed);
+  serd_reader_add_stats(&base->stats, &reader->stats);
+  unlock(inputs);
+
+  st = st ? st : label_st;
+
+  serd_env_free(input->env);
+  serd_reader_free(reader);
+  input->reader = NULL;
+  input->env    = NULL;
+  return st;
+}
+
+/// Read inputs until there are none left, or the sink fails
+static void
+read_inputs(InputReader* const input)
+{
+  Inputs* const inputs = input->inputs;
+
+  lock(inputs);
+  while (!inputs->sink_st && inputs->next < inputs->n_inputs) {
+    const size_t index = inputs->next++;
+    unlock(inputs);
+
+    const SerdStatus st = read_input(input, index);
+
+    lock(inputs);
+    if (st > SERD_FAILURE && !inputs->status) {
+      inputs->status = st;
+    }
+  }
+  unlock(inputs);
+}
+
+/// Read every input in order on the calling thread
+static SerdStatus
+read_serially(Inputs* const inputs)
+{
+  InputReader input;
+  memset(&input, 0, sizeof(input));
+  input.inputs = inputs;
+  input.batch =
+    serd_statements_new(&inputs->reader->allocator, SERD_PAGE_SIZE);
+
+  read_inputs(&input);
+  serd_statements_free(&input.batch);
+  return SERD_SUCCESS;
+}
+
+#if USE_PTHREAD
+
+static void*
+work(void* const arg)
+{
+  InputReader* const input  = (InputReader*)arg;
+  Inputs* const      inputs = input->inputs;
+
+  read_inputs(input);
+
+  pthread_mutex_lock(&inputs->mutex);
+  --inputs->n_running;
+  pthread_cond_broadcast(&inputs->cond);
+  pthread_mutex_unlock(&inputs->mutex);
+
+  return NULL;
+}
+
+/// Emit batches from the queue until every reader thread is finished
+static void
+emit_queued(Inputs* const inputs, SerdStatements* const batch)
+{
+  pthread_mutex_lock(&inputs->mutex);
+  for (;;) {
+    while (!inputs->n_queued && inputs->n_running) {
+      pthread_cond_wait(&inputs->cond, &inputs->mutex);
+    }
+
+    if (!inputs->n_queued) {
+      break; // All readers are finished
+    }
+
+    swap_batches(&inputs->queue[inputs->head], batch);
+    inputs->head = (inputs->head + 1u) % inputs->queue_size;
+    --inputs->n_queued;
+    pthread_cond_broadcast(&inputs->cond);
+    pthread_mutex_unlock(&inputs->mutex);
+
+    const SerdStatus st = inputs->sink_st ? SERD_SUCCESS
+                                          : emit_batch(inputs, batch);
+
+    serd_statements_clear(batch);
+    pthread_mutex_lock(&inputs->mutex);
+    if (st && !inputs->sink_st) {
+      inputs->sink_st = st; // Stop readers, but keep draining the queue
+      pthread_cond_broadcast(&inputs->cond);
+    }
+  }
+  pthread_mutex_unlock(&inputs->mutex);
+}
+
+static SerdStatus
+read_threaded(Inputs* const inputs, const size_t n_threads)
+{
+  const SerdAllocator* const allocator = &inputs->reader->allocator;
+
+  inputs->threaded   = true;
+  inputs->queue_size = n_threads * QUEUE_PER_THREAD;
+  inputs->queue      = (SerdStatements*)serd_acalloc(
+    allocator, inputs->queue_size, sizeof(SerdStatements));
+
+  for (size_t i = 0u; i < inputs->queue_size; ++i) {
+    inputs->queue[i] = serd_statements_new(allocator, SERD_PAGE_SIZE);
+  }
+
+  pthread_mutex_init(&inputs->mutex, NULL);
+  pthread_cond_init(&inputs->cond, NULL);
+
+  InputReader* const readers =
+    (InputReader*)serd_acalloc(allocator, n_threads, sizeof(InputReader));
+
+  // Start reader threads
+  pthread_mutex_lock(&inputs->mutex);
+  size_t n_started = 0u;
+  for (; n_started < n_threads; ++n_started) {
+    InputReader* const input = &readers[n_started];
+
+    input->inputs = inputs;
+    input->batch  = serd_statements_new(allocator, SERD_PAGE_SIZE);
+    if (pthread_create(&input->thread, NULL, work, input)) {
+      serd_statements_free(&input->batch);
+      break;
+    }
+
+    ++inputs->n_running;
+  }
+  pthread_mutex_unlock(&inputs->mutex);
+
+  SerdStatus st = SERD_SUCCESS;
+  if (!n_started) {
+    st = SERD_ERR_UNKNOWN;
+  } else {
+    SerdStatements batch = serd_statements_new(allocator, SERD_PAGE_SIZE);
+    emit_queued(inputs, &batch);
+    serd_statements_free(&batch);
+  }
+
+  for (size_t i = 0u; i < n_started; ++i) {
+    pthread_join(readers[i].thread, NULL);
+    serd_statements_free(&readers[i].batch);
+  }
+
+  for (size_t i = 0u; i < inputs->queue_size; ++i) {
+    serd_statements_free(&inputs->queue[i]);
+  }
+
+  pthread_cond_destroy(&inputs->cond);
+  pthread_mutex_destroy(&inputs->mutex);
+  serd_afree(allocator, readers);
+  serd_afree(allocator, inputs->queue);
+  return st;
+}
+
+#endif // USE_PTHREAD
+
+SerdStatus
+serd_reader_read_inputs(SerdReader* const      reader,
+                        const SerdInput* const inputs,
+                        const size_t           n_inputs,
+                        const unsigned         n_threads)
+{
+  Inputs state;
+  memset(&state, 0, sizeof(state));
+  state.reader   = reader;
+  state.inputs   = inputs;
+  state.n_inputs = n_inputs;
+
+#if USE_PTHREAD
+  const SerdStatus st =
+    (n_threads > 1u && n_inputs > 1u)
+      ? read_threaded(&state, MIN((size_t)n_threads, n_inputs))
+      : read_serially(&state);
+#else
+  (void)n_threads;
+  const SerdStatus st = read_serially(&state);
+#endif
+
+  const SerdStatus flush_st = flush_batch(reader);
+
+  return st              ? st
+         : state.sink_st ? state.sink_st
+         : state.status  ? state.status
+                         : flush_st;
+}
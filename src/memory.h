@@ -0,0 +1,135 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef SERD_MEMORY_H
+#define SERD_MEMORY_H
+
+#include "system.h"
+
+#include "serd/serd.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  Wrappers for allocating with a SerdAllocator.
+
+  The allocator may be null, or have null functions, in which case the
+  standard C allocator is used.
+*/
+
+static inline void*
+serd_amalloc(const SerdAllocator* allocator, const size_t size)
+{
+  return (allocator && allocator->malloc_func)
+           ? allocator->malloc_func(allocator->handle, size)
+           : malloc(size);
+}
+
+static inline void*
+serd_acalloc(const SerdAllocator* allocator,
+             const size_t         nmemb,
+             const size_t         size)
+{
+  if (!allocator || !allocator->malloc_func) {
+    return calloc(nmemb, size);
+  }
+
+  void* const ptr = allocator->malloc_func(allocator->handle, nmemb * size);
+  if (ptr) {
+    memset(ptr, 0, nmemb * size);
+  }
+
+  return ptr;
+}
+
+static inline void*
+serd_arealloc(const SerdAllocator* allocator, void* ptr, const size_t size)
+{
+  return (allocator && allocator->realloc_func)
+           ? allocator->realloc_func(allocator->handle, ptr, size)
+           : realloc(ptr, size);
+}
+
+static inline void
+serd_afree(const SerdAllocator* allocator, void* ptr)
+{
+  if (allocator && allocator->free_func) {
+    allocator->free_func(allocator->handle, ptr);
+  } else {
+    free(ptr);
+  }
+}
+
+/// Allocate a buffer for I/O, which is aligned with the default allocator
+static inline void*
+serd_aallocate_buffer(const SerdAllocator* allocator, const size_t size)
+{
+  return (allocator && allocator->malloc_func)
+           ? allocator->malloc_func(allocator->handle, size)
+           : serd_allocate_buffer(size);
+}
+
+/// Free a buffer allocated with serd_aallocate_buffer()
+static inline void
+serd_afree_buffer(const SerdAllocator* allocator, void* ptr)
+{
+  if (allocator && allocator->free_func) {
+    allocator->free_func(allocator->handle, ptr);
+  } else {
+    serd_free_aligned(ptr);
+  }
+}
+
+/// Copy a string into memory from `allocator`
+static inline uint8_t*
+serd_astrdup(const SerdAllocator* allocator,
+             const uint8_t*       str,
+             const size_t         len)
+{
+  uint8_t* const copy = (uint8_t*)serd_amalloc(allocator, len + 1);
+
+  memcpy(copy, str, len);
+  copy[len] = '\0';
+  return copy;
+}
+
+/// Like serd_node_copy(), but allocates the copy with `allocator`
+static inline SerdNode
+serd_node_acopy(const SerdAllocator* allocator, const SerdNode* node)
+{
+  if (!node || !node->buf) {
+    return SERD_NODE_NULL;
+  }
+
+  SerdNode copy = *node;
+  copy.buf      = serd_astrdup(allocator, node->buf, node->n_bytes);
+  return copy;
+}
+
+/// Like serd_node_free(), for a node allocated with `allocator`
+static inline void
+serd_node_afree(const SerdAllocator* allocator, SerdNode* node)
+{
+  if (node && node->buf) {
+    serd_afree(allocator, (uint8_t*)node->buf);
+    node->buf = NULL;
+  }
+}
+
+#endif // SERD_MEMORY_H
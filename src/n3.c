@@ -15,11 +15,11 @@
 */
 
 #include "byte_source.h"
+#include "ntriples.h"
 #include "reader.h"
 #include "serd_internal.h"
 #include "stack.h"
 #include "string_utils.h"
-#include "uri_utils.h"
 
 #include "serd/serd.h"
 
@@ -27,7 +27,6 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 
 #define TRY(st, exp)      \
@@ -37,238 +36,12 @@
     }                     \
   } while (0)
 
-static inline bool
-fancy_syntax(const SerdReader* reader)
-{
-  return reader->syntax == SERD_TURTLE || reader->syntax == SERD_TRIG;
-}
-
 static SerdStatus
 read_collection(SerdReader* reader, ReadContext ctx, Ref* dest);
 
 static SerdStatus
 read_predicateObjectList(SerdReader* reader, ReadContext ctx, bool* ate_dot);
 
-static inline uint8_t
-read_HEX(SerdReader* reader)
-{
-  const int c = peek_byte(reader);
-  if (is_xdigit(c)) {
-    return (uint8_t)eat_byte_safe(reader, c);
-  }
-
-  r_err(reader, SERD_ERR_BAD_SYNTAX, "invalid hexadecimal digit `%c'\n", c);
-  return 0;
-}
-
-// Read UCHAR escape, initial \ is already eaten by caller
-static inline SerdStatus
-read_UCHAR(SerdReader* reader, Ref dest, uint32_t* char_code)
-{
-  const int b      = peek_byte(reader);
-  unsigned  length = 0;
-  switch (b) {
-  case 'U':
-    length = 8;
-    break;
-  case 'u':
-    length = 4;
-    break;
-  default:
-    return SERD_ERR_BAD_SYNTAX;
-  }
-
-  eat_byte_safe(reader, b);
-
-  uint8_t buf[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
-  for (unsigned i = 0; i < length; ++i) {
-    if (!(buf[i] = read_HEX(reader))) {
-      return SERD_ERR_BAD_SYNTAX;
-    }
-  }
-
-  char*          endptr = NULL;
-  const uint32_t code   = (uint32_t)strtoul((const char*)buf, &endptr, 16);
-  assert(endptr == (char*)buf + length);
-
-  unsigned size = 0;
-  if (code < 0x00000080) {
-    size = 1;
-  } else if (code < 0x00000800) {
-    size = 2;
-  } else if (code < 0x00010000) {
-    size = 3;
-  } else if (code < 0x00110000) {
-    size = 4;
-  } else {
-    r_err(reader,
-          SERD_ERR_BAD_SYNTAX,
-          "unicode character 0x%X out of range\n",
-          code);
-    push_bytes(reader, dest, replacement_char, 3);
-    *char_code = 0xFFFD;
-    return SERD_SUCCESS;
-  }
-
-  // Build output in buf
-  // (Note # of bytes = # of leading 1 bits in first byte)
-  uint32_t c = code;
-  switch (size) {
-  case 4:
-    buf[3] = (uint8_t)(0x80u | (c & 0x3Fu));
-    c >>= 6;
-    c |= (16 << 12); // set bit 4
-    /* fallthru */
-  case 3:
-    buf[2] = (uint8_t)(0x80u | (c & 0x3Fu));
-    c >>= 6;
-    c |= (32 << 6); // set bit 5
-    /* fallthru */
-  case 2:
-    buf[1] = (uint8_t)(0x80u | (c & 0x3Fu));
-    c >>= 6;
-    c |= 0xC0; // set bits 6 and 7
-    /* fallthru */
-  case 1:
-    buf[0] = (uint8_t)c;
-    /* fallthru */
-  default:
-    break;
-  }
-
-  push_bytes(reader, dest, buf, size);
-  *char_code = code;
-  return SERD_SUCCESS;
-}
-
-// Read ECHAR escape, initial \ is already eaten by caller
-static inline SerdStatus
-read_ECHAR(SerdReader* reader, Ref dest, SerdNodeFlags* flags)
-{
-  const int c = peek_byte(reader);
-  switch (c) {
-  case 't':
-    eat_byte_safe(reader, 't');
-    push_byte(reader, dest, '\t');
-    return SERD_SUCCESS;
-  case 'b':
-    eat_byte_safe(reader, 'b');
-    push_byte(reader, dest, '\b');
-    return SERD_SUCCESS;
-  case 'n':
-    *flags |= SERD_HAS_NEWLINE;
-    eat_byte_safe(reader, 'n');
-    push_byte(reader, dest, '\n');
-    return SERD_SUCCESS;
-  case 'r':
-    *flags |= SERD_HAS_NEWLINE;
-    eat_byte_safe(reader, 'r');
-    push_byte(reader, dest, '\r');
-    return SERD_SUCCESS;
-  case 'f':
-    eat_byte_safe(reader, 'f');
-    push_byte(reader, dest, '\f');
-    return SERD_SUCCESS;
-  case '\\':
-  case '"':
-  case '\'':
-    push_byte(reader, dest, eat_byte_safe(reader, c));
-    return SERD_SUCCESS;
-  default:
-    return SERD_ERR_BAD_SYNTAX;
-  }
-}
-
-static inline SerdStatus
-bad_char(SerdReader* reader, const char* fmt, uint8_t c)
-{
-  // Skip bytes until the next start byte
-  for (int b = peek_byte(reader); b != EOF && ((uint8_t)b & 0x80);) {
-    eat_byte_safe(reader, b);
-    b = peek_byte(reader);
-  }
-
-  r_err(reader, SERD_ERR_BAD_SYNTAX, fmt, c);
-  return reader->strict ? SERD_ERR_BAD_SYNTAX : SERD_FAILURE;
-}
-
-static SerdStatus
-read_utf8_bytes(SerdReader* reader, uint8_t bytes[4], uint32_t* size, uint8_t c)
-{
-  *size = utf8_num_bytes(c);
-  if (*size <= 1 || *size > 4) {
-    return bad_char(reader, "invalid UTF-8 start 0x%X\n", c);
-  }
-
-  bytes[0] = c;
-  for (unsigned i = 1; i < *size; ++i) {
-    const int b = peek_byte(reader);
-    if (b == EOF || ((uint8_t)b & 0x80) == 0) {
-      return bad_char(reader, "invalid UTF-8 continuation 0x%X\n", (uint8_t)b);
-    }
-
-    eat_byte_safe(reader, b);
-    bytes[i] = (uint8_t)b;
-  }
-
-  return SERD_SUCCESS;
-}
-
-static SerdStatus
-read_utf8_character(SerdReader* reader, Ref dest, uint8_t c)
-{
-  uint32_t   size     = 0;
-  uint8_t    bytes[4] = {0, 0, 0, 0};
-  SerdStatus st       = read_utf8_bytes(reader, bytes, &size, c);
-  if (st) {
-    push_bytes(reader, dest, replacement_char, 3);
-  } else {
-    push_bytes(reader, dest, bytes, size);
-  }
-
-  return st;
-}
-
-static SerdStatus
-read_utf8_code(SerdReader* reader, Ref dest, uint32_t* code, uint8_t c)
-{
-  uint32_t   size     = 0;
-  uint8_t    bytes[4] = {0, 0, 0, 0};
-  SerdStatus st       = read_utf8_bytes(reader, bytes, &size, c);
-  if (st) {
-    push_bytes(reader, dest, replacement_char, 3);
-    return st;
-  }
-
-  push_bytes(reader, dest, bytes, size);
-  *code = parse_counted_utf8_char(bytes, size);
-  return st;
-}
-
-// Read one character (possibly multi-byte)
-// The first byte, c, has already been eaten by caller
-static inline SerdStatus
-read_character(SerdReader* reader, Ref dest, SerdNodeFlags* flags, uint8_t c)
-{
-  if (!(c & 0x80)) {
-    switch (c) {
-    case 0xA:
-    case 0xD:
-      *flags |= SERD_HAS_NEWLINE;
-      break;
-    case '"':
-    case '\'':
-      *flags |= SERD_HAS_QUOTE;
-      break;
-    default:
-      break;
-    }
-    return push_byte(reader, dest, c);
-  }
-
-  return read_utf8_character(reader, dest, c);
-}
-
 // [10] comment ::= '#' ( [^#xA #xD] )*
 static void
 read_comment(SerdReader* reader)
@@ -338,6 +111,17 @@ read_STRING_LITERAL_LONG(SerdReader*    reader,
   SerdStatus st = SERD_SUCCESS;
 
   while (!(st && reader->strict)) {
+    const SerdStatus piece_st = check_literal_piece(reader, ref, flags);
+    if (piece_st) {
+      return piece_st;
+    }
+
+    const size_t run = peek_string_run(reader);
+    if (run) {
+      read_string_run(reader, ref, run);
+      continue;
+    }
+
     const int c = peek_byte(reader);
     if (c == '\\') {
       eat_byte_safe(reader, c);
@@ -365,49 +149,12 @@ read_STRING_LITERAL_LONG(SerdReader*    reader,
     }
   }
 
-  return (st && reader->strict) ? st : SERD_SUCCESS;
-}
-
-// STRING_LITERAL_QUOTE and STRING_LITERAL_SINGLE_QUOTE
-// Initial quote is already eaten by caller
-static SerdStatus
-read_STRING_LITERAL(SerdReader*    reader,
-                    Ref            ref,
-                    SerdNodeFlags* flags,
-                    uint8_t        q)
-{
-  SerdStatus st = SERD_SUCCESS;
-
-  while (!(st && reader->strict)) {
-    const int c    = peek_byte(reader);
-    uint32_t  code = 0;
-    switch (c) {
-    case EOF:
-      return r_err(
-        reader, SERD_ERR_BAD_SYNTAX, "end of file in short string\n");
-    case '\n':
-    case '\r':
-      return r_err(reader, SERD_ERR_BAD_SYNTAX, "line end in short string\n");
-    case '\\':
-      eat_byte_safe(reader, c);
-      if ((st = read_ECHAR(reader, ref, flags)) &&
-          (st = read_UCHAR(reader, ref, &code))) {
-        return r_err(reader, st, "invalid escape `\\%c'\n", peek_byte(reader));
-      }
-      break;
-    default:
-      if (c == q) {
-        eat_byte_check(reader, q);
-        return SERD_SUCCESS;
-      } else {
-        st =
-          read_character(reader, ref, flags, (uint8_t)eat_byte_safe(reader, c));
-      }
-    }
+  if (st && reader->strict) {
+    return st;
   }
 
-  return st ? st
-            : (eat_byte_check(reader, q) ? SERD_SUCCESS : SERD_ERR_BAD_SYNTAX);
+  return (*flags & SERD_IS_CHUNKED) ? emit_literal_piece(reader, ref, flags)
+                                    : SERD_SUCCESS;
 }
 
 static SerdStatus
@@ -435,26 +182,10 @@ read_String(SerdReader* reader, Ref node, SerdNodeFlags* flags)
     return SERD_SUCCESS;
   }
 
-  if (!fancy_syntax(reader)) {
-    return r_err(
-      reader, SERD_ERR_BAD_SYNTAX, "syntax does not support long literals\n");
-  }
-
   eat_byte_safe(reader, q3);
   return read_STRING_LITERAL_LONG(reader, node, flags, (uint8_t)q1);
 }
 
-static inline bool
-is_PN_CHARS_BASE(const uint32_t c)
-{
-  return ((c >= 0x00C0 && c <= 0x00D6) || (c >= 0x00D8 && c <= 0x00F6) ||
-          (c >= 0x00F8 && c <= 0x02FF) || (c >= 0x0370 && c <= 0x037D) ||
-          (c >= 0x037F && c <= 0x1FFF) || (c >= 0x200C && c <= 0x200D) ||
-          (c >= 0x2070 && c <= 0x218F) || (c >= 0x2C00 && c <= 0x2FEF) ||
-          (c >= 0x3001 && c <= 0xD7FF) || (c >= 0xF900 && c <= 0xFDCF) ||
-          (c >= 0xFDF0 && c <= 0xFFFD) || (c >= 0x10000 && c <= 0xEFFFF));
-}
-
 static SerdStatus
 read_PN_CHARS_BASE(SerdReader* reader, Ref dest)
 {
@@ -478,33 +209,6 @@ read_PN_CHARS_BASE(SerdReader* reader, Ref dest)
   return st;
 }
 
-static inline bool
-is_PN_CHARS(const uint32_t c)
-{
-  return (is_PN_CHARS_BASE(c) || c == 0xB7 || (c >= 0x0300 && c <= 0x036F) ||
-          (c >= 0x203F && c <= 0x2040));
-}
-
-static SerdStatus
-read_PN_CHARS(SerdReader* reader, Ref dest)
-{
-  uint32_t   code = 0;
-  const int  c    = peek_byte(reader);
-  SerdStatus st   = SERD_SUCCESS;
-  if (is_alpha(c) || is_digit(c) || c == '_' || c == '-') {
-    push_byte(reader, dest, eat_byte_safe(reader, c));
-  } else if (c == EOF || !(c & 0x80)) {
-    return SERD_FAILURE;
-  } else if ((st = read_utf8_code(
-                reader, dest, &code, (uint8_t)eat_byte_safe(reader, c)))) {
-    return st;
-  } else if (!is_PN_CHARS(code)) {
-    return r_err(
-      reader, SERD_ERR_BAD_SYNTAX, "invalid character U+%04X in name\n", code);
-  }
-  return st;
-}
-
 static SerdStatus
 read_PERCENT(SerdReader* reader, Ref dest)
 {
@@ -609,11 +313,9 @@ read_PN_LOCAL(SerdReader* reader, Ref dest, bool* ate_dot)
     trailing_unescaped_dot = (c == '.');
   }
 
-  SerdNode* const n = deref(reader, dest);
   if (trailing_unescaped_dot) {
     // Ate trailing dot, pop it from stack/node and inform caller
-    --n->n_bytes;
-    serd_stack_pop(&reader->stack, 1);
+    pop_byte(reader, dest);
     *ate_dot = true;
   }
 
@@ -651,62 +353,6 @@ read_PN_PREFIX(SerdReader* reader, Ref dest)
   return SERD_FAILURE;
 }
 
-static SerdStatus
-read_LANGTAG(SerdReader* reader, Ref* dest)
-{
-  int c = peek_byte(reader);
-  if (!is_alpha(c)) {
-    return r_err(reader, SERD_ERR_BAD_SYNTAX, "unexpected `%c'\n", c);
-  }
-
-  *dest = push_node(reader, SERD_LITERAL, "", 0);
-
-  SerdStatus st = SERD_SUCCESS;
-  TRY(st, push_byte(reader, *dest, eat_byte_safe(reader, c)));
-  while ((c = peek_byte(reader)) && is_alpha(c)) {
-    TRY(st, push_byte(reader, *dest, eat_byte_safe(reader, c)));
-  }
-
-  while (peek_byte(reader) == '-') {
-    TRY(st, push_byte(reader, *dest, eat_byte_safe(reader, '-')));
-    while ((c = peek_byte(reader)) && (is_alpha(c) || is_digit(c))) {
-      TRY(st, push_byte(reader, *dest, eat_byte_safe(reader, c)));
-    }
-  }
-
-  return SERD_SUCCESS;
-}
-
-static SerdStatus
-read_IRIREF_scheme(SerdReader* reader, Ref dest)
-{
-  int c = peek_byte(reader);
-  if (!is_alpha(c)) {
-    return r_err(reader, SERD_ERR_BAD_SYNTAX, "bad IRI scheme start `%c'\n", c);
-  }
-
-  while ((c = peek_byte(reader)) != EOF) {
-    if (c == '>') {
-      return r_err(reader, SERD_ERR_BAD_SYNTAX, "missing IRI scheme\n");
-    }
-
-    if (!is_uri_scheme_char(c)) {
-      return r_err(reader,
-                   SERD_ERR_BAD_SYNTAX,
-                   "bad IRI scheme char U+%04X (%c)\n",
-                   (unsigned)c,
-                   (char)c);
-    }
-
-    push_byte(reader, dest, eat_byte_safe(reader, c));
-    if (c == ':') {
-      return SERD_SUCCESS; // End of scheme
-    }
-  }
-
-  return r_err(reader, SERD_ERR_BAD_SYNTAX, "unexpected end of file\n");
-}
-
 static SerdStatus
 read_IRIREF(SerdReader* reader, Ref* dest)
 {
@@ -715,81 +361,7 @@ read_IRIREF(SerdReader* reader, Ref* dest)
   }
 
   *dest = push_node(reader, SERD_URI, "", 0);
-
-  if (!fancy_syntax(reader) && read_IRIREF_scheme(reader, *dest)) {
-    *dest = pop_node(reader, *dest);
-    return r_err(reader, SERD_ERR_BAD_SYNTAX, "expected IRI scheme\n");
-  }
-
-  SerdStatus st   = SERD_SUCCESS;
-  uint32_t   code = 0;
-  while (!st) {
-    const int c = eat_byte_safe(reader, peek_byte(reader));
-    switch (c) {
-    case '"':
-    case '<':
-      *dest = pop_node(reader, *dest);
-      return r_err(
-        reader, SERD_ERR_BAD_SYNTAX, "invalid IRI character `%c'\n", c);
-
-    case '>':
-      return SERD_SUCCESS;
-
-    case '\\':
-      if (read_UCHAR(reader, *dest, &code)) {
-        *dest = pop_node(reader, *dest);
-        return r_err(reader, SERD_ERR_BAD_SYNTAX, "invalid IRI escape\n");
-      }
-
-      switch (code) {
-      case 0:
-      case ' ':
-      case '<':
-      case '>':
-        *dest = pop_node(reader, *dest);
-        return r_err(reader,
-                     SERD_ERR_BAD_SYNTAX,
-                     "invalid escaped IRI character U+%04X\n",
-                     code);
-      default:
-        break;
-      }
-      break;
-
-    case '^':
-    case '`':
-    case '{':
-    case '|':
-    case '}':
-      *dest = pop_node(reader, *dest);
-      return r_err(
-        reader, SERD_ERR_BAD_SYNTAX, "invalid IRI character `%c'\n", c);
-
-    default:
-      if (c <= 0x20) {
-        r_err(reader,
-              SERD_ERR_BAD_SYNTAX,
-              "invalid IRI character (escape %%%02X)\n",
-              (unsigned)c);
-        if (reader->strict) {
-          *dest = pop_node(reader, *dest);
-          return SERD_ERR_BAD_SYNTAX;
-        }
-        st = SERD_FAILURE;
-        push_byte(reader, *dest, c);
-      } else if (!(c & 0x80)) {
-        push_byte(reader, *dest, c);
-      } else if (read_utf8_character(reader, *dest, (uint8_t)c)) {
-        if (reader->strict) {
-          *dest = pop_node(reader, *dest);
-          return SERD_ERR_BAD_SYNTAX;
-        }
-      }
-    }
-  }
-
-  *dest = pop_node(reader, *dest);
-  return st;
+  return read_IRIREF_suffix(reader, dest);
 }
 
 static SerdStatus
@@ -974,57 +546,14 @@ read_verb(SerdReader* reader, Ref* dest)
   return SERD_SUCCESS;
 }
 
+// Read a BLANK_NODE_LABEL, and prevent clashes with generated IDs
 static SerdStatus
-read_BLANK_NODE_LABEL(SerdReader* reader, Ref* dest, bool* ate_dot)
+read_blankNodeLabel(SerdReader* reader, Ref* dest, bool* ate_dot)
 {
-  eat_byte_safe(reader, '_');
-  eat_byte_check(reader, ':');
-
-  const Ref ref = *dest =
-    push_node(reader,
-              SERD_BLANK,
-              reader->bprefix ? (char*)reader->bprefix : "",
-              reader->bprefix_len);
-
-  int c = peek_byte(reader); // First: (PN_CHARS | '_' | [0-9])
-  if (is_digit(c) || c == '_') {
-    push_byte(reader, ref, eat_byte_safe(reader, c));
-  } else if (read_PN_CHARS(reader, ref)) {
-    *dest = pop_node(reader, *dest);
-    return r_err(reader, SERD_ERR_BAD_SYNTAX, "invalid name start\n");
-  }
-
-  while ((c = peek_byte(reader))) { // Middle: (PN_CHARS | '.')*
-    if (c == '.') {
-      push_byte(reader, ref, eat_byte_safe(reader, c));
-    } else if (read_PN_CHARS(reader, ref)) {
-      break;
-    }
-  }
-
-  SerdNode* n = deref(reader, ref);
-  if (n->buf[n->n_bytes - 1] == '.' && read_PN_CHARS(reader, ref)) {
-    // Ate trailing dot, pop it from stack/node and inform caller
-    --n->n_bytes;
-    serd_stack_pop(&reader->stack, 1);
-    *ate_dot = true;
-  }
-
-  if (fancy_syntax(reader)) {
-    if (is_digit(n->buf[reader->bprefix_len + 1])) {
-      if ((n->buf[reader->bprefix_len]) == 'b') {
-        ((char*)n->buf)[reader->bprefix_len] = 'B'; // Prevent clash
-        reader->seen_genid                   = true;
-      } else if (reader->seen_genid && n->buf[reader->bprefix_len] == 'B') {
-        *dest = pop_node(reader, *dest);
-        return r_err(reader,
-                     SERD_ERR_ID_CLASH,
-                     "found both `b' and `B' blank IDs, prefix required\n");
-      }
-    }
-  }
+  SerdStatus st = SERD_SUCCESS;
+  TRY(st, read_BLANK_NODE_LABEL(reader, dest, ate_dot));
 
-  return SERD_SUCCESS;
+  return rename_blank_label(reader, dest);
 }
 
 static Ref
@@ -1046,8 +575,8 @@ read_blankName(SerdReader* reader)
 static SerdStatus
 read_anon(SerdReader* reader, ReadContext ctx, bool subject, Ref* dest)
 {
-  const SerdStatementFlags old_flags = *ctx.flags;
-  bool                     empty     = false;
+  SerdStatementFlags old_flags = *ctx.flags;
+  bool               empty     = false;
   eat_byte_safe(reader, '[');
   if ((empty = peek_delim(reader, ']'))) {
     *ctx.flags |= (subject) ? SERD_EMPTY_S : SERD_EMPTY_O;
@@ -1066,7 +595,10 @@ read_anon(SerdReader* reader, ReadContext ctx, bool subject, Ref* dest)
 
   SerdStatus st = SERD_SUCCESS;
   if (ctx.subject) {
-    TRY(st, emit_statement(reader, ctx, *dest, 0, 0));
+    // If a filter rejects everything inside, this is written as empty
+    TRY(st,
+        reader->filter ? defer_statement(reader, ctx, *dest)
+                       : emit_statement(reader, ctx, *dest, 0, 0));
   }
 
   ctx.subject = *dest;
@@ -1078,12 +610,25 @@ read_anon(SerdReader* reader, ReadContext ctx, bool subject, Ref* dest)
 
     bool ate_dot_in_list = false;
     read_predicateObjectList(reader, ctx, &ate_dot_in_list);
+
+    // Check if every statement in the node was filtered out
+    if (reader->deferred.object == *dest) {
+      empty = true;
+      reader->deferred_flags &= ~(unsigned)SERD_ANON_O_BEGIN;
+      reader->deferred_flags |= SERD_EMPTY_O;
+      TRY(st, emit_deferred(reader));
+    } else if (subject && (*ctx.flags & SERD_ANON_S_BEGIN)) {
+      empty = true;
+      old_flags |= SERD_EMPTY_S;
+    }
+
     if (ate_dot_in_list) {
       return r_err(reader, SERD_ERR_BAD_SYNTAX, "`.' inside blank\n");
     }
 
     read_ws_star(reader);
-    if (reader->end_sink) {
+    if (!empty && reader->end_sink && !reader->validate_only) {
+      TRY(st, flush_batch(reader));
       reader->end_sink(reader->handle, deref(reader, *dest));
     }
 
@@ -1116,17 +661,6 @@ read_object(SerdReader* reader, ReadContext* ctx, bool emit, bool* ate_dot)
   Ref       lang     = 0;
   uint32_t  flags    = 0;
   const int c        = peek_byte(reader);
-  if (!fancy_syntax(reader)) {
-    switch (c) {
-    case '"':
-    case ':':
-    case '<':
-    case '_':
-      break;
-    default:
-      return r_err(reader, SERD_ERR_BAD_SYNTAX, "expected: ':', '<', or '_'\n");
-    }
-  }
   switch (c) {
   case EOF:
   case ')':
@@ -1140,7 +674,7 @@ read_object(SerdReader* reader, ReadContext* ctx, bool emit, bool* ate_dot)
     ret    = read_collection(reader, *ctx, &o);
     break;
   case '_':
-    ret = read_BLANK_NODE_LABEL(reader, &o, ate_dot);
+    ret = read_blankNodeLabel(reader, &o, ate_dot);
     break;
   case '<':
   case ':':
@@ -1163,6 +697,7 @@ read_object(SerdReader* reader, ReadContext* ctx, bool emit, bool* ate_dot)
     break;
   case '\"':
   case '\'':
+    reader->literal_ctx = ctx;
     ret = read_literal(reader, &o, &datatype, &lang, &flags, ate_dot);
     break;
   default:
@@ -1216,11 +751,6 @@ read_objectList(SerdReader* reader, ReadContext ctx, bool* ate_dot)
 {
   SerdStatus st = SERD_SUCCESS;
   TRY(st, read_object(reader, &ctx, true, ate_dot));
-  if (!fancy_syntax(reader) && peek_delim(reader, ',')) {
-    return r_err(
-      reader, SERD_ERR_BAD_SYNTAX, "syntax does not support abbreviation\n");
-  }
-
   while (!*ate_dot && eat_delim(reader, ',')) {
     st = read_object(reader, &ctx, true, ate_dot);
   }
@@ -1228,12 +758,152 @@ read_objectList(SerdReader* reader, ReadContext ctx, bool* ate_dot)
   return st;
 }
 
+// Skip a quoted string without reading it
+static SerdStatus
+skip_String(SerdReader* reader)
+{
+  const int q        = eat_byte_safe(reader, peek_byte(reader));
+  bool      is_long  = false;
+  unsigned  n_quotes = 0u;
+  if (peek_byte(reader) == q) {
+    eat_byte_safe(reader, q);
+    if (peek_byte(reader) != q) {
+      return SERD_SUCCESS; // Empty string
+    }
+
+    eat_byte_safe(reader, q);
+    is_long = true;
+  }
+
+  while (true) {
+    const size_t run = peek_string_run(reader);
+    if (run) {
+      serd_byte_source_skip(&reader->source, run);
+      n_quotes = 0u;
+      continue;
+    }
+
+    const int c = peek_byte(reader);
+    if (c == EOF) {
+      return r_err(reader, SERD_ERR_BAD_SYNTAX, "end of file in string\n");
+    }
+
+    if (!is_long && (c == '\n' || c == '\r')) {
+      return r_err(reader, SERD_ERR_BAD_SYNTAX, "line end in short string\n");
+    }
+
+    eat_byte_safe(reader, c);
+    if (c == '\\') {
+      n_quotes = 0u;
+      if (peek_byte(reader) != EOF) {
+        eat_byte_safe(reader, peek_byte(reader));
+      }
+    } else if (c != q) {
+      n_quotes = 0u;
+    } else if (!is_long || ++n_quotes == 3u) {
+      return SERD_SUCCESS;
+    }
+  }
+}
+
+// Skip an IRI reference without reading it
+static SerdStatus
+skip_IRIREF(SerdReader* reader)
+{
+  eat_byte_safe(reader, '<');
+  for (int c = 0; (c = peek_byte(reader)) != '>';) {
+    const size_t run = peek_iri_run(reader);
+    if (run) {
+      serd_byte_source_skip(&reader->source, run);
+    } else if (c == EOF || c == '\n') {
+      return r_err(reader, SERD_ERR_BAD_SYNTAX, "unexpected end of IRI\n");
+    } else {
+      eat_byte_safe(reader, c);
+    }
+  }
+
+  eat_byte_safe(reader, '>');
+  return SERD_SUCCESS;
+}
+
+static inline bool
+is_name_byte(const int c)
+{
+  return is_alpha(c) || is_digit(c) || c == '_' || c == '-' || c == ':' ||
+         c == '%' || c >= 0x80;
+}
+
+/**
+   Skip the objects of a predicate that was rejected by the filter.
+
+   This scans to the end of the object list without reading any nodes, so any
+   statements in anonymous nodes or collections in the objects are skipped as
+   well.
+*/
+static SerdStatus
+skip_objectList(SerdReader* reader, bool* ate_dot)
+{
+  SerdStatus st    = SERD_SUCCESS;
+  unsigned   depth = 0u;
+  for (int c = 0; (c = peek_byte(reader)) != EOF;) {
+    switch (c) {
+    case '"':
+    case '\'':
+      TRY(st, skip_String(reader));
+      continue;
+    case '<':
+      TRY(st, skip_IRIREF(reader));
+      continue;
+    case '#':
+      read_comment(reader);
+      continue;
+    case '\\':
+      eat_byte_safe(reader, c);
+      if (peek_byte(reader) != EOF) {
+        eat_byte_safe(reader, peek_byte(reader));
+      }
+      continue;
+    case '[':
+    case '(':
+      ++depth;
+      break;
+    case ']':
+    case ')':
+      if (!depth--) {
+        return SERD_SUCCESS;
+      }
+      break;
+    case ';':
+    case '}':
+      if (!depth) {
+        return SERD_SUCCESS;
+      }
+      break;
+    case '.':
+      eat_byte_safe(reader, c);
+      if (!depth && !is_name_byte(peek_byte(reader))) {
+        *ate_dot = true; // End of statement, not a dot in a name or number
+        return SERD_SUCCESS;
+      }
+      continue;
+    default:
+      break;
+    }
+
+    eat_byte_safe(reader, c);
+  }
+
+  return SERD_SUCCESS;
+}
+
 static SerdStatus
 read_predicateObjectList(SerdReader* reader, ReadContext ctx, bool* ate_dot)
 {
   SerdStatus st = SERD_SUCCESS;
   while (!(st = read_verb(reader, &ctx.predicate)) && read_ws_star(reader) &&
-         !(st = read_objectList(reader, ctx, ate_dot))) {
+         !(st = filter_accepts(reader, ctx)
+                  ? read_objectList(reader, ctx, ate_dot)
+                  : skip_objectList(reader, ate_dot))) {
     ctx.predicate = pop_node(reader, ctx.predicate);
     if (*ate_dot) {
       return SERD_SUCCESS;
@@ -1357,7 +1027,7 @@ read_subject(SerdReader* reader, ReadContext ctx, Ref* dest, int* s_type)
     st = read_collection(reader, ctx, dest);
     break;
   case '_':
-    st = read_BLANK_NODE_LABEL(reader, dest, &ate_dot);
+    st = read_blankNodeLabel(reader, dest, &ate_dot);
     break;
   default:
     st = read_iri(reader, dest, &ate_dot);
@@ -1385,7 +1055,7 @@ read_labelOrSubject(SerdReader* reader, Ref* dest)
     *dest = blank_id(reader);
     return SERD_SUCCESS;
   case '_':
-    return read_BLANK_NODE_LABEL(reader, dest, &ate_dot);
+    return read_blankNodeLabel(reader, dest, &ate_dot);
   default:
     if (!read_iri(reader, dest, &ate_dot)) {
       return SERD_SUCCESS;
@@ -1427,7 +1097,8 @@ read_base(SerdReader* reader, bool sparql, bool token)
 
   Ref uri = 0;
   TRY(st, read_IRIREF(reader, &uri));
-  if (reader->base_sink) {
+  if (reader->base_sink && !reader->validate_only) {
+    TRY(st, flush_batch(reader));
     TRY(st, reader->base_sink(reader->handle, deref(reader, uri)));
   }
   pop_node(reader, uri);
@@ -1467,7 +1138,10 @@ read_prefixID(SerdReader* reader, bool sparql, bool token)
   Ref uri = 0;
   TRY(st, read_IRIREF(reader, &uri));
 
-  if (reader->prefix_sink) {
+  if (reader->validate_only) {
+    st = serd_env_set_prefix(
+      reader->prefixes, deref(reader, name), deref(reader, uri));
+  } else if (reader->prefix_sink && !(st = flush_batch(reader))) {
     st = reader->prefix_sink(
       reader->handle, deref(reader, name), deref(reader, uri));
   }
@@ -1575,10 +1249,6 @@ read_n3_statement(SerdReader* reader)
   case EOF:
     return SERD_FAILURE;
   case '@':
-    if (!fancy_syntax(reader)) {
-      return r_err(
-        reader, SERD_ERR_BAD_SYNTAX, "syntax does not support directives\n");
-    }
     TRY(st, read_directive(reader));
     read_ws_star(reader);
     break;
@@ -1642,79 +1312,36 @@ read_n3_statement(SerdReader* reader)
 static void
 skip_until(SerdReader* reader, uint8_t byte)
 {
-  for (int c = 0; (c = peek_byte(reader)) && c != byte;) {
+  for (int c = 0; (c = peek_byte(reader)) > 0 && c != byte;) {
     eat_byte_safe(reader, c);
   }
 }
 
 SerdStatus
-read_turtleTrigDoc(SerdReader* reader)
+read_turtleTrigStatement(SerdReader* reader)
 {
-  while (!reader->source.eof) {
-    const SerdStatus st = read_n3_statement(reader);
-    if (st > SERD_FAILURE) {
-      if (reader->strict) {
-        return st;
-      }
-      skip_until(reader, '\n');
+  const SerdStatus st = read_n3_statement(reader);
+  if (st > SERD_FAILURE) {
+    if (reader->strict) {
+      return st;
     }
+    ++reader->stats.n_recoveries;
+    skip_until(reader, '\n');
   }
 
   return SERD_SUCCESS;
 }
 
 SerdStatus
-read_nquadsDoc(SerdReader* reader)
+read_turtleTrigDoc(SerdReader* reader)
 {
-  SerdStatus st = SERD_SUCCESS;
   while (!reader->source.eof) {
-    SerdStatementFlags flags   = 0;
-    ReadContext        ctx     = {0, 0, 0, 0, 0, 0, &flags};
-    bool               ate_dot = false;
-    int                s_type  = 0;
-    read_ws_star(reader);
-    if (peek_byte(reader) == EOF) {
-      break;
-    }
-
-    if (peek_byte(reader) == '@') {
-      return r_err(
-        reader, SERD_ERR_BAD_SYNTAX, "syntax does not support directives\n");
-    }
-
-    // subject predicate object
-    if ((st = read_subject(reader, ctx, &ctx.subject, &s_type)) ||
-        !read_ws_star(reader) || (st = read_IRIREF(reader, &ctx.predicate)) ||
-        !read_ws_star(reader) ||
-        (st = read_object(reader, &ctx, false, &ate_dot))) {
+    const SerdStatus st = read_turtleTrigStatement(reader);
+    if (st) {
       return st;
     }
-
-    if (!ate_dot) { // graphLabel?
-      read_ws_star(reader);
-      switch (peek_byte(reader)) {
-      case '.':
-        break;
-      case '_':
-        TRY(st, read_BLANK_NODE_LABEL(reader, &ctx.graph, &ate_dot));
-        break;
-      default:
-        TRY(st, read_IRIREF(reader, &ctx.graph));
-      }
-
-      // Terminating '.'
-      read_ws_star(reader);
-      if (!eat_byte_check(reader, '.')) {
-        return SERD_ERR_BAD_SYNTAX;
-      }
-    }
-
-    TRY(st, emit_statement(reader, ctx, ctx.object, ctx.datatype, ctx.lang));
-
-    pop_node(reader, ctx.graph);
-    pop_node(reader, ctx.lang);
-    pop_node(reader, ctx.datatype);
-    pop_node(reader, ctx.object);
   }
+
   return SERD_SUCCESS;
 }
+
@@ -17,12 +17,13 @@
 #include "node.h"
 
 #include "base64.h"
+#include "number.h"
+#include "serd_internal.h"
 #include "string_utils.h"
 
 #include "serd/serd.h"
 
 #include <assert.h>
-#include <float.h>
 #include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -39,6 +40,29 @@
 #  endif
 #endif
 
+/// Allocate `size` bytes for a node from `arena`, or with malloc() if null
+static void*
+alloc_buf(SerdArena* const arena, const size_t size)
+{
+  return arena ? serd_arena_alloc(arena, size) : malloc(size);
+}
+
+/// Like alloc_buf(), but sets the allocated memory to zero
+static void*
+calloc_buf(SerdArena* const arena, const size_t size)
+{
+  if (!arena) {
+    return calloc(size, 1);
+  }
+
+  void* const ptr = serd_arena_alloc(arena, size);
+  if (ptr) {
+    memset(ptr, 0, size);
+  }
+
+  return ptr;
+}
+
 SerdNode
 serd_node_from_string(SerdType type, const uint8_t* str)
 {
@@ -70,13 +94,19 @@ serd_node_from_substring(SerdType type, const uint8_t* str, const size_t len)
 
 SerdNode
 serd_node_copy(const SerdNode* node)
+{
+  return serd_node_copy_in(NULL, node);
+}
+
+SerdNode
+serd_node_copy_in(SerdArena* arena, const SerdNode* node)
 {
   if (!node || !node->buf) {
     return SERD_NODE_NULL;
   }
 
   SerdNode copy = *node;
-  uint8_t* buf  = (uint8_t*)malloc(copy.n_bytes + 1);
+  uint8_t* buf  = (uint8_t*)alloc_buf(arena, copy.n_bytes + 1);
   memcpy(buf, node->buf, copy.n_bytes + 1);
   copy.buf = buf;
   return copy;
@@ -134,15 +164,25 @@ SerdNode
 serd_node_new_uri_from_string(const uint8_t* str,
                               const SerdURI* base,
                               SerdURI*       out)
+{
+  return serd_node_new_uri_from_string_in(NULL, str, base, out);
+}
+
+SerdNode
+serd_node_new_uri_from_string_in(SerdArena*     arena,
+                                 const uint8_t* str,
+                                 const SerdURI* base,
+                                 SerdURI*       out)
 {
   if (!str || str[0] == '\0') {
     // Empty URI => Base URI, or nothing if no base is given
-    return base ? serd_node_new_uri(base, NULL, out) : SERD_NODE_NULL;
+    return base ? serd_node_new_uri_in(arena, base, NULL, out)
+                : SERD_NODE_NULL;
   }
 
   SerdURI uri;
   serd_uri_parse(str, &uri);
-  return serd_node_new_uri(&uri, base, out); // Resolve/Serialise
+  return serd_node_new_uri_in(arena, &uri, base, out); // Resolve/Serialise
 }
 
 static inline bool
@@ -234,6 +274,15 @@ serd_node_new_file_uri(const uint8_t* path,
 
 SerdNode
 serd_node_new_uri(const SerdURI* uri, const SerdURI* base, SerdURI* out)
+{
+  return serd_node_new_uri_in(NULL, uri, base, out);
+}
+
+SerdNode
+serd_node_new_uri_in(SerdArena*     arena,
+                     const SerdURI* uri,
+                     const SerdURI* base,
+                     SerdURI*       out)
 {
   SerdURI abs_uri = *uri;
   if (base) {
@@ -241,7 +290,7 @@ serd_node_new_uri(const SerdURI* uri, const SerdURI* base, SerdURI* out)
   }
 
   const size_t len        = serd_uri_string_length(&abs_uri);
-  uint8_t*     buf        = (uint8_t*)malloc(len + 1);
+  uint8_t*     buf        = (uint8_t*)alloc_buf(arena, len + 1);
   SerdNode     node       = {buf, 0, 0, 0, SERD_URI};
   uint8_t*     ptr        = buf;
   const size_t actual_len = serd_uri_serialise(&abs_uri, string_sink, &ptr);
@@ -262,10 +311,20 @@ serd_node_new_relative_uri(const SerdURI* uri,
                            const SerdURI* base,
                            const SerdURI* root,
                            SerdURI*       out)
+{
+  return serd_node_new_relative_uri_in(NULL, uri, base, root, out);
+}
+
+SerdNode
+serd_node_new_relative_uri_in(SerdArena*     arena,
+                              const SerdURI* uri,
+                              const SerdURI* base,
+                              const SerdURI* root,
+                              SerdURI*       out)
 {
   const size_t uri_len  = serd_uri_string_length(uri);
   const size_t base_len = serd_uri_string_length(base);
-  uint8_t*     buf      = (uint8_t*)malloc(uri_len + base_len + 1);
+  uint8_t*     buf      = (uint8_t*)alloc_buf(arena, uri_len + base_len + 1);
   SerdNode     node     = {buf, 0, 0, 0, SERD_URI};
   uint8_t*     ptr      = buf;
   const size_t actual_len =
@@ -282,75 +341,182 @@ serd_node_new_relative_uri(const SerdURI* uri,
   return node;
 }
 
-static inline unsigned
-serd_digits(double abs)
+SerdNode
+serd_node_new_decimal(double d, unsigned frac_digits)
+{
+  return serd_node_new_decimal_in(NULL, d, frac_digits);
+}
+
+/**
+   Round `digits` to `n_kept` digits, with ties away from zero.
+
+   @return The number of digits left after removing trailing zeros, where 0
+   means the number rounded to zero.
+*/
+static unsigned
+round_digits(char* const    digits,
+             const unsigned n_digits,
+             const int      n_kept,
+             int* const     exponent)
 {
-  const double lg = ceil(log10(floor(abs) + 1.0));
-  return lg < 1.0 ? 1U : (unsigned)lg;
+  if (n_kept < 0 || (unsigned)n_kept >= n_digits) {
+    return n_kept < 0 ? 0u : n_digits;
+  }
+
+  unsigned n = (unsigned)n_kept;
+  if (digits[n] >= '5') {
+    // Carry into the kept digits, which may all become zero
+    unsigned i = n;
+    for (; i > 0u && digits[i - 1u] == '9'; --i) {
+    }
+
+    if (!i) {
+      digits[0] = '1';
+      ++*exponent;
+      return 1u;
+    }
+
+    ++digits[i - 1u];
+    n = i;
+  }
+
+  while (n > 0u && digits[n - 1u] == '0') {
+    --n;
+  }
+
+  return n;
 }
 
 SerdNode
-serd_node_new_decimal(double d, unsigned frac_digits)
+serd_node_new_decimal_in(SerdArena* arena, double d, unsigned frac_digits)
 {
   if (isnan(d) || isinf(d)) {
     return SERD_NODE_NULL;
   }
 
-  const double   abs_d      = fabs(d);
-  const unsigned int_digits = serd_digits(abs_d);
-  char*          buf        = (char*)calloc(int_digits + frac_digits + 3, 1);
-  SerdNode       node       = {(const uint8_t*)buf, 0, 0, 0, SERD_LITERAL};
-  const double   int_part   = floor(abs_d);
+  // Get the shortest digits, rounded to at most frac_digits after the point
+  char     digits[SERD_DOUBLE_DIGITS];
+  int      exponent = 0;
+  unsigned n_digits = 0u;
+  if (d != 0.0) {
+    n_digits = serd_double_digits(fabs(d), digits, &exponent);
+    n_digits = round_digits(
+      digits, n_digits, exponent + 1 + (int)frac_digits, &exponent);
+  }
+
+  // Find the decimal point and the number of zeros after it before the digits
+  const bool     big        = n_digits && exponent >= 0;
+  const bool     small      = n_digits && exponent < 0;
+  const unsigned point      = big ? (unsigned)exponent + 1u : 0u;
+  const unsigned lead_zeros = small ? (unsigned)(-exponent - 1) : 0u;
+  const unsigned n_frac     = n_digits > point ? n_digits - point : 0u;
+
+  // Sign, integer part, point, and fractional part
+  const size_t len  = 1u + (big ? point : 1u) + 1u + lead_zeros + n_frac + 1u;
+  char*        buf  = (char*)calloc_buf(arena, len + 1u);
+  SerdNode     node = {(const uint8_t*)buf, 0, 0, 0, SERD_LITERAL};
+  char*        s    = buf;
 
-  // Point s to decimal point location
-  char* s = buf + int_digits;
   if (d < 0.0) {
-    *buf = '-';
-    ++s;
+    *s++ = '-';
   }
 
-  // Write integer part (right to left)
-  char*    t   = s - 1;
-  uint64_t dec = (uint64_t)int_part;
-  do {
-    *t-- = (char)('0' + dec % 10);
-  } while ((dec /= 10) > 0);
+  // Write the integer part, padded with zeros if the digits end before it
+  if (point) {
+    const unsigned n_int = n_digits < point ? n_digits : point;
+    memcpy(s, digits, n_int);
+    memset(s + n_int, '0', point - n_int);
+    s += point;
+  } else {
+    *s++ = '0';
+  }
 
+  // Write the fractional part, or a single zero if there is none
   *s++ = '.';
-
-  // Write fractional part (right to left)
-  double frac_part = fabs(d - int_part);
-  if (frac_part < DBL_EPSILON) {
-    *s++         = '0';
-    node.n_bytes = node.n_chars = (size_t)(s - buf);
+  if (n_frac) {
+    memset(s, '0', lead_zeros);
+    memcpy(s + lead_zeros, digits + point, n_frac);
+    s += lead_zeros + n_frac;
   } else {
-    uint64_t frac = (uint64_t)llround(frac_part * pow(10.0, (int)frac_digits));
-    s += frac_digits - 1;
-    unsigned i = 0;
+    *s++ = '0';
+  }
 
-    // Skip trailing zeros
-    for (; i < frac_digits - 1 && !(frac % 10); ++i, --s, frac /= 10) {
-    }
+  node.n_bytes = node.n_chars = (size_t)(s - buf);
+  return node;
+}
 
-    node.n_bytes = node.n_chars = (size_t)(s - buf) + 1u;
+SerdNode
+serd_node_new_double(double d)
+{
+  return serd_node_new_double_in(NULL, d);
+}
 
-    // Write digits from last trailing zero to decimal point
-    for (; i < frac_digits; ++i) {
-      *s-- = (char)('0' + (frac % 10));
-      frac /= 10;
-    }
+SerdNode
+serd_node_new_double_in(SerdArena* arena, double d)
+{
+  // Sign, digits, point, exponent marker and sign, and up to 3 exponent digits
+  char*    buf  = (char*)calloc_buf(arena, SERD_DOUBLE_DIGITS + 8u);
+  SerdNode node = {(const uint8_t*)buf, 0, 0, 0, SERD_LITERAL};
+
+  if (isnan(d)) {
+    memcpy(buf, "NaN", 3);
+    node.n_bytes = node.n_chars = 3;
+    return node;
+  }
+
+  char* s = buf;
+  if (signbit(d)) {
+    *s++ = '-';
+  }
+
+  if (isinf(d)) {
+    memcpy(s, "INF", 3);
+    node.n_bytes = node.n_chars = (size_t)(s + 3 - buf);
+    return node;
+  }
+
+  char     digits[SERD_DOUBLE_DIGITS] = {'0'};
+  int      exponent                   = 0;
+  unsigned n_digits                   = 1u;
+  if (d != 0.0) {
+    n_digits = serd_double_digits(fabs(d), digits, &exponent);
   }
 
+  // Write the significand with one digit before the point, like "1.25"
+  *s++ = digits[0];
+  *s++ = '.';
+  if (n_digits > 1u) {
+    memcpy(s, digits + 1, n_digits - 1u);
+    s += n_digits - 1u;
+  } else {
+    *s++ = '0';
+  }
+
+  // Write the exponent, like "E3" or "E-12"
+  const int n =
+    snprintf(s, SERD_DOUBLE_DIGITS + 8u - (size_t)(s - buf), "E%d", exponent);
+
+  node.n_bytes = node.n_chars = (size_t)(s + n - buf);
   return node;
 }
 
 SerdNode
 serd_node_new_integer(int64_t i)
 {
-  uint64_t       abs_i  = (i < 0) ? -i : i;
-  const unsigned digits = serd_digits((double)abs_i);
-  char*          buf    = (char*)calloc(digits + 2, 1);
-  SerdNode       node   = {(const uint8_t*)buf, 0, 0, 0, SERD_LITERAL};
+  return serd_node_new_integer_in(NULL, i);
+}
+
+SerdNode
+serd_node_new_integer_in(SerdArena* arena, int64_t i)
+{
+  uint64_t abs_i  = (i < 0) ? (uint64_t)0 - (uint64_t)i : (uint64_t)i;
+  unsigned digits = 1u;
+  for (uint64_t rest = abs_i / 10u; rest; rest /= 10u) {
+    ++digits;
+  }
+
+  char*    buf  = (char*)calloc_buf(arena, digits + 2);
+  SerdNode node = {(const uint8_t*)buf, 0, 0, 0, SERD_LITERAL};
 
   // Point s to the end
   char* s = buf + digits - 1;
@@ -369,6 +535,127 @@ serd_node_new_integer(int64_t i)
   return node;
 }
 
+/// Return the type of number for the local name of an XSD datatype
+static SerdNumberType
+xsd_number_type(const char* const name)
+{
+  static const char* const integer_types[] = {"byte",
+                                              "int",
+                                              "integer",
+                                              "long",
+                                              "negativeInteger",
+                                              "nonNegativeInteger",
+                                              "nonPositiveInteger",
+                                              "positiveInteger",
+                                              "short",
+                                              "unsignedByte",
+                                              "unsignedInt",
+                                              "unsignedLong",
+                                              "unsignedShort"};
+
+  if (!strcmp(name, "decimal")) {
+    return SERD_NUMBER_DECIMAL;
+  }
+
+  if (!strcmp(name, "double") || !strcmp(name, "float")) {
+    return SERD_NUMBER_DOUBLE;
+  }
+
+  for (size_t i = 0u; i < sizeof(integer_types) / sizeof(char*); ++i) {
+    if (!strcmp(name, integer_types[i])) {
+      return SERD_NUMBER_INTEGER;
+    }
+  }
+
+  return SERD_NUMBER_NONE;
+}
+
+/// Parse an xsd:integer into `value`, or return false if it is invalid
+static bool
+parse_integer(const char* s, int64_t* const value)
+{
+  const bool negative = *s == '-';
+  if (*s == '-' || *s == '+') {
+    ++s;
+  }
+
+  if (!is_digit(*s)) {
+    return false;
+  }
+
+  // Accumulate the magnitude, which may be one more than INT64_MAX
+  const uint64_t limit     = (uint64_t)INT64_MAX + negative;
+  uint64_t       magnitude = 0u;
+  for (; is_digit(*s); ++s) {
+    const uint64_t digit = (uint64_t)(*s - '0');
+    if (magnitude > (limit - digit) / 10u) {
+      return false;
+    }
+
+    magnitude = magnitude * 10u + digit;
+  }
+
+  if (*s) {
+    return false;
+  }
+
+  *value = negative ? (int64_t)((uint64_t)0 - magnitude) : (int64_t)magnitude;
+  return true;
+}
+
+SerdNumber
+serd_node_get_number(const SerdNode* node, const SerdNode* datatype)
+{
+  static const size_t xsd_len = sizeof(NS_XSD) - 1;
+
+  SerdNumber number = {SERD_NUMBER_NONE, 0, 0.0};
+  if (!node || node->type != SERD_LITERAL || !node->buf || !datatype ||
+      datatype->type != SERD_URI || datatype->n_bytes <= xsd_len ||
+      strncmp((const char*)datatype->buf, NS_XSD, xsd_len)) {
+    return number;
+  }
+
+  const char* const    str = (const char*)node->buf;
+  const SerdNumberType type =
+    xsd_number_type((const char*)datatype->buf + xsd_len);
+  if (type == SERD_NUMBER_INTEGER) {
+    if (parse_integer(str, &number.integer)) {
+      number.type = type;
+      number.real = (double)number.integer;
+    }
+
+    return number;
+  }
+
+  if (type == SERD_NUMBER_DOUBLE) {
+    // Special values, which can't be written like other numbers
+    const char* const name = str + (*str == '-' || *str == '+');
+    if (!strcmp(name, "INF") || !strcmp(str, "NaN")) {
+      number.type = type;
+      number.real = *name == 'N' ? (double)NAN
+                    : *str == '-' ? -(double)INFINITY
+                                  : (double)INFINITY;
+      return number;
+    }
+  } else if (type != SERD_NUMBER_DECIMAL || strpbrk(str, "eE")) {
+    return number;
+  }
+
+  // Parse the whole string, which may not start with whitespace
+  const char* end = str;
+  if (!is_space(*str)) {
+    number.real = serd_parse_double(str, &end);
+  }
+
+  if (end != str && end == str + node->n_bytes) {
+    number.type = type;
+  } else {
+    number.real = 0.0;
+  }
+
+  return number;
+}
+
 SerdNode
 serd_node_new_blob(const void* buf, size_t size, bool wrap_lines)
 {
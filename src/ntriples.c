@@ -0,0 +1,802 @@
+/*
+  Copyright 2011-2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "ntriples.h"
+
+#include "attributes.h"
+#include "byte_source.h"
+#include "reader.h"
+#include "serd_internal.h"
+#include "stack.h"
+#include "string_utils.h"
+#include "uri_utils.h"
+
+#include "serd/serd.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRY(st, exp)      \
+  do {                    \
+    if (((st) = (exp))) { \
+      return (st);        \
+    }                     \
+  } while (0)
+
+/*
+  A reader for the line-based syntaxes, NTriples and NQuads.
+
+  These have one statement per line without any abbreviations, so they are
+  read by a simple parser that only handles what they allow, rather than the
+  Turtle grammar in n3.c.  The terminals that Turtle shares are defined here as
+  well, and are declared in ntriples.h.
+*/
+
+SerdStatus
+read_UCHAR(SerdReader* reader, Ref dest, uint32_t* char_code)
+{
+  const int b      = peek_byte(reader);
+  unsigned  length = 0;
+  switch (b) {
+  case 'U':
+    length = 8;
+    break;
+  case 'u':
+    length = 4;
+    break;
+  default:
+    return SERD_ERR_BAD_SYNTAX;
+  }
+
+  eat_byte_safe(reader, b);
+
+  uint8_t buf[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+  for (unsigned i = 0; i < length; ++i) {
+    if (!(buf[i] = read_HEX(reader))) {
+      return SERD_ERR_BAD_SYNTAX;
+    }
+  }
+
+  char*          endptr = NULL;
+  const uint32_t code   = (uint32_t)strtoul((const char*)buf, &endptr, 16);
+  assert(endptr == (char*)buf + length);
+
+  unsigned size = 0;
+  if (code < 0x00000080) {
+    size = 1;
+  } else if (code < 0x00000800) {
+    size = 2;
+  } else if (code < 0x00010000) {
+    size = 3;
+  } else if (code < 0x00110000) {
+    size = 4;
+  } else {
+    r_err(reader,
+          SERD_ERR_BAD_SYNTAX,
+          "unicode character 0x%X out of range\n",
+          code);
+    push_span(reader, dest, replacement_char, 3, 1);
+    *char_code = 0xFFFD;
+    return SERD_SUCCESS;
+  }
+
+  // Build output in buf
+  // (Note # of bytes = # of leading 1 bits in first byte)
+  uint32_t c = code;
+  switch (size) {
+  case 4:
+    buf[3] = (uint8_t)(0x80u | (c & 0x3Fu));
+    c >>= 6;
+    c |= (16 << 12); // set bit 4
+    /* fallthru */
+  case 3:
+    buf[2] = (uint8_t)(0x80u | (c & 0x3Fu));
+    c >>= 6;
+    c |= (32 << 6); // set bit 5
+    /* fallthru */
+  case 2:
+    buf[1] = (uint8_t)(0x80u | (c & 0x3Fu));
+    c >>= 6;
+    c |= 0xC0; // set bits 6 and 7
+    /* fallthru */
+  case 1:
+    buf[0] = (uint8_t)c;
+    /* fallthru */
+  default:
+    break;
+  }
+
+  push_span(reader, dest, buf, size, 1);
+  *char_code = code;
+  return SERD_SUCCESS;
+}
+
+SerdStatus
+read_ECHAR(SerdReader* reader, Ref dest, SerdNodeFlags* flags)
+{
+  const int c = peek_byte(reader);
+  switch (c) {
+  case 't':
+    eat_byte_safe(reader, 't');
+    push_byte(reader, dest, '\t');
+    return SERD_SUCCESS;
+  case 'b':
+    eat_byte_safe(reader, 'b');
+    push_byte(reader, dest, '\b');
+    return SERD_SUCCESS;
+  case 'n':
+    *flags |= SERD_HAS_NEWLINE;
+    eat_byte_safe(reader, 'n');
+    push_byte(reader, dest, '\n');
+    return SERD_SUCCESS;
+  case 'r':
+    *flags |= SERD_HAS_NEWLINE;
+    eat_byte_safe(reader, 'r');
+    push_byte(reader, dest, '\r');
+    return SERD_SUCCESS;
+  case 'f':
+    eat_byte_safe(reader, 'f');
+    push_byte(reader, dest, '\f');
+    return SERD_SUCCESS;
+  case '\\':
+  case '"':
+  case '\'':
+    push_byte(reader, dest, eat_byte_safe(reader, c));
+    return SERD_SUCCESS;
+  default:
+    return SERD_ERR_BAD_SYNTAX;
+  }
+}
+
+static inline SerdStatus
+bad_char(SerdReader* reader, const char* kind, uint8_t c)
+{
+  // Skip bytes until the next start byte
+  for (int b = peek_byte(reader); b != EOF && ((uint8_t)b & 0x80);) {
+    eat_byte_safe(reader, b);
+    b = peek_byte(reader);
+  }
+
+  r_err(reader, SERD_ERR_BAD_SYNTAX, "invalid UTF-8 %s 0x%X\n", kind, c);
+  return reader->strict ? SERD_ERR_BAD_SYNTAX : SERD_FAILURE;
+}
+
+static SerdStatus
+read_utf8_bytes(SerdReader* reader, uint8_t bytes[4], uint32_t* size, uint8_t c)
+{
+  *size = utf8_num_bytes(c);
+  if (*size <= 1 || *size > 4) {
+    return bad_char(reader, "start", c);
+  }
+
+  bytes[0] = c;
+  for (unsigned i = 1; i < *size; ++i) {
+    const int b = peek_byte(reader);
+    if (b == EOF || ((uint8_t)b & 0x80) == 0) {
+      return bad_char(reader, "continuation", (uint8_t)b);
+    }
+
+    eat_byte_safe(reader, b);
+    bytes[i] = (uint8_t)b;
+  }
+
+  return SERD_SUCCESS;
+}
+
+SerdStatus
+read_utf8_character(SerdReader* reader, Ref dest, uint8_t c)
+{
+  uint32_t   size     = 0;
+  uint8_t    bytes[4] = {0, 0, 0, 0};
+  SerdStatus st       = read_utf8_bytes(reader, bytes, &size, c);
+  if (st) {
+    push_span(reader, dest, replacement_char, 3, 1);
+  } else {
+    push_span(reader, dest, bytes, size, 1);
+  }
+
+  return st;
+}
+
+SerdStatus
+read_utf8_code(SerdReader* reader, Ref dest, uint32_t* code, uint8_t c)
+{
+  uint32_t   size     = 0;
+  uint8_t    bytes[4] = {0, 0, 0, 0};
+  SerdStatus st       = read_utf8_bytes(reader, bytes, &size, c);
+  if (st) {
+    push_span(reader, dest, replacement_char, 3, 1);
+    return st;
+  }
+
+  push_span(reader, dest, bytes, size, 1);
+  *code = parse_counted_utf8_char(bytes, size);
+  return st;
+}
+
+SerdStatus
+read_STRING_LITERAL(SerdReader*    reader,
+                    Ref            ref,
+                    SerdNodeFlags* flags,
+                    uint8_t        q)
+{
+  SerdStatus st = SERD_SUCCESS;
+
+  while (!(st && reader->strict)) {
+    const SerdStatus piece_st = check_literal_piece(reader, ref, flags);
+    if (piece_st) {
+      return piece_st;
+    }
+
+    const size_t run = peek_string_run(reader);
+    if (run) {
+      read_string_run(reader, ref, run);
+      continue;
+    }
+
+    const int c    = peek_byte(reader);
+    uint32_t  code = 0;
+    switch (c) {
+    case EOF:
+      return r_err(
+        reader, SERD_ERR_BAD_SYNTAX, "end of file in short string\n");
+    case '\n':
+    case '\r':
+      return r_err(reader, SERD_ERR_BAD_SYNTAX, "line end in short string\n");
+    case '\\':
+      eat_byte_safe(reader, c);
+      if ((st = read_ECHAR(reader, ref, flags)) &&
+          (st = read_UCHAR(reader, ref, &code))) {
+        return r_err(reader, st, "invalid escape `\\%c'\n", peek_byte(reader));
+      }
+      break;
+    default:
+      if (c == q) {
+        eat_byte_check(reader, q);
+        return (*flags & SERD_IS_CHUNKED)
+                 ? emit_literal_piece(reader, ref, flags)
+                 : SERD_SUCCESS;
+      } else {
+        st =
+          read_character(reader, ref, flags, (uint8_t)eat_byte_safe(reader, c));
+      }
+    }
+  }
+
+  return st ? st
+            : (eat_byte_check(reader, q) ? SERD_SUCCESS : SERD_ERR_BAD_SYNTAX);
+}
+
+static inline bool
+is_PN_CHARS(const uint32_t c)
+{
+  return (is_PN_CHARS_BASE(c) || c == 0xB7 || (c >= 0x0300 && c <= 0x036F) ||
+          (c >= 0x203F && c <= 0x2040));
+}
+
+SerdStatus
+read_PN_CHARS(SerdReader* reader, Ref dest)
+{
+  uint32_t   code = 0;
+  const int  c    = peek_byte(reader);
+  SerdStatus st   = SERD_SUCCESS;
+  if (is_alpha(c) || is_digit(c) || c == '_' || c == '-') {
+    push_byte(reader, dest, eat_byte_safe(reader, c));
+  } else if (c == EOF || !(c & 0x80)) {
+    return SERD_FAILURE;
+  } else if ((st = read_utf8_code(
+                reader, dest, &code, (uint8_t)eat_byte_safe(reader, c)))) {
+    return st;
+  } else if (!is_PN_CHARS(code)) {
+    return r_err(
+      reader, SERD_ERR_BAD_SYNTAX, "invalid character U+%04X in name\n", code);
+  }
+  return st;
+}
+
+SerdStatus
+read_LANGTAG(SerdReader* reader, Ref* dest)
+{
+  int c = peek_byte(reader);
+  if (!is_alpha(c)) {
+    return r_err(reader, SERD_ERR_BAD_SYNTAX, "unexpected `%c'\n", c);
+  }
+
+  *dest = push_node(reader, SERD_LITERAL, "", 0);
+
+  SerdStatus st = SERD_SUCCESS;
+  TRY(st, push_byte(reader, *dest, eat_byte_safe(reader, c)));
+  while ((c = peek_byte(reader)) && is_alpha(c)) {
+    TRY(st, push_byte(reader, *dest, eat_byte_safe(reader, c)));
+  }
+
+  while (peek_byte(reader) == '-') {
+    TRY(st, push_byte(reader, *dest, eat_byte_safe(reader, '-')));
+    while ((c = peek_byte(reader)) && (is_alpha(c) || is_digit(c))) {
+      TRY(st, push_byte(reader, *dest, eat_byte_safe(reader, c)));
+    }
+  }
+
+  return SERD_SUCCESS;
+}
+
+static SerdStatus
+read_IRIREF_scheme(SerdReader* reader, Ref dest)
+{
+  int c = peek_byte(reader);
+  if (!is_alpha(c)) {
+    return r_err(reader, SERD_ERR_BAD_SYNTAX, "bad IRI scheme start `%c'\n", c);
+  }
+
+  while ((c = peek_byte(reader)) != EOF) {
+    if (c == '>') {
+      return r_err(reader, SERD_ERR_BAD_SYNTAX, "missing IRI scheme\n");
+    }
+
+    if (!is_uri_scheme_char(c)) {
+      return r_err(reader,
+                   SERD_ERR_BAD_SYNTAX,
+                   "bad IRI scheme char U+%04X (%c)\n",
+                   (unsigned)c,
+                   (char)c);
+    }
+
+    push_byte(reader, dest, eat_byte_safe(reader, c));
+    if (c == ':') {
+      return SERD_SUCCESS; // End of scheme
+    }
+  }
+
+  return r_err(reader, SERD_ERR_BAD_SYNTAX, "unexpected end of file\n");
+}
+
+SerdStatus
+read_IRIREF_suffix(SerdReader* reader, Ref* dest)
+{
+  SerdStatus st   = SERD_SUCCESS;
+  uint32_t   code = 0;
+  while (!st) {
+    const size_t run = peek_iri_run(reader);
+    if (run) {
+      read_run(reader, *dest, run);
+      continue;
+    }
+
+    const int c = eat_byte_safe(reader, peek_byte(reader));
+    switch (c) {
+    case '"':
+    case '<':
+      *dest = pop_node(reader, *dest);
+      return r_err(
+        reader, SERD_ERR_BAD_SYNTAX, "invalid IRI character `%c'\n", c);
+
+    case '>':
+      return SERD_SUCCESS;
+
+    case '\\':
+      if (read_UCHAR(reader, *dest, &code)) {
+        *dest = pop_node(reader, *dest);
+        return r_err(reader, SERD_ERR_BAD_SYNTAX, "invalid IRI escape\n");
+      }
+
+      switch (code) {
+      case 0:
+      case ' ':
+      case '<':
+      case '>':
+        *dest = pop_node(reader, *dest);
+        return r_err(reader,
+                     SERD_ERR_BAD_SYNTAX,
+                     "invalid escaped IRI character U+%04X\n",
+                     code);
+      default:
+        break;
+      }
+      break;
+
+    case '^':
+    case '`':
+    case '{':
+    case '|':
+    case '}':
+      *dest = pop_node(reader, *dest);
+      return r_err(
+        reader, SERD_ERR_BAD_SYNTAX, "invalid IRI character `%c'\n", c);
+
+    default:
+      if (c <= 0x20) {
+        r_err(reader,
+              SERD_ERR_BAD_SYNTAX,
+              "invalid IRI character (escape %%%02X)\n",
+              (unsigned)c);
+        if (reader->strict) {
+          *dest = pop_node(reader, *dest);
+          return SERD_ERR_BAD_SYNTAX;
+        }
+        st = SERD_FAILURE;
+        push_byte(reader, *dest, c);
+      } else if (!(c & 0x80)) {
+        push_byte(reader, *dest, c);
+      } else if (read_utf8_character(reader, *dest, (uint8_t)c)) {
+        if (reader->strict) {
+          *dest = pop_node(reader, *dest);
+          return SERD_ERR_BAD_SYNTAX;
+        }
+      }
+    }
+  }
+
+  *dest = pop_node(reader, *dest);
+  return st;
+}
+
+// Read an IRIREF, which must be an absolute IRI in line syntaxes
+static SerdStatus
+read_IRIREF(SerdReader* reader, Ref* dest)
+{
+  if (!eat_byte_check(reader, '<')) {
+    return SERD_ERR_BAD_SYNTAX;
+  }
+
+  *dest = push_node(reader, SERD_URI, "", 0);
+
+  if (read_IRIREF_scheme(reader, *dest)) {
+    *dest = pop_node(reader, *dest);
+    return r_err(reader, SERD_ERR_BAD_SYNTAX, "expected IRI scheme\n");
+  }
+
+  return read_IRIREF_suffix(reader, dest);
+}
+
+SerdStatus
+read_BLANK_NODE_LABEL(SerdReader* reader, Ref* dest, bool* ate_dot)
+{
+  eat_byte_safe(reader, '_');
+  eat_byte_check(reader, ':');
+
+  const Ref ref = *dest =
+    push_node(reader,
+              SERD_BLANK,
+              reader->bprefix ? (char*)reader->bprefix : "",
+              reader->bprefix_len);
+
+  int c = peek_byte(reader); // First: (PN_CHARS | '_' | [0-9])
+  if (is_digit(c) || c == '_') {
+    push_byte(reader, ref, eat_byte_safe(reader, c));
+  } else if (read_PN_CHARS(reader, ref)) {
+    *dest = pop_node(reader, *dest);
+    return r_err(reader, SERD_ERR_BAD_SYNTAX, "invalid name start\n");
+  }
+
+  while ((c = peek_byte(reader))) { // Middle: (PN_CHARS | '.')*
+    if (c == '.') {
+      push_byte(reader, ref, eat_byte_safe(reader, c));
+    } else if (read_PN_CHARS(reader, ref)) {
+      break;
+    }
+  }
+
+  const SerdNode* const n = deref(reader, ref);
+  if (n->buf[n->n_bytes - 1] == '.' && read_PN_CHARS(reader, ref)) {
+    // Ate trailing dot, pop it from stack/node and inform caller
+    pop_byte(reader, ref);
+    *ate_dot = true;
+  }
+
+  return SERD_SUCCESS;
+}
+
+SerdStatus
+rename_blank_label(SerdReader* reader, Ref* dest)
+{
+  SerdNode* const n = deref(reader, *dest);
+  char* const     c = (char*)n->buf + reader->bprefix_len;
+  if (!is_digit(c[1])) {
+    return SERD_SUCCESS;
+  }
+
+  if (*c == 'b') {
+    *c                 = 'B'; // Prevent clash
+    reader->seen_genid = true;
+  } else if (*c == 'B') {
+    reader->seen_renamed = true;
+  } else {
+    return SERD_SUCCESS;
+  }
+
+  if (reader->seen_genid && reader->seen_renamed) {
+    *dest = pop_node(reader, *dest);
+    return r_err(reader,
+                 SERD_ERR_ID_CLASH,
+                 "found both `b' and `B' blank IDs, prefix required\n");
+  }
+
+  return SERD_SUCCESS;
+}
+
+// Read a BLANK_NODE_LABEL, renaming it if it may clash with another reader's
+static SerdStatus
+read_label(SerdReader* reader, Ref* dest, bool* ate_dot)
+{
+  SerdStatus st = SERD_SUCCESS;
+  TRY(st, read_BLANK_NODE_LABEL(reader, dest, ate_dot));
+  return reader->rename_labels ? rename_blank_label(reader, dest) : st;
+}
+
+// Skip to the end of the current line
+static void
+skip_line(SerdReader* reader)
+{
+  SerdByteSource* const source = &reader->source;
+
+  size_t n_buffered = 0u;
+  while ((n_buffered = serd_byte_source_n_buffered(source))) {
+    const uint8_t* const start = source->read_buf + source->read_head;
+    const uint8_t* const nl =
+      (const uint8_t*)memchr(start, '\n', n_buffered);
+
+    if (nl) {
+      if (nl > start) {
+        serd_byte_source_skip(source, (size_t)(nl - start));
+      }
+      return;
+    }
+
+    serd_byte_source_skip(source, n_buffered);
+  }
+
+  for (int c = 0; (c = peek_byte(reader)) > 0 && c != '\n';) {
+    eat_byte_safe(reader, c);
+  }
+}
+
+// [6] comment ::= '#' ( [^#xA #xD] )*
+static void
+read_comment(SerdReader* reader)
+{
+  eat_byte_safe(reader, '#');
+  for (int c = 0; (c = peek_byte(reader)) > 0 && c != 0xA && c != 0xD;) {
+    eat_byte_safe(reader, c);
+  }
+}
+
+// Skip any whitespace and comments, including line ends
+static inline void
+read_ws_star(SerdReader* reader)
+{
+  for (int c = 0;;) {
+    switch ((c = peek_byte(reader))) {
+    case 0x9:
+    case 0xA:
+    case 0xD:
+    case 0x20:
+      eat_byte_safe(reader, c);
+      break;
+    case '#':
+      read_comment(reader);
+      break;
+    default:
+      return;
+    }
+  }
+}
+
+// Read a literal with an optional language tag or datatype into `ctx`
+static SerdStatus
+read_literal(SerdReader* reader, ReadContext* ctx)
+{
+  eat_byte_safe(reader, '"');
+
+  SerdNodeFlags flags = 0;
+  SerdStatus    st    = SERD_SUCCESS;
+  ctx->object         = push_node(reader, SERD_LITERAL, "", 0);
+  reader->literal_ctx = ctx;
+  TRY(st, read_STRING_LITERAL(reader, ctx->object, &flags, '"'));
+
+  deref(reader, ctx->object)->flags = flags;
+
+  switch (peek_byte(reader)) {
+  case '@':
+    eat_byte_safe(reader, '@');
+    st = read_LANGTAG(reader, &ctx->lang);
+    break;
+  case '^':
+    eat_byte_safe(reader, '^');
+    st = eat_byte_check(reader, '^') ? read_IRIREF(reader, &ctx->datatype)
+                                     : SERD_ERR_BAD_SYNTAX;
+    break;
+  default:
+    break;
+  }
+
+  return st ? r_err(reader, st, "bad literal\n") : SERD_SUCCESS;
+}
+
+/**
+   Read the nodes of a statement into `ctx`, and emit it.
+
+   This is only called with a constant `quads`, and always inlined, so the
+   compiler generates a specialized version for each syntax.
+*/
+static SERD_ALWAYS_INLINE_FUNC inline SerdStatus
+read_quad(SerdReader* const reader, ReadContext* const ctx, const bool quads)
+{
+  SerdStatus st      = SERD_SUCCESS;
+  bool       ate_dot = false;
+
+  // subject
+  switch (peek_byte(reader)) {
+  case '<':
+    TRY(st, read_IRIREF(reader, &ctx->subject));
+    break;
+  case '_':
+    TRY(st, read_label(reader, &ctx->subject, &ate_dot));
+    if (ate_dot) {
+      return r_err(reader, SERD_ERR_BAD_SYNTAX, "subject ends with `.'\n");
+    }
+    break;
+  case '@':
+    return r_err(
+      reader, SERD_ERR_BAD_SYNTAX, "syntax does not support directives\n");
+  default:
+    return r_err(reader, SERD_ERR_BAD_SYNTAX, "expected subject\n");
+  }
+
+  // predicate
+  read_ws_star(reader);
+  TRY(st, read_IRIREF(reader, &ctx->predicate));
+
+  // The graph of a quad is not known yet, so the filter is called again later
+  if (reader->filter &&
+      !(quads ? reader->filter(reader->filter_handle,
+                               &SERD_NODE_NULL,
+                               deref(reader, ctx->predicate))
+              : filter_accepts(reader, *ctx))) {
+    skip_line(reader);
+    return SERD_SUCCESS;
+  }
+
+  // object
+  read_ws_star(reader);
+  switch (peek_byte(reader)) {
+  case '"':
+    TRY(st, read_literal(reader, ctx));
+    break;
+  case '<':
+    TRY(st, read_IRIREF(reader, &ctx->object));
+    break;
+  case '_':
+    TRY(st, read_label(reader, &ctx->object, &ate_dot));
+    break;
+  default:
+    return r_err(reader, SERD_ERR_BAD_SYNTAX, "expected object\n");
+  }
+
+  // graphLabel?
+  if (quads && !ate_dot) {
+    read_ws_star(reader);
+    switch (peek_byte(reader)) {
+    case '<':
+      TRY(st, read_IRIREF(reader, &ctx->graph));
+      break;
+    case '_':
+      TRY(st, read_label(reader, &ctx->graph, &ate_dot));
+      break;
+    default:
+      break;
+    }
+  }
+
+  // Terminating '.'
+  if (!ate_dot) {
+    read_ws_star(reader);
+    if (!eat_byte_check(reader, '.')) {
+      return SERD_ERR_BAD_SYNTAX;
+    }
+  }
+
+  if (quads && !filter_accepts(reader, *ctx)) {
+    return SERD_SUCCESS;
+  }
+
+  return emit_statement(reader, *ctx, ctx->object, ctx->datatype, ctx->lang);
+}
+
+// Read a statement, and pop everything it pushed to the stack
+static SERD_ALWAYS_INLINE_FUNC inline SerdStatus
+read_line(SerdReader* const reader, const bool quads)
+{
+  SerdStatementFlags flags = 0;
+  ReadContext        ctx   = {0, 0, 0, 0, 0, 0, &flags};
+
+  const SerdStatus st = read_quad(reader, &ctx, quads);
+
+  pop_node(reader, ctx.graph);
+  pop_node(reader, ctx.lang);
+  pop_node(reader, ctx.datatype);
+  pop_node(reader, ctx.object);
+  pop_node(reader, ctx.predicate);
+  pop_node(reader, ctx.subject);
+  return st;
+}
+
+static SERD_ALWAYS_INLINE_FUNC inline SerdStatus
+read_lines(SerdReader* const reader, const bool quads)
+{
+  while (!reader->source.eof) {
+    read_ws_star(reader);
+
+    const int c = peek_byte(reader);
+    if (c == EOF) {
+      break;
+    }
+
+    if (c == '\0') {
+      eat_byte_safe(reader, c);
+      continue;
+    }
+
+    if (reader->index) {
+      update_index(reader);
+    }
+
+    const SerdStatus st = read_line(reader, quads);
+    if (st > SERD_FAILURE) {
+      if (reader->strict) {
+        return st;
+      }
+
+      ++reader->stats.n_recoveries;
+      skip_line(reader);
+    }
+  }
+
+  return SERD_SUCCESS;
+}
+
+SerdStatus
+read_ntriples_statement(SerdReader* reader)
+{
+  read_ws_star(reader);
+  switch (peek_byte(reader)) {
+  case '\0':
+    eat_byte_safe(reader, '\0');
+    return SERD_FAILURE;
+  case EOF:
+    return SERD_FAILURE;
+  default:
+    break;
+  }
+
+  return (reader->syntax == SERD_NQUADS) ? read_line(reader, true)
+                                         : read_line(reader, false);
+}
+
+SerdStatus
+read_ntriplesDoc(SerdReader* reader)
+{
+  return read_lines(reader, false);
+}
+
+SerdStatus
+read_nquadsDoc(SerdReader* reader)
+{
+  return read_lines(reader, true);
+}
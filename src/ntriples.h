@@ -0,0 +1,174 @@
+/*
+  Copyright 2011-2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef SERD_NTRIPLES_H
+#define SERD_NTRIPLES_H
+
+#include "byte_source.h"
+#include "reader.h"
+#include "scan.h"
+#include "string_utils.h"
+
+#include "serd/serd.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+  Terminals of the NTriples grammar.
+
+  Turtle is a superset of NTriples, so these are shared by the reader for line
+  syntaxes in ntriples.c and the Turtle and TriG reader in n3.c.
+*/
+
+static inline uint8_t
+read_HEX(SerdReader* reader)
+{
+  const int c = peek_byte(reader);
+  if (is_xdigit(c)) {
+    return (uint8_t)eat_byte_safe(reader, c);
+  }
+
+  r_err(reader, SERD_ERR_BAD_SYNTAX, "invalid hexadecimal digit `%c'\n", c);
+  return 0;
+}
+
+// Read UCHAR escape, initial \ is already eaten by caller
+SerdStatus
+read_UCHAR(SerdReader* reader, Ref dest, uint32_t* char_code);
+
+// Read ECHAR escape, initial \ is already eaten by caller
+SerdStatus
+read_ECHAR(SerdReader* reader, Ref dest, SerdNodeFlags* flags);
+
+// Read a UTF-8 character, whose first byte, c, has already been eaten
+SerdStatus
+read_utf8_character(SerdReader* reader, Ref dest, uint8_t c);
+
+// Read a UTF-8 character like read_utf8_character(), and set its code point
+SerdStatus
+read_utf8_code(SerdReader* reader, Ref dest, uint32_t* code, uint8_t c);
+
+// Read one character (possibly multi-byte)
+// The first byte, c, has already been eaten by caller
+static inline SerdStatus
+read_character(SerdReader* reader, Ref dest, SerdNodeFlags* flags, uint8_t c)
+{
+  if (!(c & 0x80)) {
+    switch (c) {
+    case 0xA:
+    case 0xD:
+      *flags |= SERD_HAS_NEWLINE;
+      break;
+    case '"':
+    case '\'':
+      *flags |= SERD_HAS_QUOTE;
+      break;
+    default:
+      break;
+    }
+    return push_byte(reader, dest, c);
+  }
+
+  return read_utf8_character(reader, dest, c);
+}
+
+// Return the length of the plain run at the current position in a string
+static inline size_t
+peek_string_run(SerdReader* reader)
+{
+  const SerdByteSource* const source = &reader->source;
+  const size_t n_buffered = serd_byte_source_n_buffered(source);
+
+  return n_buffered
+           ? serd_scan_string(source->read_buf + source->read_head, n_buffered)
+           : 0u;
+}
+
+// Return the length of the plain run at the current position in an IRI
+static inline size_t
+peek_iri_run(SerdReader* reader)
+{
+  const SerdByteSource* const source = &reader->source;
+  const size_t n_buffered = serd_byte_source_n_buffered(source);
+
+  return n_buffered
+           ? serd_scan_iri(source->read_buf + source->read_head, n_buffered)
+           : 0u;
+}
+
+// Eat a plain ASCII run of `len` bytes and push it to `dest` all at once
+static inline void
+read_run(SerdReader* reader, Ref dest, const size_t len)
+{
+  SerdByteSource* const source = &reader->source;
+
+  push_span(reader, dest, source->read_buf + source->read_head, len, len);
+  serd_byte_source_skip(source, len);
+}
+
+// Eat a plain run in a string, and push at most a literal piece of it
+static inline void
+read_string_run(SerdReader* reader, Ref dest, const size_t len)
+{
+  if (reader->literal_sink) {
+    const SerdNode* const node = (const SerdNode*)(reader->stack.buf + dest);
+    const size_t          room = reader->max_literal - node->n_bytes;
+
+    read_run(reader, dest, len < room ? len : room);
+  } else {
+    read_run(reader, dest, len);
+  }
+}
+
+static inline bool
+is_PN_CHARS_BASE(const uint32_t c)
+{
+  return ((c >= 0x00C0 && c <= 0x00D6) || (c >= 0x00D8 && c <= 0x00F6) ||
+          (c >= 0x00F8 && c <= 0x02FF) || (c >= 0x0370 && c <= 0x037D) ||
+          (c >= 0x037F && c <= 0x1FFF) || (c >= 0x200C && c <= 0x200D) ||
+          (c >= 0x2070 && c <= 0x218F) || (c >= 0x2C00 && c <= 0x2FEF) ||
+          (c >= 0x3001 && c <= 0xD7FF) || (c >= 0xF900 && c <= 0xFDCF) ||
+          (c >= 0xFDF0 && c <= 0xFFFD) || (c >= 0x10000 && c <= 0xEFFFF));
+}
+
+SerdStatus
+read_PN_CHARS(SerdReader* reader, Ref dest);
+
+SerdStatus
+read_LANGTAG(SerdReader* reader, Ref* dest);
+
+// STRING_LITERAL_QUOTE and STRING_LITERAL_SINGLE_QUOTE
+// Initial quote is already eaten by caller
+SerdStatus
+read_STRING_LITERAL(SerdReader*    reader,
+                    Ref            ref,
+                    SerdNodeFlags* flags,
+                    uint8_t        q);
+
+// Read the rest of an IRIREF after the initial `<', into the node `dest`
+SerdStatus
+read_IRIREF_suffix(SerdReader* reader, Ref* dest);
+
+SerdStatus
+read_BLANK_NODE_LABEL(SerdReader* reader, Ref* dest, bool* ate_dot);
+
+// Rename a label like a generated ID to prevent a clash, or report one
+SerdStatus
+rename_blank_label(SerdReader* reader, Ref* dest);
+
+#endif // SERD_NTRIPLES_H
@@ -0,0 +1,52 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef SERD_NUMBER_H
+#define SERD_NUMBER_H
+
+/// The maximum number of significant digits needed to round-trip a double
+#define SERD_DOUBLE_DIGITS 17
+
+/**
+   Parse a decimal number to the nearest double.
+
+   This reads an optional sign, digits with an optional decimal point, and an
+   optional exponent, like strtod() in the C locale.  The result is always
+   correctly rounded, with ties to even.
+
+   @param str String to parse, leading whitespace is skipped.
+   @param end Set to the first character after the number, or `str` if no
+   number was read.
+*/
+double
+serd_parse_double(const char* str, const char** end);
+
+/**
+   Write the shortest decimal digits that parse back to `d`.
+
+   If there are several such strings, the one closest to `d` is chosen.
+
+   @param d A positive finite number.
+   @param digits Set to the digits as characters, which are not terminated.
+   Must have room for at least #SERD_DOUBLE_DIGITS characters.
+   @param exponent Set to the power of ten of the first digit, so `d` is
+   approximately `d1.d2d3...` times 10 to `exponent`.
+   @return The number of digits written, which is at least 1.
+*/
+unsigned
+serd_double_digits(double d, char* digits, int* exponent);
+
+#endif // SERD_NUMBER_H
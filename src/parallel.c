@@ -0,0 +1,896 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#define _POSIX_C_SOURCE 200809L /* for pthreads */
+
+#include "byte_source.h"
+#include "compress.h"
+#include "memory.h"
+#include "reader.h"
+#include "serd_config.h"
+#include "serd_internal.h"
+#include "statements.h"
+#include "string_utils.h"
+#include "system.h"
+
+#include "serd/serd.h"
+
+#if USE_PTHREAD
+#  include <pthread.h>
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if USE_PTHREAD
+
+/// Number of chunks per thread, so threads stay busy if lines vary in length
+#  define CHUNKS_PER_THREAD 8u
+
+/// Number of chunks per thread that may be parsed ahead of emission
+#  define WINDOW_PER_THREAD 2u
+
+/// A newline-aligned chunk of input that is parsed by a single worker
+typedef struct {
+  const uint8_t*  buf;        ///< Start of chunk in input
+  size_t          size;       ///< Size of chunk in bytes
+  SerdStatements  statements; ///< Parsed statements, if ordered
+  SerdReaderStats stats;      ///< Statistics from reading the chunk
+  SerdStatus      status;     ///< Status of reading the chunk
+  bool            directive;  ///< True iff the chunk contains a directive
+  bool            discarded;  ///< True iff the chunk was read again serially
+  bool            genids;     ///< True iff a label like `b1' was read
+  bool            renamed;    ///< True iff a label like `B1' was read
+  bool            ends;       ///< True iff statements include end events
+  bool            done;       ///< True iff reading is finished
+} Chunk;
+
+typedef struct {
+  SerdReader*    reader;    ///< Reader with the sinks and options to use
+  const uint8_t* buf;       ///< Input
+  size_t         size;      ///< Size of input in bytes
+  const uint8_t* name;      ///< Input name for error reporting
+  Chunk*         chunks;    ///< Chunks of input
+  size_t         n_chunks;  ///< Number of chunks
+  size_t         next;      ///< Index of the next chunk to read
+  size_t         n_emitted; ///< Number of chunks emitted, if ordered
+  size_t         window;    ///< Maximum number of chunks ahead of emission
+  SerdStatus     status;    ///< First error status, if unordered
+  bool           ordered;   ///< True iff statements are emitted in order
+  bool           guessed;   ///< True iff chunks may not start at statements
+  bool           stop;      ///< True iff workers should stop
+
+  pthread_mutex_t mutex; ///< Mutex for all of the above and sinks
+  pthread_cond_t  cond;  ///< Signalled when a chunk is read or emitted
+} Parallel;
+
+typedef struct {
+  Parallel*   par;        ///< Shared state
+  Chunk*      chunk;      ///< Chunk being read
+  SerdReader* reader;     ///< Reader for chunks
+  unsigned    line;       ///< Number of lines before chunk
+  bool        line_known; ///< True iff line has been counted
+  pthread_t   thread;     ///< Worker thread
+} Worker;
+
+static SerdStatus
+buffer_statement(void*              handle,
+                 SerdStatementFlags flags,
+                 const SerdNode*    graph,
+                 const SerdNode*    subject,
+                 const SerdNode*    predicate,
+                 const SerdNode*    object,
+                 const SerdNode*    object_datatype,
+                 const SerdNode*    object_lang)
+{
+  Worker* const worker = (Worker*)handle;
+
+  serd_statements_push(&worker->chunk->statements,
+                       flags,
+                       graph,
+                       subject,
+                       predicate,
+                       object,
+                       object_datatype,
+                       object_lang);
+
+  return SERD_SUCCESS;
+}
+
+static SerdStatus
+forward_statement(void*              handle,
+                  SerdStatementFlags flags,
+                  const SerdNode*    graph,
+                  const SerdNode*    subject,
+                  const SerdNode*    predicate,
+                  const SerdNode*    object,
+                  const SerdNode*    object_datatype,
+                  const SerdNode*    object_lang)
+{
+  Parallel* const   par    = ((Worker*)handle)->par;
+  SerdReader* const reader = par->reader;
+  SerdStatus        st     = SERD_SUCCESS;
+
+  pthread_mutex_lock(&par->mutex);
+  if (par->stop) {
+    st = SERD_ERR_UNKNOWN; // Abort reading this chunk
+  } else if ((st = sink_statement(reader,
+                                  flags,
+                                  graph,
+                                  subject,
+                                  predicate,
+                                  object,
+                                  object_datatype,
+                                  object_lang))) {
+    par->status = st;
+    par->stop   = true;
+  }
+  pthread_mutex_unlock(&par->mutex);
+
+  return st;
+}
+
+/// Record the end of an anonymous node as a record with no predicate
+static SerdStatus
+buffer_end(void* handle, const SerdNode* node)
+{
+  Chunk* const chunk = ((Worker*)handle)->chunk;
+
+  serd_statements_push(
+    &chunk->statements, 0u, NULL, node, NULL, NULL, NULL, NULL);
+
+  chunk->ends = true;
+  return SERD_SUCCESS;
+}
+
+static SerdStatus
+forward_end(void* handle, const SerdNode* node)
+{
+  Parallel* const   par    = ((Worker*)handle)->par;
+  SerdReader* const reader = par->reader;
+  SerdStatus        st     = SERD_SUCCESS;
+
+  pthread_mutex_lock(&par->mutex);
+  if (par->stop) {
+    st = SERD_ERR_UNKNOWN; // Abort reading this chunk
+  } else if ((st = flush_batch(reader)) ||
+             (st = reader->end_sink(reader->handle, node))) {
+    par->status = st;
+    par->stop   = true;
+  }
+  pthread_mutex_unlock(&par->mutex);
+
+  return st;
+}
+
+static SerdStatus
+note_base(void* handle, const SerdNode* uri)
+{
+  (void)uri;
+
+  ((Worker*)handle)->chunk->directive = true;
+  return SERD_SUCCESS;
+}
+
+static SerdStatus
+note_prefix(void* handle, const SerdNode* name, const SerdNode* uri)
+{
+  (void)name;
+  (void)uri;
+
+  ((Worker*)handle)->chunk->directive = true;
+  return SERD_SUCCESS;
+}
+
+static SerdStatus
+count_prefix(void* handle, const SerdNode* name, const SerdNode* uri)
+{
+  (void)name;
+  (void)uri;
+
+  ++*(size_t*)handle;
+  return SERD_SUCCESS;
+}
+
+/// Return the number of prefixes a validating reader knows, or zero
+static size_t
+n_prefixes(const SerdReader* const reader)
+{
+  size_t n = 0u;
+  if (reader->prefixes) {
+    serd_env_foreach(reader->prefixes, count_prefix, &n);
+  }
+
+  return n;
+}
+
+static SerdStatus
+ignore_error(void* handle, const SerdError* e)
+{
+  (void)handle;
+  (void)e;
+
+  // Errors are reported when the chunk is read again serially
+  return SERD_SUCCESS;
+}
+
+static SerdStatus
+forward_error(void* handle, const SerdError* e)
+{
+  Worker* const   worker = (Worker*)handle;
+  Parallel* const par    = worker->par;
+
+  if (!worker->line_known) {
+    // Count lines before this chunk (slow, but only done if there are errors)
+    const uint8_t* const end = worker->chunk->buf;
+    const uint8_t*       p   = par->buf;
+    while ((p = (const uint8_t*)memchr(p, '\n', (size_t)(end - p)))) {
+      ++worker->line;
+      ++p;
+    }
+
+    worker->line_known = true;
+  }
+
+  SerdError error = *e;
+  error.line += worker->line;
+
+  pthread_mutex_lock(&par->mutex);
+  serd_error(par->reader->error_sink, par->reader->error_handle, &error);
+  pthread_mutex_unlock(&par->mutex);
+
+  return SERD_SUCCESS;
+}
+
+/// Prepare `reader` to read from a buffer in the input
+static void
+open_buffer(SerdReader* const    reader,
+            const uint8_t* const buf,
+            const size_t         size,
+            const uint8_t* const name)
+{
+  serd_byte_source_open_buffer(&reader->source, buf, size, name);
+  serd_byte_source_set_lazy(&reader->source, reader->lazy_positions);
+  serd_byte_source_prepare(&reader->source);
+  reader->start_offset = 0u;
+}
+
+static SerdStatus
+read_chunk(Worker* const worker, const size_t index)
+{
+  Parallel* const   par    = worker->par;
+  SerdReader* const reader = worker->reader;
+  Chunk* const      chunk  = &par->chunks[index];
+
+  worker->chunk      = chunk;
+  worker->line       = 0u;
+  worker->line_known = false;
+  if (par->ordered) {
+    chunk->statements =
+      serd_statements_new(&par->reader->allocator, SERD_PAGE_SIZE);
+  }
+
+  // Generated blank node IDs must be unique across chunks
+  snprintf(reader->genid_prefix,
+           sizeof(reader->genid_prefix),
+           "%uc",
+           (unsigned)index);
+
+  reader->next_id      = 1;
+  reader->seen_genid   = false;
+  reader->seen_renamed = false;
+
+  memset(&reader->stats, 0, sizeof(reader->stats));
+  open_buffer(reader, chunk->buf, chunk->size, par->name);
+
+  // Validating readers don't call sinks, so notice new prefixes here instead
+  const size_t n_old = n_prefixes(reader);
+  SerdStatus   st    = SERD_SUCCESS;
+  switch (reader->syntax) {
+  case SERD_NTRIPLES:
+    st = read_ntriplesDoc(reader);
+    break;
+  case SERD_NQUADS:
+    st = read_nquadsDoc(reader);
+    break;
+  default:
+    st = read_turtleTrigDoc(reader);
+  }
+
+  if (n_prefixes(reader) != n_old) {
+    chunk->directive = true;
+  }
+
+  serd_reader_close_source(reader);
+  chunk->stats   = reader->stats;
+  chunk->genids  = reader->seen_genid;
+  chunk->renamed = reader->seen_renamed;
+  return st;
+}
+
+static void*
+work(void* const arg)
+{
+  Worker* const   worker = (Worker*)arg;
+  Parallel* const par    = worker->par;
+
+  pthread_mutex_lock(&par->mutex);
+  while (!par->stop && par->next < par->n_chunks) {
+    if (par->ordered && par->next >= par->n_emitted + par->window) {
+      // Too far ahead of emission, wait so buffered chunks don't pile up
+      pthread_cond_wait(&par->cond, &par->mutex);
+      continue;
+    }
+
+    const size_t index = par->next++;
+    if (index < par->n_emitted) {
+      // Already read serially after an earlier chunk, so don't bother
+      par->chunks[index].done = true;
+      continue;
+    }
+
+    pthread_mutex_unlock(&par->mutex);
+
+    const SerdStatus st = read_chunk(worker, index);
+
+    pthread_mutex_lock(&par->mutex);
+    par->chunks[index].status = st;
+    par->chunks[index].done   = true;
+    if (st > SERD_FAILURE && !par->ordered && !par->stop) {
+      par->status = st;
+      par->stop   = true;
+    }
+
+    pthread_cond_broadcast(&par->cond);
+  }
+  pthread_mutex_unlock(&par->mutex);
+
+  return NULL;
+}
+
+/**
+   Return the end of the first line that ends at or after `start`.
+
+   If `at_dot` is true, only lines that end with a dot are considered, since
+   those are likely to be at the end of a Turtle statement.
+*/
+static size_t
+find_line_end(const uint8_t* const buf,
+              const size_t         size,
+              size_t               start,
+              const bool           at_dot)
+{
+  const uint8_t* nl = NULL;
+  while ((nl = (const uint8_t*)memchr(buf + start, '\n', size - start))) {
+    const uint8_t* last = nl;
+    while (last > buf + start && (last[-1] == ' ' || last[-1] == '\t' ||
+                                  last[-1] == '\r')) {
+      --last;
+    }
+
+    start = (size_t)(nl - buf) + 1u;
+    if (!at_dot || (last > buf && last[-1] == '.')) {
+      return start;
+    }
+  }
+
+  return size;
+}
+
+/// Split `buf` into chunks that end just after a newline
+static size_t
+split_chunks(const SerdAllocator* const allocator,
+             const uint8_t* const       buf,
+             const size_t               size,
+             const size_t               chunk_size,
+             const bool                 at_dot,
+             Chunk** const              chunks)
+{
+  size_t n_chunks = 0u;
+  for (size_t start = 0u; start < size;) {
+    size_t end = start + chunk_size;
+    end        = end >= size ? size : find_line_end(buf, size, end, at_dot);
+
+    *chunks = (Chunk*)serd_arealloc(
+      allocator, *chunks, (n_chunks + 1u) * sizeof(Chunk));
+    memset(&(*chunks)[n_chunks], 0, sizeof(Chunk));
+    (*chunks)[n_chunks].buf  = buf + start;
+    (*chunks)[n_chunks].size = end - start;
+    ++n_chunks;
+    start = end;
+  }
+
+  return n_chunks;
+}
+
+/// Return true iff `str` starts with `word` followed by whitespace
+static bool
+starts_with_word(const uint8_t* const str,
+                 const size_t         len,
+                 const char* const    word,
+                 const bool           ignore_case)
+{
+  const size_t word_len = strlen(word);
+  if (len <= word_len || !is_space((char)str[word_len])) {
+    return false;
+  }
+
+  for (size_t i = 0u; i < word_len; ++i) {
+    const char c = ignore_case ? serd_to_upper((char)str[i]) : (char)str[i];
+    if (c != word[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+   Return the size of the directives at the start of a Turtle or TriG document.
+
+   This only needs to be good enough to find where the directives end in
+   typical documents, since the result is always read serially.
+*/
+static size_t
+prelude_size(const uint8_t* const buf, const size_t size)
+{
+  size_t end = 0u;
+  for (size_t i = 0u; i < size;) {
+    // Skip whitespace and comments
+    if (is_space((char)buf[i])) {
+      ++i;
+      continue;
+    }
+
+    if (buf[i] == '#') {
+      const uint8_t* const nl =
+        (const uint8_t*)memchr(buf + i, '\n', size - i);
+
+      i = nl ? (size_t)(nl - buf) + 1u : size;
+      continue;
+    }
+
+    const uint8_t* const str = buf + i;
+    const size_t         len = size - i;
+    const bool           at  = str[0] == '@';
+    if (at ? !starts_with_word(str, len, "@prefix", false) &&
+               !starts_with_word(str, len, "@base", false)
+           : !starts_with_word(str, len, "PREFIX", true) &&
+               !starts_with_word(str, len, "BASE", true)) {
+      break;
+    }
+
+    // Find the end of the IRI, then the dot that ends a Turtle directive
+    const uint8_t* const close = (const uint8_t*)memchr(str, '>', len);
+    if (!close) {
+      break;
+    }
+
+    i = (size_t)(close - buf) + 1u;
+    if (at) {
+      while (i < size && is_space((char)buf[i])) {
+        ++i;
+      }
+
+      if (i == size || buf[i] != '.') {
+        break;
+      }
+
+      ++i;
+    }
+
+    end = i;
+  }
+
+  return end;
+}
+
+/// Wait until the chunk at `index` has been read
+static void
+wait_for_chunk(Parallel* const par, const size_t index)
+{
+  pthread_mutex_lock(&par->mutex);
+  while (!par->chunks[index].done) {
+    pthread_cond_wait(&par->cond, &par->mutex);
+  }
+  pthread_mutex_unlock(&par->mutex);
+}
+
+/// Set the number of emitted chunks, so workers may read further ahead
+static void
+set_emitted(Parallel* const par, const size_t n_emitted, const bool stop)
+{
+  pthread_mutex_lock(&par->mutex);
+  par->n_emitted = n_emitted;
+  par->stop      = par->stop || stop;
+  pthread_cond_broadcast(&par->cond);
+  pthread_mutex_unlock(&par->mutex);
+}
+
+/// Pass statements and end events from a chunk to the reader's sinks in order
+static SerdStatus
+emit_events(SerdReader* const reader, Chunk* const chunk)
+{
+  SerdStatements* const statements = &chunk->statements;
+  SerdStatus            st         = SERD_SUCCESS;
+
+  for (size_t offset = SERD_STACK_BOTTOM;
+       !st && offset < statements->stack.size;) {
+    const SerdNode*                  nodes[SERD_STATEMENT_N_NODES];
+    const SerdStatementHeader* const header =
+      serd_statements_decode(statements, offset, nodes);
+
+    if (nodes[2]) {
+      st = sink_statement(reader,
+                          header->flags,
+                          nodes[0],
+                          nodes[1],
+                          nodes[2],
+                          nodes[3],
+                          nodes[4],
+                          nodes[5]);
+    } else if (!(st = flush_batch(reader))) {
+      st = reader->end_sink(reader->handle, nodes[1]);
+    }
+
+    offset += header->size;
+  }
+
+  return st ? st : flush_batch(reader);
+}
+
+/// Pass the statements read from a chunk to the reader's sinks
+static SerdStatus
+emit_chunk(SerdReader* const reader, Chunk* const chunk)
+{
+  SerdStatus st = SERD_SUCCESS;
+
+  if (chunk->ends) {
+    st = emit_events(reader, chunk);
+  } else if (reader->id_sink) {
+    st = serd_statements_emit(&chunk->statements, sink_statement, reader);
+  } else if (reader->batch_sink) {
+    st = serd_statements_emit_batches(&chunk->statements,
+                                      reader->batch_array,
+                                      reader->max_batch,
+                                      reader->batch_sink,
+                                      reader->handle);
+  } else if (reader->statement_sink) {
+    st = serd_statements_emit(
+      &chunk->statements, reader->statement_sink, reader->handle);
+  }
+
+  if (!st && chunk->status > SERD_FAILURE) {
+    st = chunk->status;
+  }
+
+  serd_statements_free(&chunk->statements);
+  return st;
+}
+
+/// Return true iff a chunk was read exactly as it would be read serially
+static bool
+chunk_is_valid(const Chunk* const chunk)
+{
+  return chunk->status <= SERD_FAILURE && !chunk->stats.n_errors &&
+         !chunk->directive;
+}
+
+/// Return true iff there is only whitespace between `a` and `b`
+static bool
+only_space_between(const uint8_t* a, const uint8_t* b)
+{
+  const uint8_t* const end = a < b ? b : a;
+  for (const uint8_t* p = a < b ? a : b; p < end; ++p) {
+    if (!is_space((char)*p)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+   Read serially with the main reader, from the start of the chunk at `index`.
+
+   This is used when a chunk may not have been read correctly on its own,
+   because it didn't start at a statement, or contained a directive or an
+   error.  Reading continues until the start of a later chunk that was read
+   correctly, and `next` is set to its index.
+*/
+static SerdStatus
+read_serially(Parallel* const par, const size_t index, size_t* const next)
+{
+  SerdReader* const    reader = par->reader;
+  Chunk* const         chunks = par->chunks;
+  const uint8_t* const start  = chunks[index].buf;
+
+  // Count lines before this chunk (slow, but only done if there are problems)
+  unsigned       line = 1u;
+  const uint8_t* p    = par->buf;
+  while ((p = (const uint8_t*)memchr(p, '\n', (size_t)(start - p)))) {
+    ++line;
+    ++p;
+  }
+
+  snprintf(reader->genid_prefix,
+           sizeof(reader->genid_prefix),
+           "%uc",
+           (unsigned)index);
+
+  reader->next_id = 1;
+  open_buffer(reader, start, (size_t)(par->buf + par->size - start), par->name);
+  serd_byte_source_cursor(&reader->source)->line = line;
+
+  SerdStatus st = SERD_SUCCESS;
+  size_t     n  = index + 1u;
+  while (!st && !reader->source.eof) {
+    const uint8_t* const pos = start + reader->source.read_head;
+
+    // Skip chunks that start inside statements that were read here
+    while (n < par->n_chunks && chunks[n].buf < pos &&
+           !only_space_between(chunks[n].buf, pos)) {
+      ++n;
+    }
+
+    set_emitted(par, n, false);
+    if (n < par->n_chunks && only_space_between(pos, chunks[n].buf)) {
+      // At the start of a chunk, which can be used if it was read correctly
+      wait_for_chunk(par, n);
+      if (chunk_is_valid(&chunks[n])) {
+        break;
+      }
+    }
+
+    st = read_turtleTrigStatement(reader);
+  }
+
+  if (reader->source.eof) {
+    n = par->n_chunks;
+  }
+
+  // Discard the chunks that were read here, freeing any that are finished
+  pthread_mutex_lock(&par->mutex);
+  for (size_t i = index; i < n; ++i) {
+    chunks[i].discarded = true;
+    if (chunks[i].done) {
+      serd_statements_free(&chunks[i].statements);
+    }
+  }
+  pthread_mutex_unlock(&par->mutex);
+
+  const SerdStatus flush_st = flush_batch(reader);
+  serd_reader_close_source(reader);
+  *next = n;
+  return st ? st : flush_st;
+}
+
+/// Read the directives at the start of the input with the main reader
+static SerdStatus
+read_prelude(SerdReader* const    reader,
+             const uint8_t* const buf,
+             const size_t         size,
+             const uint8_t* const name)
+{
+  open_buffer(reader, buf, size, name);
+
+  const SerdStatus st = read_turtleTrigDoc(reader);
+
+  serd_reader_close_source(reader);
+  return st;
+}
+
+static SerdStatus
+read_parallel(SerdReader* const    reader,
+              const uint8_t*       buf,
+              size_t               size,
+              const uint8_t* const name,
+              const unsigned       n_threads,
+              const bool           ordered)
+{
+  // Skip byte order mark, since only the first chunk may have one
+  if (size >= 3 && buf[0] == 0xEF && buf[1] == 0xBB && buf[2] == 0xBF) {
+    buf += 3;
+    size -= 3;
+  }
+
+  // Chunks of Turtle or TriG might not start at statements
+  const bool guessed =
+    reader->syntax == SERD_TURTLE || reader->syntax == SERD_TRIG;
+
+  Parallel par;
+  memset(&par, 0, sizeof(par));
+  par.reader  = reader;
+  par.buf     = buf;
+  par.size    = size;
+  par.name    = name;
+  par.window  = (size_t)n_threads * WINDOW_PER_THREAD;
+  par.ordered = ordered || guessed;
+  par.guessed = guessed;
+
+  // Read any directives serially so the sinks get them before any statements
+  const size_t prelude = guessed ? prelude_size(buf, size) : 0u;
+  if (prelude) {
+    const SerdStatus st = read_prelude(reader, buf, prelude, name);
+    if (st) {
+      return st;
+    }
+  }
+
+  pthread_mutex_init(&par.mutex, NULL);
+  pthread_cond_init(&par.cond, NULL);
+
+  // Split input into a few chunks per thread, but not tiny ones
+  const size_t body_size  = size - prelude;
+  size_t       chunk_size = body_size / ((size_t)n_threads * CHUNKS_PER_THREAD);
+  if (chunk_size < SERD_PAGE_SIZE) {
+    chunk_size = SERD_PAGE_SIZE;
+  }
+
+  const SerdAllocator* const allocator = &reader->allocator;
+
+  par.n_chunks = split_chunks(
+    allocator, buf + prelude, body_size, chunk_size, guessed, &par.chunks);
+
+  // Save the generated ID state, since serial reading changes it
+  char           genid_prefix[sizeof(reader->genid_prefix)];
+  const unsigned next_id = reader->next_id;
+  memcpy(genid_prefix, reader->genid_prefix, sizeof(genid_prefix));
+
+  // Create a worker with its own reader for each thread
+  const size_t n_workers = MIN((size_t)n_threads, par.n_chunks);
+  Worker*      workers =
+    (Worker*)serd_acalloc(allocator, n_workers, sizeof(Worker));
+  for (size_t i = 0u; i < n_workers; ++i) {
+    Worker* const worker = &workers[i];
+
+    worker->par    = &par;
+    worker->reader = serd_reader_new_with_allocator(
+      allocator,
+      reader->syntax,
+      worker,
+      NULL,
+      guessed ? note_base : NULL,
+      guessed ? note_prefix : NULL,
+      (reader->statement_sink || reader->batch_sink || reader->id_sink)
+        ? (par.ordered ? buffer_statement : forward_statement)
+        : NULL,
+      reader->end_sink ? (par.ordered ? buffer_end : forward_end) : NULL);
+
+    serd_reader_set_strict(worker->reader, reader->strict);
+    serd_reader_set_lazy_positions(worker->reader, reader->lazy_positions);
+    serd_reader_set_error_sink(
+      worker->reader, guessed ? ignore_error : forward_error, worker);
+    serd_reader_add_blank_prefix(worker->reader, reader->bprefix);
+    serd_reader_set_filter(
+      worker->reader, reader->filter, reader->filter_handle);
+    if (reader->validate_only) {
+      // Chunks that define prefixes are read again serially to get them
+      serd_reader_set_validate_only(worker->reader, true);
+      serd_env_free(worker->reader->prefixes);
+      worker->reader->prefixes = serd_env_copy(reader->prefixes);
+    }
+    if (reader->default_graph.buf) {
+      serd_reader_set_default_graph(worker->reader, &reader->default_graph);
+    }
+  }
+
+  // Start workers
+  size_t n_started = 0u;
+  for (; n_started < n_workers; ++n_started) {
+    Worker* const worker = &workers[n_started];
+    if (pthread_create(&worker->thread, NULL, work, worker)) {
+      break;
+    }
+  }
+
+  SerdStatus st = SERD_SUCCESS;
+  if (!n_started && par.n_chunks) {
+    st = SERD_ERR_UNKNOWN;
+  } else if (par.ordered) {
+    // Emit chunks in order as they are finished
+    for (size_t i = 0u; i < par.n_chunks && !st;) {
+      wait_for_chunk(&par, i);
+      if (!guessed || chunk_is_valid(&par.chunks[i])) {
+        st = emit_chunk(reader, &par.chunks[i++]);
+      } else {
+        st = read_serially(&par, i, &i);
+      }
+
+      set_emitted(&par, i, st);
+    }
+  }
+
+  for (size_t i = 0u; i < n_started; ++i) {
+    pthread_join(workers[i].thread, NULL);
+  }
+
+  if (!par.ordered && !st && !(st = par.status)) {
+    st = flush_batch(reader);
+  }
+
+  for (size_t i = 0u; i < n_workers; ++i) {
+    serd_reader_free(workers[i].reader);
+  }
+
+  for (size_t i = 0u; i < par.n_chunks; ++i) {
+    const Chunk* const chunk = &par.chunks[i];
+    if (!chunk->discarded) {
+      // Labels are only checked within a chunk, so check across chunks here
+      const SerdStatus label_st =
+        merge_blank_labels(reader, chunk->genids, chunk->renamed);
+
+      st = st ? st : label_st;
+      serd_reader_add_stats(&reader->stats, &chunk->stats);
+    }
+
+    serd_statements_free(&par.chunks[i].statements);
+  }
+
+  memcpy(reader->genid_prefix, genid_prefix, sizeof(genid_prefix));
+  reader->next_id = next_id;
+
+  pthread_cond_destroy(&par.cond);
+  pthread_mutex_destroy(&par.mutex);
+  serd_afree(allocator, workers);
+  serd_afree(allocator, par.chunks);
+  return st;
+}
+
+#endif // USE_PTHREAD
+
+SerdStatus
+serd_reader_read_parallel(SerdReader*    reader,
+                          FILE*          file,
+                          const uint8_t* name,
+                          unsigned       n_threads,
+                          bool           ordered)
+{
+#if USE_PTHREAD
+  if (n_threads > 1 && reader->syntax != SERD_BINARY) {
+    const long  pos  = ftell(file);
+    size_t      size = 0u;
+    const void* map  = serd_map_file(file, &size);
+    if (map) {
+      const size_t   offset = pos > 0 ? (size_t)pos : 0u;
+      const uint8_t* buf    = (const uint8_t*)map + offset;
+
+      if (offset < size && serd_compression_detect(buf, size - offset)) {
+        // Compressed, so decompress and read serially
+        serd_unmap_file(map, size);
+        return serd_reader_read_file_handle(reader, file, name);
+      }
+
+      const SerdStatus st =
+        offset < size
+          ? read_parallel(reader, buf, size - offset, name, n_threads, ordered)
+          : SERD_FAILURE;
+
+      serd_unmap_file(map, size);
+      return st;
+    }
+  }
+#else
+  (void)n_threads;
+  (void)ordered;
+#endif
+
+  return serd_reader_read_mapped_file_handle(reader, file, name);
+}
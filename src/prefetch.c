@@ -0,0 +1,257 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#define _POSIX_C_SOURCE 200809L /* for pthreads */
+
+#include "serd_config.h"
+#include "system.h"
+
+#include "serd/serd.h"
+
+#if USE_PTHREAD
+#  include <pthread.h>
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+   A block of input.
+
+   Each block is owned by either the reader thread or the consumer, according
+   to `full` which is protected by the mutex.  The reader thread fills empty
+   blocks and marks them full, the consumer drains full blocks and marks them
+   empty.  A block shorter than the block size is the last one.
+*/
+typedef struct {
+  uint8_t* buf;  ///< Block data
+  size_t   size; ///< Number of bytes in buf
+  bool     full; ///< True iff filled by the reader thread
+} Block;
+
+struct SerdPrefetchImpl {
+  SerdSource          read_func;  ///< Underlying read function
+  SerdStreamErrorFunc error_func; ///< Underlying error function
+  void*               stream;     ///< Underlying stream
+  size_t              block_size; ///< Number of bytes to read at a time
+  Block               blocks[2];  ///< Double buffer
+  unsigned            cur;        ///< Index of the block being consumed
+  size_t              head;       ///< Offset into the block being consumed
+  int                 error;      ///< Stream error after the last block
+#if USE_PTHREAD
+  pthread_t       thread;  ///< Background reader thread
+  pthread_mutex_t mutex;   ///< Mutex for block ownership and exit
+  pthread_cond_t  cond;    ///< Signalled when a block changes hands
+  bool            exit;    ///< True iff the reader thread should stop
+  bool            started; ///< True iff the reader thread is running
+#endif
+};
+
+/// Fill `block` from the underlying source, return true iff it is the last
+static bool
+fill_block(SerdPrefetch* const prefetch, Block* const block)
+{
+  block->size = prefetch->read_func(
+    block->buf, 1, prefetch->block_size, prefetch->stream);
+
+  if (block->size < prefetch->block_size) {
+    prefetch->error = prefetch->error_func(prefetch->stream);
+    return true;
+  }
+
+  return false;
+}
+
+#if USE_PTHREAD
+
+static void*
+prefetch_run(void* const arg)
+{
+  SerdPrefetch* const prefetch = (SerdPrefetch*)arg;
+
+  for (unsigned i = 0u;; i ^= 1u) {
+    Block* const block = &prefetch->blocks[i];
+
+    // Wait until the consumer has finished with this block
+    pthread_mutex_lock(&prefetch->mutex);
+    while (block->full && !prefetch->exit) {
+      pthread_cond_wait(&prefetch->cond, &prefetch->mutex);
+    }
+
+    const bool stop = prefetch->exit;
+    pthread_mutex_unlock(&prefetch->mutex);
+    if (stop) {
+      break;
+    }
+
+    // Read without holding the lock, so the consumer can parse meanwhile
+    const bool last = fill_block(prefetch, block);
+
+    pthread_mutex_lock(&prefetch->mutex);
+    block->full = true;
+    pthread_cond_broadcast(&prefetch->cond);
+    pthread_mutex_unlock(&prefetch->mutex);
+
+    if (last) {
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+#endif
+
+/// Acquire the current block from the reader thread
+static Block*
+acquire_block(SerdPrefetch* const prefetch)
+{
+  Block* const block = &prefetch->blocks[prefetch->cur];
+
+#if USE_PTHREAD
+  if (prefetch->started) {
+    pthread_mutex_lock(&prefetch->mutex);
+    while (!block->full) {
+      pthread_cond_wait(&prefetch->cond, &prefetch->mutex);
+    }
+    pthread_mutex_unlock(&prefetch->mutex);
+    return block;
+  }
+#endif
+
+  if (!block->full) {
+    fill_block(prefetch, block);
+    block->full = true;
+  }
+
+  return block;
+}
+
+/// Return the current block to the reader thread and move to the next one
+static void
+release_block(SerdPrefetch* const prefetch)
+{
+  Block* const block = &prefetch->blocks[prefetch->cur];
+
+#if USE_PTHREAD
+  if (prefetch->started) {
+    pthread_mutex_lock(&prefetch->mutex);
+    block->full = false;
+    pthread_cond_broadcast(&prefetch->cond);
+    pthread_mutex_unlock(&prefetch->mutex);
+  } else {
+    block->full = false;
+  }
+#else
+  block->full = false;
+#endif
+
+  prefetch->cur ^= 1u;
+  prefetch->head = 0u;
+}
+
+SerdPrefetch*
+serd_prefetch_new(SerdSource          read_func,
+                  SerdStreamErrorFunc error_func,
+                  void*               stream,
+                  size_t              block_size)
+{
+  if (!block_size) {
+    return NULL;
+  }
+
+  SerdPrefetch* const prefetch =
+    (SerdPrefetch*)calloc(1, sizeof(SerdPrefetch));
+
+  prefetch->read_func     = read_func;
+  prefetch->error_func    = error_func;
+  prefetch->stream        = stream;
+  prefetch->block_size    = block_size;
+  prefetch->blocks[0].buf = (uint8_t*)serd_allocate_buffer(block_size);
+  prefetch->blocks[1].buf = (uint8_t*)serd_allocate_buffer(block_size);
+
+#if USE_PTHREAD
+  pthread_mutex_init(&prefetch->mutex, NULL);
+  pthread_cond_init(&prefetch->cond, NULL);
+  prefetch->started =
+    !pthread_create(&prefetch->thread, NULL, prefetch_run, prefetch);
+#endif
+
+  return prefetch;
+}
+
+size_t
+serd_prefetch_read(void* buf, size_t size, size_t nmemb, void* stream)
+{
+  SerdPrefetch* const prefetch = (SerdPrefetch*)stream;
+  uint8_t* const      out      = (uint8_t*)buf;
+  const size_t        len      = size * nmemb;
+  size_t              n_read   = 0u;
+
+  while (n_read < len) {
+    Block* const block = acquire_block(prefetch);
+    const size_t avail = block->size - prefetch->head;
+    if (!avail) {
+      if (block->size < prefetch->block_size) {
+        break; // End of input
+      }
+
+      release_block(prefetch);
+      continue;
+    }
+
+    const size_t n = len - n_read < avail ? len - n_read : avail;
+    memcpy(out + n_read, block->buf + prefetch->head, n);
+    prefetch->head += n;
+    n_read += n;
+  }
+
+  return size ? n_read / size : 0u;
+}
+
+int
+serd_prefetch_error(void* stream)
+{
+  return ((const SerdPrefetch*)stream)->error;
+}
+
+void
+serd_prefetch_free(SerdPrefetch* prefetch)
+{
+  if (!prefetch) {
+    return;
+  }
+
+#if USE_PTHREAD
+  if (prefetch->started) {
+    pthread_mutex_lock(&prefetch->mutex);
+    prefetch->exit = true;
+    pthread_cond_broadcast(&prefetch->cond);
+    pthread_mutex_unlock(&prefetch->mutex);
+    pthread_join(prefetch->thread, NULL);
+  }
+
+  pthread_cond_destroy(&prefetch->cond);
+  pthread_mutex_destroy(&prefetch->mutex);
+#endif
+
+  serd_free_aligned(prefetch->blocks[1].buf);
+  serd_free_aligned(prefetch->blocks[0].buf);
+  free(prefetch);
+}
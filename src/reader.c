@@ -15,6 +15,9 @@
 */
 
 #include "byte_source.h"
+#include "compress.h"
+#include "index.h"
+#include "memory.h"
 #include "reader.h"
 #include "stack.h"
 #include "system.h"
@@ -22,6 +25,7 @@
 #include "serd_internal.h"
 
 #include <errno.h>
+#include <limits.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -33,8 +37,9 @@ r_err(SerdReader* reader, SerdStatus st, const char* fmt, ...)
 {
   va_list args;
   va_start(args, fmt);
-  const Cursor* const cur = &reader->source.cur;
+  const Cursor* const cur = serd_byte_source_cursor(&reader->source);
   const SerdError     e = {st, cur->filename, cur->line, cur->col, fmt, &args};
+  ++reader->stats.n_errors;
   serd_error(reader->error_sink, reader->error_handle, &e);
   va_end(args);
   return st;
@@ -43,16 +48,43 @@ r_err(SerdReader* reader, SerdStatus st, const char* fmt, ...)
 void
 set_blank_id(SerdReader* reader, Ref ref, size_t buf_size)
 {
+  if (reader->validate_only) {
+    return; // Leave the ID empty, since it is never used
+  }
+
   SerdNode*   node   = deref(reader, ref);
   const char* prefix = reader->bprefix ? (const char*)reader->bprefix : "";
-  node->n_bytes = node->n_chars = (size_t)snprintf(
-    (char*)node->buf, buf_size, "%sb%u", prefix, reader->next_id++);
+  node->n_bytes = node->n_chars = (size_t)snprintf((char*)node->buf,
+                                                   buf_size,
+                                                   "%sb%s%u",
+                                                   prefix,
+                                                   reader->genid_prefix,
+                                                   reader->next_id++);
 }
 
 size_t
 genid_size(SerdReader* reader)
 {
-  return reader->bprefix_len + 1 + 10 + 1; // + "b" + UINT32_MAX + \0
+  // bprefix + "b" + genid_prefix + UINT32_MAX + \0
+  return reader->bprefix_len + strlen(reader->genid_prefix) + 1 + 10 + 1;
+}
+
+SerdStatus
+merge_blank_labels(SerdReader* const reader,
+                   const bool        seen_genid,
+                   const bool        seen_renamed)
+{
+  const bool clashed = reader->seen_genid && reader->seen_renamed;
+
+  reader->seen_genid   = reader->seen_genid || seen_genid;
+  reader->seen_renamed = reader->seen_renamed || seen_renamed;
+  if (!clashed && reader->seen_genid && reader->seen_renamed) {
+    return r_err(reader,
+                 SERD_ERR_ID_CLASH,
+                 "found both `b' and `B' blank IDs, prefix required\n");
+  }
+
+  return SERD_SUCCESS;
 }
 
 Ref
@@ -98,9 +130,14 @@ push_node_padded(SerdReader* reader,
   uint8_t* buf = (uint8_t*)(node + 1);
   memcpy(buf, str, n_bytes + 1);
 
+  ++reader->stats.n_nodes;
+  if (reader->stack.size > reader->stats.peak_stack_size) {
+    reader->stats.peak_stack_size = reader->stack.size;
+  }
+
 #ifdef SERD_STACK_CHECK
-  reader->allocs                       = (Ref*)realloc(reader->allocs,
-                                 sizeof(reader->allocs) * (++reader->n_allocs));
+  reader->allocs = (Ref*)serd_arealloc(
+    &reader->allocator, reader->allocs, sizeof(Ref) * (++reader->n_allocs));
   reader->allocs[reader->n_allocs - 1] = ((uint8_t*)mem - reader->stack.buf);
 #endif
   return (Ref)((uint8_t*)node - reader->stack.buf);
@@ -139,40 +176,260 @@ pop_node(SerdReader* reader, Ref ref)
   return 0;
 }
 
+/// Report an error if `node` is a CURIE with an undefined prefix
+static SerdStatus
+check_prefix(SerdReader* reader, const SerdNode* node)
+{
+  SerdChunk prefix = {NULL, 0u};
+  SerdChunk suffix = {NULL, 0u};
+  if (node && node->type == SERD_CURIE &&
+      serd_env_expand(reader->prefixes, node, &prefix, &suffix)) {
+    return r_err(reader,
+                 SERD_ERR_BAD_CURIE,
+                 "undefined namespace prefix `%s'\n",
+                 node->buf);
+  }
+
+  return SERD_SUCCESS;
+}
+
+SerdStatus
+sink_statement(void*              handle,
+               SerdStatementFlags flags,
+               const SerdNode*    graph,
+               const SerdNode*    subject,
+               const SerdNode*    predicate,
+               const SerdNode*    object,
+               const SerdNode*    object_datatype,
+               const SerdNode*    object_lang)
+{
+  SerdReader* const reader = (SerdReader*)handle;
+
+  if (reader->validate_only) {
+    SerdStatus st = SERD_SUCCESS;
+    if (!(st = check_prefix(reader, graph)) &&
+        !(st = check_prefix(reader, subject)) &&
+        !(st = check_prefix(reader, predicate)) &&
+        !(st = check_prefix(reader, object))) {
+      st = check_prefix(reader, object_datatype);
+    }
+
+    return st;
+  }
+
+  if (reader->id_sink) {
+    SerdDictionary* const dict = reader->dictionary;
+
+    return reader->id_sink(reader->handle,
+                           flags,
+                           serd_dictionary_intern(dict, graph),
+                           serd_dictionary_intern(dict, subject),
+                           serd_dictionary_intern(dict, predicate),
+                           serd_dictionary_intern(dict, object),
+                           serd_dictionary_intern(dict, object_datatype),
+                           serd_dictionary_intern(dict, object_lang));
+  }
+
+  if (!reader->batch_sink) {
+    return !reader->statement_sink ? SERD_SUCCESS
+                                   : reader->statement_sink(reader->handle,
+                                                            flags,
+                                                            graph,
+                                                            subject,
+                                                            predicate,
+                                                            object,
+                                                            object_datatype,
+                                                            object_lang);
+  }
+
+  serd_statements_push(&reader->batch,
+                       flags,
+                       graph,
+                       subject,
+                       predicate,
+                       object,
+                       object_datatype,
+                       object_lang);
+
+  return reader->batch.n_statements < reader->max_batch ? SERD_SUCCESS
+                                                        : flush_batch(reader);
+}
+
+SerdStatus
+flush_batch(SerdReader* reader)
+{
+  if (!reader->batch.n_statements) {
+    return SERD_SUCCESS;
+  }
+
+  const SerdStatus st = serd_statements_emit_batches(&reader->batch,
+                                                     reader->batch_array,
+                                                     reader->max_batch,
+                                                     reader->batch_sink,
+                                                     reader->handle);
+
+  serd_statements_clear(&reader->batch);
+  return st;
+}
+
+/// Return the graph of a statement, which may be the default graph
+static const SerdNode*
+context_graph(SerdReader* reader, const ReadContext ctx)
+{
+  const SerdNode* const graph = deref(reader, ctx.graph);
+
+  return (!graph && reader->default_graph.buf) ? &reader->default_graph
+                                                : graph;
+}
+
+static SerdStatus
+emit_context(SerdReader* reader, ReadContext ctx, Ref o, Ref d, Ref l)
+{
+  const SerdStatus st = sink_statement(reader,
+                                       *ctx.flags,
+                                       context_graph(reader, ctx),
+                                       deref(reader, ctx.subject),
+                                       deref(reader, ctx.predicate),
+                                       deref(reader, o),
+                                       deref(reader, d),
+                                       deref(reader, l));
+
+  *ctx.flags &= SERD_ANON_CONT | SERD_LIST_CONT; // Preserve only cont flags
+  ++reader->n_statements;
+  ++reader->stats.n_statements;
+  return st;
+}
+
+SerdStatus
+emit_deferred(SerdReader* reader)
+{
+  if (!reader->deferred.object) {
+    return SERD_SUCCESS;
+  }
+
+  const ReadContext ctx = reader->deferred;
+
+  reader->deferred.object = 0;
+  return emit_context(reader, ctx, ctx.object, 0, 0);
+}
+
+SerdStatus
+defer_statement(SerdReader* reader, ReadContext ctx, Ref o)
+{
+  const SerdStatus st = emit_deferred(reader);
+
+  reader->deferred        = ctx;
+  reader->deferred.object = o;
+  reader->deferred.flags  = &reader->deferred_flags;
+  reader->deferred_flags  = *ctx.flags;
+
+  *ctx.flags &= SERD_ANON_CONT | SERD_LIST_CONT; // As if it was emitted
+  return st;
+}
+
 SerdStatus
 emit_statement(SerdReader* reader, ReadContext ctx, Ref o, Ref d, Ref l)
 {
-  SerdNode* graph = deref(reader, ctx.graph);
+  const SerdStatus st = emit_deferred(reader);
+
+  return st ? st : emit_context(reader, ctx, o, d, l);
+}
+
+SerdStatus
+emit_literal_piece(SerdReader* reader, const Ref ref, SerdNodeFlags* flags)
+{
+  SERD_STACK_ASSERT_TOP(reader, ref);
+
+  SerdNode* const node = (SerdNode*)(reader->stack.buf + ref);
+  SerdStatus      st   = SERD_SUCCESS;
+
+  *flags |= SERD_IS_CHUNKED;
+  if (!node->n_bytes) {
+    return st;
+  }
+
+  if (!reader->validate_only && !(st = emit_deferred(reader)) &&
+      !(st = flush_batch(reader))) {
+    const ReadContext* const ctx   = reader->literal_ctx;
+    const SerdNode           piece = {
+      (const uint8_t*)(node + 1), node->n_bytes, node->n_chars, 0u, node->type};
+
+    st = reader->literal_sink(reader->handle,
+                              *ctx->flags,
+                              context_graph(reader, *ctx),
+                              deref(reader, ctx->subject),
+                              deref(reader, ctx->predicate),
+                              &piece);
+  }
+
+  // Pop the string, leaving an empty node
+  serd_stack_pop(&reader->stack, node->n_bytes);
+  reader->stack.buf[reader->stack.size - 1u] = '\0';
+  node->n_bytes = node->n_chars = 0u;
+  return st;
+}
+
+bool
+filter_accepts(SerdReader* reader, const ReadContext ctx)
+{
+  if (!reader->filter) {
+    return true;
+  }
+
+  const SerdNode* graph = deref(reader, ctx.graph);
   if (!graph && reader->default_graph.buf) {
     graph = &reader->default_graph;
   }
 
-  const SerdStatus st = !reader->statement_sink
-                          ? SERD_SUCCESS
-                          : reader->statement_sink(reader->handle,
-                                                   *ctx.flags,
-                                                   graph,
-                                                   deref(reader, ctx.subject),
-                                                   deref(reader, ctx.predicate),
-                                                   deref(reader, o),
-                                                   deref(reader, d),
-                                                   deref(reader, l));
+  return reader->filter(
+    reader->filter_handle, graph, deref(reader, ctx.predicate));
+}
 
-  *ctx.flags &= SERD_ANON_CONT | SERD_LIST_CONT; // Preserve only cont flags
-  return st;
+void
+update_index(SerdReader* reader)
+{
+  SerdByteSource* const source     = &reader->source;
+  const SerdCheckpoint  checkpoint = {serd_byte_source_offset(source),
+                                      reader->n_statements,
+                                      serd_byte_source_cursor(source)->line};
+
+  serd_index_update(reader->index, &checkpoint);
 }
 
 static SerdStatus
 read_statement(SerdReader* reader)
 {
-  return read_n3_statement(reader);
+  switch (reader->syntax) {
+  case SERD_NTRIPLES:
+  case SERD_NQUADS:
+    return read_ntriples_statement(reader);
+  case SERD_BINARY:
+    return read_binary_statement(reader);
+  default:
+    return read_n3_statement(reader);
+  }
 }
 
-static SerdStatus
+SerdStatus
 read_doc(SerdReader* reader)
 {
-  return ((reader->syntax == SERD_NQUADS) ? read_nquadsDoc(reader)
-                                          : read_turtleTrigDoc(reader));
+  SerdStatus st = SERD_SUCCESS;
+  switch (reader->syntax) {
+  case SERD_NTRIPLES:
+    st = read_ntriplesDoc(reader);
+    break;
+  case SERD_NQUADS:
+    st = read_nquadsDoc(reader);
+    break;
+  case SERD_BINARY:
+    st = read_binaryDoc(reader);
+    break;
+  default:
+    st = read_turtleTrigDoc(reader);
+  }
+
+  const SerdStatus flush_st = flush_batch(reader);
+  return st ? st : flush_st;
 }
 
 SerdReader*
@@ -184,7 +441,33 @@ serd_reader_new(SerdSyntax syntax,
                 SerdStatementSink statement_sink,
                 SerdEndSink       end_sink)
 {
-  SerdReader* me     = (SerdReader*)calloc(1, sizeof(SerdReader));
+  return serd_reader_new_with_allocator(NULL,
+                                        syntax,
+                                        handle,
+                                        free_handle,
+                                        base_sink,
+                                        prefix_sink,
+                                        statement_sink,
+                                        end_sink);
+}
+
+SerdReader*
+serd_reader_new_with_allocator(const SerdAllocator* allocator,
+                               SerdSyntax           syntax,
+                               void*                handle,
+                               void (*free_handle)(void*),
+                               SerdBaseSink      base_sink,
+                               SerdPrefixSink    prefix_sink,
+                               SerdStatementSink statement_sink,
+                               SerdEndSink       end_sink)
+{
+  SerdReader* const me =
+    (SerdReader*)serd_acalloc(allocator, 1, sizeof(SerdReader));
+
+  if (allocator) {
+    me->allocator = *allocator;
+  }
+
   me->handle         = handle;
   me->free_handle    = free_handle;
   me->base_sink      = base_sink;
@@ -192,7 +475,7 @@ serd_reader_new(SerdSyntax syntax,
   me->statement_sink = statement_sink;
   me->end_sink       = end_sink;
   me->default_graph  = SERD_NODE_NULL;
-  me->stack          = serd_stack_new(SERD_PAGE_SIZE);
+  me->stack          = serd_stack_new(&me->allocator, SERD_PAGE_SIZE);
   me->syntax         = syntax;
   me->next_id        = 1;
   me->strict         = true;
@@ -210,6 +493,21 @@ serd_reader_set_strict(SerdReader* reader, bool strict)
   reader->strict = strict;
 }
 
+void
+serd_reader_set_lazy_positions(SerdReader* reader, bool lazy)
+{
+  reader->lazy_positions = lazy;
+}
+
+void
+serd_reader_set_validate_only(SerdReader* reader, bool validate_only)
+{
+  reader->validate_only = validate_only;
+  if (validate_only && !reader->prefixes) {
+    reader->prefixes = serd_env_new_with_allocator(&reader->allocator, NULL);
+  }
+}
+
 void
 serd_reader_set_error_sink(SerdReader*   reader,
                            SerdErrorSink error_sink,
@@ -219,6 +517,53 @@ serd_reader_set_error_sink(SerdReader*   reader,
   reader->error_handle = error_handle;
 }
 
+void
+serd_reader_set_dictionary(SerdReader*     reader,
+                           SerdDictionary* dictionary,
+                           SerdIDSink      id_sink)
+{
+  reader->dictionary = dictionary;
+  reader->id_sink    = dictionary ? id_sink : NULL;
+}
+
+void
+serd_reader_set_filter(SerdReader* reader, SerdFilterFunc filter, void* handle)
+{
+  reader->filter        = filter;
+  reader->filter_handle = handle;
+}
+
+void
+serd_reader_set_batch_sink(SerdReader*   reader,
+                           size_t        max_batch,
+                           SerdBatchSink batch_sink)
+{
+  serd_statements_free(&reader->batch);
+  serd_afree(&reader->allocator, reader->batch_array);
+  reader->batch_sink  = NULL;
+  reader->batch_array = NULL;
+  reader->max_batch   = 0u;
+
+  if (batch_sink && max_batch) {
+    reader->batch_sink = batch_sink;
+    reader->batch = serd_statements_new(&reader->allocator, SERD_PAGE_SIZE);
+    reader->batch_array = (SerdStatement*)serd_acalloc(
+      &reader->allocator, max_batch, sizeof(SerdStatement));
+    reader->max_batch = max_batch;
+  }
+}
+
+void
+serd_reader_set_literal_sink(SerdReader*     reader,
+                             size_t          max_bytes,
+                             SerdLiteralSink literal_sink)
+{
+  // The graph of an NQuads statement is only known after the object
+  reader->literal_sink =
+    (max_bytes && reader->syntax != SERD_NQUADS) ? literal_sink : NULL;
+  reader->max_literal = max_bytes;
+}
+
 void
 serd_reader_free(SerdReader* reader)
 {
@@ -229,17 +574,63 @@ serd_reader_free(SerdReader* reader)
   pop_node(reader, reader->rdf_nil);
   pop_node(reader, reader->rdf_rest);
   pop_node(reader, reader->rdf_first);
-  serd_node_free(&reader->default_graph);
+  serd_node_afree(&reader->allocator, &reader->default_graph);
 
 #ifdef SERD_STACK_CHECK
-  free(reader->allocs);
+  serd_afree(&reader->allocator, reader->allocs);
 #endif
-  free(reader->stack.buf);
-  free(reader->bprefix);
+  serd_statements_free(&reader->batch);
+  serd_afree(&reader->allocator, reader->batch_array);
+  serd_arena_free(reader->term_arena);
+  serd_afree(&reader->allocator, reader->terms);
+  serd_env_free(reader->prefixes);
+  serd_stack_free(&reader->stack);
+  serd_afree(&reader->allocator, reader->feed.buf);
+  serd_afree(&reader->allocator, reader->bprefix);
   if (reader->free_handle) {
     reader->free_handle(reader->handle);
   }
-  free(reader);
+
+  const SerdAllocator allocator = reader->allocator;
+  serd_afree(&allocator, reader);
+}
+
+SerdStatus
+serd_reader_reset(SerdReader* reader)
+{
+  const SerdStatus st = serd_byte_source_close(&reader->source);
+
+  serd_reader_end_feed(reader);
+
+  // Pop everything but the nodes pushed by serd_reader_new()
+  const SerdNode* const nil = deref(reader, reader->rdf_nil);
+  reader->stack.size = reader->rdf_nil + sizeof(SerdNode) + nil->n_bytes + 1u;
+#ifdef SERD_STACK_CHECK
+  reader->n_allocs = 3u;
+#endif
+
+  if (reader->batch_sink) {
+    serd_statements_clear(&reader->batch);
+  }
+
+  reader->n_terms = 0u;
+  if (reader->term_arena) {
+    serd_arena_reset(reader->term_arena);
+  }
+
+  if (reader->prefixes) {
+    serd_env_free(reader->prefixes);
+    reader->prefixes = serd_env_new_with_allocator(&reader->allocator, NULL);
+  }
+
+  memset(&reader->stats, 0, sizeof(reader->stats));
+  reader->n_statements    = 0u;
+  reader->start_offset    = 0u;
+  reader->next_id         = 1;
+  reader->genid_prefix[0] = '\0';
+  reader->seen_genid      = false;
+  reader->seen_renamed    = false;
+  return st;
 }
 
 void*
@@ -248,26 +639,62 @@ serd_reader_get_handle(const SerdReader* reader)
   return reader->handle;
 }
 
+void
+serd_reader_add_stats(SerdReaderStats* total, const SerdReaderStats* stats)
+{
+  total->n_bytes += stats->n_bytes;
+  total->n_statements += stats->n_statements;
+  total->n_nodes += stats->n_nodes;
+  total->n_pages += stats->n_pages;
+  total->read_time += stats->read_time;
+  total->n_errors += stats->n_errors;
+  total->n_recoveries += stats->n_recoveries;
+  if (stats->peak_stack_size > total->peak_stack_size) {
+    total->peak_stack_size = stats->peak_stack_size;
+  }
+}
+
+SerdReaderStats
+serd_reader_get_stats(const SerdReader* reader)
+{
+  // Add the progress so far in the source that is being read, if any
+  const SerdByteSource* const source = &reader->source;
+  SerdReaderStats             stats  = reader->stats;
+
+  if (source->prepared) {
+    stats.n_bytes += serd_byte_source_offset(source) - reader->start_offset;
+  }
+
+  stats.n_pages += source->n_pages;
+  stats.read_time += source->read_time;
+  return stats;
+}
+
 void
 serd_reader_add_blank_prefix(SerdReader* reader, const uint8_t* prefix)
 {
-  free(reader->bprefix);
+  serd_afree(&reader->allocator, reader->bprefix);
   reader->bprefix_len = 0;
   reader->bprefix     = NULL;
 
   const size_t prefix_len = prefix ? strlen((const char*)prefix) : 0;
   if (prefix_len) {
     reader->bprefix_len = prefix_len;
-    reader->bprefix     = (uint8_t*)malloc(reader->bprefix_len + 1);
-    memcpy(reader->bprefix, prefix, reader->bprefix_len + 1);
+    reader->bprefix = serd_astrdup(&reader->allocator, prefix, prefix_len);
   }
 }
 
+void
+serd_reader_set_index(SerdReader* reader, SerdIndex* index)
+{
+  reader->index = index;
+}
+
 void
 serd_reader_set_default_graph(SerdReader* reader, const SerdNode* graph)
 {
-  serd_node_free(&reader->default_graph);
-  reader->default_graph = serd_node_copy(graph);
+  serd_node_afree(&reader->allocator, &reader->default_graph);
+  reader->default_graph = serd_node_acopy(&reader->allocator, graph);
 }
 
 SerdStatus
@@ -330,13 +757,22 @@ serd_reader_start_source_stream(SerdReader*         reader,
                                 const uint8_t*      name,
                                 size_t              page_size)
 {
-  return serd_byte_source_open_source(
-    &reader->source, read_func, error_func, stream, name, page_size);
+  return serd_byte_source_open_source(&reader->source,
+                                      &reader->allocator,
+                                      read_func,
+                                      error_func,
+                                      stream,
+                                      name,
+                                      page_size);
 }
 
 static SerdStatus
 serd_reader_prepare(SerdReader* reader)
 {
+  reader->n_statements = 0u;
+  reader->start_offset = reader->source.offset;
+  serd_byte_source_set_lazy(&reader->source, reader->lazy_positions);
+
   SerdStatus st = serd_byte_source_prepare(&reader->source);
   if (st == SERD_SUCCESS) {
     st = skip_bom(reader);
@@ -363,26 +799,124 @@ serd_reader_read_chunk(SerdReader* reader)
     eat_byte_safe(reader, 0);
   }
 
-  return st ? st : read_statement(reader);
+  if (st) {
+    return st;
+  }
+
+  st                        = read_statement(reader);
+  const SerdStatus flush_st = flush_batch(reader);
+  return st ? st : flush_st;
 }
 
 SerdStatus
-serd_reader_end_stream(SerdReader* reader)
+serd_reader_close_source(SerdReader* reader)
 {
+  reader->stats = serd_reader_get_stats(reader);
   return serd_byte_source_close(&reader->source);
 }
 
+SerdStatus
+serd_reader_end_stream(SerdReader* reader)
+{
+  return serd_reader_close_source(reader);
+}
+
+/// Read `file` from the current position, or from `checkpoint` if given
+static SerdStatus
+read_file(SerdReader* const           reader,
+          FILE* const                 file,
+          const uint8_t* const        name,
+          const SerdCheckpoint* const checkpoint)
+{
+  const long         pos     = ftell(file);
+  SerdDecoder* const decoder = serd_decoder_new(
+    &reader->allocator, (SerdSource)fread, (SerdStreamErrorFunc)ferror, file);
+
+  const SerdCompression compression = serd_decoder_compression(decoder);
+
+  SerdStatus st = serd_reader_start_source_stream(
+    reader,
+    serd_decoder_read,
+    serd_decoder_error,
+    decoder,
+    name,
+    compression ? SERD_COMPRESSED_PAGE_SIZE : SERD_PAGE_SIZE);
+
+  // Offsets in compressed input are not file positions, so don't index it
+  SerdIndex* const index = reader->index;
+  if (compression) {
+    reader->index = NULL;
+  } else {
+    reader->source.offset = pos > 0 ? (uint64_t)pos : 0u;
+  }
+
+  if (!st && !serd_compression_supported(compression)) {
+    st = r_err(reader,
+               SERD_ERR_BAD_ARG,
+               "%s input is not supported\n",
+               serd_compression_name(compression));
+  } else if (!st && !(st = serd_reader_prepare(reader))) {
+    if (checkpoint) {
+      reader->n_statements = checkpoint->n_statements;
+      serd_byte_source_cursor(&reader->source)->line = checkpoint->line;
+    }
+
+    st = read_doc(reader);
+  }
+
+  reader->index = index;
+
+  if (st <= SERD_FAILURE && compression && serd_decoder_error(decoder)) {
+    st = r_err(reader,
+               SERD_ERR_UNKNOWN,
+               "corrupt %s input\n",
+               serd_compression_name(compression));
+  }
+
+  serd_reader_end_stream(reader);
+  serd_decoder_free(decoder);
+  return st;
+}
+
 SerdStatus
 serd_reader_read_file_handle(SerdReader*    reader,
                              FILE*          file,
                              const uint8_t* name)
 {
-  return serd_reader_read_source(reader,
-                                 (SerdSource)fread,
-                                 (SerdStreamErrorFunc)ferror,
-                                 file,
-                                 name,
-                                 SERD_PAGE_SIZE);
+  return read_file(reader, file, name, NULL);
+}
+
+SerdStatus
+serd_reader_read_file_handle_at(SerdReader*           reader,
+                                FILE*                 file,
+                                const uint8_t*        name,
+                                const SerdCheckpoint* checkpoint)
+{
+  if ((reader->syntax != SERD_NTRIPLES && reader->syntax != SERD_NQUADS) ||
+      checkpoint->offset > (uint64_t)LONG_MAX ||
+      fseek(file, (long)checkpoint->offset, SEEK_SET)) {
+    return SERD_ERR_BAD_ARG;
+  }
+
+  return read_file(reader, file, name, checkpoint);
+}
+
+SerdStatus
+serd_reader_read_mapped_file_handle(SerdReader*    reader,
+                                    FILE*          file,
+                                    const uint8_t* name)
+{
+  SerdStatus st = serd_byte_source_open_mapped(&reader->source, file, name);
+  if (st == SERD_FAILURE) {
+    return serd_reader_read_file_handle(reader, file, name);
+  }
+
+  if (!(st = serd_reader_prepare(reader))) {
+    st = read_doc(reader);
+  }
+
+  serd_reader_close_source(reader);
+  return st;
 }
 
 SerdStatus
@@ -419,7 +953,7 @@ serd_reader_read_string(SerdReader* reader, const uint8_t* utf8)
     st = read_doc(reader);
   }
 
-  serd_byte_source_close(&reader->source);
+  serd_reader_close_source(reader);
 
   return st;
 }
@@ -18,12 +18,15 @@
 #define SERD_READER_H
 
 #include "byte_source.h"
+#include "scan.h"
 #include "stack.h"
+#include "statements.h"
 
 #include "serd/serd.h"
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 
@@ -55,34 +58,111 @@ typedef struct {
   SerdStatementFlags* flags;
 } ReadContext;
 
+/// Lexical state of the scanner that finds the end of fed statements
+typedef enum {
+  FEED_TOP,         ///< Between tokens
+  FEED_WORD,        ///< In the first word of a statement
+  FEED_COMMENT,     ///< In a comment
+  FEED_IRI,         ///< In an IRI reference
+  FEED_QUOTES,      ///< In the quotes that start a string
+  FEED_STRING,      ///< In a short string
+  FEED_LONG_STRING, ///< In a long string
+  FEED_DOT          ///< After a dot that may end a statement
+} FeedState;
+
+/// Input fed to the reader which has not been read yet
+typedef struct {
+  uint8_t*  buf;       ///< Start of an incomplete statement
+  size_t    len;       ///< Number of bytes in buf
+  size_t    size;      ///< Allocated size of buf
+  uint64_t  offset;    ///< Offset of the next byte to read in the input
+  Cursor    cur;       ///< Cursor at offset
+  FeedState state;     ///< Lexical state at the end of the input
+  unsigned  depth;     ///< Depth of brackets, parentheses, and braces
+  unsigned  n_quotes;  ///< Number of consecutive quotes in a string
+  unsigned  word_len;  ///< Length of the first word of a statement
+  char      word[8];   ///< First word of a statement, if it is short
+  uint8_t   quote;     ///< Quote character of the current string
+  bool      escaped;   ///< True iff the last byte was a backslash
+  bool      at_start;  ///< True iff no statement has been started
+  bool      directive; ///< True iff the statement ends after the next IRI
+  bool      started;   ///< True iff a document is being fed
+} ReadFeed;
+
 struct SerdReaderImpl {
-  void* handle;
+  SerdAllocator allocator; ///< Allocator for everything the reader owns
+  void*         handle;
   void (*free_handle)(void* ptr);
   SerdBaseSink      base_sink;
   SerdPrefixSink    prefix_sink;
   SerdStatementSink statement_sink;
   SerdEndSink       end_sink;
+  SerdBatchSink     batch_sink;
+  SerdIDSink        id_sink;
+  SerdLiteralSink   literal_sink;
   SerdErrorSink     error_sink;
   void*             error_handle;
+  SerdFilterFunc    filter;
+  void*             filter_handle;
+  SerdStatements    batch;        ///< Statements not yet passed to batch_sink
+  SerdStatement*    batch_array;  ///< Array of max_batch for batch_sink
+  size_t            max_batch;    ///< Maximum number of statements in a batch
+  size_t            max_literal;  ///< Length of literals to pass in pieces
+  SerdDictionary*   dictionary;   ///< Dictionary for id_sink, not owned
+  SerdNode*         terms;        ///< Term table for binary syntax
+  size_t            n_terms;      ///< Number of terms in the table
+  size_t            terms_size;   ///< Number of allocated terms
+  SerdArena*        term_arena;   ///< Strings of terms, or null
+  SerdIndex*        index;        ///< Index to add checkpoints to, not owned
+  SerdEnv*          prefixes;     ///< Defined prefixes if only validating
+  uint64_t          n_statements; ///< Number of statements read so far
+  SerdReaderStats   stats;        ///< Statistics of closed sources
+  uint64_t          start_offset; ///< Offset where reading the source started
   Ref               rdf_first;
   Ref               rdf_rest;
   Ref               rdf_nil;
   SerdNode          default_graph;
   SerdByteSource    source;
+  ReadFeed          feed; ///< Input passed to serd_reader_feed()
   SerdStack         stack;
   SerdSyntax        syntax;
   unsigned          next_id;
   uint8_t*          buf;
   uint8_t*          bprefix;
   size_t            bprefix_len;
+  char              genid_prefix[16]; ///< Extra prefix for generated IDs
   bool              strict; ///< True iff strict parsing
-  bool              seen_genid;
+  bool              lazy_positions; ///< True iff lines are counted lazily
+  bool              validate_only;  ///< True iff no sinks are called
+  bool              seen_genid;     ///< True iff a label like an ID was read
+  bool              seen_renamed;   ///< True iff a label like `B1' was read
+  bool              rename_labels;  ///< True iff NTriples labels are renamed
+
+  const ReadContext* literal_ctx;    ///< Statement of the literal being read
+  ReadContext        deferred;       ///< Statement not emitted yet, if object
+  SerdStatementFlags deferred_flags; ///< Flags of the deferred statement
 #ifdef SERD_STACK_CHECK
   Ref*   allocs;   ///< Stack of push offsets
   size_t n_allocs; ///< Number of stack pushes
 #endif
 };
 
+/// Close the current source, and add its statistics to the reader's
+SerdStatus
+serd_reader_close_source(SerdReader* reader);
+
+/// Add `stats` to the statistics in `total`
+void
+serd_reader_add_stats(SerdReaderStats* total, const SerdReaderStats* stats);
+
+/// Read a whole document from the current source
+SerdStatus
+read_doc(SerdReader* reader);
+
+/// Discard any input that was fed to the reader but not read yet
+void
+serd_reader_end_feed(SerdReader* reader);
+
 SERD_LOG_FUNC(3, 4)
 SerdStatus
 r_err(SerdReader* reader, SerdStatus st, const char* fmt, ...);
@@ -100,6 +180,10 @@ push_node(SerdReader* reader, SerdType type, const char* str, size_t n_bytes);
 SERD_PURE_FUNC size_t
 genid_size(SerdReader* reader);
 
+/// Merge the blank labels seen by another reader, and report any new clash
+SerdStatus
+merge_blank_labels(SerdReader* reader, bool seen_genid, bool seen_renamed);
+
 Ref
 blank_id(SerdReader* reader);
 
@@ -112,18 +196,76 @@ deref(SerdReader* reader, Ref ref);
 Ref
 pop_node(SerdReader* reader, Ref ref);
 
+/// Pass a statement to the statement sink, or add it to the current batch
+SerdStatus
+sink_statement(void*              handle,
+               SerdStatementFlags flags,
+               const SerdNode*    graph,
+               const SerdNode*    subject,
+               const SerdNode*    predicate,
+               const SerdNode*    object,
+               const SerdNode*    object_datatype,
+               const SerdNode*    object_lang);
+
+/// Return true iff statements with the predicate in `ctx` should be read
+bool
+filter_accepts(SerdReader* reader, ReadContext ctx);
+
+/// Pass any statements in the current batch to the batch sink
+SerdStatus
+flush_batch(SerdReader* reader);
+
+/// Emit the statement deferred by defer_statement(), if there is one
+SerdStatus
+emit_deferred(SerdReader* reader);
+
+/**
+   Defer emitting a statement with an anonymous object until the next one.
+
+   This is used when the object may turn out to be empty, so the statement can
+   be changed before it is emitted.  Any statement already deferred is emitted
+   first.
+*/
+SerdStatus
+defer_statement(SerdReader* reader, ReadContext ctx, Ref o);
+
 SerdStatus
 emit_statement(SerdReader* reader, ReadContext ctx, Ref o, Ref d, Ref l);
 
+/// Pass the string of the literal at `ref` to the literal sink, and clear it
+SerdStatus
+emit_literal_piece(SerdReader* reader, Ref ref, SerdNodeFlags* flags);
+
+/// Add a checkpoint at the current position to the index if one is due
+void
+update_index(SerdReader* reader);
+
 SerdStatus
 read_n3_statement(SerdReader* reader);
 
+/// Read an NTriples or NQuads statement, depending on the reader syntax
+SerdStatus
+read_ntriples_statement(SerdReader* reader);
+
+SerdStatus
+read_ntriplesDoc(SerdReader* reader);
+
 SerdStatus
 read_nquadsDoc(SerdReader* reader);
 
+/// Read a statement, or skip to the next line after an error if lax
+SerdStatus
+read_turtleTrigStatement(SerdReader* reader);
+
 SerdStatus
 read_turtleTrigDoc(SerdReader* reader);
 
+SerdStatus
+read_binary_statement(SerdReader* reader);
+
+SerdStatus
+read_binaryDoc(SerdReader* reader);
+
 static inline int
 peek_byte(SerdReader* reader)
 {
@@ -176,7 +318,7 @@ push_byte(SerdReader* reader, Ref ref, const int c)
   SerdNode* const node = (SerdNode*)(reader->stack.buf + ref);
 
   ++node->n_bytes;
-  if (!(c & 0x80)) { // Starts with 0 bit, start of new character
+  if ((c & 0xC0) != 0x80) { // Not a continuation byte, start of new character
     ++node->n_chars;
   }
 
@@ -185,12 +327,54 @@ push_byte(SerdReader* reader, Ref ref, const int c)
   return SERD_SUCCESS;
 }
 
+/// Pop the last byte from a node, which must be an ASCII character
 static inline void
-push_bytes(SerdReader* reader, Ref ref, const uint8_t* bytes, unsigned len)
+pop_byte(SerdReader* reader, Ref ref)
 {
-  for (unsigned i = 0; i < len; ++i) {
-    push_byte(reader, ref, bytes[i]);
-  }
+  SERD_STACK_ASSERT_TOP(reader, ref);
+
+  SerdNode* const node = (SerdNode*)(reader->stack.buf + ref);
+
+  assert(node->n_bytes && node->n_chars);
+  --node->n_bytes;
+  --node->n_chars;
+
+  serd_stack_pop(&reader->stack, 1u);
+  reader->stack.buf[reader->stack.size - 1u] = '\0';
+}
+
+/// Push a span of `n_bytes` bytes that contains exactly `n_chars` characters
+static inline void
+push_span(SerdReader*    reader,
+          Ref            ref,
+          const uint8_t* bytes,
+          size_t         n_bytes,
+          size_t         n_chars)
+{
+  SERD_STACK_ASSERT_TOP(reader, ref);
+
+  serd_stack_push_span(&reader->stack, bytes, n_bytes);
+
+  SerdNode* const node = (SerdNode*)(reader->stack.buf + ref);
+  node->n_bytes += n_bytes;
+  node->n_chars += n_chars;
+}
+
+/// Pass the literal at `ref` to the literal sink if it is long enough
+static inline SerdStatus
+check_literal_piece(SerdReader* reader, Ref ref, SerdNodeFlags* flags)
+{
+  const SerdNode* const node = (const SerdNode*)(reader->stack.buf + ref);
+
+  return (reader->literal_sink && node->n_bytes >= reader->max_literal)
+           ? emit_literal_piece(reader, ref, flags)
+           : SERD_SUCCESS;
+}
+
+static inline void
+push_bytes(SerdReader* reader, Ref ref, const uint8_t* bytes, size_t len)
+{
+  push_span(reader, ref, bytes, len, serd_scan_n_chars(bytes, len));
 }
 
 #endif // SERD_READER_H
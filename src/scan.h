@@ -0,0 +1,374 @@
+/*
+  Copyright 2011-2020 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef SERD_SCAN_H
+#define SERD_SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#  include <arm_neon.h>
+#endif
+
+/*
+  Scanning for runs of plain bytes.
+
+  These functions return the length of the longest prefix of a buffer that
+  contains only bytes which the reader can copy as-is, so the caller only has
+  to process the (rare) bytes that need special handling one at a time.  Runs
+  never contain newlines or non-ASCII bytes, so they are always exactly one
+  character per byte.
+
+  The writer uses the "blocks" variants, which only scan whole 16-byte blocks
+  and leave the remaining bytes for the caller to check with its own tables.
+*/
+
+/// Return true iff `c` needs to be handled specially in a string literal
+static inline bool
+serd_scan_is_string_delim(const uint8_t c)
+{
+  return c < 0x20 || c >= 0x80 || c == '"' || c == '\'' || c == '\\';
+}
+
+/// Return true iff `c` needs to be handled specially in an IRI reference
+static inline bool
+serd_scan_is_iri_delim(const uint8_t c)
+{
+  switch (c) {
+  case '"':
+  case '<':
+  case '>':
+  case '\\':
+  case '^':
+  case '`':
+  case '{':
+  case '|':
+  case '}':
+    return true;
+  default:
+    break;
+  }
+
+  return c <= 0x20 || c >= 0x80;
+}
+
+#if defined(__SSE2__)
+
+/// Return a bit mask of the bytes in `v` that end a string literal run
+static inline unsigned
+serd_scan_string_mask(const __m128i v)
+{
+  // Signed comparison catches both control characters and non-ASCII bytes
+  const __m128i special = _mm_cmplt_epi8(v, _mm_set1_epi8(0x20));
+  const __m128i dquote  = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+  const __m128i squote  = _mm_cmpeq_epi8(v, _mm_set1_epi8('\''));
+  const __m128i bslash  = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+
+  return (unsigned)_mm_movemask_epi8(_mm_or_si128(
+    _mm_or_si128(special, dquote), _mm_or_si128(squote, bslash)));
+}
+
+/// Return a bit mask of the bytes in `v` that end an IRI reference run
+static inline unsigned
+serd_scan_iri_mask(const __m128i v)
+{
+  // Signed comparison catches both space and below, and non-ASCII bytes
+  const __m128i special = _mm_cmplt_epi8(v, _mm_set1_epi8(0x21));
+  const __m128i dquote  = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+  const __m128i langle  = _mm_cmpeq_epi8(v, _mm_set1_epi8('<'));
+  const __m128i rangle  = _mm_cmpeq_epi8(v, _mm_set1_epi8('>'));
+  const __m128i bslash  = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+  const __m128i caret   = _mm_cmpeq_epi8(v, _mm_set1_epi8('^'));
+  const __m128i btick   = _mm_cmpeq_epi8(v, _mm_set1_epi8('`'));
+
+  // Unsigned range check for '{', '|', and '}' (v - '{' <= 2)
+  const __m128i offset = _mm_sub_epi8(v, _mm_set1_epi8('{'));
+  const __m128i brace =
+    _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(2)), offset);
+
+  const __m128i quotes = _mm_or_si128(dquote, bslash);
+  const __m128i angles = _mm_or_si128(langle, rangle);
+  const __m128i others = _mm_or_si128(_mm_or_si128(caret, btick), brace);
+
+  return (unsigned)_mm_movemask_epi8(
+    _mm_or_si128(_mm_or_si128(special, quotes), _mm_or_si128(angles, others)));
+}
+
+#elif defined(__ARM_NEON)
+
+/// Return the index of the first set byte in mask `m`, or 16 if there is none
+static inline size_t
+serd_scan_first(const uint8x16_t m)
+{
+  // Narrow to a 64-bit mask with 4 bits per byte
+  const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(m), 4);
+  const uint64_t  bits     = vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+
+  return bits ? (size_t)(__builtin_ctzll(bits) >> 2) : 16u;
+}
+
+/// Return a mask of the bytes in `v` that end a string literal run
+static inline uint8x16_t
+serd_scan_string_mask(const uint8x16_t v)
+{
+  const uint8x16_t control = vcltq_u8(v, vdupq_n_u8(0x20));
+  const uint8x16_t high    = vcgeq_u8(v, vdupq_n_u8(0x80));
+  const uint8x16_t dquote  = vceqq_u8(v, vdupq_n_u8('"'));
+  const uint8x16_t squote  = vceqq_u8(v, vdupq_n_u8('\''));
+  const uint8x16_t bslash  = vceqq_u8(v, vdupq_n_u8('\\'));
+
+  return vorrq_u8(vorrq_u8(vorrq_u8(control, high), vorrq_u8(dquote, squote)),
+                  bslash);
+}
+
+/// Return a mask of the bytes in `v` that end an IRI reference run
+static inline uint8x16_t
+serd_scan_iri_mask(const uint8x16_t v)
+{
+  const uint8x16_t control = vcleq_u8(v, vdupq_n_u8(0x20));
+  const uint8x16_t high    = vcgeq_u8(v, vdupq_n_u8(0x80));
+  const uint8x16_t dquote  = vceqq_u8(v, vdupq_n_u8('"'));
+  const uint8x16_t langle  = vceqq_u8(v, vdupq_n_u8('<'));
+  const uint8x16_t rangle  = vceqq_u8(v, vdupq_n_u8('>'));
+  const uint8x16_t bslash  = vceqq_u8(v, vdupq_n_u8('\\'));
+  const uint8x16_t caret   = vceqq_u8(v, vdupq_n_u8('^'));
+  const uint8x16_t btick   = vceqq_u8(v, vdupq_n_u8('`'));
+  const uint8x16_t brace =
+    vcleq_u8(vsubq_u8(v, vdupq_n_u8('{')), vdupq_n_u8(2));
+
+  const uint8x16_t quotes = vorrq_u8(dquote, bslash);
+  const uint8x16_t angles = vorrq_u8(langle, rangle);
+  const uint8x16_t others = vorrq_u8(vorrq_u8(caret, btick), brace);
+
+  return vorrq_u8(vorrq_u8(vorrq_u8(control, high), quotes),
+                  vorrq_u8(angles, others));
+}
+
+#endif
+
+/// Return the length of the run at the start of `buf` that a string can copy
+static inline size_t
+serd_scan_string(const uint8_t* const buf, const size_t len)
+{
+  size_t i = 0u;
+
+#if defined(__SSE2__)
+  for (; i + 16u <= len; i += 16u) {
+    const __m128i  v    = _mm_loadu_si128((const __m128i*)(buf + i));
+    const unsigned mask = serd_scan_string_mask(v);
+    if (mask) {
+      return i + (size_t)__builtin_ctz(mask);
+    }
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 16u <= len; i += 16u) {
+    const uint8x16_t mask = serd_scan_string_mask(vld1q_u8(buf + i));
+    const size_t     first = serd_scan_first(mask);
+    if (first < 16u) {
+      return i + first;
+    }
+  }
+#endif
+
+  while (i < len && !serd_scan_is_string_delim(buf[i])) {
+    ++i;
+  }
+
+  return i;
+}
+
+/// Return the length of the run at the start of `buf` that an IRI can copy
+static inline size_t
+serd_scan_iri(const uint8_t* const buf, const size_t len)
+{
+  size_t i = 0u;
+
+#if defined(__SSE2__)
+  for (; i + 16u <= len; i += 16u) {
+    const __m128i  v    = _mm_loadu_si128((const __m128i*)(buf + i));
+    const unsigned mask = serd_scan_iri_mask(v);
+    if (mask) {
+      return i + (size_t)__builtin_ctz(mask);
+    }
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 16u <= len; i += 16u) {
+    const uint8x16_t mask = serd_scan_iri_mask(vld1q_u8(buf + i));
+    const size_t     first = serd_scan_first(mask);
+    if (first < 16u) {
+      return i + first;
+    }
+  }
+#endif
+
+  while (i < len && !serd_scan_is_iri_delim(buf[i])) {
+    ++i;
+  }
+
+  return i;
+}
+
+#if defined(__SSE2__)
+
+/// Return a bit mask of the bytes in `v` that are not printable ASCII text
+static inline unsigned
+serd_scan_text_mask(const __m128i v)
+{
+  // Signed comparison catches both control characters and non-ASCII bytes
+  const __m128i special = _mm_cmplt_epi8(v, _mm_set1_epi8(0x20));
+  const __m128i del     = _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7F));
+  const __m128i dquote  = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+  const __m128i bslash  = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+
+  return (unsigned)_mm_movemask_epi8(
+    _mm_or_si128(_mm_or_si128(special, del), _mm_or_si128(dquote, bslash)));
+}
+
+#elif defined(__ARM_NEON)
+
+/// Return a mask of the bytes in `v` that are not printable ASCII text
+static inline uint8x16_t
+serd_scan_text_mask(const uint8x16_t v)
+{
+  const uint8x16_t control = vcltq_u8(v, vdupq_n_u8(0x20));
+  const uint8x16_t high    = vcgeq_u8(v, vdupq_n_u8(0x7F));
+  const uint8x16_t dquote  = vceqq_u8(v, vdupq_n_u8('"'));
+  const uint8x16_t bslash  = vceqq_u8(v, vdupq_n_u8('\\'));
+
+  return vorrq_u8(vorrq_u8(control, high), vorrq_u8(dquote, bslash));
+}
+
+#endif
+
+/**
+   Return the length of the printable ASCII prefix of `buf` found in blocks.
+
+   Printable means 0x20 to 0x7E except for double quote and backslash.  The
+   returned prefix is plain, but the byte after it may be as well if it is in
+   the final partial block, so the caller must check the rest byte by byte.
+*/
+static inline size_t
+serd_scan_text_blocks(const uint8_t* const buf, const size_t len)
+{
+  size_t i = 0u;
+
+#if defined(__SSE2__)
+  for (; i + 16u <= len; i += 16u) {
+    const __m128i  v    = _mm_loadu_si128((const __m128i*)(buf + i));
+    const unsigned mask = serd_scan_text_mask(v);
+    if (mask) {
+      return i + (size_t)__builtin_ctz(mask);
+    }
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 16u <= len; i += 16u) {
+    const uint8x16_t mask  = serd_scan_text_mask(vld1q_u8(buf + i));
+    const size_t     first = serd_scan_first(mask);
+    if (first < 16u) {
+      return i + first;
+    }
+  }
+#else
+  (void)buf;
+  (void)len;
+#endif
+
+  return i;
+}
+
+/**
+   Return the length of the prefix of `buf` that needs no URI escapes.
+
+   This is like serd_scan_text_blocks(), but for bytes that may be written
+   as-is in an IRI reference, which excludes DEL as well as the delimiters
+   that end a run in serd_scan_iri().
+*/
+static inline size_t
+serd_scan_uri_blocks(const uint8_t* const buf, const size_t len)
+{
+  size_t i = 0u;
+
+#if defined(__SSE2__)
+  const __m128i del = _mm_set1_epi8(0x7F);
+  for (; i + 16u <= len; i += 16u) {
+    const __m128i  v    = _mm_loadu_si128((const __m128i*)(buf + i));
+    const unsigned mask = serd_scan_iri_mask(v) |
+                          (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, del));
+    if (mask) {
+      return i + (size_t)__builtin_ctz(mask);
+    }
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t del = vdupq_n_u8(0x7F);
+  for (; i + 16u <= len; i += 16u) {
+    const uint8x16_t v     = vld1q_u8(buf + i);
+    const uint8x16_t mask  = vorrq_u8(serd_scan_iri_mask(v), vceqq_u8(v, del));
+    const size_t     first = serd_scan_first(mask);
+    if (first < 16u) {
+      return i + first;
+    }
+  }
+#else
+  (void)buf;
+  (void)len;
+#endif
+
+  return i;
+}
+
+/// Return the number of UTF-8 characters in `buf`, which is not validated
+static inline size_t
+serd_scan_n_chars(const uint8_t* const buf, const size_t len)
+{
+  size_t n_chars = 0u;
+  size_t i       = 0u;
+
+#if defined(__SSE2__)
+  // Every byte except continuation bytes (0x80 to 0xBF) starts a character
+  const __m128i last_continuation = _mm_set1_epi8(-65); // 0xBF
+  for (; i + 16u <= len; i += 16u) {
+    const __m128i  v     = _mm_loadu_si128((const __m128i*)(buf + i));
+    const __m128i  start = _mm_cmpgt_epi8(v, last_continuation);
+    const unsigned mask  = (unsigned)_mm_movemask_epi8(start);
+
+    n_chars += (size_t)__builtin_popcount(mask);
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t high_bits = vdupq_n_u8(0xC0);
+  const uint8x16_t cont_bits = vdupq_n_u8(0x80);
+  const uint8x16_t one       = vdupq_n_u8(1);
+  for (; i + 16u <= len; i += 16u) {
+    const uint8x16_t v     = vld1q_u8(buf + i);
+    const uint8x16_t cont  = vceqq_u8(vandq_u8(v, high_bits), cont_bits);
+    const uint8x16_t start = vandq_u8(vmvnq_u8(cont), one);
+    const uint64x2_t sums  = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(start)));
+
+    n_chars += (size_t)(vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1));
+  }
+#endif
+
+  for (; i < len; ++i) {
+    n_chars += (size_t)((buf[i] & 0xC0u) != 0x80u);
+  }
+
+  return n_chars;
+}
+
+#endif // SERD_SCAN_H
@@ -55,6 +55,13 @@
 #    endif
 #  endif
 
+// POSIX.1-2001: clock_gettime()
+#  ifndef HAVE_CLOCK_GETTIME
+#    if defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0
+#      define HAVE_CLOCK_GETTIME
+#    endif
+#  endif
+
 // POSIX.1-2001: fileno()
 #  ifndef HAVE_FILENO
 #    if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
@@ -62,6 +69,13 @@
 #    endif
 #  endif
 
+// POSIX.1-2001: mmap()
+#  ifndef HAVE_MMAP
+#    if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
+#      define HAVE_MMAP
+#    endif
+#  endif
+
 // POSIX.1-2001: posix_fadvise()
 #  ifndef HAVE_POSIX_FADVISE
 #    ifndef __APPLE__
@@ -71,6 +85,13 @@
 #    endif
 #  endif
 
+// POSIX.1-2001: posix_madvise()
+#  ifndef HAVE_POSIX_MADVISE
+#    if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
+#      define HAVE_POSIX_MADVISE
+#    endif
+#  endif
+
 // POSIX.1-2001: posix_memalign()
 #  ifndef HAVE_POSIX_MEMALIGN
 #    if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
@@ -78,6 +99,20 @@
 #    endif
 #  endif
 
+// POSIX.1-2001: pthreads
+#  ifndef HAVE_PTHREAD
+#    if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
+#      define HAVE_PTHREAD
+#    endif
+#  endif
+
+// POSIX.1-2008: realpath()
+#  ifndef HAVE_REALPATH
+#    if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200809L
+#      define HAVE_REALPATH
+#    endif
+#  endif
+
 #endif // !defined(SERD_NO_DEFAULT_CONFIG)
 
 /*
@@ -94,22 +129,64 @@
 #  define USE_ALIGNED_ALLOC 0
 #endif
 
+#ifdef HAVE_CLOCK_GETTIME
+#  define USE_CLOCK_GETTIME 1
+#else
+#  define USE_CLOCK_GETTIME 0
+#endif
+
 #ifdef HAVE_FILENO
 #  define USE_FILENO 1
 #else
 #  define USE_FILENO 0
 #endif
 
+#ifdef HAVE_MMAP
+#  define USE_MMAP 1
+#else
+#  define USE_MMAP 0
+#endif
+
 #ifdef HAVE_POSIX_FADVISE
 #  define USE_POSIX_FADVISE 1
 #else
 #  define USE_POSIX_FADVISE 0
 #endif
 
+#ifdef HAVE_POSIX_MADVISE
+#  define USE_POSIX_MADVISE 1
+#else
+#  define USE_POSIX_MADVISE 0
+#endif
+
 #ifdef HAVE_POSIX_MEMALIGN
 #  define USE_POSIX_MEMALIGN 1
 #else
 #  define USE_POSIX_MEMALIGN 0
 #endif
 
+#ifdef HAVE_PTHREAD
+#  define USE_PTHREAD 1
+#else
+#  define USE_PTHREAD 0
+#endif
+
+#ifdef HAVE_REALPATH
+#  define USE_REALPATH 1
+#else
+#  define USE_REALPATH 0
+#endif
+
+#ifdef HAVE_ZLIB
+#  define USE_ZLIB 1
+#else
+#  define USE_ZLIB 0
+#endif
+
+#ifdef HAVE_ZSTD
+#  define USE_ZSTD 1
+#else
+#  define USE_ZSTD 0
+#endif
+
 #endif // SERD_CONFIG_H
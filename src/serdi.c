@@ -14,7 +14,7 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
-#define _POSIX_C_SOURCE 200809L /* for fileno and posix_fadvise */
+#define _XOPEN_SOURCE 700 /* for fileno, posix_fadvise, and realpath */
 
 #include "serd_config.h"
 #include "string_utils.h"
@@ -34,6 +34,8 @@
 #endif
 
 #include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -43,6 +45,12 @@
 #define SERDI_ERROR(msg) fprintf(stderr, "serdi: " msg)
 #define SERDI_ERRORF(fmt, ...) fprintf(stderr, "serdi: " fmt, __VA_ARGS__)
 
+/// Memory limit for statements buffered to be grouped by subject
+#define SERDI_WINDOW_BYTES (64u * 1024u * 1024u)
+
+/// Memory limit for statements sorted at once before using temporary files
+#define SERDI_SORT_BYTES (256u * 1024u * 1024u)
+
 typedef struct {
   SerdSyntax  syntax;
   const char* name;
@@ -53,6 +61,7 @@ static const Syntax syntaxes[] = {{SERD_TURTLE, "turtle", ".ttl"},
                                   {SERD_NTRIPLES, "ntriples", ".nt"},
                                   {SERD_NQUADS, "nquads", ".nq"},
                                   {SERD_TRIG, "trig", ".trig"},
+                                  {SERD_BINARY, "binary", ".serd"},
                                   {(SerdSyntax)0, NULL, NULL}};
 
 static SerdSyntax
@@ -68,13 +77,41 @@ get_syntax(const char* name)
   return (SerdSyntax)0;
 }
 
+static SERD_PURE_FUNC SerdStyle
+guess_compression(const char* filename)
+{
+  const char* ext = strrchr(filename, '.');
+  if (ext && !serd_strncasecmp(ext, ".gz", 4)) {
+    return SERD_STYLE_GZIP;
+  }
+
+  if (ext && !serd_strncasecmp(ext, ".zst", 5)) {
+    return SERD_STYLE_ZSTD;
+  }
+
+  return (SerdStyle)0;
+}
+
 static SERD_PURE_FUNC SerdSyntax
 guess_syntax(const char* filename)
 {
-  const char* ext = strrchr(filename, '.');
+  // Ignore any compression extension, like the ".gz" of "data.nt.gz"
+  size_t len = strlen(filename);
+  if (guess_compression(filename)) {
+    len = (size_t)(strrchr(filename, '.') - filename);
+  }
+
+  const char* ext = NULL;
+  for (size_t i = len; i > 0u && !ext; --i) {
+    if (filename[i - 1u] == '.') {
+      ext = filename + i - 1u;
+    }
+  }
+
   if (ext) {
+    const size_t ext_len = len - (size_t)(ext - filename);
     for (const Syntax* s = syntaxes; s->name; ++s) {
-      if (!serd_strncasecmp(s->extension, ext, strlen(ext))) {
+      if (!serd_strncasecmp(s->extension, ext, ext_len)) {
         return s->syntax;
       }
     }
@@ -83,6 +120,105 @@ guess_syntax(const char* filename)
   return (SerdSyntax)0;
 }
 
+typedef struct {
+  const SerdEnv* env;    ///< Environment for expanding predicates
+  char**         uris;   ///< Predicate URIs to keep
+  size_t         n_uris; ///< Number of URIs in `uris`
+} Filter;
+
+static bool
+filter_has_uri(const Filter* const filter,
+               const SerdChunk     prefix,
+               const SerdChunk     suffix)
+{
+  for (size_t i = 0u; i < filter->n_uris; ++i) {
+    const char* const uri = filter->uris[i];
+    if (strlen(uri) == prefix.len + suffix.len &&
+        !memcmp(uri, prefix.buf, prefix.len) &&
+        (!suffix.len || !memcmp(uri + prefix.len, suffix.buf, suffix.len))) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/// Return true iff `predicate` is one of the URIs given with -F
+static bool
+filter_predicate(void* const           handle,
+                 const SerdNode* const graph,
+                 const SerdNode* const predicate)
+{
+  (void)graph;
+
+  const Filter* const filter = (const Filter*)handle;
+  const SerdChunk     empty  = {NULL, 0u};
+
+  if (predicate->type == SERD_CURIE) {
+    SerdChunk prefix = empty;
+    SerdChunk suffix = empty;
+    if (serd_env_expand(filter->env, predicate, &prefix, &suffix)) {
+      return true; // Keep the statement so the error is reported
+    }
+
+    return filter_has_uri(filter, prefix, suffix);
+  }
+
+  if (serd_uri_string_has_scheme(predicate->buf)) {
+    const SerdChunk uri = {predicate->buf, predicate->n_bytes};
+    return filter_has_uri(filter, uri, empty);
+  }
+
+  SerdNode expanded = serd_env_expand_node(filter->env, predicate);
+  if (!expanded.buf) {
+    return true;
+  }
+
+  const SerdChunk uri    = {expanded.buf, expanded.n_bytes};
+  const bool      accept = filter_has_uri(filter, uri, empty);
+
+  serd_node_free(&expanded);
+  return accept;
+}
+
+/// Reader handle that sorts statements before passing them to the writer
+typedef struct {
+  SerdWriter* writer;
+  SerdSorter* sorter;
+} Sorting;
+
+static SerdStatus
+sort_base(void* const handle, const SerdNode* const uri)
+{
+  return serd_writer_set_base_uri(((Sorting*)handle)->writer, uri);
+}
+
+static SerdStatus
+sort_prefix(void* const handle, const SerdNode* const name, const SerdNode* uri)
+{
+  return serd_writer_set_prefix(((Sorting*)handle)->writer, name, uri);
+}
+
+static SerdStatus
+sort_statement(void*              handle,
+               SerdStatementFlags flags,
+               const SerdNode*    graph,
+               const SerdNode*    subject,
+               const SerdNode*    predicate,
+               const SerdNode*    object,
+               const SerdNode*    object_datatype,
+               const SerdNode*    object_lang)
+{
+  return serd_sorter_write_statement(((Sorting*)handle)->sorter,
+                                     flags,
+                                     graph,
+                                     subject,
+                                     predicate,
+                                     object,
+                                     object_datatype,
+                                     object_lang);
+}
+
 static int
 print_version(void)
 {
@@ -94,28 +230,67 @@ print_version(void)
   return 0;
 }
 
+static void
+print_stat(const char* const name, const uint64_t value)
+{
+  fprintf(stderr, "serdi: %-20s %" PRIu64 "\n", name, value);
+}
+
+static void
+print_stats(const SerdReader* const reader, const SerdWriter* const writer)
+{
+  const SerdReaderStats rstats = serd_reader_get_stats(reader);
+  const SerdWriterStats wstats = serd_writer_get_stats(writer);
+
+  print_stat("bytes read:", rstats.n_bytes);
+  print_stat("statements read:", rstats.n_statements);
+  print_stat("nodes read:", rstats.n_nodes);
+  print_stat("pages read:", rstats.n_pages);
+  print_stat("read wait (ns):", rstats.read_time);
+  print_stat("read errors:", rstats.n_errors);
+  print_stat("read recoveries:", rstats.n_recoveries);
+  print_stat("peak stack size:", (uint64_t)rstats.peak_stack_size);
+  print_stat("bytes written:", wstats.n_bytes);
+  print_stat("statements written:", wstats.n_statements);
+  print_stat("escapes written:", wstats.n_escapes);
+}
+
 static int
 print_usage(const char* name, bool error)
 {
   FILE* const os = error ? stderr : stdout;
   fprintf(os, "%s", error ? "\n" : "");
   fprintf(os, "Usage: %s [OPTION]... INPUT [BASE_URI]\n", name);
+  fprintf(os, "       %s [OPTION]... -M INPUT...\n", name);
   fprintf(os, "Read and write RDF syntax.\n");
   fprintf(os, "Use - for INPUT to read from standard input.\n\n");
   fprintf(os, "  -a           Write ASCII output if possible.\n");
-  fprintf(os, "  -b           Fast bulk output for large serialisations.\n");
+  fprintf(os, "  -b           Fast bulk output in a background thread.\n");
   fprintf(os, "  -c PREFIX    Chop PREFIX from matching blank node IDs.\n");
   fprintf(os, "  -e           Eat input one character at a time.\n");
+  fprintf(os, "  -F URI       Skip objects of predicates other than URI.\n");
   fprintf(os, "  -f           Keep full URIs in input (don't qualify).\n");
+  fprintf(os, "  -G           Put each input in a graph named by its URI.\n");
+  fprintf(os, "  -g COUNT     Group up to COUNT statements by subject.\n");
   fprintf(os, "  -h           Display this help and exit.\n");
-  fprintf(os, "  -i SYNTAX    Input syntax: turtle/ntriples/trig/nquads.\n");
+  fprintf(os,
+          "  -i SYNTAX    Input syntax: "
+          "turtle/ntriples/trig/nquads/binary.\n");
+  fprintf(os, "  -j THREADS   Read input with THREADS threads.\n");
+  fprintf(os, "  -L BYTES     Write literals over BYTES long in pieces.\n");
   fprintf(os, "  -l           Lax (non-strict) parsing.\n");
-  fprintf(os, "  -o SYNTAX    Output syntax: turtle/ntriples/nquads.\n");
+  fprintf(os, "  -M           Merge all remaining arguments as inputs.\n");
+  fprintf(os, "  -m           Map input file into memory (if possible).\n");
+  fprintf(os, "  -n           Only validate input, and print counts.\n");
+  fprintf(os, "  -o SYNTAX    Output syntax: turtle/ntriples/nquads/binary.\n");
   fprintf(os, "  -p PREFIX    Add PREFIX to blank node IDs.\n");
   fprintf(os, "  -q           Suppress all output except data.\n");
   fprintf(os, "  -r ROOT_URI  Keep relative URIs within ROOT_URI.\n");
   fprintf(os, "  -s INPUT     Parse INPUT as string (terminates options).\n");
+  fprintf(os, "  -t           Print reading and writing statistics.\n");
+  fprintf(os, "  -u           Sort statements and remove duplicates.\n");
   fprintf(os, "  -v           Display version information and exit.\n");
+  fprintf(os, "  -w FILENAME  Write output to FILENAME (.gz/.zst compress).\n");
   return error ? 1 : 0;
 }
 
@@ -150,14 +325,102 @@ serd_fopen(const char* path, const char* mode)
   return fd;
 }
 
+/// Return a file URI for `path`, which is absolute if possible
+static SerdNode
+absolute_file_uri(const uint8_t* const path)
+{
+#if USE_REALPATH
+  char* const real_path = realpath((const char*)path, NULL);
+  if (real_path) {
+    const SerdNode node =
+      serd_node_new_file_uri((const uint8_t*)real_path, NULL, NULL, true);
+
+    free(real_path);
+    return node;
+  }
+#endif
+
+  return serd_node_new_file_uri(path, NULL, NULL, true);
+}
+
+/// Read every file in `args` with serd_reader_read_inputs()
+static SerdStatus
+read_merged(SerdReader* const    reader,
+            const size_t         n_args,
+            char** const         args,
+            const SerdSyntax     syntax,
+            const uint8_t* const add_prefix,
+            const bool           graphs,
+            const unsigned       n_threads)
+{
+  SerdInput* const inputs   = (SerdInput*)calloc(n_args, sizeof(SerdInput));
+  SerdNode* const  uris     = (SerdNode*)calloc(n_args, sizeof(SerdNode));
+  uint8_t** const  paths    = (uint8_t**)calloc(n_args, sizeof(uint8_t*));
+  char** const     prefixes = (char**)calloc(n_args, sizeof(char*));
+
+  SerdStatus st = SERD_SUCCESS;
+  for (size_t i = 0u; !st && i < n_args; ++i) {
+    SerdInput* const  input = &inputs[i];
+    const char* const arg   = args[i];
+
+    if (!strcmp(arg, "-")) {
+      input->path = (const uint8_t*)"(stdin)";
+      input->file = stdin;
+    } else if (strncmp(arg, "file:", 5)) {
+      input->path = (const uint8_t*)arg;
+    } else if (!(input->path = paths[i] =
+                   serd_file_uri_parse((const uint8_t*)arg, NULL))) {
+      SERDI_ERRORF("invalid file URI `%s'\n", arg);
+      st = SERD_ERR_BAD_ARG;
+    }
+
+    if (!(input->syntax = syntax)) {
+      input->syntax = guess_syntax((const char*)input->path);
+      input->syntax = input->syntax ? input->syntax : SERD_TRIG;
+    }
+
+    if (!input->file) {
+      uris[i]      = absolute_file_uri(input->path);
+      input->base  = &uris[i];
+      input->graph = graphs ? &uris[i] : NULL;
+    }
+
+    if (add_prefix) {
+      // Add the input number so blank nodes in different inputs are distinct
+      const size_t len = strlen((const char*)add_prefix) + 24u;
+
+      prefixes[i] = (char*)malloc(len);
+      snprintf(prefixes[i], len, "%s%zu_", (const char*)add_prefix, i);
+      input->blank_prefix = (const uint8_t*)prefixes[i];
+    }
+  }
+
+  if (!st) {
+    st = serd_reader_read_inputs(reader, inputs, n_args, n_threads);
+  }
+
+  for (size_t i = 0u; i < n_args; ++i) {
+    serd_node_free(&uris[i]);
+    serd_free(paths[i]);
+    free(prefixes[i]);
+  }
+
+  free(prefixes);
+  free(paths);
+  free(uris);
+  free(inputs);
+  return st;
+}
+
 static SerdStyle
 choose_style(const SerdSyntax input_syntax,
              const SerdSyntax output_syntax,
+             const SerdStyle  compression,
              const bool       ascii,
              const bool       bulk_write,
              const bool       full_uris)
 {
-  unsigned output_style = 0u;
+  unsigned output_style = (unsigned)compression;
   if (output_syntax == SERD_NTRIPLES || ascii) {
     output_style |= SERD_STYLE_ASCII;
   } else if (output_syntax == SERD_TURTLE) {
@@ -167,14 +430,15 @@ choose_style(const SerdSyntax input_syntax,
     }
   }
 
-  if ((input_syntax == SERD_TURTLE || input_syntax == SERD_TRIG) ||
+  if ((input_syntax == SERD_TURTLE || input_syntax == SERD_TRIG ||
+       input_syntax == SERD_BINARY) ||
       (output_style & SERD_STYLE_CURIED)) {
     // Base URI may change and/or we're abbreviating URIs, so must resolve
     output_style |= SERD_STYLE_RESOLVED;
   }
 
   if (bulk_write) {
-    output_style |= SERD_STYLE_BULK;
+    output_style |= SERD_STYLE_BULK | SERD_STYLE_ASYNC;
   }
 
   return (SerdStyle)output_style;
@@ -195,12 +459,23 @@ main(int argc, char** argv)
   bool           bulk_read     = true;
   bool           bulk_write    = false;
   bool           full_uris     = false;
+  bool           graphs        = false;
   bool           lax           = false;
+  bool           mapped        = false;
+  bool           merge         = false;
+  bool           validate      = false;
   bool           quiet         = false;
+  bool           stats         = false;
+  bool           sort          = false;
   const uint8_t* in_name       = NULL;
   const uint8_t* add_prefix    = NULL;
   const uint8_t* chop_prefix   = NULL;
   const uint8_t* root_uri      = NULL;
+  const char*    out_filename  = NULL;
+  unsigned       n_threads     = 1u;
+  size_t         window_size   = 0u;
+  size_t         max_literal   = 0u;
+  Filter         filter        = {NULL, argv + 1, 0u};
   int            a             = 1;
   for (; a < argc && argv[a][0] == '-'; ++a) {
     if (argv[a][1] == '\0') {
@@ -217,12 +492,24 @@ main(int argc, char** argv)
       bulk_read = false;
     } else if (argv[a][1] == 'f') {
       full_uris = true;
+    } else if (argv[a][1] == 'G') {
+      graphs = true;
     } else if (argv[a][1] == 'h') {
       return print_usage(argv[0], false);
     } else if (argv[a][1] == 'l') {
       lax = true;
+    } else if (argv[a][1] == 'm') {
+      mapped = true;
+    } else if (argv[a][1] == 'M') {
+      merge = true;
+    } else if (argv[a][1] == 'n') {
+      validate = true;
     } else if (argv[a][1] == 'q') {
       quiet = true;
+    } else if (argv[a][1] == 't') {
+      stats = true;
+    } else if (argv[a][1] == 'u') {
+      sort = true;
     } else if (argv[a][1] == 'v') {
       return print_version();
     } else if (argv[a][1] == 's') {
@@ -238,6 +525,52 @@ main(int argc, char** argv)
       if (!(input_syntax = get_syntax(argv[a]))) {
         return print_usage(argv[0], true);
       }
+    } else if (argv[a][1] == 'j') {
+      if (++a == argc) {
+        return missing_arg(argv[0], 'j');
+      }
+
+      char*      end = NULL;
+      const long n   = strtol(argv[a], &end, 10);
+      if (n < 1 || (unsigned long)n > UINT_MAX || *end) {
+        SERDI_ERRORF("invalid number of threads `%s'\n", argv[a]);
+        return print_usage(argv[0], true);
+      }
+
+      n_threads = (unsigned)n;
+    } else if (argv[a][1] == 'F') {
+      if (++a == argc) {
+        return missing_arg(argv[0], 'F');
+      }
+
+      // Collect URIs at the start of argv, over options that have been parsed
+      filter.uris[filter.n_uris++] = argv[a];
+    } else if (argv[a][1] == 'g') {
+      if (++a == argc) {
+        return missing_arg(argv[0], 'g');
+      }
+
+      char*      end = NULL;
+      const long n   = strtol(argv[a], &end, 10);
+      if (n < 1 || *end) {
+        SERDI_ERRORF("invalid number of statements `%s'\n", argv[a]);
+        return print_usage(argv[0], true);
+      }
+
+      window_size = (size_t)n;
+    } else if (argv[a][1] == 'L') {
+      if (++a == argc) {
+        return missing_arg(argv[0], 'L');
+      }
+
+      char*      end = NULL;
+      const long n   = strtol(argv[a], &end, 10);
+      if (n < 1 || *end) {
+        SERDI_ERRORF("invalid number of bytes `%s'\n", argv[a]);
+        return print_usage(argv[0], true);
+      }
+
+      max_literal = (size_t)n;
     } else if (argv[a][1] == 'o') {
       if (++a == argc) {
         return missing_arg(argv[0], 'o');
@@ -264,6 +597,12 @@ main(int argc, char** argv)
       }
 
       root_uri = (const uint8_t*)argv[a];
+    } else if (argv[a][1] == 'w') {
+      if (++a == argc) {
+        return missing_arg(argv[0], 'w');
+      }
+
+      out_filename = argv[a];
     } else {
       SERDI_ERRORF("invalid option -- '%s'\n", argv[a] + 1);
       return print_usage(argv[0], true);
@@ -280,9 +619,14 @@ main(int argc, char** argv)
   _setmode(_fileno(stdout), _O_BINARY);
 #endif
 
-  uint8_t*       input_path = NULL;
-  const uint8_t* input      = (const uint8_t*)argv[a++];
-  if (from_file) {
+  const bool       merged       = merge && from_file;
+  const SerdSyntax given_syntax = input_syntax;
+  uint8_t*         input_path   = NULL;
+  const uint8_t*   input        = (const uint8_t*)argv[a++];
+  if (merged) {
+    // Inputs are opened when they are read, so only guess syntax from the first
+    in_name = in_fd ? in_name : input;
+  } else if (from_file) {
     in_name = in_name ? in_name : input;
     if (!in_fd) {
       if (!strncmp((const char*)input, "file:", 5)) {
@@ -299,54 +643,142 @@ main(int argc, char** argv)
     input_syntax = SERD_TRIG;
   }
 
+  if (!output_syntax && out_filename) {
+    output_syntax = guess_syntax(out_filename);
+  }
+
   if (!output_syntax) {
     output_syntax =
-      ((input_syntax == SERD_TURTLE || input_syntax == SERD_NTRIPLES)
+      (!graphs && (input_syntax == SERD_TURTLE || input_syntax == SERD_NTRIPLES)
          ? SERD_NTRIPLES
          : SERD_NQUADS);
   }
 
-  const SerdStyle output_style =
-    choose_style(input_syntax, output_syntax, ascii, bulk_write, full_uris);
+  const SerdStyle compression =
+    out_filename ? guess_compression(out_filename) : (SerdStyle)0;
+
+  const SerdStyle output_style = choose_style(
+    input_syntax, output_syntax, compression, ascii, bulk_write, full_uris);
+
+  FILE* const out_fd = out_filename ? serd_fopen(out_filename, "wb") : stdout;
+  if (!out_fd) {
+    if (in_fd) {
+      fclose(in_fd);
+    }
+
+    free(input_path);
+    return 1;
+  }
 
   SerdURI  base_uri = SERD_URI_NULL;
   SerdNode base     = SERD_NODE_NULL;
-  if (a < argc) { // Base URI given on command line
+  if (!merged && a < argc) { // Base URI given on command line
     base =
       serd_node_new_uri_from_string((const uint8_t*)argv[a], NULL, &base_uri);
-  } else if (from_file && in_fd != stdin) { // Use input file URI
+  } else if (!merged && from_file && in_fd != stdin) { // Use input file URI
     base = serd_node_new_file_uri(input, NULL, &base_uri, true);
   }
 
-  FILE* const    out_fd = stdout;
-  SerdEnv* const env    = serd_env_new(&base);
-
+  SerdEnv* const    env    = serd_env_new(&base);
   SerdWriter* const writer = serd_writer_new(
     output_syntax, output_style, env, &base_uri, serd_file_sink, out_fd);
 
+  if (!writer) {
+    SERDI_ERROR("compressed output is not supported\n");
+    serd_env_free(env);
+    serd_node_free(&base);
+    free(input_path);
+    if (in_fd) {
+      fclose(in_fd);
+    }
+
+    fclose(out_fd);
+    return 1;
+  }
+
+  Sorting sorting = {writer, NULL};
+  if (sort) {
+    sorting.sorter =
+      serd_sorter_new(env,
+                      SERDI_SORT_BYTES,
+                      (SerdStatementSink)serd_writer_write_statement,
+                      writer);
+  }
+
   SerdReader* const reader =
-    serd_reader_new(input_syntax,
-                    writer,
-                    NULL,
-                    (SerdBaseSink)serd_writer_set_base_uri,
-                    (SerdPrefixSink)serd_writer_set_prefix,
-                    (SerdStatementSink)serd_writer_write_statement,
-                    (SerdEndSink)serd_writer_end_anon);
+    sort ? serd_reader_new(input_syntax,
+                           &sorting,
+                           NULL,
+                           sort_base,
+                           sort_prefix,
+                           sort_statement,
+                           NULL)
+         : serd_reader_new(input_syntax,
+                           writer,
+                           NULL,
+                           (SerdBaseSink)serd_writer_set_base_uri,
+                           (SerdPrefixSink)serd_writer_set_prefix,
+                           (SerdStatementSink)serd_writer_write_statement,
+                           (SerdEndSink)serd_writer_end_anon);
 
   serd_reader_set_strict(reader, !lax);
+  serd_reader_set_validate_only(reader, validate);
+  if (quiet || validate) {
+    // Positions are only needed for errors, so don't count lines eagerly
+    serd_reader_set_lazy_positions(reader, true);
+  }
+
   if (quiet) {
     serd_reader_set_error_sink(reader, quiet_error_sink, NULL);
     serd_writer_set_error_sink(writer, quiet_error_sink, NULL);
+    if (sorting.sorter) {
+      serd_sorter_set_error_sink(sorting.sorter, quiet_error_sink, NULL);
+    }
+  }
+
+  SerdNode graph = SERD_NODE_NULL;
+  if (graphs && !merged && from_file && in_fd != stdin) {
+    graph = absolute_file_uri(input);
+    serd_reader_set_default_graph(reader, &graph);
   }
 
   SerdNode root = serd_node_from_string(SERD_URI, root_uri);
   serd_writer_set_root_uri(writer, &root);
   serd_writer_chop_blank_prefix(writer, chop_prefix);
+  serd_writer_set_reorder_window(writer, window_size, SERDI_WINDOW_BYTES);
   serd_reader_add_blank_prefix(reader, add_prefix);
+  if (max_literal && !sort && output_syntax != SERD_BINARY) {
+    // Stream long literals to the writer without reading them into memory
+    serd_reader_set_literal_sink(
+      reader,
+      max_literal,
+      (SerdLiteralSink)serd_writer_write_literal_piece);
+  }
+
+  if (filter.n_uris) {
+    filter.env = env;
+    serd_reader_set_filter(reader, filter_predicate, &filter);
+    if (!merged &&
+        (input_syntax == SERD_TURTLE || input_syntax == SERD_TRIG)) {
+      n_threads = 1u; // The filter reads prefixes while they are being set
+    }
+  }
 
   SerdStatus st = SERD_SUCCESS;
-  if (!from_file) {
+  if (merged) {
+    st = read_merged(reader,
+                     (size_t)(argc - a + 1),
+                     argv + a - 1,
+                     given_syntax,
+                     add_prefix,
+                     graphs,
+                     n_threads);
+  } else if (!from_file) {
     st = serd_reader_read_string(reader, input);
+  } else if (n_threads > 1u) {
+    st = serd_reader_read_parallel(reader, in_fd, in_name, n_threads, true);
+  } else if (mapped) {
+    st = serd_reader_read_mapped_file_handle(reader, in_fd, in_name);
   } else if (bulk_read) {
     st = serd_reader_read_file_handle(reader, in_fd, in_name);
   } else {
@@ -357,14 +789,30 @@ main(int argc, char** argv)
     serd_reader_end_stream(reader);
   }
 
-  serd_reader_free(reader);
+  if (sorting.sorter) {
+    const SerdStatus sort_st = serd_sorter_finish(sorting.sorter);
+    st                       = st > SERD_FAILURE ? st : sort_st;
+  }
+
   serd_writer_finish(writer);
+  if (stats) {
+    print_stats(reader, writer);
+  } else if (validate && !quiet) {
+    const SerdReaderStats rstats = serd_reader_get_stats(reader);
+
+    print_stat("bytes read:", rstats.n_bytes);
+    print_stat("statements read:", rstats.n_statements);
+  }
+
+  serd_reader_free(reader);
+  serd_sorter_free(sorting.sorter);
   serd_writer_free(writer);
   serd_env_free(env);
+  serd_node_free(&graph);
   serd_node_free(&base);
   free(input_path);
 
-  if (from_file) {
+  if (in_fd) {
     fclose(in_fd);
   }
 
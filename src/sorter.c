@@ -0,0 +1,449 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "serd_internal.h"
+#include "stack.h"
+#include "statements.h"
+
+#include "serd/serd.h"
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  Statements are collected in a SerdStatements until it reaches the memory
+  limit, then sorted and written to a temporary file as a run.  A run is
+  simply the statement records, which are self-contained apart from the node
+  string pointers that are set again when a record is decoded.  When
+  finished, the runs are merged by keeping the run with the least current
+  statement at the top of a heap.
+*/
+
+/// A statement in the current run, for sorting
+typedef struct {
+  const SerdNode* nodes[SERD_STATEMENT_N_NODES]; ///< Statement nodes
+  size_t          offset; ///< Offset of the record in the statements
+} SortEntry;
+
+/// A sorted run of statements in a temporary file
+typedef struct {
+  FILE*           file;    ///< Temporary file of statement records
+  SerdStatements  current; ///< Record of the current statement
+  const SerdNode* nodes[SERD_STATEMENT_N_NODES]; ///< Current statement nodes
+} Run;
+
+struct SerdSorterImpl {
+  const SerdEnv*    env;          ///< Environment for expanding nodes, or null
+  SerdStatementSink sink;         ///< Sink for sorted statements
+  void*             handle;       ///< Handle for sink
+  SerdErrorSink     error_sink;   ///< Sink for errors, or null
+  void*             error_handle; ///< Handle for error_sink
+  size_t            max_bytes;    ///< Memory limit, or zero
+  SerdStatements    statements;   ///< Statements not yet in a run
+  SortEntry*        entries;      ///< Entries for sorting statements
+  size_t            n_entries;    ///< Number of allocated entries
+  Run*              runs;         ///< Runs written to temporary files
+  size_t            n_runs;       ///< Number of runs
+};
+
+static SerdStatus
+s_err(SerdSorter* sorter, SerdStatus st, const char* fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  const SerdError e = {st, (const uint8_t*)"", 0, 0, fmt, &args};
+  serd_error(sorter->error_sink, sorter->error_handle, &e);
+  va_end(args);
+  return st;
+}
+
+SerdSorter*
+serd_sorter_new(const SerdEnv* const    env,
+                const size_t            max_bytes,
+                const SerdStatementSink sink,
+                void* const             handle)
+{
+  SerdSorter* const sorter = (SerdSorter*)calloc(1, sizeof(SerdSorter));
+
+  sorter->env        = env;
+  sorter->sink       = sink;
+  sorter->handle     = handle;
+  sorter->max_bytes  = max_bytes;
+  sorter->statements = serd_statements_new(NULL, SERD_PAGE_SIZE);
+  return sorter;
+}
+
+static void
+close_runs(SerdSorter* const sorter)
+{
+  for (size_t i = 0u; i < sorter->n_runs; ++i) {
+    fclose(sorter->runs[i].file);
+    serd_statements_free(&sorter->runs[i].current);
+  }
+
+  free(sorter->runs);
+  sorter->runs   = NULL;
+  sorter->n_runs = 0u;
+}
+
+void
+serd_sorter_free(SerdSorter* const sorter)
+{
+  if (sorter) {
+    close_runs(sorter);
+    free(sorter->entries);
+    serd_statements_free(&sorter->statements);
+    free(sorter);
+  }
+}
+
+void
+serd_sorter_set_error_sink(SerdSorter* const   sorter,
+                           const SerdErrorSink error_sink,
+                           void* const         error_handle)
+{
+  sorter->error_sink   = error_sink;
+  sorter->error_handle = error_handle;
+}
+
+size_t
+serd_sorter_n_runs(const SerdSorter* const sorter)
+{
+  return sorter->n_runs;
+}
+
+/// Compare nodes by type, then string, with null before anything else
+static int
+compare_nodes(const SerdNode* const a, const SerdNode* const b)
+{
+  if (!a || !b) {
+    return (int)!!a - (int)!!b;
+  }
+
+  if (a->type != b->type) {
+    return (int)a->type - (int)b->type;
+  }
+
+  const size_t len = a->n_bytes < b->n_bytes ? a->n_bytes : b->n_bytes;
+  const int    cmp = memcmp(a->buf, b->buf, len);
+  if (cmp || a->n_bytes == b->n_bytes) {
+    return cmp;
+  }
+
+  return a->n_bytes < b->n_bytes ? -1 : 1;
+}
+
+/// Compare statements by graph, subject, predicate, object, datatype, lang
+static int
+compare_statements(const SerdNode* const* const a,
+                   const SerdNode* const* const b)
+{
+  for (unsigned i = 0u; i < SERD_STATEMENT_N_NODES; ++i) {
+    const int cmp = compare_nodes(a[i], b[i]);
+    if (cmp) {
+      return cmp;
+    }
+  }
+
+  return 0;
+}
+
+static int
+compare_entries(const void* const a, const void* const b)
+{
+  return compare_statements(((const SortEntry*)a)->nodes,
+                            ((const SortEntry*)b)->nodes);
+}
+
+/// Sort the statements not yet in a run, and return the number of them
+static size_t
+sort_statements(SerdSorter* const sorter)
+{
+  const size_t n = sorter->statements.n_statements;
+  if (n > sorter->n_entries) {
+    sorter->entries =
+      (SortEntry*)realloc(sorter->entries, n * sizeof(SortEntry));
+    sorter->n_entries = n;
+  }
+
+  SortEntry* const entries = sorter->entries;
+  size_t           offset  = SERD_STACK_BOTTOM;
+  for (size_t i = 0u; i < n; ++i) {
+    const SerdStatementHeader* const header =
+      serd_statements_decode(&sorter->statements, offset, entries[i].nodes);
+
+    entries[i].offset = offset;
+    offset += header->size;
+  }
+
+  qsort(entries, n, sizeof(SortEntry), compare_entries);
+  return n;
+}
+
+/// Sort the statements not yet in a run, and write them to a temporary file
+static SerdStatus
+write_run(SerdSorter* const sorter)
+{
+  const size_t n    = sort_statements(sorter);
+  FILE* const  file = tmpfile();
+  if (!file) {
+    return s_err(sorter, SERD_ERR_UNKNOWN, "failed to open temporary file\n");
+  }
+
+  sorter->runs =
+    (Run*)realloc(sorter->runs, (sorter->n_runs + 1u) * sizeof(Run));
+
+  Run* const run = &sorter->runs[sorter->n_runs++];
+  run->file      = file;
+  run->current   = serd_statements_new(NULL, SERD_PAGE_SIZE);
+
+  const SortEntry* const entries = sorter->entries;
+  for (size_t i = 0u; i < n; ++i) {
+    if (i && !compare_statements(entries[i - 1u].nodes, entries[i].nodes)) {
+      continue; // Duplicate
+    }
+
+    const uint8_t* const record =
+      sorter->statements.stack.buf + entries[i].offset;
+
+    const size_t size = ((const SerdStatementHeader*)record)->size;
+    if (fwrite(record, 1, size, file) != size) {
+      return s_err(sorter, SERD_ERR_UNKNOWN, "failed to write sorted run\n");
+    }
+  }
+
+  serd_statements_clear(&sorter->statements);
+  return SERD_SUCCESS;
+}
+
+/// Return `node` as an absolute URI, which is stored in `expanded` if needed
+static const SerdNode*
+expand(SerdSorter* const     sorter,
+       const SerdNode* const node,
+       SerdNode* const       expanded)
+{
+  if (!sorter->env || !node || node->type == SERD_LITERAL ||
+      node->type == SERD_BLANK ||
+      (node->type == SERD_URI && serd_uri_string_has_scheme(node->buf))) {
+    return node;
+  }
+
+  if (!(*expanded = serd_env_expand_node(sorter->env, node)).buf) {
+    s_err(sorter,
+          SERD_ERR_BAD_CURIE,
+          "undefined namespace prefix `%s'\n",
+          node->buf);
+    return NULL;
+  }
+
+  return expanded;
+}
+
+SerdStatus
+serd_sorter_write_statement(SerdSorter* const        sorter,
+                            const SerdStatementFlags flags,
+                            const SerdNode* const    graph,
+                            const SerdNode* const    subject,
+                            const SerdNode* const    predicate,
+                            const SerdNode* const    object,
+                            const SerdNode* const    datatype,
+                            const SerdNode* const    lang)
+{
+  (void)flags;
+
+  if (!subject || !predicate || !object || !object->buf) {
+    return SERD_ERR_BAD_ARG;
+  }
+
+  SerdNode expanded[5];
+  memset(expanded, 0, sizeof(expanded));
+
+  const SerdNode* const g = expand(sorter, graph, &expanded[0]);
+  const SerdNode* const s = expand(sorter, subject, &expanded[1]);
+  const SerdNode* const p = expand(sorter, predicate, &expanded[2]);
+  const SerdNode* const o = expand(sorter, object, &expanded[3]);
+  const SerdNode* const d = expand(sorter, datatype, &expanded[4]);
+
+  SerdStatus st = SERD_SUCCESS;
+  if ((graph && !g) || !s || !p || !o || (datatype && !d)) {
+    st = SERD_ERR_BAD_CURIE;
+  } else {
+    // Flags are dropped, since anonymous nodes and lists are split up
+    serd_statements_push(&sorter->statements, 0u, g, s, p, o, d, lang);
+
+    const size_t size = sorter->statements.stack.size +
+                        sorter->statements.n_statements * sizeof(SortEntry);
+    if (sorter->max_bytes && size >= sorter->max_bytes) {
+      st = write_run(sorter);
+    }
+  }
+
+  for (unsigned i = 0u; i < 5u; ++i) {
+    serd_node_free(&expanded[i]);
+  }
+
+  return st;
+}
+
+/// Read the next statement of `run`, or return SERD_FAILURE at the end
+static SerdStatus
+read_record(SerdSorter* const sorter, Run* const run)
+{
+  SerdStatementHeader header;
+  if (fread(&header, sizeof(header), 1, run->file) != 1) {
+    return ferror(run->file)
+             ? s_err(sorter, SERD_ERR_UNKNOWN, "failed to read sorted run\n")
+             : SERD_FAILURE;
+  }
+
+  SerdStatements* const current = &run->current;
+  serd_statements_clear(current);
+
+  uint8_t* const record =
+    (uint8_t*)serd_stack_push(&current->stack, header.size);
+
+  const size_t rest = header.size - sizeof(header);
+  memcpy(record, &header, sizeof(header));
+  if (fread(record + sizeof(header), 1, rest, run->file) != rest) {
+    return s_err(sorter, SERD_ERR_UNKNOWN, "failed to read sorted run\n");
+  }
+
+  serd_statements_decode(current, SERD_STACK_BOTTOM, run->nodes);
+  return SERD_SUCCESS;
+}
+
+/// Move the run at `i` down the heap until it is less than its children
+static void
+sift_down(Run** const heap, const size_t n, size_t i)
+{
+  for (size_t least = i;; i = least) {
+    const size_t left  = 2u * i + 1u;
+    const size_t right = left + 1u;
+    if (left < n &&
+        compare_statements(heap[left]->nodes, heap[least]->nodes) < 0) {
+      least = left;
+    }
+
+    if (right < n &&
+        compare_statements(heap[right]->nodes, heap[least]->nodes) < 0) {
+      least = right;
+    }
+
+    if (least == i) {
+      break;
+    }
+
+    Run* const tmp = heap[i];
+    heap[i]        = heap[least];
+    heap[least]    = tmp;
+  }
+}
+
+/// Merge every run into the sink, dropping statements that were just passed
+static SerdStatus
+merge_runs(SerdSorter* const sorter)
+{
+  Run** const heap = (Run**)calloc(sorter->n_runs, sizeof(Run*));
+  size_t      n    = 0u;
+  SerdStatus  st   = SERD_SUCCESS;
+
+  // Start with the first statement of every run
+  for (size_t i = 0u; !st && i < sorter->n_runs; ++i) {
+    Run* const run = &sorter->runs[i];
+    if (fseek(run->file, 0, SEEK_SET)) {
+      st = s_err(sorter, SERD_ERR_UNKNOWN, "failed to rewind sorted run\n");
+    } else if (!(st = read_record(sorter, run))) {
+      heap[n++] = run;
+    } else if (st == SERD_FAILURE) {
+      st = SERD_SUCCESS; // Empty run
+    }
+  }
+
+  for (size_t i = n / 2u; i-- > 0u;) {
+    sift_down(heap, n, i);
+  }
+
+  // Repeatedly pass the least statement and replace it with the next one
+  SerdStatements  last = serd_statements_new(NULL, SERD_PAGE_SIZE);
+  const SerdNode* last_nodes[SERD_STATEMENT_N_NODES];
+  while (!st && n) {
+    Run* const             run   = heap[0];
+    const SerdNode* const* nodes = run->nodes;
+    if (!last.n_statements || compare_statements(last_nodes, nodes)) {
+      st = sorter->sink(sorter->handle,
+                        0u,
+                        nodes[0],
+                        nodes[1],
+                        nodes[2],
+                        nodes[3],
+                        nodes[4],
+                        nodes[5]);
+
+      serd_statements_clear(&last);
+      serd_statements_push(
+        &last, 0u, nodes[0], nodes[1], nodes[2], nodes[3], nodes[4], nodes[5]);
+      serd_statements_decode(&last, SERD_STACK_BOTTOM, last_nodes);
+    }
+
+    if (!st && (st = read_record(sorter, run)) == SERD_FAILURE) {
+      heap[0] = heap[--n]; // End of this run
+      st      = SERD_SUCCESS;
+    }
+
+    sift_down(heap, n, 0u);
+  }
+
+  serd_statements_free(&last);
+  free(heap);
+  return st;
+}
+
+SerdStatus
+serd_sorter_finish(SerdSorter* const sorter)
+{
+  SerdStatus st = SERD_SUCCESS;
+  if (sorter->n_runs) {
+    if (!sorter->statements.n_statements || !(st = write_run(sorter))) {
+      st = merge_runs(sorter);
+    }
+  } else {
+    // Everything fits in memory, so pass the sorted statements directly
+    const size_t           n       = sort_statements(sorter);
+    const SortEntry* const entries = sorter->entries;
+    for (size_t i = 0u; !st && i < n; ++i) {
+      const SerdNode* const* const nodes = entries[i].nodes;
+      if (!i || compare_statements(entries[i - 1u].nodes, nodes)) {
+        st = sorter->sink(sorter->handle,
+                          0u,
+                          nodes[0],
+                          nodes[1],
+                          nodes[2],
+                          nodes[3],
+                          nodes[4],
+                          nodes[5]);
+      }
+    }
+  }
+
+  close_runs(sorter);
+  serd_statements_clear(&sorter->statements);
+  return st;
+}
@@ -17,32 +17,39 @@
 #ifndef SERD_STACK_H
 #define SERD_STACK_H
 
+#include "memory.h"
+
+#include "serd/serd.h"
+
 #include <assert.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 /** An offset to start the stack at. Note 0 is reserved for NULL. */
 #define SERD_STACK_BOTTOM sizeof(void*)
 
 /** A dynamic stack in memory. */
 typedef struct {
-  uint8_t* buf;      ///< Stack memory
-  size_t   buf_size; ///< Allocated size of buf (>= size)
-  size_t   size;     ///< Conceptual size of stack in buf
+  const SerdAllocator* allocator; ///< Allocator for buf, or null
+  uint8_t*             buf;       ///< Stack memory
+  size_t               buf_size;  ///< Allocated size of buf (>= size)
+  size_t               size;      ///< Conceptual size of stack in buf
 } SerdStack;
 
 /** An offset to start the stack at. Note 0 is reserved for NULL. */
 #define SERD_STACK_BOTTOM sizeof(void*)
 
 static inline SerdStack
-serd_stack_new(size_t size)
+serd_stack_new(const SerdAllocator* allocator, size_t size)
 {
   SerdStack stack;
-  stack.buf      = (uint8_t*)calloc(size, 1);
-  stack.buf_size = size;
-  stack.size     = SERD_STACK_BOTTOM;
+  stack.allocator = allocator;
+  stack.buf       = (uint8_t*)serd_acalloc(allocator, size, 1);
+  stack.buf_size  = size;
+  stack.size      = SERD_STACK_BOTTOM;
   return stack;
 }
 
@@ -55,7 +62,7 @@ serd_stack_is_empty(SerdStack* stack)
 static inline void
 serd_stack_free(SerdStack* stack)
 {
-  free(stack->buf);
+  serd_afree(stack->allocator, stack->buf);
   stack->buf      = NULL;
   stack->buf_size = 0;
   stack->size     = 0;
@@ -67,7 +74,12 @@ serd_stack_push(SerdStack* stack, size_t n_bytes)
   const size_t new_size = stack->size + n_bytes;
   if (stack->buf_size < new_size) {
     stack->buf_size += (stack->buf_size >> 1); // *= 1.5
-    stack->buf = (uint8_t*)realloc(stack->buf, stack->buf_size);
+    if (stack->buf_size < new_size) {
+      stack->buf_size = new_size;
+    }
+
+    stack->buf =
+      (uint8_t*)serd_arealloc(stack->allocator, stack->buf, stack->buf_size);
   }
 
   uint8_t* const ret = (stack->buf + stack->size);
@@ -76,6 +88,28 @@ serd_stack_push(SerdStack* stack, size_t n_bytes)
   return ret;
 }
 
+/**
+   Append a span of bytes to the null-terminated string on top of the stack.
+
+   The span is copied over the current terminator and terminated again, so
+   the stack grows by exactly `n_bytes`.  Space is reserved at most once.
+
+   @return A pointer to the start of the copied span.
+*/
+static inline uint8_t*
+serd_stack_push_span(SerdStack* stack, const uint8_t* data, size_t n_bytes)
+{
+  assert(stack->size > SERD_STACK_BOTTOM);
+  assert(!stack->buf[stack->size - 1]);
+
+  uint8_t* const top  = (uint8_t*)serd_stack_push(stack, n_bytes);
+  uint8_t* const span = top - 1;
+
+  memcpy(span, data, n_bytes);
+  span[n_bytes] = '\0';
+  return span;
+}
+
 static inline void
 serd_stack_pop(SerdStack* stack, size_t n_bytes)
 {
@@ -0,0 +1,229 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef SERD_STATEMENTS_H
+#define SERD_STATEMENTS_H
+
+#include "stack.h"
+
+#include "serd/serd.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+   A sequence of statements stored by value.
+
+   Each statement is stored as a record in a single stack: a header followed
+   by the graph, subject, predicate, object, datatype, and language nodes,
+   each of which is a SerdNode immediately followed by its null-terminated
+   string.  Absent nodes are stored with type SERD_NOTHING and no string.
+*/
+typedef struct {
+  SerdStack stack;        ///< Statement records
+  size_t    n_statements; ///< Number of statements in stack
+} SerdStatements;
+
+/// Header of a statement record
+typedef struct {
+  size_t             size;  ///< Size of record including header
+  SerdStatementFlags flags; ///< Statement flags
+} SerdStatementHeader;
+
+#define SERD_STATEMENT_N_NODES 6u
+
+/// Return `size` padded up so the next node in a record is aligned
+static inline size_t
+serd_statements_pad(const size_t size)
+{
+  const size_t align = sizeof(void*);
+
+  return (size + align - 1u) / align * align;
+}
+
+static inline SerdStatements
+serd_statements_new(const SerdAllocator* allocator, size_t size)
+{
+  SerdStatements statements = {serd_stack_new(allocator, size), 0u};
+  return statements;
+}
+
+static inline void
+serd_statements_clear(SerdStatements* statements)
+{
+  statements->stack.size   = SERD_STACK_BOTTOM;
+  statements->n_statements = 0u;
+}
+
+static inline void
+serd_statements_free(SerdStatements* statements)
+{
+  serd_stack_free(&statements->stack);
+  statements->n_statements = 0u;
+}
+
+/// Append a statement, copying all of its nodes
+static inline void
+serd_statements_push(SerdStatements*    statements,
+                     SerdStatementFlags flags,
+                     const SerdNode*    graph,
+                     const SerdNode*    subject,
+                     const SerdNode*    predicate,
+                     const SerdNode*    object,
+                     const SerdNode*    object_datatype,
+                     const SerdNode*    object_lang)
+{
+  const SerdNode* const nodes[SERD_STATEMENT_N_NODES] = {
+    graph, subject, predicate, object, object_datatype, object_lang};
+
+  // Calculate the size of the record so it can be pushed all at once
+  size_t size = serd_statements_pad(sizeof(SerdStatementHeader));
+  for (unsigned i = 0u; i < SERD_STATEMENT_N_NODES; ++i) {
+    size += sizeof(SerdNode);
+    if (nodes[i] && nodes[i]->type && nodes[i]->buf) {
+      size += serd_statements_pad(nodes[i]->n_bytes + 1u);
+    }
+  }
+
+  uint8_t* const record = (uint8_t*)serd_stack_push(&statements->stack, size);
+  SerdStatementHeader* const header = (SerdStatementHeader*)record;
+
+  header->size  = size;
+  header->flags = flags;
+
+  uint8_t* ptr = record + serd_statements_pad(sizeof(SerdStatementHeader));
+  for (unsigned i = 0u; i < SERD_STATEMENT_N_NODES; ++i) {
+    SerdNode* const node = (SerdNode*)ptr;
+    ptr += sizeof(SerdNode);
+
+    if (nodes[i] && nodes[i]->type && nodes[i]->buf) {
+      *node     = *nodes[i];
+      node->buf = NULL;
+      memcpy(ptr, nodes[i]->buf, nodes[i]->n_bytes);
+      ptr[nodes[i]->n_bytes] = '\0';
+      ptr += serd_statements_pad(nodes[i]->n_bytes + 1u);
+    } else {
+      *node = SERD_NODE_NULL;
+    }
+  }
+
+  ++statements->n_statements;
+}
+
+/**
+   Decode the statement record at `offset`.
+
+   This sets the string pointers of the nodes in the record, which may have
+   been moved since it was pushed, sets `nodes` to point to them, and returns
+   the record header.
+*/
+static inline const SerdStatementHeader*
+serd_statements_decode(SerdStatements* statements,
+                       const size_t    offset,
+                       const SerdNode* nodes[SERD_STATEMENT_N_NODES])
+{
+  uint8_t* const                   buf    = statements->stack.buf;
+  const SerdStatementHeader* const header =
+    (const SerdStatementHeader*)(buf + offset);
+
+  uint8_t* ptr = buf + offset + serd_statements_pad(sizeof(*header));
+  for (unsigned i = 0u; i < SERD_STATEMENT_N_NODES; ++i) {
+    SerdNode* const node = (SerdNode*)ptr;
+    ptr += sizeof(SerdNode);
+    if (node->type) {
+      node->buf = ptr;
+      nodes[i]  = node;
+      ptr += serd_statements_pad(node->n_bytes + 1u);
+    } else {
+      nodes[i] = NULL;
+    }
+  }
+
+  return header;
+}
+
+/// Call `sink` for every statement in order, stopping at the first error
+static inline SerdStatus
+serd_statements_emit(SerdStatements*   statements,
+                     SerdStatementSink sink,
+                     void*             handle)
+{
+  SerdStatus st = SERD_SUCCESS;
+
+  for (size_t offset = SERD_STACK_BOTTOM;
+       !st && offset < statements->stack.size;) {
+    const SerdNode*                  nodes[SERD_STATEMENT_N_NODES];
+    const SerdStatementHeader* const header =
+      serd_statements_decode(statements, offset, nodes);
+
+    st = sink(handle,
+              header->flags,
+              nodes[0],
+              nodes[1],
+              nodes[2],
+              nodes[3],
+              nodes[4],
+              nodes[5]);
+
+    offset += header->size;
+  }
+
+  return st;
+}
+
+/**
+   Call `sink` with every statement in order, up to `max_batch` at a time.
+
+   The `batch` array must have space for `max_batch` statements.  Stops at the
+   first error.
+*/
+static inline SerdStatus
+serd_statements_emit_batches(SerdStatements* statements,
+                             SerdStatement*  batch,
+                             const size_t    max_batch,
+                             SerdBatchSink   sink,
+                             void*           handle)
+{
+  SerdStatus st = SERD_SUCCESS;
+  size_t     n  = 0u;
+
+  for (size_t offset = SERD_STACK_BOTTOM;
+       !st && offset < statements->stack.size;) {
+    const SerdNode*                  nodes[SERD_STATEMENT_N_NODES];
+    const SerdStatementHeader* const header =
+      serd_statements_decode(statements, offset, nodes);
+
+    SerdStatement* const statement = &batch[n++];
+    statement->flags               = header->flags;
+    statement->graph               = nodes[0];
+    statement->subject             = nodes[1];
+    statement->predicate           = nodes[2];
+    statement->object              = nodes[3];
+    statement->object_datatype     = nodes[4];
+    statement->object_lang         = nodes[5];
+
+    offset += header->size;
+    if (n == max_batch || offset >= statements->stack.size) {
+      st = sink(handle, batch, n);
+      n  = 0u;
+    }
+  }
+
+  return st;
+}
+
+#endif // SERD_STATEMENTS_H
@@ -170,4 +170,16 @@ parse_utf8_char(const uint8_t* utf8, size_t* size)
   }
 }
 
+/// Return the FNV-1a hash of a string of `len` bytes
+static inline uint32_t
+serd_string_hash(const uint8_t* str, size_t len)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; ++i) {
+    hash = (hash ^ str[i]) * 16777619u;
+  }
+
+  return hash;
+}
+
 #endif // SERD_STRING_UTILS_H
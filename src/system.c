@@ -14,7 +14,7 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
-#define _POSIX_C_SOURCE 200809L /* for posix_memalign and posix_fadvise */
+#define _POSIX_C_SOURCE 200809L /* for posix_memalign, posix_fadvise, mmap */
 
 #include "system.h"
 
@@ -25,11 +25,21 @@
 #  include <fcntl.h>
 #endif
 
+#if USE_MMAP && USE_FILENO
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+#if USE_CLOCK_GETTIME
+#  include <time.h>
+#endif
+
 #ifdef _WIN32
 #  include <malloc.h>
 #endif
 
 #include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -50,6 +60,48 @@ serd_fopen(const char* path, const char* mode)
   return fd;
 }
 
+const void*
+serd_map_file(FILE* const file, size_t* const size)
+{
+  *size = 0;
+
+#if USE_MMAP && USE_FILENO
+  const int   fd = fileno(file);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+      (uintmax_t)st.st_size > SIZE_MAX) {
+    return NULL;
+  }
+
+  const size_t len = (size_t)st.st_size;
+  void* const  map = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED) {
+    return NULL;
+  }
+
+#  if USE_POSIX_MADVISE
+  posix_madvise(map, len, POSIX_MADV_SEQUENTIAL);
+#  endif
+
+  *size = len;
+  return map;
+#else
+  (void)file;
+  return NULL;
+#endif
+}
+
+void
+serd_unmap_file(const void* const map, const size_t size)
+{
+#if USE_MMAP && USE_FILENO
+  munmap((void*)map, size);
+#else
+  (void)map;
+  (void)size;
+#endif
+}
+
 void*
 serd_malloc_aligned(const size_t alignment, const size_t size)
 {
@@ -70,7 +122,10 @@ serd_malloc_aligned(const size_t alignment, const size_t size)
 void*
 serd_allocate_buffer(const size_t size)
 {
-  return serd_malloc_aligned(SERD_PAGE_SIZE, size);
+  // Round up to a multiple of the alignment as required by aligned_alloc()
+  const size_t n_pages = (size + SERD_PAGE_SIZE - 1u) / SERD_PAGE_SIZE;
+
+  return serd_malloc_aligned(SERD_PAGE_SIZE, n_pages * SERD_PAGE_SIZE);
 }
 
 void
@@ -82,3 +137,16 @@ serd_free_aligned(void* const ptr)
   free(ptr);
 #endif
 }
+
+uint64_t
+serd_monotonic_time(void)
+{
+#if USE_CLOCK_GETTIME
+  struct timespec ts;
+  if (!clock_gettime(CLOCK_MONOTONIC, &ts)) {
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+  }
+#endif
+
+  return 0u;
+}
@@ -19,12 +19,27 @@
 
 #include "attributes.h"
 
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
 /// Open a file configured for fast sequential reading
 FILE*
 serd_fopen(const char* path, const char* mode);
 
+/**
+   Map the entire contents of `file` into memory for reading.
+
+   Returns NULL if `file` is not a regular file or can not be mapped for any
+   other reason, otherwise `size` is set to the size of the mapping.
+*/
+const void*
+serd_map_file(FILE* file, size_t* size);
+
+/// Unmap a file mapped with serd_map_file()
+void
+serd_unmap_file(const void* map, size_t size);
+
 /// Allocate a buffer aligned to `alignment` bytes
 SERD_MALLOC_FUNC void*
 serd_malloc_aligned(size_t alignment, size_t size);
@@ -37,4 +52,8 @@ serd_allocate_buffer(size_t size);
 void
 serd_free_aligned(void* ptr);
 
+/// Return the time of a monotonic clock in nanoseconds, or 0 if unsupported
+uint64_t
+serd_monotonic_time(void);
+
 #endif // SERD_SYSTEM_H
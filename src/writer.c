@@ -14,9 +14,14 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include "binary.h"
 #include "byte_sink.h"
+#include "compress.h"
+#include "memory.h"
+#include "scan.h"
 #include "serd_internal.h"
 #include "stack.h"
+#include "statements.h"
 #include "string_utils.h"
 #include "uri_utils.h"
 
@@ -91,25 +96,85 @@ static const SepRule rules[] = {{NULL, 0, 0, 0, 0},
                                 {">", 1, 0, 0, 0},
                                 {"\n", 1, 0, 1, 0}};
 
+/// Number of entries in the resolved URI cache (a power of two)
+#define URI_CACHE_SIZE 1024u
+
+/// A cached URI to write in resolved style
+typedef struct {
+  SerdNode uri;     ///< URI as given, or null if the entry is empty
+  SerdNode written; ///< Resolved and possibly relative URI to write
+} CachedURI;
+
+/// Number of written nodes kept for each field of line statements
+#define NODE_CACHE_SIZE 16u
+
+/// A node as written in a line-based syntax, to copy if it is written again
+typedef struct {
+  uint8_t* buf;       ///< Node string, followed by the bytes written for it
+  size_t   size;      ///< Allocated size of buf
+  size_t   n_bytes;   ///< Length of the node string
+  size_t   n_written; ///< Number of bytes written
+  size_t   n_escapes; ///< Number of escapes in the written bytes
+  SerdType type;      ///< Type of node, or SERD_NOTHING if the entry is empty
+} CachedNode;
+
+/// Written nodes for one field, indexed by a cheap function of the string
+typedef struct {
+  CachedNode entries[NODE_CACHE_SIZE];
+} NodeCache;
+
+/// The end of a statement whose object literal is being written in pieces
+typedef struct {
+  SerdNode graph;    ///< Graph to write after the object in NQuads
+  SerdNode datatype; ///< Datatype to write after the string
+  SerdNode lang;     ///< Language tag to write after the string
+  bool     open;     ///< True iff a literal is being written
+} OpenLiteral;
+
+/// A statement in the reorder window, with the first index of its groups
+typedef struct {
+  const SerdNode* nodes[SERD_STATEMENT_N_NODES]; ///< Statement nodes
+  size_t          index;    ///< Position in the window
+  size_t          first[3]; ///< First index of graph, subject, and predicate
+} WindowEntry;
+
+/// Statements buffered to be regrouped before writing
+typedef struct {
+  SerdStatements statements;     ///< Buffered statements
+  WindowEntry*   entries;        ///< Entries for sorting statements
+  size_t         n_entries;      ///< Number of allocated entries
+  size_t         max_statements; ///< Maximum number of statements, or zero
+  size_t         max_bytes;      ///< Maximum size of statements and entries
+} Window;
+
 struct SerdWriterImpl {
-  SerdSyntax    syntax;
-  SerdStyle     style;
-  SerdEnv*      env;
-  SerdNode      root_node;
-  SerdURI       root_uri;
-  SerdURI       base_uri;
-  SerdStack     anon_stack;
-  SerdByteSink  byte_sink;
-  SerdErrorSink error_sink;
-  void*         error_handle;
-  WriteContext  context;
-  SerdNode      list_subj;
-  unsigned      list_depth;
-  unsigned      indent;
-  uint8_t*      bprefix;
-  size_t        bprefix_len;
-  Sep           last_sep;
-  bool          empty;
+  SerdAllocator   allocator;
+  SerdSyntax      syntax;
+  SerdStyle       style;
+  SerdEnv*        env;
+  SerdNode        root_node;
+  SerdURI         root_uri;
+  SerdURI         base_uri;
+  CachedURI*      uri_cache;
+  NodeCache       node_caches[3]; ///< Written subjects, predicates, and graphs
+  CachedNode*     capture;        ///< Entry to copy written bytes to
+  SerdDictionary* terms;
+  SerdStack       anon_stack;
+  SerdEncoder*    encoder;
+  SerdByteSink    byte_sink;
+  SerdErrorSink   error_sink;
+  void*           error_handle;
+  WriteContext    context;
+  SerdNode        list_subj;
+  unsigned        list_depth;
+  unsigned        indent;
+  uint8_t*        bprefix;
+  size_t          bprefix_len;
+  SerdWriterStats stats;
+  Window          window;
+  OpenLiteral     literal; ///< Literal being written in pieces
+  Sep             last_sep;
+  bool            empty;
 };
 
 typedef enum { WRITE_STRING, WRITE_LONG_STRING } TextContext;
@@ -159,10 +224,11 @@ anon_stack_top(SerdWriter* writer)
 }
 
 static void
-copy_node(SerdNode* dst, const SerdNode* src)
+copy_node(const SerdAllocator* allocator, SerdNode* dst, const SerdNode* src)
 {
   if (src) {
-    dst->buf     = (uint8_t*)realloc((char*)dst->buf, src->n_bytes + 1);
+    dst->buf =
+      (uint8_t*)serd_arealloc(allocator, (char*)dst->buf, src->n_bytes + 1);
     dst->n_bytes = src->n_bytes;
     dst->n_chars = src->n_chars;
     dst->flags   = src->flags;
@@ -173,10 +239,52 @@ copy_node(SerdNode* dst, const SerdNode* src)
   }
 }
 
+// Reserve space for at least `len` bytes in a cached node
+static void
+reserve_cached(SerdWriter* writer, CachedNode* entry, size_t len)
+{
+  if (len > entry->size) {
+    size_t size = entry->size ? entry->size : 128u;
+    while (size < len) {
+      size *= 2u;
+    }
+
+    entry->buf  = (uint8_t*)serd_arealloc(&writer->allocator, entry->buf, size);
+    entry->size = size;
+  }
+}
+
+// Append written bytes to the cached node that is being written
+static void
+capture(SerdWriter* writer, const void* buf, size_t len)
+{
+  CachedNode* const entry = writer->capture;
+  const size_t      end   = entry->n_bytes + entry->n_written;
+
+  reserve_cached(writer, entry, end + len);
+  memcpy(entry->buf + end, buf, len);
+  entry->n_written += len;
+}
+
 static inline size_t
 sink(const void* buf, size_t len, SerdWriter* writer)
 {
-  return serd_byte_sink_write(buf, len, &writer->byte_sink);
+  const size_t n_written = serd_byte_sink_write(buf, len, &writer->byte_sink);
+
+  if (writer->capture) {
+    capture(writer, buf, n_written);
+  }
+
+  writer->stats.n_bytes += n_written;
+  return n_written;
+}
+
+// Write an escape sequence that stands for a single character
+static inline size_t
+write_escape(SerdWriter* writer, const char* escape, size_t len)
+{
+  ++writer->stats.n_escapes;
+  return sink(escape, len, writer);
 }
 
 // Write a single character, as an escape for single byte characters
@@ -192,7 +300,7 @@ write_character(SerdWriter* writer, const uint8_t* utf8, size_t* size)
     return sink(replacement_char, sizeof(replacement_char), writer);
   case 1:
     snprintf(escape, sizeof(escape), "\\u%04X", utf8[0]);
-    return sink(escape, 6, writer);
+    return write_escape(writer, escape, 6);
   default:
     break;
   }
@@ -204,31 +312,55 @@ write_character(SerdWriter* writer, const uint8_t* utf8, size_t* size)
 
   if (c <= 0xFFFF) {
     snprintf(escape, sizeof(escape), "\\u%04X", c);
-    return sink(escape, 6, writer);
+    return write_escape(writer, escape, 6);
   }
 
   snprintf(escape, sizeof(escape), "\\U%08X", c);
-  return sink(escape, 10, writer);
+  return write_escape(writer, escape, 10);
 }
 
-static inline bool
-uri_must_escape(const uint8_t c)
-{
-  switch (c) {
-  case ' ':
-  case '"':
-  case '<':
-  case '>':
-  case '\\':
-  case '^':
-  case '`':
-  case '{':
-  case '|':
-  case '}':
-    return true;
-  default:
-    return !in_range(c, 0x20, 0x7E);
+/* Escape classes of bytes, which are combinations of the following bits.
+
+   This arbitrary list of characters in ESCAPE_LNAME, most of which have
+   nothing to do with Turtle, must be handled as special cases here because
+   the RDF and SPARQL WGs are apparently intent on making the once elegant
+   Turtle a baroque and inconsistent mess, throwing elegance and extensibility
+   completely out the window for no good reason.
+
+   Note '-', '.', and '_' are also in PN_LOCAL_ESC, but are valid unescaped in
+   local names, so they are not escaped here. */
+
+#define ESCAPE_URI 1u   ///< Must be escaped in a URI
+#define ESCAPE_LNAME 2u ///< Must be escaped in a local name
+#define ESCAPE_TEXT 4u  ///< Not printable text (0x20 to 0x7E except " and \)
+
+static const uint8_t escape_classes[256] = {
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, // 0_
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, // 1_
+  1, 2, 5, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 2, // 2_
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, // 3_
+  2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 4_
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 1, 0, // 5_
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 6_
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 2, 5, // 7_
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, // 8_
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, // 9_
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, // A_
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, // B_
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, // C_
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, // D_
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, // E_
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, // F_
+};
+
+// Return the index of the first byte from `i` on with the escape class `mask`
+static inline size_t
+find_escape(const uint8_t* utf8, size_t i, const size_t n_bytes, unsigned mask)
+{
+  for (; i < n_bytes && !(escape_classes[utf8[i]] & mask); ++i) {
   }
+
+  return i;
 }
 
 static size_t
@@ -236,12 +368,9 @@ write_uri(SerdWriter* writer, const uint8_t* utf8, size_t n_bytes)
 {
   size_t len = 0;
   for (size_t i = 0; i < n_bytes;) {
-    size_t j = i; // Index of next character that must be escaped
-    for (; j < n_bytes; ++j) {
-      if (uri_must_escape(utf8[j])) {
-        break;
-      }
-    }
+    // Index of next character that must be escaped
+    const size_t run = serd_scan_uri_blocks(utf8 + i, n_bytes - i);
+    const size_t j   = find_escape(utf8, i + run, n_bytes, ESCAPE_URI);
 
     // Bulk write all characters up to this special one
     len += sink(&utf8[i], j - i, writer);
@@ -263,54 +392,13 @@ write_uri(SerdWriter* writer, const uint8_t* utf8, size_t n_bytes)
   return len;
 }
 
-static bool
-lname_must_escape(const uint8_t c)
-{
-  /* This arbitrary list of characters, most of which have nothing to do with
-     Turtle, must be handled as special cases here because the RDF and SPARQL
-     WGs are apparently intent on making the once elegant Turtle a baroque
-     and inconsistent mess, throwing elegance and extensibility completely
-     out the window for no good reason.
-
-     Note '-', '.', and '_' are also in PN_LOCAL_ESC, but are valid unescaped
-     in local names, so they are not escaped here. */
-
-  switch (c) {
-  case '\'':
-  case '!':
-  case '#':
-  case '$':
-  case '%':
-  case '&':
-  case '(':
-  case ')':
-  case '*':
-  case '+':
-  case ',':
-  case '/':
-  case ';':
-  case '=':
-  case '?':
-  case '@':
-  case '~':
-    return true;
-  default:
-    break;
-  }
-  return false;
-}
-
 static size_t
 write_lname(SerdWriter* writer, const uint8_t* utf8, size_t n_bytes)
 {
   size_t len = 0;
   for (size_t i = 0; i < n_bytes; ++i) {
-    size_t j = i; // Index of next character that must be escaped
-    for (; j < n_bytes; ++j) {
-      if (lname_must_escape(utf8[j])) {
-        break;
-      }
-    }
+    // Index of next character that must be escaped
+    const size_t j = find_escape(utf8, i, n_bytes, ESCAPE_LNAME);
 
     // Bulk write all characters up to this special one
     len += sink(&utf8[i], j - i, writer);
@@ -319,8 +407,8 @@ write_lname(SerdWriter* writer, const uint8_t* utf8, size_t n_bytes)
     }
 
     // Write escape
-    len += sink("\\", 1, writer);
-    len += sink(&utf8[i], 1, writer);
+    const char escape[2] = {'\\', (char)utf8[i]};
+    len += write_escape(writer, escape, 2);
   }
 
   return len;
@@ -335,13 +423,8 @@ write_text(SerdWriter*    writer,
   size_t len = 0;
   for (size_t i = 0; i < n_bytes;) {
     // Fast bulk write for long strings of printable ASCII
-    size_t j = i;
-    for (; j < n_bytes; ++j) {
-      if (utf8[j] == '\\' || utf8[j] == '"' ||
-          (!in_range(utf8[j], 0x20, 0x7E))) {
-        break;
-      }
-    }
+    const size_t run = serd_scan_text_blocks(utf8 + i, n_bytes - i);
+    const size_t j   = find_escape(utf8, i + run, n_bytes, ESCAPE_TEXT);
 
     len += sink(&utf8[i], j - i, writer);
     if ((i = j) == n_bytes) {
@@ -352,10 +435,10 @@ write_text(SerdWriter*    writer,
     if (ctx == WRITE_LONG_STRING) {
       switch (in) {
       case '\\':
-        len += sink("\\\\", 2, writer);
+        len += write_escape(writer, "\\\\", 2);
         continue;
       case '\b':
-        len += sink("\\b", 2, writer);
+        len += write_escape(writer, "\\b", 2);
         continue;
       case '\n':
       case '\r':
@@ -365,7 +448,7 @@ write_text(SerdWriter*    writer,
         continue;
       case '\"':
         if (i == n_bytes) { // '"' at string end
-          len += sink("\\\"", 2, writer);
+          len += write_escape(writer, "\\\"", 2);
         } else {
           len += sink(&in, 1, writer);
         }
@@ -376,19 +459,19 @@ write_text(SerdWriter*    writer,
     } else if (ctx == WRITE_STRING) {
       switch (in) {
       case '\\':
-        len += sink("\\\\", 2, writer);
+        len += write_escape(writer, "\\\\", 2);
         continue;
       case '\n':
-        len += sink("\\n", 2, writer);
+        len += write_escape(writer, "\\n", 2);
         continue;
       case '\r':
-        len += sink("\\r", 2, writer);
+        len += write_escape(writer, "\\r", 2);
         continue;
       case '\t':
-        len += sink("\\t", 2, writer);
+        len += write_escape(writer, "\\t", 2);
         continue;
       case '"':
-        len += sink("\\\"", 2, writer);
+        len += write_escape(writer, "\\\"", 2);
         continue;
       default:
         break;
@@ -396,10 +479,10 @@ write_text(SerdWriter*    writer,
       if (writer->syntax == SERD_TURTLE) {
         switch (in) {
         case '\b':
-          len += sink("\\b", 2, writer);
+          len += write_escape(writer, "\\b", 2);
           continue;
         case '\f':
-          len += sink("\\f", 2, writer);
+          len += write_escape(writer, "\\f", 2);
           continue;
         default:
           break;
@@ -422,12 +505,6 @@ write_text(SerdWriter*    writer,
   return len;
 }
 
-static size_t
-uri_sink(const void* buf, size_t len, void* stream)
-{
-  return write_uri((SerdWriter*)stream, (const uint8_t*)buf, len);
-}
-
 static void
 write_newline(SerdWriter* writer)
 {
@@ -476,9 +553,9 @@ reset_context(SerdWriter* writer, bool graph)
 static SerdStatus
 free_context(SerdWriter* writer)
 {
-  serd_node_free(&writer->context.graph);
-  serd_node_free(&writer->context.subject);
-  serd_node_free(&writer->context.predicate);
+  serd_node_afree(&writer->allocator, &writer->context.graph);
+  serd_node_afree(&writer->allocator, &writer->context.subject);
+  serd_node_afree(&writer->allocator, &writer->context.predicate);
   return reset_context(writer, true);
 }
 
@@ -497,6 +574,12 @@ write_literal(SerdWriter*        writer,
               const SerdNode*    lang,
               SerdStatementFlags flags)
 {
+  if (writer->literal.open) {
+    sink("\"", 1, writer);
+    write_text(writer, WRITE_STRING, node->buf, node->n_bytes);
+    return true; // Continued by serd_writer_write_literal_piece()
+  }
+
   if (supports_abbrev(writer) && datatype && datatype->buf) {
     const char* type_uri = (const char*)datatype->buf;
     if (!strncmp(type_uri, NS_XSD, sizeof(NS_XSD) - 1) &&
@@ -553,6 +636,86 @@ is_name(const uint8_t* buf, const size_t len)
   return true;
 }
 
+/// A string built with an allocator, for serialising URIs with alloc_sink()
+typedef struct {
+  const SerdAllocator* allocator;
+  uint8_t*             buf;
+  size_t               len;
+} AllocChunk;
+
+static size_t
+alloc_sink(const void* buf, size_t len, void* stream)
+{
+  AllocChunk* const chunk = (AllocChunk*)stream;
+
+  chunk->buf = (uint8_t*)serd_arealloc(
+    chunk->allocator, chunk->buf, chunk->len + len + 1u);
+
+  memcpy(chunk->buf + chunk->len, buf, len);
+  chunk->len += len;
+  chunk->buf[chunk->len] = '\0';
+  return len;
+}
+
+static void
+clear_uri_cache(SerdWriter* writer)
+{
+  if (writer->uri_cache) {
+    for (size_t i = 0; i < URI_CACHE_SIZE; ++i) {
+      serd_node_afree(&writer->allocator, &writer->uri_cache[i].uri);
+      serd_node_afree(&writer->allocator, &writer->uri_cache[i].written);
+    }
+
+    serd_afree(&writer->allocator, writer->uri_cache);
+    writer->uri_cache = NULL;
+  }
+}
+
+// Return the resolved form of `node` to write, which may be relative
+static const SerdNode*
+resolve_uri(SerdWriter* writer, const SerdNode* node)
+{
+  if (!writer->uri_cache) {
+    writer->uri_cache = (CachedURI*)serd_acalloc(
+      &writer->allocator, URI_CACHE_SIZE, sizeof(CachedURI));
+  }
+
+  const uint32_t   hash  = serd_string_hash(node->buf, node->n_bytes);
+  CachedURI* const entry = &writer->uri_cache[hash & (URI_CACHE_SIZE - 1u)];
+  if (entry->uri.buf && entry->uri.n_bytes == node->n_bytes &&
+      !memcmp(entry->uri.buf, node->buf, node->n_bytes)) {
+    return &entry->written;
+  }
+
+  SerdURI in_base_uri;
+  SerdURI uri;
+  SerdURI abs_uri;
+  serd_env_get_base_uri(writer->env, &in_base_uri);
+  serd_uri_parse(node->buf, &uri);
+  serd_uri_resolve(&uri, &in_base_uri, &abs_uri);
+  bool       rooted = uri_is_under(&writer->base_uri, &writer->root_uri);
+  SerdURI*   root   = rooted ? &writer->root_uri : &writer->base_uri;
+  AllocChunk chunk  = {&writer->allocator, NULL, 0u};
+  if (!uri_is_under(&abs_uri, root) || writer->syntax == SERD_NTRIPLES ||
+      writer->syntax == SERD_NQUADS || writer->syntax == SERD_BINARY) {
+    serd_uri_serialise(&abs_uri, alloc_sink, &chunk);
+  } else {
+    serd_uri_serialise_relative(
+      &uri, &writer->base_uri, root, alloc_sink, &chunk);
+  }
+
+  if (!chunk.buf) {
+    alloc_sink("", 0u, &chunk); // Empty relative URI
+  }
+
+  // Replace whatever was in this entry
+  serd_node_afree(&writer->allocator, &entry->uri);
+  serd_node_afree(&writer->allocator, &entry->written);
+  entry->uri     = serd_node_acopy(&writer->allocator, node);
+  entry->written = serd_node_from_substring(SERD_URI, chunk.buf, chunk.len);
+  return &entry->written;
+}
+
 static bool
 write_uri_node(SerdWriter* const        writer,
                const SerdNode*          node,
@@ -600,21 +763,8 @@ write_uri_node(SerdWriter* const        writer,
 
   write_sep(writer, SEP_URI_BEGIN);
   if (writer->style & SERD_STYLE_RESOLVED) {
-    SerdURI in_base_uri;
-    SerdURI uri;
-    SerdURI abs_uri;
-    serd_env_get_base_uri(writer->env, &in_base_uri);
-    serd_uri_parse(node->buf, &uri);
-    serd_uri_resolve(&uri, &in_base_uri, &abs_uri);
-    bool     rooted = uri_is_under(&writer->base_uri, &writer->root_uri);
-    SerdURI* root   = rooted ? &writer->root_uri : &writer->base_uri;
-    if (!uri_is_under(&abs_uri, root) || writer->syntax == SERD_NTRIPLES ||
-        writer->syntax == SERD_NQUADS) {
-      serd_uri_serialise(&abs_uri, uri_sink, writer);
-    } else {
-      serd_uri_serialise_relative(
-        &uri, &writer->base_uri, root, uri_sink, writer);
-    }
+    const SerdNode* const resolved = resolve_uri(writer, node);
+    write_uri(writer, resolved->buf, resolved->n_bytes);
   } else {
     write_uri(writer, node->buf, node->n_bytes);
   }
@@ -641,6 +791,7 @@ write_curie(SerdWriter* const        writer,
   switch (writer->syntax) {
   case SERD_NTRIPLES:
   case SERD_NQUADS:
+  case SERD_BINARY:
     if ((st = serd_env_expand(writer->env, node, &prefix, &suffix))) {
       w_err(writer, st, "undefined namespace prefix `%s'\n", node->buf);
       return false;
@@ -676,12 +827,17 @@ write_blank(SerdWriter* const        writer,
   if (supports_abbrev(writer)) {
     if (is_inline_start(writer, field, flags)) {
       ++writer->indent;
+      if (field == FIELD_SUBJECT) {
+        // The predicate list starts with a newline, so don't add another
+        return sink("[", 1, writer) == 1;
+      }
+
       return write_sep(writer, SEP_ANON_BEGIN);
     }
 
     if (field == FIELD_SUBJECT && (flags & SERD_LIST_S_BEGIN)) {
       assert(writer->list_depth == 0);
-      copy_node(&writer->list_subj, node);
+      copy_node(&writer->allocator, &writer->list_subj, node);
       ++writer->list_depth;
       ++writer->indent;
       return write_sep(writer, SEP_LIST_BEGIN);
@@ -743,6 +899,183 @@ write_node(SerdWriter*        writer,
   return ret;
 }
 
+static void
+clear_node_caches(SerdWriter* writer)
+{
+  for (unsigned f = 0u; f < 3u; ++f) {
+    NodeCache* const cache = &writer->node_caches[f];
+    for (unsigned i = 0u; i < NODE_CACHE_SIZE; ++i) {
+      cache->entries[i].type = SERD_NOTHING;
+    }
+  }
+}
+
+static void
+free_node_caches(SerdWriter* writer)
+{
+  for (unsigned f = 0u; f < 3u; ++f) {
+    NodeCache* const cache = &writer->node_caches[f];
+    for (unsigned i = 0u; i < NODE_CACHE_SIZE; ++i) {
+      serd_afree(&writer->allocator, cache->entries[i].buf);
+    }
+  }
+}
+
+// Return the index of a node in a node cache, from only a few of its bytes
+static inline unsigned
+node_cache_index(const SerdNode* node)
+{
+  const size_t   n    = node->n_bytes;
+  const unsigned last = n > 0u ? node->buf[n - 1u] : 0u;
+  const unsigned prev = n > 1u ? node->buf[n - 2u] : 0u;
+
+  return ((unsigned)n ^ (last << 1u) ^ (prev << 4u)) & (NODE_CACHE_SIZE - 1u);
+}
+
+/**
+   Write the subject, predicate, or graph of a line statement.
+
+   These are often the same as in recent statements, so the bytes written for
+   absolute URIs and blank nodes are kept, and copied directly if the same node
+   is written again.  Nothing else affects how these are written in line
+   syntaxes, except the blank prefix, and the caches are cleared if that
+   changes.
+*/
+static bool
+write_line_node(SerdWriter*              writer,
+                const SerdNode*          node,
+                const Field              field,
+                const SerdStatementFlags flags)
+{
+  if (node->type != SERD_URI && node->type != SERD_BLANK) {
+    return write_node(writer, node, NULL, NULL, field, flags);
+  }
+
+  NodeCache* const cache =
+    &writer->node_caches[field == FIELD_GRAPH ? 2u : (unsigned)field - 1u];
+
+  CachedNode* const entry = &cache->entries[node_cache_index(node)];
+  if (entry->type == node->type && entry->n_bytes == node->n_bytes &&
+      !memcmp(entry->buf, node->buf, node->n_bytes)) {
+    writer->stats.n_escapes += entry->n_escapes;
+    writer->last_sep = SEP_NONE;
+    return sink(entry->buf + entry->n_bytes, entry->n_written, writer) ==
+           entry->n_written;
+  }
+
+  if (node->type == SERD_URI && !serd_uri_string_has_scheme(node->buf)) {
+    return write_node(writer, node, NULL, NULL, field, flags);
+  }
+
+  // Replace the entry with this node, and copy the bytes written for it
+  const size_t n_escapes = writer->stats.n_escapes;
+
+  reserve_cached(writer, entry, node->n_bytes);
+  memcpy(entry->buf, node->buf, node->n_bytes);
+  entry->type      = SERD_NOTHING;
+  entry->n_bytes   = node->n_bytes;
+  entry->n_written = 0u;
+  writer->capture  = entry;
+
+  const bool ret = write_node(writer, node, NULL, NULL, field, flags);
+
+  writer->capture = NULL;
+  if (ret) {
+    entry->type      = node->type;
+    entry->n_escapes = writer->stats.n_escapes - n_escapes;
+  }
+
+  return ret;
+}
+
+static void
+write_binary_varint(SerdWriter* writer, const uint64_t value)
+{
+  uint8_t buf[SERD_BINARY_MAX_VARINT];
+  sink(buf, serd_binary_encode_varint(buf, value), writer);
+}
+
+/// Write the binary header if this is the start of the output
+static void
+write_binary_header(SerdWriter* writer)
+{
+  if (!writer->terms) {
+    writer->terms = serd_dictionary_new();
+    sink(SERD_BINARY_MAGIC, SERD_BINARY_MAGIC_LEN, writer);
+  }
+}
+
+/// Write a node in binary syntax, using the term table if `intern` is true
+static void
+write_binary_node(SerdWriter* writer, const SerdNode* node, const bool intern)
+{
+  uint8_t header = 0u;
+  if (!node || !node->buf) {
+    sink(&header, 1u, writer);
+    return;
+  }
+
+  if (node->type == SERD_URI && (writer->style & SERD_STYLE_RESOLVED)) {
+    node = resolve_uri(writer, node);
+  }
+
+  header = (uint8_t)node->type;
+  if (intern) {
+    const size_t     n_terms = serd_dictionary_size(writer->terms);
+    const SerdNodeID id      = serd_dictionary_intern(writer->terms, node);
+    if (serd_dictionary_size(writer->terms) == n_terms) {
+      header = SERD_BINARY_REF;
+      sink(&header, 1u, writer);
+      write_binary_varint(writer, id);
+      return;
+    }
+
+    header |= SERD_BINARY_DEFINE;
+  }
+
+  sink(&header, 1u, writer);
+  write_binary_varint(writer, node->flags);
+  write_binary_varint(writer, node->n_chars);
+  write_binary_varint(writer, node->n_bytes);
+  sink(node->buf, node->n_bytes, writer);
+}
+
+static void
+write_binary_statement(SerdWriter*        writer,
+                       SerdStatementFlags flags,
+                       const SerdNode*    graph,
+                       const SerdNode*    subject,
+                       const SerdNode*    predicate,
+                       const SerdNode*    object,
+                       const SerdNode*    datatype,
+                       const SerdNode*    lang)
+{
+  write_binary_header(writer);
+  sink("t", 1u, writer);
+  write_binary_varint(writer, flags);
+  write_binary_node(writer, graph, true);
+  write_binary_node(writer, subject, true);
+  write_binary_node(writer, predicate, true);
+  write_binary_node(writer, object, object->type != SERD_LITERAL);
+  write_binary_node(writer, datatype, true);
+  write_binary_node(writer, lang, true);
+}
+
+/// Write a binary record for a base, prefix, or end event
+static void
+write_binary_event(SerdWriter*     writer,
+                   const char      tag,
+                   const SerdNode* first,
+                   const SerdNode* second)
+{
+  write_binary_header(writer);
+  sink(&tag, 1u, writer);
+  write_binary_node(writer, first, false);
+  if (second) {
+    write_binary_node(writer, second, false);
+  }
+}
+
 static inline bool
 is_resource(const SerdNode* node)
 {
@@ -754,7 +1087,7 @@ write_pred(SerdWriter* writer, SerdStatementFlags flags, const SerdNode* pred)
 {
   write_node(writer, pred, NULL, NULL, FIELD_PREDICATE, flags);
   write_sep(writer, SEP_P_O);
-  copy_node(&writer->context.predicate, pred);
+  copy_node(&writer->allocator, &writer->context.predicate, pred);
 }
 
 static bool
@@ -779,21 +1112,16 @@ write_list_obj(SerdWriter*        writer,
   return false;
 }
 
-SerdStatus
-serd_writer_write_statement(SerdWriter*        writer,
-                            SerdStatementFlags flags,
-                            const SerdNode*    graph,
-                            const SerdNode*    subject,
-                            const SerdNode*    predicate,
-                            const SerdNode*    object,
-                            const SerdNode*    datatype,
-                            const SerdNode*    lang)
+static SerdStatus
+write_statement(SerdWriter*        writer,
+                SerdStatementFlags flags,
+                const SerdNode*    graph,
+                const SerdNode*    subject,
+                const SerdNode*    predicate,
+                const SerdNode*    object,
+                const SerdNode*    datatype,
+                const SerdNode*    lang)
 {
-  if (!is_resource(subject) || !is_resource(predicate) || !object ||
-      !object->buf) {
-    return SERD_ERR_BAD_ARG;
-  }
-
 #define TRY(write_result)      \
   do {                         \
     if (!(write_result)) {     \
@@ -801,15 +1129,27 @@ serd_writer_write_statement(SerdWriter*        writer,
     }                          \
   } while (0)
 
+  ++writer->stats.n_statements;
+
+  if (writer->syntax == SERD_BINARY) {
+    write_binary_statement(
+      writer, flags, graph, subject, predicate, object, datatype, lang);
+    return SERD_SUCCESS;
+  }
+
   if (writer->syntax == SERD_NTRIPLES || writer->syntax == SERD_NQUADS) {
-    TRY(write_node(writer, subject, NULL, NULL, FIELD_SUBJECT, flags));
+    TRY(write_line_node(writer, subject, FIELD_SUBJECT, flags));
     sink(" ", 1, writer);
-    TRY(write_node(writer, predicate, NULL, NULL, FIELD_PREDICATE, flags));
+    TRY(write_line_node(writer, predicate, FIELD_PREDICATE, flags));
     sink(" ", 1, writer);
     TRY(write_node(writer, object, datatype, lang, FIELD_OBJECT, flags));
+    if (writer->literal.open) {
+      return SERD_SUCCESS; // Finished by serd_writer_end_literal()
+    }
+
     if (writer->syntax == SERD_NQUADS && graph) {
       sink(" ", 1, writer);
-      TRY(write_node(writer, graph, datatype, lang, FIELD_GRAPH, flags));
+      TRY(write_line_node(writer, graph, FIELD_GRAPH, flags));
     }
     sink(" .\n", 3, writer);
     return SERD_SUCCESS;
@@ -832,7 +1172,7 @@ serd_writer_write_statement(SerdWriter*        writer,
       TRY(write_node(writer, graph, datatype, lang, FIELD_GRAPH, flags));
       ++writer->indent;
       write_sep(writer, SEP_GRAPH_BEGIN);
-      copy_node(&writer->context.graph, graph);
+      copy_node(&writer->allocator, &writer->context.graph, graph);
     }
   }
 
@@ -841,7 +1181,7 @@ serd_writer_write_statement(SerdWriter*        writer,
       // Reached end of list
       if (--writer->list_depth == 0 && writer->list_subj.type) {
         reset_context(writer, false);
-        serd_node_free(&writer->context.subject);
+        serd_node_afree(&writer->allocator, &writer->context.subject);
         writer->context.subject = writer->list_subj;
         writer->list_subj       = SERD_NODE_NULL;
       }
@@ -886,7 +1226,7 @@ serd_writer_write_statement(SerdWriter*        writer,
     }
 
     reset_context(writer, false);
-    copy_node(&writer->context.subject, subject);
+    copy_node(&writer->allocator, &writer->context.subject, subject);
 
     if (!(flags & SERD_LIST_S_BEGIN)) {
       write_pred(writer, flags, predicate);
@@ -899,18 +1239,339 @@ serd_writer_write_statement(SerdWriter*        writer,
     WriteContext* ctx =
       (WriteContext*)serd_stack_push(&writer->anon_stack, sizeof(WriteContext));
     *ctx                     = writer->context;
-    WriteContext new_context = {
-      serd_node_copy(graph), serd_node_copy(subject), SERD_NODE_NULL};
+    WriteContext new_context = {serd_node_acopy(&writer->allocator, graph),
+                                serd_node_acopy(&writer->allocator, subject),
+                                SERD_NODE_NULL};
     if ((flags & SERD_ANON_S_BEGIN)) {
-      new_context.predicate = serd_node_copy(predicate);
+      new_context.predicate = serd_node_acopy(&writer->allocator, predicate);
     }
     writer->context = new_context;
   } else {
-    copy_node(&writer->context.graph, graph);
-    copy_node(&writer->context.subject, subject);
-    copy_node(&writer->context.predicate, predicate);
+    copy_node(&writer->allocator, &writer->context.graph, graph);
+    copy_node(&writer->allocator, &writer->context.subject, subject);
+    copy_node(&writer->allocator, &writer->context.predicate, predicate);
+  }
+
+  return SERD_SUCCESS;
+}
+
+/// Compare nodes as cheaply as possible, for grouping rather than ordering
+static int
+compare_nodes(const SerdNode* a, const SerdNode* b)
+{
+  if (!a || !b) {
+    return (int)!!a - (int)!!b;
   }
 
+  if (a->type != b->type) {
+    return (int)a->type - (int)b->type;
+  }
+
+  if (a->n_bytes != b->n_bytes) {
+    return a->n_bytes < b->n_bytes ? -1 : 1;
+  }
+
+  return memcmp(a->buf, b->buf, a->n_bytes);
+}
+
+/// Compare entries by graph, subject, predicate, then position
+static int
+compare_by_nodes(const void* a, const void* b)
+{
+  const WindowEntry* const ea = (const WindowEntry*)a;
+  const WindowEntry* const eb = (const WindowEntry*)b;
+
+  for (unsigned i = 0u; i < 3u; ++i) {
+    const int cmp = compare_nodes(ea->nodes[i], eb->nodes[i]);
+    if (cmp) {
+      return cmp;
+    }
+  }
+
+  return ea->index < eb->index ? -1 : ea->index > eb->index;
+}
+
+/// Compare entries by the first appearance of their groups, then position
+static int
+compare_by_first(const void* a, const void* b)
+{
+  const WindowEntry* const ea = (const WindowEntry*)a;
+  const WindowEntry* const eb = (const WindowEntry*)b;
+
+  for (unsigned i = 0u; i < 3u; ++i) {
+    if (ea->first[i] != eb->first[i]) {
+      return ea->first[i] < eb->first[i] ? -1 : 1;
+    }
+  }
+
+  return ea->index < eb->index ? -1 : ea->index > eb->index;
+}
+
+/// Return true iff two entries are in the same group of the given field
+static bool
+in_group(const WindowEntry* a, const WindowEntry* b, const unsigned field)
+{
+  for (unsigned i = 0u; i <= field; ++i) {
+    if (compare_nodes(a->nodes[i], b->nodes[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/// Write every statement in the window grouped by graph, subject, and predicate
+static SerdStatus
+flush_window(SerdWriter* writer)
+{
+  Window* const window = &writer->window;
+  const size_t  n      = window->statements.n_statements;
+  if (!n) {
+    return SERD_SUCCESS;
+  }
+
+  if (n > window->n_entries) {
+    window->entries = (WindowEntry*)serd_arealloc(
+      &writer->allocator, window->entries, n * sizeof(WindowEntry));
+    window->n_entries = n;
+  }
+
+  // Decode every statement so the entries point to their nodes
+  WindowEntry* const entries = window->entries;
+  size_t             offset  = SERD_STACK_BOTTOM;
+  for (size_t i = 0u; i < n; ++i) {
+    const SerdStatementHeader* const header =
+      serd_statements_decode(&window->statements, offset, entries[i].nodes);
+
+    entries[i].index = i;
+    offset += header->size;
+  }
+
+  // Sort to make groups contiguous, then find where each group first appears
+  qsort(entries, n, sizeof(WindowEntry), compare_by_nodes);
+  for (unsigned f = 0u; f < 3u; ++f) {
+    for (size_t begin = 0u; begin < n;) {
+      size_t end   = begin + 1u;
+      size_t first = entries[begin].index;
+      for (; end < n && in_group(&entries[begin], &entries[end], f); ++end) {
+        first = entries[end].index < first ? entries[end].index : first;
+      }
+
+      for (size_t i = begin; i < end; ++i) {
+        entries[i].first[f] = first;
+      }
+
+      begin = end;
+    }
+  }
+
+  // Sort groups into the order they first appeared in and write them
+  qsort(entries, n, sizeof(WindowEntry), compare_by_first);
+
+  SerdStatus st = SERD_SUCCESS;
+  for (size_t i = 0u; !st && i < n; ++i) {
+    const SerdNode* const* const nodes = entries[i].nodes;
+
+    st = write_statement(
+      writer, 0, nodes[0], nodes[1], nodes[2], nodes[3], nodes[4], nodes[5]);
+  }
+
+  serd_statements_clear(&window->statements);
+  return st;
+}
+
+/// Copy `src` to `dst` if it is set, or clear `dst` otherwise
+static void
+copy_optional_node(const SerdAllocator* allocator,
+                   SerdNode*            dst,
+                   const SerdNode*      src)
+{
+  copy_node(allocator, dst, (src && src->buf) ? src : NULL);
+}
+
+/// Finish a literal written in pieces with the end of its statement
+static SerdStatus
+finish_literal(SerdWriter*     writer,
+               const SerdNode* graph,
+               const SerdNode* datatype,
+               const SerdNode* lang)
+{
+  OpenLiteral* const literal = &writer->literal;
+  copy_optional_node(&writer->allocator, &literal->graph, graph);
+  copy_optional_node(&writer->allocator, &literal->datatype, datatype);
+  copy_optional_node(&writer->allocator, &literal->lang, lang);
+  return serd_writer_end_literal(writer);
+}
+
+SerdStatus
+serd_writer_write_statement(SerdWriter*        writer,
+                            SerdStatementFlags flags,
+                            const SerdNode*    graph,
+                            const SerdNode*    subject,
+                            const SerdNode*    predicate,
+                            const SerdNode*    object,
+                            const SerdNode*    datatype,
+                            const SerdNode*    lang)
+{
+  if (!is_resource(subject) || !is_resource(predicate) || !object ||
+      !object->buf) {
+    return SERD_ERR_BAD_ARG;
+  }
+
+  if (writer->literal.open) {
+    if (object->flags & SERD_IS_CHUNKED) {
+      return finish_literal(writer, graph, datatype, lang);
+    }
+
+    // The literal was abandoned, for example after an error in lax reading
+    serd_writer_end_literal(writer);
+  }
+
+  Window* const window = &writer->window;
+  if (!window->max_statements) {
+    return write_statement(
+      writer, flags, graph, subject, predicate, object, datatype, lang);
+  }
+
+  // Anonymous nodes and lists depend on order, so write everything before them
+  if (flags || !serd_stack_is_empty(&writer->anon_stack)) {
+    const SerdStatus st = flush_window(writer);
+    return st ? st
+              : write_statement(writer,
+                                flags,
+                                graph,
+                                subject,
+                                predicate,
+                                object,
+                                datatype,
+                                lang);
+  }
+
+  serd_statements_push(&window->statements,
+                       flags,
+                       graph,
+                       subject,
+                       predicate,
+                       object,
+                       datatype,
+                       lang);
+
+  const size_t n_statements = window->statements.n_statements;
+  const size_t size =
+    window->statements.stack.size + n_statements * sizeof(WindowEntry);
+
+  return (n_statements == window->max_statements || size >= window->max_bytes)
+           ? flush_window(writer)
+           : SERD_SUCCESS;
+}
+
+SerdStatus
+serd_writer_write_statements(SerdWriter*          writer,
+                             const SerdStatement* statements,
+                             size_t               n_statements)
+{
+  SerdStatus st = SERD_SUCCESS;
+  for (size_t i = 0u; !st && i < n_statements; ++i) {
+    const SerdStatement* const s = &statements[i];
+
+    st = serd_writer_write_statement(writer,
+                                     s->flags,
+                                     s->graph,
+                                     s->subject,
+                                     s->predicate,
+                                     s->object,
+                                     s->object_datatype,
+                                     s->object_lang);
+  }
+
+  return st;
+}
+
+SerdStatus
+serd_writer_begin_literal(SerdWriter*        writer,
+                          SerdStatementFlags flags,
+                          const SerdNode*    graph,
+                          const SerdNode*    subject,
+                          const SerdNode*    predicate,
+                          const SerdNode*    object,
+                          const SerdNode*    datatype,
+                          const SerdNode*    lang)
+{
+  if (!is_resource(subject) || !is_resource(predicate) || !object ||
+      !object->buf || object->type != SERD_LITERAL ||
+      writer->syntax == SERD_BINARY || writer->literal.open) {
+    return SERD_ERR_BAD_ARG;
+  }
+
+  // Write everything before, since the statement is written immediately
+  SerdStatus st = flush_window(writer);
+  if (st) {
+    return st;
+  }
+
+  OpenLiteral* const literal = &writer->literal;
+  copy_optional_node(&writer->allocator, &literal->graph, graph);
+  copy_optional_node(&writer->allocator, &literal->datatype, datatype);
+  copy_optional_node(&writer->allocator, &literal->lang, lang);
+
+  literal->open = true;
+  if ((st = write_statement(
+         writer, flags, graph, subject, predicate, object, NULL, NULL))) {
+    literal->open = false;
+  }
+
+  return st;
+}
+
+SerdStatus
+serd_writer_write_literal_piece(SerdWriter*        writer,
+                                SerdStatementFlags flags,
+                                const SerdNode*    graph,
+                                const SerdNode*    subject,
+                                const SerdNode*    predicate,
+                                const SerdNode*    piece)
+{
+  if (!piece->buf) {
+    return SERD_ERR_BAD_ARG;
+  }
+
+  if (!writer->literal.open) {
+    return serd_writer_begin_literal(
+      writer, flags, graph, subject, predicate, piece, NULL, NULL);
+  }
+
+  write_text(writer, WRITE_STRING, piece->buf, piece->n_bytes);
+  return SERD_SUCCESS;
+}
+
+SerdStatus
+serd_writer_end_literal(SerdWriter* writer)
+{
+  OpenLiteral* const literal = &writer->literal;
+  if (!literal->open) {
+    return SERD_ERR_BAD_ARG;
+  }
+
+  literal->open = false;
+  sink("\"", 1, writer);
+  if (literal->lang.type) {
+    sink("@", 1, writer);
+    sink(literal->lang.buf, literal->lang.n_bytes, writer);
+  } else if (literal->datatype.type) {
+    sink("^^", 2, writer);
+    write_node(writer, &literal->datatype, NULL, NULL, FIELD_NONE, 0u);
+  }
+
+  if (writer->syntax == SERD_NTRIPLES || writer->syntax == SERD_NQUADS) {
+    if (writer->syntax == SERD_NQUADS && literal->graph.type) {
+      sink(" ", 1, writer);
+      write_line_node(writer, &literal->graph, FIELD_GRAPH, 0u);
+    }
+
+    sink(" .\n", 3, writer);
+  }
+
+  writer->last_sep = SEP_NONE;
   return SERD_SUCCESS;
 }
 
@@ -921,6 +1582,16 @@ serd_writer_end_anon(SerdWriter* writer, const SerdNode* node)
     return SERD_SUCCESS;
   }
 
+  if (writer->syntax == SERD_BINARY) {
+    write_binary_event(writer, 'e', node, NULL);
+    return SERD_SUCCESS;
+  }
+
+  const SerdStatus st = flush_window(writer);
+  if (st) {
+    return st;
+  }
+
   if (serd_stack_is_empty(&writer->anon_stack) || writer->indent == 0) {
     w_err(writer, SERD_ERR_UNKNOWN, "unexpected end of anonymous node\n");
     return SERD_ERR_UNKNOWN;
@@ -933,7 +1604,7 @@ serd_writer_end_anon(SerdWriter* writer, const SerdNode* node)
   serd_stack_pop(&writer->anon_stack, sizeof(WriteContext));
   const bool is_subject = serd_node_equals(node, &writer->context.subject);
   if (is_subject) {
-    copy_node(&writer->context.subject, node);
+    copy_node(&writer->allocator, &writer->context.subject, node);
     writer->context.predicate.type = SERD_NOTHING;
   }
 
@@ -943,6 +1614,12 @@ serd_writer_end_anon(SerdWriter* writer, const SerdNode* node)
 SerdStatus
 serd_writer_finish(SerdWriter* writer)
 {
+  if (writer->literal.open) {
+    serd_writer_end_literal(writer);
+  }
+
+  const SerdStatus window_st = flush_window(writer);
+
   if (writer->context.subject.type) {
     write_sep(writer, SEP_END_S);
   }
@@ -953,7 +1630,55 @@ serd_writer_finish(SerdWriter* writer)
 
   serd_byte_sink_flush(&writer->byte_sink);
   writer->indent = 0;
-  return free_context(writer);
+
+  const SerdStatus context_st = free_context(writer);
+  const SerdStatus st         = window_st ? window_st : context_st;
+  if (writer->encoder) {
+    const SerdStatus encoder_st = serd_encoder_finish(writer->encoder);
+    return st ? st : encoder_st;
+  }
+
+  return st;
+}
+
+/// Free the contexts of any anonymous nodes that were not ended
+static void
+free_anon_contexts(SerdWriter* writer)
+{
+  while (!serd_stack_is_empty(&writer->anon_stack)) {
+    writer->context = *anon_stack_top(writer);
+    serd_stack_pop(&writer->anon_stack, sizeof(WriteContext));
+    free_context(writer);
+  }
+}
+
+SerdStatus
+serd_writer_reset(SerdWriter* writer, SerdEnv* env)
+{
+  const SerdStatus st = serd_writer_finish(writer);
+
+  free_anon_contexts(writer);
+
+  if (env) {
+    writer->env = env;
+  }
+
+  serd_env_get_base_uri(writer->env, &writer->base_uri);
+  clear_uri_cache(writer);
+  clear_node_caches(writer);
+
+  // Forget binary terms, so the header is written again
+  serd_dictionary_free(writer->terms);
+  writer->terms = NULL;
+
+  serd_node_afree(&writer->allocator, &writer->list_subj);
+  writer->list_subj  = SERD_NODE_NULL;
+  writer->list_depth = 0u;
+  writer->indent     = 0u;
+  writer->last_sep   = SEP_NONE;
+  writer->empty      = true;
+  memset(&writer->stats, 0, sizeof(writer->stats));
+  return st;
 }
 
 SerdWriter*
@@ -964,8 +1689,64 @@ serd_writer_new(SerdSyntax     syntax,
                 SerdSink       ssink,
                 void*          stream)
 {
+  return serd_writer_new_with_allocator(
+    NULL, syntax, style, env, base_uri, ssink, stream);
+}
+
+/// Return the size of output blocks for a writer with `style`
+static size_t
+writer_block_size(const SerdStyle style)
+{
+  if (style & SERD_STYLE_ASYNC) {
+    return SERD_ASYNC_BLOCK_SIZE;
+  }
+
+  // Compression is always buffered, since every write to an encoder is costly
+  return (style & (SERD_STYLE_BULK | SERD_STYLE_GZIP | SERD_STYLE_ZSTD))
+           ? SERD_PAGE_SIZE
+           : 1u;
+}
+
+/// Return the output compression for a writer with `style`
+static SerdCompression
+writer_compression(const SerdStyle style)
+{
+  if (style & SERD_STYLE_ZSTD) {
+    return SERD_COMPRESSION_ZSTD;
+  }
+
+  return (style & SERD_STYLE_GZIP) ? SERD_COMPRESSION_GZIP
+                                   : SERD_COMPRESSION_NONE;
+}
+
+SerdWriter*
+serd_writer_new_with_allocator(const SerdAllocator* allocator,
+                               SerdSyntax           syntax,
+                               SerdStyle            style,
+                               SerdEnv*             env,
+                               const SerdURI*       base_uri,
+                               SerdSink             ssink,
+                               void*                stream)
+{
+  const SerdCompression compression = writer_compression(style);
+  if (!serd_compression_supported(compression)) {
+    return NULL;
+  }
+
   const WriteContext context = WRITE_CONTEXT_NULL;
-  SerdWriter*        writer  = (SerdWriter*)calloc(1, sizeof(SerdWriter));
+  SerdWriter* const  writer =
+    (SerdWriter*)serd_acalloc(allocator, 1, sizeof(SerdWriter));
+
+  if (allocator) {
+    writer->allocator = *allocator;
+  }
+
+  if (compression) {
+    writer->encoder =
+      serd_encoder_new(&writer->allocator, compression, ssink, stream);
+    ssink  = serd_encoder_write;
+    stream = writer->encoder;
+  }
 
   writer->syntax     = syntax;
   writer->style      = style;
@@ -973,12 +1754,16 @@ serd_writer_new(SerdSyntax     syntax,
   writer->root_node  = SERD_NODE_NULL;
   writer->root_uri   = SERD_URI_NULL;
   writer->base_uri   = base_uri ? *base_uri : SERD_URI_NULL;
-  writer->anon_stack = serd_stack_new(4 * sizeof(WriteContext));
+  writer->anon_stack =
+    serd_stack_new(&writer->allocator, 4 * sizeof(WriteContext));
   writer->context    = context;
   writer->list_subj  = SERD_NODE_NULL;
   writer->empty      = true;
-  writer->byte_sink  = serd_byte_sink_new(
-    ssink, stream, (style & SERD_STYLE_BULK) ? SERD_PAGE_SIZE : 1);
+  writer->byte_sink  = serd_byte_sink_new(&writer->allocator,
+                                         ssink,
+                                         stream,
+                                         writer_block_size(style),
+                                         style & SERD_STYLE_ASYNC);
 
   return writer;
 }
@@ -992,26 +1777,49 @@ serd_writer_set_error_sink(SerdWriter*   writer,
   writer->error_handle = error_handle;
 }
 
+void
+serd_writer_set_reorder_window(SerdWriter*  writer,
+                               const size_t max_statements,
+                               const size_t max_bytes)
+{
+  Window* const window = &writer->window;
+
+  flush_window(writer);
+  if (writer->syntax != SERD_TURTLE && writer->syntax != SERD_TRIG) {
+    return;
+  }
+
+  window->max_statements = max_bytes ? max_statements : 0u;
+  window->max_bytes      = max_bytes;
+  if (window->max_statements && !window->statements.stack.buf) {
+    window->statements =
+      serd_statements_new(&writer->allocator, SERD_PAGE_SIZE);
+  }
+}
+
 void
 serd_writer_chop_blank_prefix(SerdWriter* writer, const uint8_t* prefix)
 {
-  free(writer->bprefix);
+  flush_window(writer);
+  clear_node_caches(writer);
+  serd_afree(&writer->allocator, writer->bprefix);
   writer->bprefix_len = 0;
   writer->bprefix     = NULL;
 
   const size_t prefix_len = prefix ? strlen((const char*)prefix) : 0;
   if (prefix_len) {
     writer->bprefix_len = prefix_len;
-    writer->bprefix     = (uint8_t*)malloc(writer->bprefix_len + 1);
-    memcpy(writer->bprefix, prefix, writer->bprefix_len + 1);
+    writer->bprefix = serd_astrdup(&writer->allocator, prefix, prefix_len);
   }
 }
 
 SerdStatus
 serd_writer_set_base_uri(SerdWriter* writer, const SerdNode* uri)
 {
+  flush_window(writer);
   if (!serd_env_set_base_uri(writer->env, uri)) {
     serd_env_get_base_uri(writer->env, &writer->base_uri);
+    clear_uri_cache(writer);
 
     if (writer->syntax == SERD_TURTLE || writer->syntax == SERD_TRIG) {
       if (writer->context.graph.type || writer->context.subject.type) {
@@ -1021,6 +1829,8 @@ serd_writer_set_base_uri(SerdWriter* writer, const SerdNode* uri)
       sink("@base <", 7, writer);
       sink(uri->buf, uri->n_bytes, writer);
       sink("> .\n", 4, writer);
+    } else if (writer->syntax == SERD_BINARY) {
+      write_binary_event(writer, 'b', uri, NULL);
     }
     writer->indent = 0;
     return reset_context(writer, true);
@@ -1032,10 +1842,12 @@ serd_writer_set_base_uri(SerdWriter* writer, const SerdNode* uri)
 SerdStatus
 serd_writer_set_root_uri(SerdWriter* writer, const SerdNode* uri)
 {
-  serd_node_free(&writer->root_node);
+  flush_window(writer);
+  serd_node_afree(&writer->allocator, &writer->root_node);
+  clear_uri_cache(writer);
 
   if (uri && uri->buf) {
-    writer->root_node = serd_node_copy(uri);
+    writer->root_node = serd_node_acopy(&writer->allocator, uri);
     serd_uri_parse(uri->buf, &writer->root_uri);
   } else {
     writer->root_node = SERD_NODE_NULL;
@@ -1050,6 +1862,7 @@ serd_writer_set_prefix(SerdWriter*     writer,
                        const SerdNode* name,
                        const SerdNode* uri)
 {
+  flush_window(writer);
   if (!serd_env_set_prefix(writer->env, name, uri)) {
     if (writer->syntax == SERD_TURTLE || writer->syntax == SERD_TRIG) {
       if (writer->context.graph.type || writer->context.subject.type) {
@@ -1061,6 +1874,8 @@ serd_writer_set_prefix(SerdWriter*     writer,
       sink(": <", 3, writer);
       write_uri(writer, uri->buf, uri->n_bytes);
       sink("> .\n", 4, writer);
+    } else if (writer->syntax == SERD_BINARY) {
+      write_binary_event(writer, 'p', name, uri);
     }
     writer->indent = 0;
     return reset_context(writer, true);
@@ -1077,11 +1892,23 @@ serd_writer_free(SerdWriter* writer)
   }
 
   serd_writer_finish(writer);
+  free_anon_contexts(writer);
+  serd_statements_free(&writer->window.statements);
+  serd_afree(&writer->allocator, writer->window.entries);
   serd_stack_free(&writer->anon_stack);
-  free(writer->bprefix);
+  serd_afree(&writer->allocator, writer->bprefix);
   serd_byte_sink_free(&writer->byte_sink);
-  serd_node_free(&writer->root_node);
-  free(writer);
+  serd_encoder_free(writer->encoder);
+  clear_uri_cache(writer);
+  free_node_caches(writer);
+  serd_dictionary_free(writer->terms);
+  serd_node_afree(&writer->allocator, &writer->literal.graph);
+  serd_node_afree(&writer->allocator, &writer->literal.datatype);
+  serd_node_afree(&writer->allocator, &writer->literal.lang);
+  serd_node_afree(&writer->allocator, &writer->root_node);
+
+  const SerdAllocator allocator = writer->allocator;
+  serd_afree(&allocator, writer);
 }
 
 SerdEnv*
@@ -1090,6 +1917,12 @@ serd_writer_get_env(SerdWriter* writer)
   return writer->env;
 }
 
+SerdWriterStats
+serd_writer_get_stats(const SerdWriter* writer)
+{
+  return writer->stats;
+}
+
 size_t
 serd_file_sink(const void* buf, size_t len, void* stream)
 {
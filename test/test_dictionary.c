@@ -0,0 +1,176 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "serd/serd.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define USTR(s) ((const uint8_t*)(s))
+
+#define N_STATEMENTS 3u
+
+typedef struct {
+  SerdNodeID ids[N_STATEMENTS][6];
+  unsigned   n_statements;
+} IDTest;
+
+static SerdStatus
+id_sink(void*              handle,
+        SerdStatementFlags flags,
+        SerdNodeID         graph,
+        SerdNodeID         subject,
+        SerdNodeID         predicate,
+        SerdNodeID         object,
+        SerdNodeID         object_datatype,
+        SerdNodeID         object_lang)
+{
+  (void)flags;
+
+  IDTest* const     test = (IDTest*)handle;
+  SerdNodeID* const ids  = test->ids[test->n_statements++];
+
+  assert(test->n_statements <= N_STATEMENTS);
+  ids[0] = graph;
+  ids[1] = subject;
+  ids[2] = predicate;
+  ids[3] = object;
+  ids[4] = object_datatype;
+  ids[5] = object_lang;
+  return SERD_SUCCESS;
+}
+
+static void
+test_intern(void)
+{
+  SerdDictionary* const dict = serd_dictionary_new();
+
+  const uint8_t* const str = USTR("http://example.org/");
+  const SerdNode       uri = serd_node_from_string(SERD_URI, str);
+  const SerdNode       lit = serd_node_from_string(SERD_LITERAL, str);
+
+  assert(!serd_dictionary_size(dict));
+  assert(!serd_dictionary_find(dict, &uri));
+  assert(!serd_dictionary_intern(dict, NULL));
+  assert(!serd_dictionary_intern(dict, &SERD_NODE_NULL));
+  assert(!serd_dictionary_get(dict, 0u));
+  assert(!serd_dictionary_get(dict, 1u));
+
+  // Nodes with the same string but different types are different
+  assert(serd_dictionary_intern(dict, &uri) == 1u);
+  assert(serd_dictionary_intern(dict, &lit) == 2u);
+  assert(serd_dictionary_intern(dict, &uri) == 1u);
+  assert(serd_dictionary_find(dict, &lit) == 2u);
+  assert(serd_dictionary_size(dict) == 2u);
+
+  const SerdNode* const got = serd_dictionary_get(dict, 1u);
+  assert(got && got->buf != uri.buf);
+  assert(serd_node_equals(got, &uri));
+  assert(!serd_dictionary_get(dict, 3u));
+
+  // Add enough nodes to grow everything, including a large string
+  char* const big = (char*)calloc(100000u, 1);
+  memset(big, 'x', 99999u);
+
+  const SerdNode big_node = serd_node_from_string(SERD_LITERAL, USTR(big));
+  assert(serd_dictionary_intern(dict, &big_node) == 3u);
+
+  char buf[32];
+  for (unsigned i = 0u; i < 10000u; ++i) {
+    snprintf(buf, sizeof(buf), "http://example.org/%u", i);
+    const SerdNode node = serd_node_from_string(SERD_URI, USTR(buf));
+    assert(serd_dictionary_intern(dict, &node) == i + 4u);
+  }
+
+  // Export every node and check that IDs are stable
+  assert(serd_dictionary_size(dict) == 10003u);
+  for (SerdNodeID id = 1u; id <= serd_dictionary_size(dict); ++id) {
+    const SerdNode* const node = serd_dictionary_get(dict, id);
+    assert(node);
+    assert(serd_dictionary_find(dict, node) == id);
+    assert(strlen((const char*)node->buf) == node->n_bytes);
+  }
+
+  assert(!strcmp((const char*)serd_dictionary_get(dict, 3u)->buf, big));
+  assert(!strcmp((const char*)serd_dictionary_get(dict, 10003u)->buf,
+                 "http://example.org/9999"));
+
+  free(big);
+  serd_dictionary_free(dict);
+}
+
+static void
+test_read_ids(void)
+{
+  static const char* const doc =
+    "<http://example.org/s> <http://example.org/p>\n"
+    "  \"hello\"@en , \"1\"^^<http://example.org/int> .\n";
+
+  IDTest                test   = {{{0u}}, 0u};
+  SerdDictionary* const dict   = serd_dictionary_new();
+  SerdReader* const     reader =
+    serd_reader_new(SERD_TURTLE, &test, NULL, NULL, NULL, NULL, NULL);
+
+  serd_reader_set_dictionary(reader, dict, id_sink);
+  assert(!serd_reader_read_string(reader, USTR(doc)));
+  assert(test.n_statements == 2u);
+
+  const SerdNodeID* const first  = test.ids[0];
+  const SerdNodeID* const second = test.ids[1];
+  assert(!first[0] && !second[0]);
+  assert(first[1] && second[1] == first[1]);
+  assert(first[2] && second[2] == first[2]);
+  assert(!first[4] && first[5]);
+  assert(second[4] && !second[5]);
+
+  assert(!strcmp((const char*)serd_dictionary_get(dict, first[1])->buf,
+                 "http://example.org/s"));
+  assert(!strcmp((const char*)serd_dictionary_get(dict, first[3])->buf,
+                 "hello"));
+  assert(!strcmp((const char*)serd_dictionary_get(dict, first[5])->buf, "en"));
+  assert(!strcmp((const char*)serd_dictionary_get(dict, second[4])->buf,
+                 "http://example.org/int"));
+
+  // Another reader sharing the dictionary gives the same IDs
+  SerdReader* const other =
+    serd_reader_new(SERD_NTRIPLES, &test, NULL, NULL, NULL, NULL, NULL);
+
+  serd_reader_set_dictionary(other, dict, id_sink);
+  assert(!serd_reader_read_string(
+    other, USTR("<http://example.org/s> <http://example.org/p> \"x\" .\n")));
+
+  assert(test.n_statements == 3u);
+  assert(test.ids[2][1] == first[1]);
+  assert(test.ids[2][2] == first[2]);
+  assert(test.ids[2][3] == serd_dictionary_size(dict));
+
+  serd_reader_free(other);
+  serd_reader_free(reader);
+  serd_dictionary_free(dict);
+}
+
+int
+main(void)
+{
+  test_intern();
+  test_read_ids();
+  return 0;
+}
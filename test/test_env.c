@@ -20,6 +20,7 @@
 
 #include <assert.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
 #define USTR(s) ((const uint8_t*)(s))
@@ -94,9 +95,137 @@ test_env(void)
   serd_env_free(env);
 }
 
+static void
+test_qualify(void)
+{
+  SerdEnv* const env = serd_env_new(NULL);
+
+  // Declare enough prefixes to grow the hash table several times
+  char name[16];
+  char uri[64];
+  for (unsigned i = 0u; i < 100u; ++i) {
+    snprintf(name, sizeof(name), "p%u", i);
+    snprintf(uri, sizeof(uri), "http://example.org/ns%u/", i);
+    assert(!serd_env_set_prefix_from_strings(env, USTR(name), USTR(uri)));
+  }
+
+  assert(!serd_env_set_prefix_from_strings(
+    env, USTR("eg"), USTR("http://example.org/")));
+  assert(!serd_env_set_prefix_from_strings(
+    env, USTR("deep"), USTR("http://example.org/ns1/deep/")));
+  assert(!serd_env_set_prefix_from_strings(
+    env, USTR("same"), USTR("http://example.org/ns1/deep/")));
+
+  int n_prefixes = 0;
+  serd_env_foreach(env, count_prefixes, &n_prefixes);
+  assert(n_prefixes == 103);
+
+  // Expand every name through the hash table
+  for (unsigned i = 0u; i < 100u; ++i) {
+    snprintf(name, sizeof(name), "p%u:x", i);
+    snprintf(uri, sizeof(uri), "http://example.org/ns%u/x", i);
+
+    const SerdNode curie = serd_node_from_string(SERD_CURIE, USTR(name));
+    SerdNode       xc    = serd_env_expand_node(env, &curie);
+    assert(!strcmp((const char*)xc.buf, uri));
+    serd_node_free(&xc);
+  }
+
+  // The longest prefix wins, regardless of the declaration order
+  SerdNode  prefix;
+  SerdChunk suffix;
+  SerdNode  u = serd_node_from_string(SERD_URI, USTR("http://example.org/a"));
+  assert(serd_env_qualify(env, &u, &prefix, &suffix));
+  assert(!strcmp((const char*)prefix.buf, "eg"));
+  assert(!strcmp((const char*)suffix.buf, "a"));
+
+  u = serd_node_from_string(SERD_URI, USTR("http://example.org/ns10/a"));
+  assert(serd_env_qualify(env, &u, &prefix, &suffix));
+  assert(!strcmp((const char*)prefix.buf, "p10"));
+  assert(!strcmp((const char*)suffix.buf, "a"));
+
+  // The first declared prefix wins ties
+  u = serd_node_from_string(SERD_URI, USTR("http://example.org/ns1/deep/a"));
+  assert(serd_env_qualify(env, &u, &prefix, &suffix));
+  assert(!strcmp((const char*)prefix.buf, "deep"));
+
+  // A URI that shares part of a prefix falls back to a shorter one
+  u = serd_node_from_string(SERD_URI, USTR("http://example.org/ns1/dee"));
+  assert(serd_env_qualify(env, &u, &prefix, &suffix));
+  assert(!strcmp((const char*)prefix.buf, "p1"));
+  assert(!strcmp((const char*)suffix.buf, "dee"));
+
+  // Redefining a prefix moves it in the index
+  assert(!serd_env_set_prefix_from_strings(
+    env, USTR("deep"), USTR("http://example.org/other/")));
+  u = serd_node_from_string(SERD_URI, USTR("http://example.org/ns1/deep/a"));
+  assert(serd_env_qualify(env, &u, &prefix, &suffix));
+  assert(!strcmp((const char*)prefix.buf, "same"));
+  u = serd_node_from_string(SERD_URI, USTR("http://example.org/other/a"));
+  assert(serd_env_qualify(env, &u, &prefix, &suffix));
+  assert(!strcmp((const char*)prefix.buf, "deep"));
+
+  u = serd_node_from_string(SERD_URI, USTR("http://example.com/"));
+  assert(!serd_env_qualify(env, &u, &prefix, &suffix));
+
+  // An empty prefix URI matches anything
+  assert(!serd_env_set_prefix_from_strings(env, USTR("empty"), USTR("")));
+  assert(serd_env_qualify(env, &u, &prefix, &suffix));
+  assert(!strcmp((const char*)prefix.buf, "empty"));
+  assert(!strcmp((const char*)suffix.buf, "http://example.com/"));
+
+  serd_env_free(env);
+}
+
+static void
+test_copy(void)
+{
+  assert(!serd_env_copy(NULL));
+
+  SerdNode base = serd_node_from_string(SERD_URI, USTR("http://example.org/"));
+  SerdEnv* env  = serd_env_new(&base);
+  serd_env_set_prefix_from_strings(env, USTR("a"), USTR("http://a.org/"));
+  serd_env_set_prefix_from_strings(env, USTR("b"), USTR("http://b.org/"));
+
+  SerdEnv* const copy = serd_env_copy(env);
+
+  // Changing the original after copying doesn't affect the copy
+  serd_env_set_prefix_from_strings(env, USTR("a"), USTR("http://c.org/"));
+  serd_env_set_prefix_from_strings(env, USTR("d"), USTR("http://d.org/"));
+  serd_env_free(env);
+
+  int n_prefixes = 0;
+  serd_env_foreach(copy, count_prefixes, &n_prefixes);
+  assert(n_prefixes == 2);
+
+  const SerdNode a  = serd_node_from_string(SERD_CURIE, USTR("a:x"));
+  SerdNode       xa = serd_env_expand_node(copy, &a);
+  assert(!strcmp((const char*)xa.buf, "http://a.org/x"));
+  serd_node_free(&xa);
+
+  const SerdNode b  = serd_node_from_string(SERD_URI, USTR("http://b.org/y"));
+  SerdNode       qb = SERD_NODE_NULL;
+  SerdChunk      suffix;
+  assert(serd_env_qualify(copy, &b, &qb, &suffix));
+  assert(!strcmp((const char*)qb.buf, "b"));
+
+  SerdURI base_uri;
+  assert(serd_node_equals(serd_env_get_base_uri(copy, &base_uri), &base));
+  assert(!strncmp((const char*)base_uri.authority.buf, "example.org", 11));
+
+  const SerdNode rel  = serd_node_from_string(SERD_URI, USTR("rel"));
+  SerdNode       xrel = serd_env_expand_node(copy, &rel);
+  assert(!strcmp((const char*)xrel.buf, "http://example.org/rel"));
+  serd_node_free(&xrel);
+
+  serd_env_free(copy);
+}
+
 int
 main(void)
 {
   test_env();
+  test_qualify();
+  test_copy();
   return 0;
 }
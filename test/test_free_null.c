@@ -25,9 +25,14 @@ main(void)
 {
   serd_free(NULL);
   serd_node_free(NULL);
+  serd_arena_free(NULL);
   serd_env_free(NULL);
+  serd_dictionary_free(NULL);
+  serd_index_free(NULL);
+  serd_sorter_free(NULL);
   serd_reader_free(NULL);
   serd_writer_free(NULL);
+  serd_prefetch_free(NULL);
 
   return 0;
 }
@@ -0,0 +1,240 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "serd/serd.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define USTR(s) ((const uint8_t*)(s))
+
+#define N_STATEMENTS 100u
+
+typedef struct {
+  unsigned n_statements; ///< Number of statements read
+  unsigned first;        ///< Number of the first subject read
+  unsigned error_line;   ///< Line of the last error
+} IndexTest;
+
+static SerdStatus
+count_sink(void*              handle,
+           SerdStatementFlags flags,
+           const SerdNode*    graph,
+           const SerdNode*    subject,
+           const SerdNode*    predicate,
+           const SerdNode*    object,
+           const SerdNode*    object_datatype,
+           const SerdNode*    object_lang)
+{
+  (void)flags;
+  (void)graph;
+  (void)predicate;
+  (void)object;
+  (void)object_datatype;
+  (void)object_lang;
+
+  IndexTest* const test = (IndexTest*)handle;
+  if (!test->n_statements++) {
+    const char* const s = strrchr((const char*)subject->buf, 's');
+    assert(s && sscanf(s + 1, "%u", &test->first) == 1);
+  }
+
+  return SERD_SUCCESS;
+}
+
+static SerdStatus
+line_error_sink(void* handle, const SerdError* e)
+{
+  ((IndexTest*)handle)->error_line = e->line;
+  return SERD_SUCCESS;
+}
+
+static bool
+checkpoint_equals(const SerdCheckpoint* a, const SerdCheckpoint* b)
+{
+  return a->offset == b->offset && a->n_statements == b->n_statements &&
+         a->line == b->line;
+}
+
+/// Write a document with every other statement on two lines after a comment
+static FILE*
+write_doc(const SerdSyntax syntax)
+{
+  FILE* const f = tmpfile();
+
+  for (unsigned i = 0u; i < N_STATEMENTS; ++i) {
+    if (i % 2u) {
+      fprintf(f, "# Statement %u\n", i);
+    }
+
+    fprintf(f, "<http://example.org/s%u> <http://example.org/p> \"%u\"", i, i);
+    fprintf(f, syntax == SERD_NQUADS ? " <http://example.org/g> .\n" : " .\n");
+  }
+
+  fprintf(f, "<http://example.org/bad> .\n");
+  fseek(f, 0, SEEK_SET);
+  return f;
+}
+
+static void
+test_index(const SerdSyntax syntax, const bool lazy)
+{
+  FILE* const       f      = write_doc(syntax);
+  IndexTest         test   = {0u, 0u, 0u};
+  SerdIndex* const  index  = serd_index_new(10u);
+  SerdReader* const reader =
+    serd_reader_new(syntax, &test, NULL, NULL, NULL, count_sink, NULL);
+
+  assert(serd_index_interval(index) == 10u);
+  assert(!serd_index_size(index));
+  assert(!serd_index_get(index, 0u));
+  assert(!serd_index_find(index, 0u));
+
+  // Read the whole document, which has an error on the last line
+  serd_reader_set_lazy_positions(reader, lazy);
+  serd_reader_set_index(reader, index);
+  serd_reader_set_error_sink(reader, line_error_sink, &test);
+  assert(serd_reader_read_file_handle(reader, f, USTR("test")) ==
+         SERD_ERR_BAD_SYNTAX);
+  assert(test.n_statements == N_STATEMENTS);
+  assert(test.error_line > 150u);
+
+  const unsigned error_line = test.error_line;
+
+  // Check that there is a checkpoint at the start of every 10th statement
+  assert(serd_index_size(index) == 11u);
+  for (size_t i = 0u; i < 10u; ++i) {
+    const SerdCheckpoint* const c = serd_index_get(index, i);
+    assert(c->n_statements == i * 10u);
+    assert(c->line == 1u + (unsigned)i * 15u);
+
+    char expected[32];
+    char buf[32] = {0};
+    snprintf(expected, sizeof(expected), "<http://example.org/s%zu>", i * 10u);
+
+    fseek(f, (long)c->offset, SEEK_SET);
+    assert(fread(buf, 1, strlen(expected), f) == strlen(expected));
+    assert(!strcmp(buf, expected));
+  }
+
+  // The last is at the start of the invalid line where statement 100 would be
+  assert(serd_index_get(index, 10u)->n_statements == N_STATEMENTS);
+  assert(serd_index_get(index, 10u)->line == 151u);
+
+  assert(serd_index_find(index, 0u) == serd_index_get(index, 0u));
+  assert(serd_index_find(index, 25u) == serd_index_get(index, 2u));
+  assert(serd_index_find(index, 1000u) == serd_index_get(index, 10u));
+
+  // Resume from a checkpoint, and check statements and lines continue
+  const SerdCheckpoint* const c = serd_index_find(index, 45u);
+  test.n_statements             = 0u;
+  assert(serd_reader_read_file_handle_at(reader, f, USTR("test"), c) ==
+         SERD_ERR_BAD_SYNTAX);
+  assert(test.n_statements == N_STATEMENTS - 40u);
+  assert(test.first == 40u);
+  assert(test.error_line == error_line);
+
+  // Reading again doesn't add checkpoints, and mapped reading gives the same
+  SerdIndex* const mapped = serd_index_new(10u);
+  assert(serd_index_size(index) == 11u);
+  serd_reader_set_index(reader, mapped);
+  fseek(f, 0, SEEK_SET);
+  assert(serd_reader_read_mapped_file_handle(reader, f, USTR("test")));
+  assert(serd_index_size(mapped) == 11u);
+  for (size_t i = 0u; i < serd_index_size(index); ++i) {
+    assert(checkpoint_equals(serd_index_get(index, i),
+                             serd_index_get(mapped, i)));
+  }
+
+  serd_index_free(mapped);
+  serd_reader_free(reader);
+  serd_index_free(index);
+  fclose(f);
+}
+
+static void
+test_read_write(void)
+{
+  FILE* const       f      = write_doc(SERD_NTRIPLES);
+  IndexTest         test   = {0u, 0u, 0u};
+  SerdIndex* const  index  = serd_index_new(7u);
+  SerdReader* const reader =
+    serd_reader_new(SERD_NTRIPLES, &test, NULL, NULL, NULL, count_sink, NULL);
+
+  serd_reader_set_index(reader, index);
+  serd_reader_set_error_sink(reader, line_error_sink, &test);
+  serd_reader_read_file_handle(reader, f, USTR("test"));
+  assert(serd_index_size(index) == 15u);
+
+  // Write the index to a file and read it back
+  FILE* const index_file = tmpfile();
+  assert(!serd_index_write(index, index_file));
+  fseek(index_file, 0, SEEK_SET);
+
+  SerdIndex* const loaded = serd_index_read(index_file);
+  assert(loaded);
+  assert(serd_index_interval(loaded) == 7u);
+  assert(serd_index_size(loaded) == serd_index_size(index));
+  for (size_t i = 0u; i < serd_index_size(index); ++i) {
+    assert(checkpoint_equals(serd_index_get(index, i),
+                             serd_index_get(loaded, i)));
+  }
+
+  // Invalid indices fail to load
+  static const char* const bad[] = {"",
+                                    "serd-index 2 7\n",
+                                    "serd-index 1 0\n",
+                                    "serd-index 1 7\n0 1 0\nbad\n",
+                                    "serd-index 1 7\n10 2 7\n0 1 0\n"};
+
+  for (size_t i = 0u; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+    FILE* const bad_file = tmpfile();
+    fprintf(bad_file, "%s", bad[i]);
+    fseek(bad_file, 0, SEEK_SET);
+    assert(!serd_index_read(bad_file));
+    fclose(bad_file);
+  }
+
+  // Only line-based syntaxes can be resumed
+  SerdReader* const turtle =
+    serd_reader_new(SERD_TURTLE, &test, NULL, NULL, NULL, count_sink, NULL);
+
+  assert(serd_reader_read_file_handle_at(
+           turtle, f, USTR("test"), serd_index_get(index, 1u)) ==
+         SERD_ERR_BAD_ARG);
+
+  serd_reader_free(turtle);
+  serd_index_free(loaded);
+  fclose(index_file);
+  serd_reader_free(reader);
+  serd_index_free(index);
+  fclose(f);
+}
+
+int
+main(void)
+{
+  test_index(SERD_NTRIPLES, false);
+  test_index(SERD_NQUADS, false);
+  test_index(SERD_NTRIPLES, true);
+  test_read_write();
+  return 0;
+}
@@ -67,6 +67,50 @@ test_string_to_double(void)
   }
 }
 
+static void
+test_string_to_double_exact(void)
+{
+  // Cases that are hard to round, with the nearest double as hex
+  static const struct {
+    const char* str;
+    double      value;
+  } cases[] = {
+    {"0.1", 0x1.999999999999ap-4},
+    {"9007199254740993", 0x1p53},
+    {"9007199254740993.0000000000000000000000000001", 0x1.0000000000001p53},
+    {"9007199254740995", 0x1.0000000000002p53},
+    {"2.2250738585072011e-308", 0x0.fffffffffffffp-1022},
+    {"2.2250738585072012e-308", 0x1p-1022},
+    {"4.9406564584124654e-324", 0x0.0000000000001p-1022},
+    {"2.4703282292062327e-324", 0.0},
+    {"2.4703282292062328e-324", 0x0.0000000000001p-1022},
+    {"1.7976931348623157e308", 0x1.fffffffffffffp1023},
+    {"123456789012345678901234567890", 0x1.8ee90ff6c373ep+96},
+    {"0.000000000000000000000000000000000001e36", 1.0},
+    {"1e-400", 0.0},
+    {"1e400", INFINITY},
+    {"0e999999999999", 0.0},
+    {"-0.0", -0.0}};
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+    char*        end   = NULL;
+    const double value = serd_strtod(cases[i].str, &end);
+
+    assert(!memcmp(&value, &cases[i].value, sizeof(value)));
+    assert(end == cases[i].str + strlen(cases[i].str));
+  }
+
+  // Invalid numbers or exponents are not read
+  static const char* const partial[][2] = {
+    {"", ""}, {".", "."}, {"-x", "-x"}, {"1e", "e"}, {"5.e+x", "e+x"}};
+
+  for (size_t i = 0; i < sizeof(partial) / sizeof(partial[0]); ++i) {
+    char* end = NULL;
+    serd_strtod(partial[i][0], &end);
+    assert(!strcmp(end, partial[i][1]));
+  }
+}
+
 static void
 test_double_to_node(void)
 {
@@ -78,6 +122,10 @@ test_double_to_node(void)
                                   -16.00001,
                                   5.000000005,
                                   0.0000000001,
+                                  0.1 + 0.2,
+                                  9.999999999,
+                                  -0.000000006,
+                                  1e20,
                                   NAN,
                                   INFINITY};
 
@@ -89,6 +137,10 @@ test_double_to_node(void)
                                  "-16.00001",
                                  "5.00000001",
                                  "0.0",
+                                 "0.3",
+                                 "10.0",
+                                 "-0.00000001",
+                                 "100000000000000000000.0",
                                  NULL,
                                  NULL};
 
@@ -105,14 +157,69 @@ test_double_to_node(void)
 }
 
 static void
-test_integer_to_node(void)
+test_double_to_xsd_double(void)
 {
-  const long int_test_nums[] = {0, -0, -23, 23, -12340, 1000, -1000};
+  static const struct {
+    double      value;
+    const char* str;
+  } cases[] = {{0.0, "0.0E0"},
+               {-0.0, "-0.0E0"},
+               {1.0, "1.0E0"},
+               {-1250.0, "-1.25E3"},
+               {0.1, "1.0E-1"},
+               {0.1 + 0.2, "3.0000000000000004E-1"},
+               {1e23, "1.0E23"},
+               {DBL_MAX, "1.7976931348623157E308"},
+               {DBL_MIN, "2.2250738585072014E-308"},
+               {0x0.0000000000001p-1022, "5.0E-324"},
+               {INFINITY, "INF"},
+               {-INFINITY, "-INF"},
+               {NAN, "NaN"}};
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+    SerdNode node = serd_node_new_double(cases[i].value);
+    assert(!strcmp((const char*)node.buf, cases[i].str));
+    assert(node.n_bytes == strlen(cases[i].str));
+    serd_node_free(&node);
+  }
+
+  // Every double round-trips exactly through the shortest string
+  uint64_t bits = 0x0123456789ABCDEFu;
+  for (unsigned i = 0u; i < 10000u; ++i) {
+    bits ^= bits << 13u;
+    bits ^= bits >> 7u;
+    bits ^= bits << 17u;
+
+    double value = 0.0;
+    memcpy(&value, &bits, sizeof(value));
+    if (isnan(value) || isinf(value)) {
+      continue;
+    }
 
-  const char* int_test_strs[] = {
-    "0", "0", "-23", "23", "-12340", "1000", "-1000"};
+    SerdNode     node   = serd_node_new_double(value);
+    const double parsed = serd_strtod((const char*)node.buf, NULL);
+    assert(!memcmp(&parsed, &value, sizeof(value)));
+    serd_node_free(&node);
+  }
+}
 
-  for (size_t i = 0; i < sizeof(int_test_nums) / sizeof(double); ++i) {
+static void
+test_integer_to_node(void)
+{
+  const int64_t int_test_nums[] = {
+    0, -0, -23, 23, -12340, 1000, -1000, INT64_MAX, INT64_MIN};
+
+  const char* int_test_strs[] = {"0",
+                                 "0",
+                                 "-23",
+                                 "23",
+                                 "-12340",
+                                 "1000",
+                                 "-1000",
+                                 "9223372036854775807",
+                                 "-9223372036854775808"};
+
+  for (size_t i = 0; i < sizeof(int_test_nums) / sizeof(int64_t); ++i) {
     SerdNode node = serd_node_new_integer(int_test_nums[i]);
     assert(!strcmp((const char*)node.buf, (const char*)int_test_strs[i]));
     const size_t len = strlen((const char*)node.buf);
@@ -121,6 +228,69 @@ test_integer_to_node(void)
   }
 }
 
+static void
+test_node_get_number(void)
+{
+#define XSD "http://www.w3.org/2001/XMLSchema#"
+
+  static const struct {
+    const char*    str;
+    const char*    datatype;
+    SerdNumberType type;
+    int64_t        integer;
+    double         real;
+  } cases[] = {
+    {"42", XSD "integer", SERD_NUMBER_INTEGER, 42, 42.0},
+    {"-9223372036854775808",
+     XSD "long",
+     SERD_NUMBER_INTEGER,
+     INT64_MIN,
+     -0x1p63},
+    {"+7", XSD "byte", SERD_NUMBER_INTEGER, 7, 7.0},
+    {"9223372036854775808", XSD "integer", SERD_NUMBER_NONE, 0, 0.0},
+    {"4.2", XSD "integer", SERD_NUMBER_NONE, 0, 0.0},
+    {"", XSD "integer", SERD_NUMBER_NONE, 0, 0.0},
+    {"-1.5", XSD "decimal", SERD_NUMBER_DECIMAL, 0, -1.5},
+    {".5", XSD "decimal", SERD_NUMBER_DECIMAL, 0, 0.5},
+    {"1.5e3", XSD "decimal", SERD_NUMBER_NONE, 0, 0.0},
+    {"1.5e3", XSD "double", SERD_NUMBER_DOUBLE, 0, 1500.0},
+    {"1.5E-3", XSD "float", SERD_NUMBER_DOUBLE, 0, 0.0015},
+    {"-INF", XSD "double", SERD_NUMBER_DOUBLE, 0, -INFINITY},
+    {"INF", XSD "float", SERD_NUMBER_DOUBLE, 0, INFINITY},
+    {" 1.0", XSD "double", SERD_NUMBER_NONE, 0, 0.0},
+    {"1.0 ", XSD "double", SERD_NUMBER_NONE, 0, 0.0},
+    {"inf", XSD "double", SERD_NUMBER_NONE, 0, 0.0},
+    {"42", XSD "string", SERD_NUMBER_NONE, 0, 0.0},
+    {"42", "http://example.org/integer", SERD_NUMBER_NONE, 0, 0.0}};
+
+#undef XSD
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+    const SerdNode node =
+      serd_node_from_string(SERD_LITERAL, USTR(cases[i].str));
+    const SerdNode datatype =
+      serd_node_from_string(SERD_URI, USTR(cases[i].datatype));
+
+    const SerdNumber number = serd_node_get_number(&node, &datatype);
+    assert(number.type == cases[i].type);
+    assert(number.integer == cases[i].integer);
+    assert(number.real == cases[i].real);
+  }
+
+  const SerdNode nan = serd_node_from_string(SERD_LITERAL, USTR("NaN"));
+  const SerdNode xsd_double = serd_node_from_string(
+    SERD_URI, USTR("http://www.w3.org/2001/XMLSchema#double"));
+
+  const SerdNumber number = serd_node_get_number(&nan, &xsd_double);
+  assert(number.type == SERD_NUMBER_DOUBLE);
+  assert(isnan(number.real));
+
+  // Nodes without a datatype or that aren't literals aren't numbers
+  assert(!serd_node_get_number(&nan, NULL).type);
+  assert(!serd_node_get_number(&xsd_double, &xsd_double).type);
+  assert(!serd_node_get_number(NULL, &xsd_double).type);
+}
+
 static void
 test_blob_to_node(void)
 {
@@ -196,16 +366,75 @@ test_node_from_substring(void)
          !strncmp((const char*)a_b.buf, "a\"bc", 4));
 }
 
+static void
+test_arena_nodes(void)
+{
+  SerdArena* const arena = serd_arena_new(NULL, 256u);
+
+  // Build enough nodes to use several blocks, then reset and do it again
+  for (unsigned pass = 0u; pass < 2u; ++pass) {
+    for (int64_t i = 0; i < 100; ++i) {
+      const SerdNode integer = serd_node_new_integer_in(arena, i - 50);
+      const SerdNode decimal =
+        serd_node_new_decimal_in(arena, 0.5 + (double)i, 2u);
+
+      char expected[32];
+      snprintf(expected, sizeof(expected), "%d", (int)(i - 50));
+      assert(!strcmp((const char*)integer.buf, expected));
+      assert(integer.n_bytes == strlen(expected));
+
+      snprintf(expected, sizeof(expected), "%d.5", (int)i);
+      assert(!strcmp((const char*)decimal.buf, expected));
+      assert(decimal.n_bytes == strlen(expected));
+
+      const SerdNode dbl = serd_node_new_double_in(arena, (double)i + 0.5);
+      assert(serd_strtod((const char*)dbl.buf, NULL) == (double)i + 0.5);
+      assert(dbl.n_bytes == strlen((const char*)dbl.buf));
+    }
+
+    serd_arena_reset(arena);
+  }
+
+  SerdURI        base_uri;
+  const SerdNode base = serd_node_new_uri_from_string_in(
+    arena, USTR("http://example.org/a/b/"), NULL, &base_uri);
+  assert(!strcmp((const char*)base.buf, "http://example.org/a/b/"));
+
+  SerdURI        abs_uri;
+  const SerdNode abs = serd_node_new_uri_from_string_in(
+    arena, USTR("../c"), &base_uri, &abs_uri);
+  assert(!strcmp((const char*)abs.buf, "http://example.org/a/c"));
+
+  const SerdNode rel =
+    serd_node_new_relative_uri_in(arena, &abs_uri, &base_uri, NULL, NULL);
+  assert(!strcmp((const char*)rel.buf, "../c"));
+
+  const SerdNode copy = serd_node_copy_in(arena, &rel);
+  assert(copy.buf != rel.buf && serd_node_equals(&copy, &rel));
+
+  // Large allocations are made separately
+  uint8_t* const big = (uint8_t*)serd_arena_alloc(arena, 1000u);
+  memset(big, 'x', 1000u);
+  assert(!strcmp((const char*)rel.buf, "../c"));
+  assert(!((uintptr_t)big % sizeof(double)));
+
+  serd_arena_free(arena);
+}
+
 int
 main(void)
 {
   test_string_to_double();
+  test_string_to_double_exact();
   test_double_to_node();
+  test_double_to_xsd_double();
   test_integer_to_node();
+  test_node_get_number();
   test_blob_to_node();
   test_node_equals();
   test_node_from_string();
   test_node_from_substring();
+  test_arena_nodes();
 
   printf("Success\n");
   return 0;
@@ -25,6 +25,7 @@
 static size_t n_base      = 0;
 static size_t n_prefix    = 0;
 static size_t n_statement = 0;
+static size_t n_graph     = 0;
 static size_t n_end       = 0;
 
 static SerdStatus
@@ -60,7 +61,6 @@ on_statement(void*              handle,
 {
   (void)handle;
   (void)flags;
-  (void)graph;
   (void)subject;
   (void)predicate;
   (void)object;
@@ -68,6 +68,7 @@ on_statement(void*              handle,
   (void)object_lang;
 
   ++n_statement;
+  n_graph += graph != NULL;
   return SERD_SUCCESS;
 }
 
@@ -81,8 +82,8 @@ on_end(void* handle, const SerdNode* node)
   return SERD_SUCCESS;
 }
 
-int
-main(void)
+static void
+test_read_turtle_chunks(void)
 {
   FILE* file = tmpfile();
 
@@ -117,6 +118,43 @@ main(void)
   assert(!serd_reader_end_stream(reader));
   serd_reader_free(reader);
   fclose(file);
+}
 
+static void
+test_read_nquads_chunks(void)
+{
+  FILE* file = tmpfile();
+
+  fprintf(file,
+          "<http://example.org/s> <http://example.org/p> \"o\" .\n"
+          "# Comment\n"
+          "<http://example.org/s> <http://example.org/p> _:b1 "
+          "<http://example.org/g> .\n"
+          "_:b1 <http://example.org/p> <http://example.org/o> _:g .\n");
+
+  fseek(file, 0, SEEK_SET);
+
+  SerdReader* reader = serd_reader_new(
+    SERD_NQUADS, NULL, NULL, on_base, on_prefix, on_statement, on_end);
+
+  assert(reader);
+  assert(!serd_reader_start_stream(reader, file, NULL, true));
+
+  n_statement = 0;
+  assert(!serd_reader_read_chunk(reader) && n_statement == 1 && !n_graph);
+  assert(!serd_reader_read_chunk(reader) && n_statement == 2 && n_graph == 1);
+  assert(!serd_reader_read_chunk(reader) && n_statement == 3 && n_graph == 2);
+  assert(serd_reader_read_chunk(reader) == SERD_FAILURE);
+
+  assert(!serd_reader_end_stream(reader));
+  serd_reader_free(reader);
+  fclose(file);
+}
+
+int
+main(void)
+{
+  test_read_turtle_chunks();
+  test_read_nquads_chunks();
   return 0;
 }
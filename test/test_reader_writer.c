@@ -26,6 +26,7 @@
 #include <string.h>
 
 #define USTR(s) ((const uint8_t*)(s))
+#define NS_RDF "http://www.w3.org/1999/02/22-rdf-syntax-ns#"
 
 typedef struct {
   int             n_statements;
@@ -162,6 +163,1629 @@ test_read_string(void)
   serd_reader_free(reader);
 }
 
+static void
+test_read_mapped(void)
+{
+  ReaderTest* const rt = (ReaderTest*)calloc(1, sizeof(ReaderTest));
+  FILE* const       f  = tmpfile();
+  SerdReader* const reader =
+    serd_reader_new(SERD_TURTLE, rt, free, NULL, NULL, test_sink, NULL);
+
+  assert(reader);
+  assert(f);
+
+  // Empty files can't be mapped, so are read normally
+  assert(serd_reader_read_mapped_file_handle(reader, f, NULL) <= SERD_FAILURE);
+  assert(rt->n_statements == 0);
+
+  // Write two statements, the last ending exactly at the end of the file
+  fprintf(f, "@prefix eg: <http://example.org/> .\n");
+  fprintf(f, "eg:s eg:p eg:o1 .\n");
+  const long second = ftell(f);
+  fprintf(f, "<http://example.org/s> <http://example.org/p> _:o2 .");
+  fflush(f);
+
+  // Read the whole file
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_mapped_file_handle(reader, f, NULL));
+  assert(rt->n_statements == 2);
+
+  // Read from the current position in the file
+  fseek(f, second, SEEK_SET);
+  assert(!serd_reader_read_mapped_file_handle(reader, f, NULL));
+  assert(rt->n_statements == 3);
+
+  serd_reader_free(reader);
+  fclose(f);
+}
+
+static void
+test_read_prefetched(void)
+{
+  ReaderTest* const rt = (ReaderTest*)calloc(1, sizeof(ReaderTest));
+  FILE* const       f  = tmpfile();
+  SerdReader* const reader =
+    serd_reader_new(SERD_NTRIPLES, rt, free, NULL, NULL, test_sink, NULL);
+
+  assert(reader);
+  assert(f);
+  assert(
+    !serd_prefetch_new((SerdSource)fread, (SerdStreamErrorFunc)ferror, f, 0));
+
+  for (unsigned i = 0u; i < 100u; ++i) {
+    fprintf(f, "_:s%u <http://example.org/p> \"%u\" .\n", i, i);
+  }
+  fseek(f, 0, SEEK_SET);
+
+  // Read with blocks that don't line up with the reader's pages
+  SerdPrefetch* prefetch =
+    serd_prefetch_new((SerdSource)fread, (SerdStreamErrorFunc)ferror, f, 7);
+
+  assert(prefetch);
+  assert(!serd_reader_read_source(
+    reader, serd_prefetch_read, serd_prefetch_error, prefetch, NULL, 16));
+  assert(rt->n_statements == 100);
+  assert(!serd_prefetch_error(prefetch));
+  serd_prefetch_free(prefetch);
+
+  // Free a prefetcher before reading everything
+  fseek(f, 0, SEEK_SET);
+  prefetch =
+    serd_prefetch_new((SerdSource)fread, (SerdStreamErrorFunc)ferror, f, 64);
+  assert(prefetch);
+  assert(!serd_reader_start_source_stream(
+    reader, serd_prefetch_read, serd_prefetch_error, prefetch, NULL, 32));
+  assert(!serd_reader_read_chunk(reader));
+  assert(rt->n_statements == 101);
+  serd_reader_end_stream(reader);
+  serd_prefetch_free(prefetch);
+
+  serd_reader_free(reader);
+  fclose(f);
+}
+
+typedef struct {
+  unsigned n_statements;
+  unsigned n_matches;
+} RunTest;
+
+static const char* const run_subject =
+  "http://example.org/a/rather/long/subject/that/spans/several/pages";
+
+static const char* const run_objects[] = {
+  "A short string with \"escapes\", caf\xc3\xa9 \xc3\xa9, and more plain text",
+  "A long string\nwith a 'quote', \"\" two quotes, and a newline"};
+
+static SerdStatus
+run_sink(void*              handle,
+         SerdStatementFlags flags,
+         const SerdNode*    graph,
+         const SerdNode*    subject,
+         const SerdNode*    predicate,
+         const SerdNode*    object,
+         const SerdNode*    object_datatype,
+         const SerdNode*    object_lang)
+{
+  (void)flags;
+  (void)graph;
+  (void)predicate;
+  (void)object_datatype;
+  (void)object_lang;
+
+  RunTest* const rt       = (RunTest*)handle;
+  const char*    expected = run_objects[rt->n_statements++ % 2u];
+
+  if (!strcmp((const char*)subject->buf, run_subject) &&
+      !strcmp((const char*)object->buf, expected) &&
+      object->n_bytes == strlen(expected) &&
+      object->n_chars == serd_strlen((const uint8_t*)expected, NULL, NULL)) {
+    ++rt->n_matches;
+  }
+
+  return SERD_SUCCESS;
+}
+
+static void
+test_read_runs(void)
+{
+  RunTest           rt = {0u, 0u};
+  FILE* const       f  = tmpfile();
+  SerdReader* const reader =
+    serd_reader_new(SERD_TURTLE, &rt, NULL, NULL, NULL, run_sink, NULL);
+
+  assert(reader);
+  assert(f);
+
+  static const char* const doc =
+    "<http://example.org/a/rather/long/subject/that/spans/several/pages>\n"
+    "  <http://example.org/p>\n"
+    "    \"A short string with \\\"escapes\\\", caf\xc3\xa9 \\u00E9, and more "
+    "plain text\" ,\n"
+    "    \"\"\"A long string\nwith a 'quote', \"\" two quotes, and a "
+    "newline\"\"\" .\n";
+
+  fprintf(f, "%s", doc);
+  fseek(f, 0, SEEK_SET);
+
+  // Read with pages small enough that runs are split between them
+  assert(!serd_reader_read_source(
+    reader, (SerdSource)fread, (SerdStreamErrorFunc)ferror, f, NULL, 7));
+  assert(rt.n_statements == 2u);
+  assert(rt.n_matches == 2u);
+
+  // Read from a buffer that ends where the document does
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_mapped_file_handle(reader, f, NULL));
+  assert(rt.n_statements == 4u);
+  assert(rt.n_matches == 4u);
+
+  // Read from a string, where runs are not scanned ahead
+  assert(!serd_reader_read_string(reader, (const uint8_t*)doc));
+  assert(rt.n_statements == 6u);
+  assert(rt.n_matches == 6u);
+
+  serd_reader_free(reader);
+  fclose(f);
+}
+
+typedef struct {
+  unsigned n_statements;
+  unsigned n_prefixes;
+  unsigned sum;
+  bool     ordered;
+} ParallelTest;
+
+static SerdStatus
+parallel_sink(void*              handle,
+              SerdStatementFlags flags,
+              const SerdNode*    graph,
+              const SerdNode*    subject,
+              const SerdNode*    predicate,
+              const SerdNode*    object,
+              const SerdNode*    object_datatype,
+              const SerdNode*    object_lang)
+{
+  (void)flags;
+  (void)graph;
+  (void)subject;
+  (void)predicate;
+  (void)object_datatype;
+  (void)object_lang;
+
+  ParallelTest* const pt = (ParallelTest*)handle;
+  const char* const   str = (const char*)object->buf;
+  const unsigned      i   = (unsigned)strtoul(str, NULL, 10);
+
+  pt->ordered = pt->ordered && i == pt->n_statements;
+  pt->sum += i;
+  ++pt->n_statements;
+  return SERD_SUCCESS;
+}
+
+static SerdStatus
+parallel_prefix_sink(void* handle, const SerdNode* name, const SerdNode* uri)
+{
+  (void)uri;
+
+  // Prefixes after the first two are defined every 5000 statements
+  ParallelTest* const pt = (ParallelTest*)handle;
+  if (++pt->n_prefixes > 2u) {
+    const char* const str = (const char*)name->buf;
+    const unsigned    i   = (unsigned)strtoul(str + 1, NULL, 10);
+
+    pt->ordered = pt->ordered && i == pt->n_statements;
+  }
+
+  return SERD_SUCCESS;
+}
+
+static SerdStatus
+parallel_error_sink(void* handle, const SerdError* e)
+{
+  *(unsigned*)handle = e->line;
+  return SERD_SUCCESS;
+}
+
+static void
+test_read_parallel(void)
+{
+  static const unsigned n_lines = 20000u;
+
+  ParallelTest      pt = {0u, 0u, 0u, true};
+  FILE* const       f  = tmpfile();
+  SerdReader* const reader =
+    serd_reader_new(SERD_NQUADS, &pt, NULL, NULL, NULL, parallel_sink, NULL);
+
+  assert(reader);
+  assert(f);
+
+  for (unsigned i = 0u; i < n_lines; ++i) {
+    fprintf(f, "_:s%u <http://example.org/p> \"%u\" _:g .\n", i, i);
+  }
+
+  // Read in order
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_parallel(reader, f, NULL, 4u, true));
+  assert(pt.n_statements == n_lines);
+  assert(pt.sum == n_lines * (n_lines - 1u) / 2u);
+  assert(pt.ordered);
+
+  // Read in any order
+  memset(&pt, 0, sizeof(pt));
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_parallel(reader, f, NULL, 4u, false));
+  assert(pt.n_statements == n_lines);
+  assert(pt.sum == n_lines * (n_lines - 1u) / 2u);
+
+  // Read with an error near the end, which is reported on the correct line
+  unsigned error_line = 0u;
+  fseek(f, 0, SEEK_END);
+  fprintf(f, "_:s <http://example.org/p> \"unterminated .\n");
+  fprintf(f, "_:s <http://example.org/p> \"%u\" .\n", n_lines);
+  serd_reader_set_error_sink(reader, parallel_error_sink, &error_line);
+  memset(&pt, 0, sizeof(pt));
+  pt.ordered = true;
+  fseek(f, 0, SEEK_SET);
+  assert(serd_reader_read_parallel(reader, f, NULL, 4u, true) ==
+         SERD_ERR_BAD_SYNTAX);
+  assert(pt.n_statements == n_lines);
+  assert(pt.ordered);
+  assert(error_line == n_lines + 1u);
+
+  serd_reader_free(reader);
+  fclose(f);
+}
+
+static void
+test_read_parallel_turtle(void)
+{
+  static const unsigned n_statements = 20000u;
+
+  ParallelTest      pt = {0u, 0u, 0u, true};
+  FILE* const       f  = tmpfile();
+  SerdReader* const reader = serd_reader_new(
+    SERD_TURTLE, &pt, NULL, NULL, parallel_prefix_sink, parallel_sink, NULL);
+
+  assert(reader);
+  assert(f);
+
+  unsigned n_lines = 3u;
+  fprintf(f, "@prefix eg: <http://example.org/> .\n");
+  fprintf(f, "# A comment before the second prefix\n");
+  fprintf(f, "PREFIX x: <http://example.org/x/>\n");
+  for (unsigned i = 0u; i < n_statements; ++i) {
+    if (i && !(i % 5000u)) {
+      // A directive after the prelude, which must be read in order
+      fprintf(f, "@prefix p%u: <http://example.org/%u/> .\n", i, i);
+      ++n_lines;
+    }
+
+    if (i % 7u) {
+      fprintf(f, "eg:s%u eg:p \"%u\" .\n", i, i);
+      ++n_lines;
+    } else {
+      // A long string with lines that look like the end of a statement
+      fprintf(f, "eg:s%u x:p \"\"\"%u\nis long .\n\"\"\" .\n", i, i);
+      n_lines += 3u;
+    }
+  }
+
+  // Read in order, which is the only order for Turtle
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_parallel(reader, f, NULL, 4u, false));
+  assert(pt.n_statements == n_statements);
+  assert(pt.n_prefixes == 5u);
+  assert(pt.sum == n_statements * (n_statements - 1u) / 2u);
+  assert(pt.ordered);
+
+  // Read with an error at the end, which is reported on the correct line
+  unsigned error_line = 0u;
+  fseek(f, 0, SEEK_END);
+  fprintf(f, "eg:s eg:p .\n");
+  serd_reader_set_error_sink(reader, parallel_error_sink, &error_line);
+  memset(&pt, 0, sizeof(pt));
+  pt.ordered = true;
+  fseek(f, 0, SEEK_SET);
+  assert(serd_reader_read_parallel(reader, f, NULL, 4u, true) ==
+         SERD_ERR_BAD_SYNTAX);
+  assert(pt.n_statements == n_statements);
+  assert(pt.ordered);
+  assert(error_line == n_lines + 1u);
+
+  serd_reader_free(reader);
+  fclose(f);
+}
+
+#define N_INPUTS 4u
+
+typedef struct {
+  unsigned n_statements;
+  unsigned n_graphs;
+  unsigned n_prefixed;
+  unsigned max_statements;
+  unsigned next[N_INPUTS];
+  bool     ordered;
+  bool     absolute;
+} InputsTest;
+
+static SerdStatus
+inputs_sink(void*              handle,
+            SerdStatementFlags flags,
+            const SerdNode*    graph,
+            const SerdNode*    subject,
+            const SerdNode*    predicate,
+            const SerdNode*    object,
+            const SerdNode*    object_datatype,
+            const SerdNode*    object_lang)
+{
+  (void)flags;
+  (void)object_datatype;
+  (void)object_lang;
+
+  static const char* const eg = "http://example.org/";
+
+  InputsTest* const it    = (InputsTest*)handle;
+  unsigned          input = N_INPUTS;
+  unsigned          i     = 0u;
+
+  // Objects are like "2 15" for the statement 15 of input 2
+  assert(sscanf((const char*)object->buf, "%u %u", &input, &i) == 2);
+  it->ordered = it->ordered && input < N_INPUTS && i == it->next[input]++;
+  it->absolute =
+    it->absolute && predicate->type == SERD_URI &&
+    !strncmp((const char*)predicate->buf, eg, strlen(eg)) &&
+    (subject->type == SERD_BLANK ||
+     !strncmp((const char*)subject->buf, eg, strlen(eg)));
+
+  it->n_graphs += graph && !strcmp((const char*)graph->buf, "urn:graph");
+  it->n_prefixed += subject->type == SERD_BLANK &&
+                    !strncmp((const char*)subject->buf, "in3_", 4);
+
+  return (++it->n_statements == it->max_statements) ? SERD_ERR_BAD_ARG
+                                                    : SERD_SUCCESS;
+}
+
+static void
+test_read_inputs(void)
+{
+  static const unsigned n_statements = 3000u;
+
+  InputsTest        it;
+  SerdReader* const reader =
+    serd_reader_new(SERD_TURTLE, &it, NULL, NULL, NULL, inputs_sink, NULL);
+
+  const SerdNode base =
+    serd_node_from_string(SERD_URI, USTR("http://example.org/one/"));
+  const SerdNode graph = serd_node_from_string(SERD_URI, USTR("urn:graph"));
+
+  SerdInput inputs[N_INPUTS + 1u] = {
+    {USTR("in0"), tmpfile(), (SerdSyntax)0, NULL, NULL, NULL},
+    {USTR("in1"), tmpfile(), (SerdSyntax)0, &base, NULL, NULL},
+    {USTR("in2"), tmpfile(), SERD_NTRIPLES, NULL, &graph, NULL},
+    {USTR("in3"), tmpfile(), SERD_NTRIPLES, NULL, NULL, USTR("in3_")},
+    {USTR("/no/such/file"), NULL, (SerdSyntax)0, NULL, NULL, NULL}};
+
+  // Turtle with its own base and prefix, and with a base from the input
+  fprintf(inputs[0].file, "@base <http://example.org/zero/> .\n");
+  fprintf(inputs[0].file, "@prefix eg: <http://example.org/> .\n");
+  for (unsigned i = 0u; i < n_statements; ++i) {
+    fprintf(inputs[0].file, "<s%u> eg:p \"0 %u\" .\n", i, i);
+    fprintf(inputs[1].file, "<s%u> <http://example.org/p> \"1 %u\" .\n", i, i);
+  }
+
+  // NTriples, with a default graph, and with a blank node prefix
+  for (unsigned i = 0u; i < n_statements; ++i) {
+    fprintf(inputs[2].file, "<http://example.org/s> ");
+    fprintf(inputs[2].file, "<http://example.org/p> \"2 %u\" .\n", i);
+    fprintf(inputs[3].file, "_:s%u <http://example.org/p> \"3 %u\" .\n", i, i);
+  }
+
+  for (unsigned n_threads = 1u; n_threads <= 3u; n_threads += 2u) {
+    memset(&it, 0, sizeof(it));
+    it.ordered  = true;
+    it.absolute = true;
+
+    for (unsigned i = 0u; i < N_INPUTS; ++i) {
+      fseek(inputs[i].file, 0, SEEK_SET);
+    }
+
+    // Read every input, with statements from each in order
+    assert(!serd_reader_read_inputs(reader, inputs, N_INPUTS, n_threads));
+    assert(it.n_statements == N_INPUTS * n_statements);
+    assert(it.n_graphs == n_statements);
+    assert(it.n_prefixed == n_statements);
+    assert(it.ordered);
+    assert(it.absolute);
+
+    // An input that can't be read is an error, but others are still read
+    memset(&it, 0, sizeof(it));
+    for (unsigned i = 0u; i < N_INPUTS; ++i) {
+      fseek(inputs[i].file, 0, SEEK_SET);
+    }
+
+    assert(serd_reader_read_inputs(reader, inputs, N_INPUTS + 1u, n_threads) ==
+           SERD_ERR_UNKNOWN);
+    assert(it.n_statements == N_INPUTS * n_statements);
+
+    // A sink error stops reading
+    memset(&it, 0, sizeof(it));
+    it.max_statements = 100u;
+    for (unsigned i = 0u; i < N_INPUTS; ++i) {
+      fseek(inputs[i].file, 0, SEEK_SET);
+    }
+
+    assert(serd_reader_read_inputs(reader, inputs, N_INPUTS, n_threads) ==
+           SERD_ERR_BAD_ARG);
+    assert(it.n_statements == 100u);
+  }
+
+  for (unsigned i = 0u; i < N_INPUTS; ++i) {
+    fclose(inputs[i].file);
+  }
+
+  serd_reader_free(reader);
+}
+
+typedef struct {
+  SerdWriter* writer;
+  size_t      max_batch;
+  size_t      n_batches;
+} BatchTest;
+
+static SerdStatus
+batch_prefix_sink(void* handle, const SerdNode* name, const SerdNode* uri)
+{
+  return serd_writer_set_prefix(((BatchTest*)handle)->writer, name, uri);
+}
+
+static SerdStatus
+batch_end_sink(void* handle, const SerdNode* node)
+{
+  return serd_writer_end_anon(((BatchTest*)handle)->writer, node);
+}
+
+static SerdStatus
+batch_sink(void* handle, const SerdStatement* statements, size_t n_statements)
+{
+  BatchTest* const bt = (BatchTest*)handle;
+
+  assert(n_statements > 0u);
+  assert(n_statements <= bt->max_batch);
+  ++bt->n_batches;
+  return serd_writer_write_statements(bt->writer, statements, n_statements);
+}
+
+static SerdStatus
+failing_batch_sink(void*                handle,
+                   const SerdStatement* statements,
+                   size_t               n_statements)
+{
+  (void)statements;
+  (void)n_statements;
+
+  ++((BatchTest*)handle)->n_batches;
+  return SERD_ERR_UNKNOWN;
+}
+
+static SerdStatus
+parallel_batch_sink(void*                handle,
+                    const SerdStatement* statements,
+                    size_t               n_statements)
+{
+  for (size_t i = 0u; i < n_statements; ++i) {
+    const SerdStatement* const s = &statements[i];
+
+    parallel_sink(handle,
+                  s->flags,
+                  s->graph,
+                  s->subject,
+                  s->predicate,
+                  s->object,
+                  s->object_datatype,
+                  s->object_lang);
+  }
+
+  return SERD_SUCCESS;
+}
+
+/**
+   Read `doc`, or `file` if it is not null, and write it as Turtle.
+
+   Statements are passed in batches if `max_batch` is not zero, and `file` is
+   read in parallel if `n_threads` is not zero.
+*/
+static char*
+rewrite_batched(const char* const doc,
+                FILE* const       file,
+                const unsigned    n_threads,
+                const size_t      max_batch,
+                BatchTest*        bt)
+{
+  SerdChunk         chunk  = {NULL, 0};
+  SerdEnv* const    env    = serd_env_new(NULL);
+  SerdWriter* const writer = serd_writer_new(
+    SERD_TURTLE, (SerdStyle)0, env, NULL, serd_chunk_sink, &chunk);
+
+  bt->writer    = writer;
+  bt->max_batch = max_batch;
+  bt->n_batches = 0u;
+
+  SerdReader* const reader =
+    max_batch ? serd_reader_new(SERD_TURTLE,
+                                bt,
+                                NULL,
+                                NULL,
+                                batch_prefix_sink,
+                                NULL,
+                                batch_end_sink)
+              : serd_reader_new(SERD_TURTLE,
+                                writer,
+                                NULL,
+                                NULL,
+                                (SerdPrefixSink)serd_writer_set_prefix,
+                                (SerdStatementSink)serd_writer_write_statement,
+                                (SerdEndSink)serd_writer_end_anon);
+
+  serd_reader_set_batch_sink(reader, max_batch, batch_sink);
+  if (!file) {
+    assert(!serd_reader_read_string(reader, USTR(doc)));
+  } else if (!n_threads) {
+    fseek(file, 0, SEEK_SET);
+    assert(!serd_reader_read_file_handle(reader, file, USTR("test")));
+  } else {
+    fseek(file, 0, SEEK_SET);
+    assert(!serd_reader_read_parallel(reader, file, NULL, n_threads, true));
+  }
+
+  serd_reader_free(reader);
+
+  serd_writer_finish(writer);
+  serd_writer_free(writer);
+  serd_env_free(env);
+
+  return (char*)serd_chunk_sink_finish(&chunk);
+}
+
+static void
+test_read_batches(void)
+{
+  static const char* const doc =
+    "@prefix eg: <http://example.org/> .\n"
+    "eg:s eg:p eg:o1 , eg:o2 ; eg:q [ eg:r \"a\" ; eg:t \"b\" ] .\n"
+    "@prefix ex: <http://example.org/x/> .\n"
+    "ex:s eg:p ( 1 2 3 ) .\n"
+    "[ eg:p \"c\" ] eg:q eg:o3 .\n"
+    "ex:t eg:p eg:o4 .\n";
+
+  // Batches of any size produce the same output as individual statements
+  static const size_t max_batches[] = {1u, 2u, 3u, 64u};
+
+  BatchTest   bt       = {NULL, 0u, 0u};
+  char* const expected = rewrite_batched(doc, NULL, 0u, 0u, &bt);
+  for (size_t i = 0u; i < sizeof(max_batches) / sizeof(size_t); ++i) {
+    char* const out = rewrite_batched(doc, NULL, 0u, max_batches[i], &bt);
+    assert(!strcmp(out, expected));
+    assert(bt.n_batches > 0u);
+    serd_free(out);
+  }
+
+  serd_free(expected);
+
+  // Errors from the batch sink stop reading
+  SerdReader* const reader =
+    serd_reader_new(SERD_TURTLE, &bt, NULL, NULL, NULL, NULL, NULL);
+
+  bt.n_batches = 0u;
+  serd_reader_set_batch_sink(reader, 2u, failing_batch_sink);
+  assert(serd_reader_read_string(reader, USTR(doc)) == SERD_ERR_UNKNOWN);
+  assert(bt.n_batches == 1u);
+
+  // Clearing the batch sink restores the (null) statement sink
+  serd_reader_set_batch_sink(reader, 0u, failing_batch_sink);
+  assert(!serd_reader_read_string(reader, USTR(doc)));
+  serd_reader_free(reader);
+
+  // Batches are supported when reading in parallel
+  static const unsigned n_lines = 20000u;
+
+  ParallelTest      pt = {0u, 0u, 0u, true};
+  FILE* const       f  = tmpfile();
+  SerdReader* const par_reader =
+    serd_reader_new(SERD_NTRIPLES, &pt, NULL, NULL, NULL, NULL, NULL);
+
+  assert(f);
+  for (unsigned i = 0u; i < n_lines; ++i) {
+    fprintf(f, "_:s%u <http://example.org/p> \"%u\" .\n", i, i);
+  }
+
+  serd_reader_set_batch_sink(par_reader, 100u, parallel_batch_sink);
+
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_parallel(par_reader, f, NULL, 4u, true));
+  assert(pt.n_statements == n_lines);
+  assert(pt.sum == n_lines * (n_lines - 1u) / 2u);
+  assert(pt.ordered);
+
+  memset(&pt, 0, sizeof(pt));
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_parallel(par_reader, f, NULL, 4u, false));
+  assert(pt.n_statements == n_lines);
+  assert(pt.sum == n_lines * (n_lines - 1u) / 2u);
+
+  serd_reader_free(par_reader);
+  fclose(f);
+
+  // Anonymous nodes are ended in order when reading in parallel
+  FILE* const anon_f = tmpfile();
+
+  assert(anon_f);
+  fprintf(anon_f, "@prefix eg: <http://example.org/> .\n");
+  for (unsigned i = 0u; i < n_lines / 10u; ++i) {
+    fprintf(anon_f, "eg:s%u eg:p [ eg:q [ eg:r \"%u\" ] ] .\n", i, i);
+  }
+
+  char* const anon_expected = rewrite_batched(NULL, anon_f, 0u, 0u, &bt);
+  for (size_t i = 0u; i < 2u; ++i) {
+    char* const out = rewrite_batched(NULL, anon_f, 4u, i ? 100u : 0u, &bt);
+
+    assert(!strcmp(out, anon_expected));
+    serd_free(out);
+  }
+
+  serd_free(anon_expected);
+  fclose(anon_f);
+}
+
+static SerdStatus
+quiet_error_sink(void* handle, const SerdError* e)
+{
+  (void)handle;
+  (void)e;
+  return SERD_SUCCESS;
+}
+
+#define MAX_BLANKS 4096u
+
+typedef struct {
+  char   subjects[MAX_BLANKS][16];
+  size_t n_subjects;
+} BlankTest;
+
+static SerdStatus
+blank_sink(void*              handle,
+           SerdStatementFlags flags,
+           const SerdNode*    graph,
+           const SerdNode*    subject,
+           const SerdNode*    predicate,
+           const SerdNode*    object,
+           const SerdNode*    object_datatype,
+           const SerdNode*    object_lang)
+{
+  (void)flags;
+  (void)graph;
+  (void)predicate;
+  (void)object;
+  (void)object_datatype;
+  (void)object_lang;
+
+  BlankTest* const bt = (BlankTest*)handle;
+  assert(subject->type == SERD_BLANK);
+  assert(subject->n_bytes < sizeof(bt->subjects[0]));
+  assert(bt->n_subjects < MAX_BLANKS);
+  memcpy(bt->subjects[bt->n_subjects++], subject->buf, subject->n_bytes + 1u);
+  return SERD_SUCCESS;
+}
+
+static int
+compare_blanks(const void* a, const void* b)
+{
+  return strcmp((const char*)a, (const char*)b);
+}
+
+// Return true iff every statement had a different subject
+static bool
+blanks_are_distinct(BlankTest* const bt)
+{
+  qsort(bt->subjects, bt->n_subjects, sizeof(bt->subjects[0]), compare_blanks);
+  for (size_t i = 1u; i < bt->n_subjects; ++i) {
+    if (!strcmp(bt->subjects[i - 1u], bt->subjects[i])) {
+      return false;
+    }
+  }
+
+  bt->n_subjects = 0u;
+  return true;
+}
+
+static SerdReader*
+new_blank_reader(BlankTest* const bt)
+{
+  SerdReader* const reader =
+    serd_reader_new(SERD_TURTLE, bt, NULL, NULL, NULL, blank_sink, NULL);
+
+  serd_reader_set_error_sink(reader, quiet_error_sink, NULL);
+  return reader;
+}
+
+static void
+test_read_blank_clash(void)
+{
+  static const unsigned n_blanks = 1000u;
+  static const char     p[]      = "<http://example.org/p>";
+
+  BlankTest* const bt     = (BlankTest*)calloc(1, sizeof(BlankTest));
+  SerdReader*      reader = new_blank_reader(bt);
+  FILE* const      f      = tmpfile();
+
+  // Labels like the IDs that chunks might generate, and anonymous nodes
+  for (unsigned i = 0u; i < n_blanks; ++i) {
+    fprintf(f, "_:c%ub%u %s 1 .\n", i % 8u, i / 8u + 1u, p);
+    fprintf(f, "_:b%uc%u %s 1 .\n", i % 8u, i / 8u + 1u, p);
+    fprintf(f, "[] %s 1 .\n", p);
+  }
+
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_parallel(reader, f, NULL, 4u, true));
+  assert(bt->n_subjects == 3u * n_blanks);
+  assert(blanks_are_distinct(bt));
+  serd_reader_free(reader);
+
+  // Labels like generated and renamed IDs in different chunks clash
+  reader = new_blank_reader(bt);
+  fseek(f, 0, SEEK_END);
+  fprintf(f, "_:B1 %s 1 .\n", p);
+  fseek(f, 0, SEEK_SET);
+  assert(serd_reader_read_parallel(reader, f, NULL, 4u, true) ==
+         SERD_ERR_ID_CLASH);
+  serd_reader_free(reader);
+  bt->n_subjects = 0u;
+
+  // Labels in one input don't clash with IDs generated in another
+  SerdInput inputs[2] = {
+    {USTR("ids"), tmpfile(), SERD_TURTLE, NULL, NULL, NULL},
+    {USTR("labels"), tmpfile(), SERD_NTRIPLES, NULL, NULL, NULL}};
+
+  for (unsigned i = 0u; i < n_blanks; ++i) {
+    fprintf(inputs[0].file, "[] %s 1 .\n", p);
+    fprintf(inputs[1].file, "_:i0b%u %s \"1\" .\n", i + 1u, p);
+    fprintf(inputs[1].file, "_:b0i%u %s \"1\" .\n", i + 1u, p);
+  }
+
+  for (unsigned n_threads = 1u; n_threads <= 2u; ++n_threads) {
+    reader = new_blank_reader(bt);
+    fseek(inputs[0].file, 0, SEEK_SET);
+    fseek(inputs[1].file, 0, SEEK_SET);
+    assert(!serd_reader_read_inputs(reader, inputs, 2u, n_threads));
+    assert(bt->n_subjects == 3u * n_blanks);
+    assert(blanks_are_distinct(bt));
+    serd_reader_free(reader);
+  }
+
+  // Labels like generated and renamed IDs in different inputs clash
+  reader = new_blank_reader(bt);
+  fseek(inputs[0].file, 0, SEEK_END);
+  fprintf(inputs[0].file, "_:B1 %s 1 .\n", p);
+  fseek(inputs[0].file, 0, SEEK_SET);
+  fseek(inputs[1].file, 0, SEEK_SET);
+  assert(serd_reader_read_inputs(reader, inputs, 2u, 1u) ==
+         SERD_ERR_ID_CLASH);
+  serd_reader_free(reader);
+
+  // They clash regardless of the order they are read in
+  reader = new_blank_reader(bt);
+  assert(serd_reader_read_string(reader,
+                                 USTR("_:B1 <http://example.org/p> 1 .\n"
+                                      "_:b1 <http://example.org/p> 1 .\n")) ==
+         SERD_ERR_ID_CLASH);
+
+  serd_reader_free(reader);
+  fclose(inputs[1].file);
+  fclose(inputs[0].file);
+  fclose(f);
+  free(bt);
+}
+
+static void
+test_read_stats(void)
+{
+  static const char* const doc = "@prefix eg: <http://example.org/> .\n"
+                                 "eg:s eg:p eg:o1 .\n"
+                                 "eg:s eg:p .\n"
+                                 "eg:s eg:p ( eg:o2 eg:o3 ) .\n";
+
+  ReaderTest* const rt = (ReaderTest*)calloc(1, sizeof(ReaderTest));
+  FILE* const       f  = tmpfile();
+  SerdReader* const reader =
+    serd_reader_new(SERD_TURTLE, rt, free, NULL, NULL, test_sink, NULL);
+
+  assert(f);
+  fprintf(f, "%s", doc);
+  fseek(f, 0, SEEK_SET);
+
+  SerdReaderStats stats = serd_reader_get_stats(reader);
+  assert(!stats.n_bytes && !stats.n_statements && !stats.n_pages);
+
+  // Read a document with an invalid statement which is skipped
+  serd_reader_set_strict(reader, false);
+  serd_reader_set_error_sink(reader, quiet_error_sink, NULL);
+  assert(!serd_reader_read_file_handle(reader, f, USTR("test")));
+  assert(rt->n_statements == 6);
+
+  stats = serd_reader_get_stats(reader);
+  assert(stats.n_bytes == strlen(doc));
+  assert(stats.n_statements == 6u);
+  assert(stats.n_nodes > stats.n_statements);
+  assert(stats.n_pages >= 1u);
+  assert(stats.n_errors == 1u);
+  assert(stats.n_recoveries == 1u);
+  assert(stats.peak_stack_size > 0u);
+
+  // Statistics accumulate over reads, and include the one in progress
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_start_stream(reader, f, USTR("test"), true));
+  assert(!serd_reader_read_chunk(reader));
+  assert(!serd_reader_read_chunk(reader));
+
+  const SerdReaderStats partial = serd_reader_get_stats(reader);
+  assert(partial.n_bytes > stats.n_bytes);
+  assert(partial.n_bytes < 2u * stats.n_bytes);
+  assert(partial.n_statements == stats.n_statements + 1u);
+
+  serd_reader_end_stream(reader);
+  serd_reader_free(reader);
+
+  // Parallel reading counts everything read by every thread
+  SerdReader* const par_reader =
+    serd_reader_new(SERD_NTRIPLES, NULL, NULL, NULL, NULL, NULL, NULL);
+
+  uint64_t size = 0u;
+  fseek(f, 0, SEEK_SET);
+  for (unsigned i = 0u; i < 10000u; ++i) {
+    const int n = fprintf(f, "_:s%u <http://example.org/p> \"%u\" .\n", i, i);
+    size += (uint64_t)n;
+  }
+
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_parallel(par_reader, f, NULL, 4u, true));
+  stats = serd_reader_get_stats(par_reader);
+  assert(stats.n_bytes == size);
+  assert(stats.n_statements == 10000u);
+  assert(!stats.n_errors);
+
+  serd_reader_free(par_reader);
+  fclose(f);
+}
+
+#define MAX_POSITIONS 8u
+
+typedef struct {
+  unsigned n_errors;
+  unsigned lines[MAX_POSITIONS];
+  unsigned cols[MAX_POSITIONS];
+} Positions;
+
+static SerdStatus
+position_error_sink(void* handle, const SerdError* e)
+{
+  Positions* const pos = (Positions*)handle;
+  if (pos->n_errors < MAX_POSITIONS) {
+    pos->lines[pos->n_errors] = e->line;
+    pos->cols[pos->n_errors]  = e->col;
+  }
+
+  ++pos->n_errors;
+  return SERD_SUCCESS;
+}
+
+static bool
+positions_equal(const Positions* a, const Positions* b)
+{
+  return a->n_errors == b->n_errors &&
+         !memcmp(a->lines, b->lines, sizeof(a->lines)) &&
+         !memcmp(a->cols, b->cols, sizeof(a->cols));
+}
+
+static SerdStatus
+first_subject_sink(void*              handle,
+                   SerdStatementFlags flags,
+                   const SerdNode*    graph,
+                   const SerdNode*    subject,
+                   const SerdNode*    predicate,
+                   const SerdNode*    object,
+                   const SerdNode*    object_datatype,
+                   const SerdNode*    object_lang)
+{
+  (void)flags;
+  (void)graph;
+  (void)predicate;
+  (void)object;
+  (void)object_datatype;
+  (void)object_lang;
+
+  char* const first = (char*)handle;
+  if (!first[0]) {
+    snprintf(first, 16, "%s", (const char*)subject->buf);
+  }
+
+  return SERD_SUCCESS;
+}
+
+static void
+test_read_lax_lines(const SerdSyntax syntax)
+{
+  static const char* const doc =
+    "<http://example.org/s> <http://example.org/p> \"o1\" .\n"
+    "<http://example.org/s> <http://example.org/p> eg:o2 .\n"
+    "<http://example.org/s> <http://example.org/p> \"o3\"@en .\n"
+    "<http://example.org/s> <http://example.org/p> <o4> .\n"
+    "_:s <http://example.org/p> _:o5 .\n";
+
+  ReaderTest        rt = {0, NULL};
+  SerdReader* const reader =
+    serd_reader_new(syntax, &rt, NULL, NULL, NULL, test_sink, NULL);
+
+  serd_reader_set_error_sink(reader, quiet_error_sink, NULL);
+
+  // Strictly, reading stops at the first invalid line
+  assert(serd_reader_read_string(reader, USTR(doc)) == SERD_ERR_BAD_SYNTAX);
+  assert(rt.n_statements == 1);
+
+  // Laxly, invalid lines are skipped
+  rt.n_statements = 0;
+  serd_reader_set_strict(reader, false);
+  assert(!serd_reader_read_string(reader, USTR(doc)));
+  assert(rt.n_statements == 3);
+
+  const SerdReaderStats stats = serd_reader_get_stats(reader);
+  assert(stats.n_recoveries == 2u);
+
+  serd_reader_free(reader);
+}
+
+#define MAX_PIECE 64u
+
+typedef struct {
+  SerdWriter*      writer;
+  const SerdChunk* out;       ///< Output written so far
+  const char*      graph;     ///< Expected graph of statements
+  size_t           last_len;  ///< Length of the last piece of a literal
+  size_t           n_pieces;  ///< Number of pieces of the current literal
+  unsigned         n_chunked; ///< Number of literals read in pieces
+} PieceTest;
+
+static SerdStatus
+test_piece_sink(void*              handle,
+                SerdStatementFlags flags,
+                const SerdNode*    graph,
+                const SerdNode*    subject,
+                const SerdNode*    predicate,
+                const SerdNode*    piece)
+{
+  PieceTest* const test = (PieceTest*)handle;
+
+  // Pieces come with the start of their statement, and all but the last are
+  // at least as long as the maximum
+  assert(!strcmp((const char*)subject->buf, "http://eg/s"));
+  assert(!strncmp((const char*)predicate->buf, "http://eg/", 10u));
+  assert(test->graph ? !strcmp((const char*)graph->buf, test->graph) : !graph);
+  assert(piece->type == SERD_LITERAL);
+  assert(piece->n_bytes);
+  assert(!test->n_pieces || test->last_len >= MAX_PIECE);
+
+  // Each piece is written as it is read, not when the statement is finished
+  const size_t     len = test->out->len;
+  const SerdStatus st  = serd_writer_write_literal_piece(
+    test->writer, flags, graph, subject, predicate, piece);
+
+  assert(test->out->len > len);
+  test->last_len = piece->n_bytes;
+  ++test->n_pieces;
+  return st;
+}
+
+static SerdStatus
+test_piece_statement_sink(void*              handle,
+                          SerdStatementFlags flags,
+                          const SerdNode*    graph,
+                          const SerdNode*    subject,
+                          const SerdNode*    predicate,
+                          const SerdNode*    object,
+                          const SerdNode*    object_datatype,
+                          const SerdNode*    object_lang)
+{
+  PieceTest* const test = (PieceTest*)handle;
+  if (object->flags & SERD_IS_CHUNKED) {
+    // The object is an empty placeholder for the pieces that came before
+    assert(!object->n_bytes);
+    assert(test->n_pieces > 1u);
+    ++test->n_chunked;
+  } else {
+    assert(!test->n_pieces);
+  }
+
+  test->n_pieces = 0u;
+  return serd_writer_write_statement(test->writer,
+                                     flags,
+                                     graph,
+                                     subject,
+                                     predicate,
+                                     object,
+                                     object_datatype,
+                                     object_lang);
+}
+
+/// Read `doc` and return it as NQuads, with long literals in pieces if asked
+static char*
+rewrite_in_pieces(const SerdSyntax  syntax,
+                  const char* const doc,
+                  const bool        in_pieces,
+                  size_t* const     peak_stack_size)
+{
+  SerdChunk      chunk = {NULL, 0};
+  SerdEnv* const env   = serd_env_new(NULL);
+  PieceTest      test  = {NULL, &chunk, NULL, 0u, 0u, 0u};
+
+  test.writer = serd_writer_new(
+    SERD_NQUADS, (SerdStyle)0, env, NULL, serd_chunk_sink, &chunk);
+
+  if (syntax == SERD_TRIG) {
+    test.graph = "http://eg/g";
+  }
+
+  SerdReader* const reader = serd_reader_new(
+    syntax, &test, NULL, NULL, NULL, test_piece_statement_sink, NULL);
+
+  if (in_pieces) {
+    serd_reader_set_literal_sink(reader, MAX_PIECE, test_piece_sink);
+  }
+
+  assert(!serd_reader_read_string(reader, USTR(doc)));
+  assert(test.n_chunked == (in_pieces && syntax != SERD_NQUADS ? 2u : 0u));
+
+  *peak_stack_size = serd_reader_get_stats(reader).peak_stack_size;
+
+  assert(!serd_writer_finish(test.writer));
+  serd_reader_free(reader);
+  serd_writer_free(test.writer);
+  serd_env_free(env);
+  return (char*)serd_chunk_sink_finish(&chunk);
+}
+
+static void
+test_read_literal_pieces(const SerdSyntax syntax)
+{
+  static const char* const escaped = "A \\\"quoted\\\" caf\xc3\xa9,\\n";
+  static const char* const raw     = "A \"quoted\" caf\xc3\xa9,\n";
+
+  const bool        turtle = syntax == SERD_TURTLE || syntax == SERD_TRIG;
+  const char* const text   = turtle ? raw : escaped;
+  const char* const quotes = turtle ? "\"\"\"" : "\"";
+  const char* const graph  = syntax == SERD_NQUADS ? " <http://eg/g>" : "";
+  const size_t      len    = strlen(text);
+  char* const       doc    = (char*)calloc(1u, 128u * len + 256u);
+
+  // Write two long literals, with a short one between them
+  if (syntax == SERD_TRIG) {
+    strcat(doc, "<http://eg/g> {\n");
+  }
+
+  strcat(doc, "<http://eg/s> <http://eg/p> ");
+  for (unsigned l = 0u; l < 2u; ++l) {
+    strcat(doc, quotes);
+    for (unsigned i = 0u; i < 64u; ++i) {
+      strcat(doc, text);
+    }
+    strcat(doc, quotes);
+    strcat(doc, l ? "^^<http://eg/T>" : "@en");
+    strcat(doc, graph);
+    strcat(doc, " .\n");
+
+    if (!l) {
+      strcat(doc, "<http://eg/s> <http://eg/p> \"short\"");
+      strcat(doc, graph);
+      strcat(doc, " .\n<http://eg/s> <http://eg/q> ");
+    }
+  }
+
+  if (syntax == SERD_TRIG) {
+    strcat(doc, "}\n");
+  }
+
+  size_t      whole_peak  = 0u;
+  size_t      pieces_peak = 0u;
+  char* const whole       = rewrite_in_pieces(syntax, doc, false, &whole_peak);
+  char* const pieces      = rewrite_in_pieces(syntax, doc, true, &pieces_peak);
+
+  // The output is the same, without reading long literals into memory
+  assert(!strcmp(pieces, whole));
+  if (syntax != SERD_NQUADS) {
+    assert(pieces_peak + 64u * strlen(raw) - MAX_PIECE <= whole_peak);
+  }
+
+  serd_free(pieces);
+  serd_free(whole);
+  free(doc);
+}
+
+static void
+test_read_reset(void)
+{
+  static const char* const doc =
+    "[] <http://example.org/p> ( <http://example.org/o> ) .\n";
+
+  char              first[16] = {0};
+  SerdReader* const reader    = serd_reader_new(
+    SERD_TURTLE, first, NULL, NULL, NULL, first_subject_sink, NULL);
+
+  assert(!serd_reader_read_string(reader, USTR(doc)));
+  assert(!strcmp(first, "b1"));
+  const SerdReaderStats stats = serd_reader_get_stats(reader);
+  assert(stats.n_statements == 3u);
+
+  // Stop in the middle of a document, then reset and read it again
+  FILE* const f = tmpfile();
+  fprintf(f, "%s%s", doc, doc);
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_start_stream(reader, f, USTR("test"), true));
+  assert(!serd_reader_read_chunk(reader));
+  assert(!serd_reader_reset(reader));
+
+  // Generated IDs and statistics start again from scratch
+  first[0] = '\0';
+  assert(!serd_reader_read_string(reader, USTR(doc)));
+  assert(!strcmp(first, "b1"));
+
+  const SerdReaderStats reset_stats = serd_reader_get_stats(reader);
+  assert(reset_stats.n_statements == stats.n_statements);
+  assert(reset_stats.n_bytes == stats.n_bytes);
+
+  serd_reader_free(reader);
+  fclose(f);
+}
+
+/// Read `doc` by feeding slices of `size` bytes, and write it as NQuads
+static char*
+rewrite_fed(const SerdSyntax syntax, const char* const doc, const size_t size)
+{
+  SerdChunk         chunk  = {NULL, 0};
+  SerdEnv* const    env    = serd_env_new(NULL);
+  SerdWriter* const writer = serd_writer_new(
+    SERD_NQUADS, (SerdStyle)0, env, NULL, serd_chunk_sink, &chunk);
+
+  SerdReader* const reader =
+    serd_reader_new(syntax,
+                    writer,
+                    NULL,
+                    (SerdBaseSink)serd_writer_set_base_uri,
+                    (SerdPrefixSink)serd_writer_set_prefix,
+                    (SerdStatementSink)serd_writer_write_statement,
+                    NULL);
+
+  const uint8_t* const buf = USTR(doc);
+  const size_t         len = strlen(doc);
+  if (size) {
+    for (size_t i = 0u; i < len; i += size) {
+      const size_t n = i + size < len ? size : len - i;
+      assert(!serd_reader_feed(reader, buf + i, n, false));
+    }
+
+    assert(!serd_reader_feed(reader, NULL, 0u, true));
+    assert(serd_reader_get_stats(reader).n_bytes == len);
+  } else {
+    assert(!serd_reader_read_string(reader, buf));
+  }
+
+  serd_reader_free(reader);
+  serd_writer_finish(writer);
+  serd_writer_free(writer);
+  serd_env_free(env);
+
+  return (char*)serd_chunk_sink_finish(&chunk);
+}
+
+static void
+test_read_feed(void)
+{
+  static const char* const turtle =
+    "@prefix eg: <http://example.org/> .\n"
+    "PREFIX ex: <http://example.org/x/>\n"
+    "# A comment with a dot. And \"quotes\n"
+    "eg:s eg:p \"a. b\" , 'c.\\'. d' , 1.5 , .5 , 2. eg:s eg:p eg:o.\n"
+    "eg:s eg:p \"\"\"long.\n"
+    "string \"\" } .\"\"\" ; eg:q [ eg:r \"\" ] .\n"
+    "ex:a\\.b eg:p ( eg:o1 \"x.\" ) .\n"
+    "<http://example.org/x.y> eg:p eg:a.b .\n";
+
+  static const char* const trig =
+    "@prefix eg: <http://example.org/> .\n"
+    "eg:g { eg:s eg:p eg:o . eg:s eg:p \"}\" . }\n"
+    "GRAPH eg:h { eg:s eg:p [ eg:q eg:r ] }\n"
+    "{ eg:s eg:p eg:o }\n";
+
+  static const char* const nquads =
+    "<http://example.org/s> <http://example.org/p> \"o\" .\n"
+    "<http://example.org/s> <http://example.org/p> _:o <http://ex.org/g> .\n"
+    "<http://example.org/s> <http://example.org/p> <http://ex.org/o> .";
+
+  static const SerdSyntax syntaxes[] = {SERD_TURTLE, SERD_TRIG, SERD_NQUADS};
+  static const char* const docs[]    = {turtle, trig, nquads};
+  static const size_t      counts[]  = {15u, 5u, 3u};
+  static const size_t      sizes[]   = {1u, 2u, 3u, 7u, 64u, 4096u};
+
+  for (size_t d = 0u; d < sizeof(docs) / sizeof(docs[0]); ++d) {
+    char* const expected = rewrite_fed(syntaxes[d], docs[d], 0u);
+    size_t      n_lines  = 0u;
+    for (const char* c = expected; *c; ++c) {
+      n_lines += *c == '\n';
+    }
+
+    assert(n_lines == counts[d]);
+    for (size_t i = 0u; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+      char* const fed = rewrite_fed(syntaxes[d], docs[d], sizes[i]);
+      assert(!strcmp(fed, expected));
+      serd_free(fed);
+    }
+
+    serd_free(expected);
+  }
+
+  // Errors are reported when a bad statement is complete
+  static const char* const bad = "<http://example.org/s> <http://exa";
+
+  ReaderTest        rt     = {0, NULL};
+  SerdReader* const reader =
+    serd_reader_new(SERD_NQUADS, &rt, NULL, NULL, NULL, test_sink, NULL);
+
+  serd_reader_set_error_sink(reader, quiet_error_sink, NULL);
+  assert(!serd_reader_feed(reader, USTR(bad), strlen(bad), false));
+  assert(serd_reader_feed(reader, USTR("mple.org/p> .\n"), 14u, false));
+  assert(!rt.n_statements);
+
+  // After an error, feeding starts a new document
+  assert(!serd_reader_feed(reader, USTR(nquads), strlen(nquads), true));
+  assert(rt.n_statements == 3);
+  assert(serd_reader_feed(reader, USTR(bad), strlen(bad), true));
+
+  serd_reader_free(reader);
+
+  SerdReader* const binary =
+    serd_reader_new(SERD_BINARY, NULL, NULL, NULL, NULL, NULL, NULL);
+
+  assert(serd_reader_feed(binary, USTR(bad), strlen(bad), true) ==
+         SERD_ERR_BAD_ARG);
+
+  serd_reader_free(binary);
+}
+
+/// Keep predicates and graphs that end with "keep", or no or unknown graph
+static bool
+keep_filter(void* handle, const SerdNode* graph, const SerdNode* predicate)
+{
+  size_t* const n_calls = (size_t*)handle;
+  ++*n_calls;
+
+  return (!graph || !graph->type ||
+          !strcmp((const char*)graph->buf + graph->n_bytes - 4u, "keep")) &&
+         !strcmp((const char*)predicate->buf + predicate->n_bytes - 4u,
+                 "keep");
+}
+
+/// Keep only graphs that end with "keep", once the graph is known
+static bool
+keep_graph_filter(void*           handle,
+                  const SerdNode* graph,
+                  const SerdNode* predicate)
+{
+  (void)predicate;
+
+  size_t* const n_calls = (size_t*)handle;
+  ++*n_calls;
+
+  return graph &&
+         (!graph->type ||
+          !strcmp((const char*)graph->buf + graph->n_bytes - 4u, "keep"));
+}
+
+/// Read `doc` with `filter`, and write it in `out_syntax`
+static char*
+rewrite_filtered(const SerdSyntax     syntax,
+                 const SerdSyntax     out_syntax,
+                 const SerdFilterFunc filter,
+                 const char* const    doc)
+{
+  size_t            n_calls = 0u;
+  SerdChunk         chunk   = {NULL, 0};
+  SerdEnv* const    env     = serd_env_new(NULL);
+  SerdWriter* const writer  = serd_writer_new(
+    out_syntax, (SerdStyle)0, env, NULL, serd_chunk_sink, &chunk);
+
+  SerdReader* const reader =
+    serd_reader_new(syntax,
+                    writer,
+                    NULL,
+                    (SerdBaseSink)serd_writer_set_base_uri,
+                    (SerdPrefixSink)serd_writer_set_prefix,
+                    (SerdStatementSink)serd_writer_write_statement,
+                    (SerdEndSink)serd_writer_end_anon);
+
+  serd_reader_set_filter(reader, filter, &n_calls);
+  assert(!serd_reader_read_string(reader, USTR(doc)));
+  assert(n_calls > 0u);
+
+  serd_reader_free(reader);
+  serd_writer_finish(writer);
+  serd_writer_free(writer);
+  serd_env_free(env);
+
+  return (char*)serd_chunk_sink_finish(&chunk);
+}
+
+static void
+test_read_filtered(void)
+{
+  static const char* const turtle =
+    "@prefix eg: <http://example.org/> .\n"
+    "eg:s eg:skip \"a. b; c\" , 'd' , 1.5 , .5 ; eg:keep eg:o1 ;\n"
+    "  eg:skip \"\"\"long ; . ]\n\"\"\" , <http://example.org/x;y.z> ,\n"
+    "    [ eg:keep eg:nested ; eg:q ( 1 2 [ eg:r \"]\" ] ) ] ; # ] .\n"
+    "  eg:keep \"2\" .\n"
+    "eg:t eg:skip eg:a.b.\n"
+    "eg:t eg:keep [ eg:skip eg:x ; eg:keep eg:o3 ] .\n"
+    "[ eg:skip ( eg:x ) ] eg:keep eg:o4 .\n"
+    "eg:u eg:keep ( eg:x ) .\n";
+
+  static const char* const turtle_out =
+    "<http://example.org/s> <http://example.org/keep> "
+    "<http://example.org/o1> .\n"
+    "<http://example.org/s> <http://example.org/keep> \"2\" .\n"
+    "<http://example.org/t> <http://example.org/keep> _:b1 .\n"
+    "_:b1 <http://example.org/keep> <http://example.org/o3> .\n"
+    "_:b2 <http://example.org/keep> <http://example.org/o4> .\n"
+    "<http://example.org/u> <http://example.org/keep> _:b3 .\n"
+    "_:b3 <" NS_RDF "first> <http://example.org/x> .\n"
+    "_:b3 <" NS_RDF "rest> <" NS_RDF "nil> .\n";
+
+  static const char* const trig =
+    "@prefix eg: <http://example.org/> .\n"
+    "eg:keep { eg:s eg:skip eg:o . eg:s eg:keep eg:o1 }\n"
+    "eg:skip { eg:s eg:keep eg:o }\n"
+    "{ eg:s eg:keep eg:o2 ; eg:skip \"}\" }\n";
+
+  static const char* const trig_out =
+    "<http://example.org/s> <http://example.org/keep> "
+    "<http://example.org/o1> <http://example.org/keep> .\n"
+    "<http://example.org/s> <http://example.org/keep> "
+    "<http://example.org/o2> .\n";
+
+  static const char* const nquads =
+    "<http://example.org/s> <http://example.org/skip> \"o\" .\n"
+    "<http://example.org/s> <http://example.org/keep> \"o1\" .\n"
+    "<http://example.org/s> <http://example.org/skip> \"\\\" .\" "
+    "<http://example.org/keep> .\n"
+    "<http://example.org/s> <http://example.org/keep> _:o "
+    "<http://example.org/skip> .\n"
+    "<http://example.org/s> <http://example.org/keep> <http://example.org/o2> "
+    "<http://example.org/keep> .\n";
+
+  static const char* const nquads_out =
+    "<http://example.org/s> <http://example.org/keep> \"o1\" .\n"
+    "<http://example.org/s> <http://example.org/keep> "
+    "<http://example.org/o2> <http://example.org/keep> .\n";
+
+  static const char* const trig_out_graph =
+    "<http://example.org/s> <http://example.org/skip> "
+    "<http://example.org/o> <http://example.org/keep> .\n"
+    "<http://example.org/s> <http://example.org/keep> "
+    "<http://example.org/o1> <http://example.org/keep> .\n";
+
+  static const char* const nquads_out_graph =
+    "<http://example.org/s> <http://example.org/skip> \"\\\" .\" "
+    "<http://example.org/keep> .\n"
+    "<http://example.org/s> <http://example.org/keep> "
+    "<http://example.org/o2> <http://example.org/keep> .\n";
+
+  static const SerdSyntax syntaxes[] = {SERD_TURTLE, SERD_TRIG, SERD_NQUADS};
+  static const char* const docs[]    = {turtle, trig, nquads};
+  static const char* const outputs[] = {turtle_out, trig_out, nquads_out};
+
+  for (size_t i = 0u; i < sizeof(docs) / sizeof(docs[0]); ++i) {
+    char* const out =
+      rewrite_filtered(syntaxes[i], SERD_NQUADS, keep_filter, docs[i]);
+    assert(!strcmp(out, outputs[i]));
+    serd_free(out);
+  }
+
+  // Statements in the default graph are filtered out by graph in every syntax
+  static const char* const graph_outputs[] = {
+    "", trig_out_graph, nquads_out_graph};
+
+  for (size_t i = 0u; i < sizeof(docs) / sizeof(docs[0]); ++i) {
+    char* const out =
+      rewrite_filtered(syntaxes[i], SERD_NQUADS, keep_graph_filter, docs[i]);
+    assert(!strcmp(out, graph_outputs[i]));
+    serd_free(out);
+  }
+
+  // Anonymous nodes are written without lines for filtered statements
+  static const char* const anon =
+    "@prefix eg: <http://example.org/> .\n"
+    "[ eg:skip 1 ; eg:keep 2 ] eg:keep eg:o1 .\n"
+    "[ eg:skip 3 ] eg:keep eg:o2 .\n"
+    "eg:s eg:keep [ eg:skip 4 ] , [ eg:keep [ eg:skip 5 ] ] .\n";
+
+  static const char* const anon_out =
+    "@prefix eg: <http://example.org/> .\n"
+    "\n"
+    "[\n"
+    "\t\teg:keep 2\n"
+    "\t] eg:keep eg:o1 .\n"
+    "\n"
+    "[]\n"
+    "\teg:keep eg:o2 .\n"
+    "\n"
+    "eg:s\n"
+    "\teg:keep [] ,\n"
+    "\t[\n"
+    "\t\teg:keep []\n"
+    "\t] .\n"
+    "\n";
+
+  char* const out =
+    rewrite_filtered(SERD_TURTLE, SERD_TURTLE, keep_filter, anon);
+
+  assert(!strcmp(out, anon_out));
+  serd_free(out);
+}
+
+static SerdStatus
+count_prefix_sink(void* handle, const SerdNode* name, const SerdNode* uri)
+{
+  (void)name;
+  (void)uri;
+
+  ++((ReaderTest*)handle)->n_statements;
+  return SERD_SUCCESS;
+}
+
+static void
+test_read_validate(void)
+{
+  static const char* const doc =
+    "@prefix eg: <http://example.org/> .\n"
+    "eg:s eg:p [ eg:q ( 1 2 ) ] , \"x\"^^eg:T .\n";
+
+  ReaderTest        rt     = {0, NULL};
+  SerdReader* const reader = serd_reader_new(
+    SERD_TURTLE, &rt, NULL, NULL, count_prefix_sink, test_sink, NULL);
+
+  // Validating reads everything without calling any sinks
+  serd_reader_set_validate_only(reader, true);
+  serd_reader_set_error_sink(reader, quiet_error_sink, NULL);
+  assert(!serd_reader_read_string(reader, USTR(doc)));
+  assert(!rt.n_statements);
+  assert(serd_reader_get_stats(reader).n_statements == 7u);
+
+  // Prefixes are remembered, and undefined ones are errors
+  assert(!serd_reader_read_string(reader, USTR("eg:s eg:p eg:o .")));
+  assert(serd_reader_read_string(reader, USTR("eg:s eg:p ex:o .")) ==
+         SERD_ERR_BAD_CURIE);
+  assert(serd_reader_read_string(reader, USTR("eg:s eg:p \"x\"^^ex:T .")) ==
+         SERD_ERR_BAD_CURIE);
+  assert(serd_reader_get_stats(reader).n_errors == 2u);
+
+  // Syntax errors are reported as usual
+  assert(serd_reader_read_string(reader, USTR("eg:s eg:p \"o .")));
+
+  // Resetting forgets prefixes
+  assert(!serd_reader_reset(reader));
+  assert(serd_reader_read_string(reader, USTR("eg:s eg:p eg:o .")) ==
+         SERD_ERR_BAD_CURIE);
+
+  // Without validation, sinks are called again
+  serd_reader_set_validate_only(reader, false);
+  assert(!serd_reader_read_string(reader, USTR(doc)));
+  assert(rt.n_statements == 8);
+  serd_reader_free(reader);
+
+  // Parallel reading picks up prefixes defined partway through the input
+  FILE* const f = tmpfile();
+  fprintf(f, "@prefix eg: <http://example.org/> .\n");
+  for (unsigned i = 0u; i < 10000u; ++i) {
+    if (i == 5000u) {
+      fprintf(f, "@prefix ex: <http://example.org/x/> .\n");
+    }
+
+    fprintf(f, "eg:s%u %s:p \"%u\" .\n", i, i < 5000u ? "eg" : "ex", i);
+  }
+
+  SerdReader* const par_reader = serd_reader_new(
+    SERD_TURTLE, &rt, NULL, NULL, count_prefix_sink, test_sink, NULL);
+
+  rt.n_statements = 0;
+  serd_reader_set_validate_only(par_reader, true);
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_parallel(par_reader, f, NULL, 4u, true));
+  assert(!rt.n_statements);
+  assert(serd_reader_get_stats(par_reader).n_statements == 10000u);
+  assert(!serd_reader_get_stats(par_reader).n_errors);
+
+  serd_reader_free(par_reader);
+  fclose(f);
+}
+
+static void
+test_read_lazy_positions(void)
+{
+  static const char* const doc =
+    "@prefix eg: <http://example.org/> .\n"
+    "eg:s eg:p eg:o1 .\n"
+    "eg:s eg:p \"bad\\q\" .\n"
+    "\n"
+    "# A comment\n"
+    "eg:s eg:p eg:o2 , eg:o3 ;\n"
+    "  eg:q 12 .\n"
+    "eg:s \"bad\" eg:o4 .\n"
+    "eg:s eg:p eg:o5 . eg:s eg:p .\n";
+
+  FILE* const       f = tmpfile();
+  SerdReader* const reader =
+    serd_reader_new(SERD_TURTLE, NULL, NULL, NULL, NULL, NULL, NULL);
+
+  assert(f);
+  fprintf(f, "%s", doc);
+  serd_reader_set_strict(reader, false);
+
+  // Read eagerly from a string to get the expected positions
+  Positions expected = {0u, {0u}, {0u}};
+  serd_reader_set_error_sink(reader, position_error_sink, &expected);
+  serd_reader_read_string(reader, USTR(doc));
+  assert(expected.n_errors == 3u);
+  assert(expected.lines[0] == 3u);
+  assert(expected.lines[1] == 8u);
+  assert(expected.lines[2] == 9u);
+
+  serd_reader_set_lazy_positions(reader, true);
+  for (unsigned i = 0u; i < 5u; ++i) {
+    Positions pos = {0u, {0u}, {0u}};
+    serd_reader_set_error_sink(reader, position_error_sink, &pos);
+    fseek(f, 0, SEEK_SET);
+
+    switch (i) {
+    case 0:
+      serd_reader_read_string(reader, USTR(doc));
+      break;
+    case 1:
+      serd_reader_read_file_handle(reader, f, USTR("test"));
+      break;
+    case 2:
+      serd_reader_read_mapped_file_handle(reader, f, USTR("test"));
+      break;
+    case 3:
+      // Small pages, so lines are counted as pages are replaced
+      serd_reader_read_source(reader,
+                              (SerdSource)fread,
+                              (SerdStreamErrorFunc)ferror,
+                              f,
+                              USTR("test"),
+                              16u);
+      break;
+    default:
+      // Byte-at-a-time streams count eagerly regardless
+      serd_reader_read_source(reader,
+                              (SerdSource)fread,
+                              (SerdStreamErrorFunc)ferror,
+                              f,
+                              USTR("test"),
+                              1u);
+    }
+
+    assert(positions_equal(&pos, &expected));
+  }
+
+  serd_reader_free(reader);
+  fclose(f);
+}
+
 static void
 test_writer(const char* const path)
 {
@@ -277,6 +1901,735 @@ test_writer(const char* const path)
   fclose(fd);
 }
 
+/// Write interleaved statements with a reorder window and return the output
+static char*
+write_reordered(const SerdSyntax syntax,
+                const size_t     max_statements,
+                const size_t     max_bytes)
+{
+  static const char* const ids[][3] = {{"g1", "s1", "p"},
+                                       {"g1", "s2", "p"},
+                                       {"g1", "s1", "q"},
+                                       {"g1", "s1", "p"},
+                                       {"g2", "s1", "p"},
+                                       {"g1", "s2", "p"}};
+
+  SerdChunk         chunk  = {NULL, 0};
+  SerdEnv* const    env    = serd_env_new(NULL);
+  SerdWriter* const writer = serd_writer_new(
+    syntax, (SerdStyle)0, env, NULL, serd_chunk_sink, &chunk);
+
+  const SerdNode eg = serd_node_from_string(SERD_LITERAL, USTR("eg"));
+  const SerdNode ns =
+    serd_node_from_string(SERD_URI, USTR("http://example.org/"));
+
+  serd_writer_set_reorder_window(writer, max_statements, max_bytes);
+  assert(!serd_writer_set_prefix(writer, &eg, &ns));
+
+  for (unsigned i = 0u; i < sizeof(ids) / sizeof(ids[0]); ++i) {
+    char g[8];
+    char s[8];
+    char p[8];
+    char o[8];
+    snprintf(g, sizeof(g), "eg:%s", ids[i][0]);
+    snprintf(s, sizeof(s), "eg:%s", ids[i][1]);
+    snprintf(p, sizeof(p), "eg:%s", ids[i][2]);
+    snprintf(o, sizeof(o), "eg:o%u", i);
+
+    const SerdNode gnode = serd_node_from_string(SERD_CURIE, USTR(g));
+    const SerdNode snode = serd_node_from_string(SERD_CURIE, USTR(s));
+    const SerdNode pnode = serd_node_from_string(SERD_CURIE, USTR(p));
+    const SerdNode onode = serd_node_from_string(SERD_CURIE, USTR(o));
+
+    assert(!serd_writer_write_statement(writer,
+                                        0,
+                                        syntax == SERD_TRIG ? &gnode : NULL,
+                                        &snode,
+                                        &pnode,
+                                        &onode,
+                                        NULL,
+                                        NULL));
+  }
+
+  assert(!serd_writer_finish(writer));
+  serd_writer_free(writer);
+  serd_env_free(env);
+  return (char*)serd_chunk_sink_finish(&chunk);
+}
+
+static void
+test_write_reordered(void)
+{
+  static const char* const expected = "@prefix eg: <http://example.org/> .\n"
+                                      "\n"
+                                      "eg:s1\n"
+                                      "\teg:p eg:o0 ,\n"
+                                      "\t\teg:o3 ,\n"
+                                      "\t\teg:o4 ;\n"
+                                      "\teg:q eg:o2 .\n"
+                                      "\n"
+                                      "eg:s2\n"
+                                      "\teg:p eg:o1 ,\n"
+                                      "\t\teg:o5 .\n";
+
+  char* const unordered = write_reordered(SERD_TURTLE, 0u, 0u);
+  char* const grouped   = write_reordered(SERD_TURTLE, 100u, 4096u);
+  char* const small     = write_reordered(SERD_TURTLE, 2u, 4096u);
+  char* const tiny      = write_reordered(SERD_TURTLE, 100u, 1u);
+  char* const trig      = write_reordered(SERD_TRIG, 100u, 4096u);
+
+  // Groups are written in the order they first appeared
+  assert(!strncmp(grouped, expected, strlen(expected)));
+  assert(strlen(grouped) < strlen(unordered));
+
+  // Groups can't span windows, and a window too small for anything is skipped
+  assert(!strcmp(small, unordered));
+  assert(!strcmp(tiny, unordered));
+
+  // Statements in the same graph are grouped too
+  const char* const g1 = strstr(trig, "eg:g1 {");
+  assert(g1 && !strstr(g1 + 1, "eg:g1 {"));
+  assert(strstr(g1, "eg:g2 {"));
+
+  serd_free(trig);
+  serd_free(tiny);
+  serd_free(small);
+  serd_free(grouped);
+  serd_free(unordered);
+}
+
+static void
+test_write_escapes(void)
+{
+  SerdChunk         chunk  = {NULL, 0};
+  SerdEnv* const    env    = serd_env_new(NULL);
+  SerdWriter* const writer = serd_writer_new(
+    SERD_NTRIPLES, (SerdStyle)0, env, NULL, serd_chunk_sink, &chunk);
+
+  // Put characters to escape both in and after whole 16-byte blocks
+  const SerdNode s = serd_node_from_string(
+    SERD_URI, USTR("http://example.org/a/path/with/a space/and/a/DEL\x7F"));
+  const SerdNode p =
+    serd_node_from_string(SERD_URI, USTR("http://example.org/{pred}"));
+  const SerdNode o = serd_node_from_string(
+    SERD_LITERAL,
+    USTR("A \"quoted\" string with a \\ and a\nnewline, \x7F, "
+         "and caf\xc3\xa9 at the end\t"));
+
+  assert(!serd_writer_write_statement(writer, 0, NULL, &s, &p, &o, NULL, NULL));
+
+  const SerdWriterStats stats = serd_writer_get_stats(writer);
+  assert(stats.n_bytes == chunk.len);
+  assert(stats.n_statements == 1u);
+  assert(stats.n_escapes == 10u);
+
+  serd_writer_free(writer);
+  serd_env_free(env);
+
+  uint8_t* const out = serd_chunk_sink_finish(&chunk);
+
+  assert(!strcmp((const char*)out,
+                 "<http://example.org/a/path/with/a\\u0020space/and/a/DEL"
+                 "\\u007F> <http://example.org/\\u007Bpred\\u007D> "
+                 "\"A \\\"quoted\\\" string with a \\\\ and a\\nnewline, "
+                 "\\u007F, and caf\xc3\xa9 at the end\\t\" .\n"));
+
+  serd_free(out);
+}
+
+static void
+test_write_repeated(void)
+{
+  SerdChunk         chunk  = {NULL, 0};
+  SerdEnv* const    env    = serd_env_new(NULL);
+  SerdWriter* const writer = serd_writer_new(
+    SERD_NQUADS, (SerdStyle)0, env, NULL, serd_chunk_sink, &chunk);
+
+  const SerdNode s = serd_node_from_string(SERD_URI, USTR("http://eg/a s"));
+  const SerdNode p = serd_node_from_string(SERD_URI, USTR("http://eg/p"));
+  const SerdNode q = serd_node_from_string(SERD_URI, USTR("http://eg/q"));
+  const SerdNode g = serd_node_from_string(SERD_URI, USTR("http://eg/g"));
+  const SerdNode b = serd_node_from_string(SERD_BLANK, USTR("bx"));
+  const SerdNode o = serd_node_from_string(SERD_LITERAL, USTR("o"));
+
+  // Write the same nodes several times, in different places
+  assert(!serd_writer_write_statement(writer, 0, &g, &s, &p, &o, 0, 0));
+  assert(!serd_writer_write_statement(writer, 0, &g, &s, &q, &o, 0, 0));
+  assert(!serd_writer_write_statement(writer, 0, NULL, &b, &p, &s, 0, 0));
+  assert(!serd_writer_write_statement(writer, 0, &g, &b, &p, &o, 0, 0));
+
+  // Changing the blank prefix changes how the same blank node is written
+  serd_writer_chop_blank_prefix(writer, USTR("b"));
+  assert(!serd_writer_write_statement(writer, 0, &g, &b, &p, &b, 0, 0));
+  serd_writer_chop_blank_prefix(writer, NULL);
+  assert(!serd_writer_write_statement(writer, 0, &g, &b, &p, &s, 0, 0));
+
+  const SerdWriterStats stats = serd_writer_get_stats(writer);
+  assert(stats.n_bytes == chunk.len);
+  assert(stats.n_statements == 6u);
+  assert(stats.n_escapes == 4u);
+
+  serd_writer_free(writer);
+  serd_env_free(env);
+
+  char* const out = (char*)serd_chunk_sink_finish(&chunk);
+
+  assert(!strcmp(out,
+                 "<http://eg/a\\u0020s> <http://eg/p> \"o\" <http://eg/g> .\n"
+                 "<http://eg/a\\u0020s> <http://eg/q> \"o\" <http://eg/g> .\n"
+                 "_:bx <http://eg/p> <http://eg/a\\u0020s> .\n"
+                 "_:bx <http://eg/p> \"o\" <http://eg/g> .\n"
+                 "_:x <http://eg/p> _:x <http://eg/g> .\n"
+                 "_:bx <http://eg/p> <http://eg/a\\u0020s> <http://eg/g> .\n"));
+
+  serd_free(out);
+}
+
+static void
+test_write_literal_pieces(void)
+{
+  SerdChunk         chunk  = {NULL, 0};
+  SerdEnv* const    env    = serd_env_new(NULL);
+  SerdWriter* const writer = serd_writer_new(
+    SERD_TURTLE, (SerdStyle)0, env, NULL, serd_chunk_sink, &chunk);
+
+  const SerdNode s  = serd_node_from_string(SERD_URI, USTR("http://eg/s"));
+  const SerdNode p  = serd_node_from_string(SERD_URI, USTR("http://eg/p"));
+  const SerdNode o  = serd_node_from_string(SERD_LITERAL, USTR("o"));
+  const SerdNode en = serd_node_from_string(SERD_LITERAL, USTR("en"));
+  const SerdNode t  = serd_node_from_string(SERD_URI, USTR("http://eg/T"));
+  const SerdNode p1 = serd_node_from_string(SERD_LITERAL, USTR(" \"one\""));
+  const SerdNode p2 = serd_node_from_string(SERD_LITERAL, USTR("\ntwo"));
+  const SerdNode p3 = serd_node_from_string(SERD_LITERAL, USTR("three"));
+  const SerdNode chunked = {USTR(""), 0u, 0u, SERD_IS_CHUNKED, SERD_LITERAL};
+
+  // Only a literal that was started can be ended
+  assert(serd_writer_end_literal(writer) == SERD_ERR_BAD_ARG);
+  assert(serd_writer_begin_literal(writer, 0, 0, &s, &p, &s, 0, 0) ==
+         SERD_ERR_BAD_ARG);
+
+  // Write a literal in pieces, which are escaped like a short string
+  assert(!serd_writer_begin_literal(writer, 0, 0, &s, &p, &o, 0, &en));
+  assert(serd_writer_begin_literal(writer, 0, 0, &s, &p, &o, 0, 0) ==
+         SERD_ERR_BAD_ARG);
+  assert(!serd_writer_write_literal_piece(writer, 0, 0, &s, &p, &p1));
+  assert(!serd_writer_write_literal_piece(writer, 0, 0, &s, &p, &p2));
+  assert(!serd_writer_end_literal(writer));
+
+  // Or start a literal with a piece, and end it with a statement like a reader
+  assert(!serd_writer_write_literal_piece(writer, 0, 0, &s, &p, &p3));
+  assert(!serd_writer_write_literal_piece(writer, 0, 0, &s, &p, &p1));
+  assert(!serd_writer_write_statement(writer, 0, 0, &s, &p, &chunked, &t, 0));
+
+  // Statements are abbreviated as usual around them, and finish any literal
+  assert(!serd_writer_write_literal_piece(writer, 0, 0, &s, &p, &p2));
+  assert(!serd_writer_write_statement(writer, 0, 0, &s, &p, &o, 0, 0));
+  assert(!serd_writer_finish(writer));
+  assert(serd_writer_get_stats(writer).n_statements == 4u);
+
+  serd_writer_free(writer);
+  serd_env_free(env);
+
+  char* const out = (char*)serd_chunk_sink_finish(&chunk);
+
+  assert(!strcmp(out,
+                 "<http://eg/s>\n"
+                 "\t<http://eg/p> \"o \\\"one\\\"\\ntwo\"@en ,\n"
+                 "\t\t\"three \\\"one\\\"\"^^<http://eg/T> ,\n"
+                 "\t\t\"\\ntwo\" ,\n"
+                 "\t\t\"o\" .\n\n"));
+
+  serd_free(out);
+}
+
+/// Write a document with an unfinished anonymous node to `writer`
+static void
+write_unfinished(SerdWriter* const writer, const unsigned i)
+{
+  char buf[32];
+  snprintf(buf, sizeof(buf), "http://example.org/s%u", i);
+
+  const SerdNode s = serd_node_from_string(SERD_URI, USTR(buf));
+  const SerdNode p = serd_node_from_string(SERD_CURIE, USTR("eg:p"));
+  const SerdNode o = serd_node_from_string(SERD_BLANK, USTR("o"));
+
+  assert(!serd_writer_write_statement(
+    writer, SERD_ANON_O_BEGIN, NULL, &s, &p, &o, NULL, NULL));
+  assert(!serd_writer_write_statement(writer, 0, NULL, &o, &p, &s, NULL, NULL));
+}
+
+static void
+test_write_reset(void)
+{
+  const SerdNode eg  = serd_node_from_string(SERD_URI, USTR("http://ex.org/"));
+  SerdEnv* const env = serd_env_new(&eg);
+  serd_env_set_prefix_from_strings(env, USTR("eg"), USTR("http://ex.org/"));
+
+  // Write a document with a fresh writer for comparison
+  const SerdStyle style       = SERD_STYLE_ABBREVIATED;
+  SerdChunk       fresh_chunk = {NULL, 0};
+  SerdEnv*        fresh_env   = serd_env_copy(env);
+  SerdWriter*     writer      = serd_writer_new(
+    SERD_TURTLE, style, fresh_env, NULL, serd_chunk_sink, &fresh_chunk);
+
+  write_unfinished(writer, 2u);
+  assert(!serd_writer_finish(writer));
+  serd_writer_free(writer);
+  serd_env_free(fresh_env);
+
+  char* const fresh = (char*)serd_chunk_sink_finish(&fresh_chunk);
+
+  // Write two documents with the same writer, resetting in between
+  SerdChunk chunk     = {NULL, 0};
+  SerdEnv*  first_env = serd_env_copy(env);
+  writer              = serd_writer_new(
+    SERD_TURTLE, style, first_env, NULL, serd_chunk_sink, &chunk);
+
+  write_unfinished(writer, 1u);
+  assert(serd_writer_get_stats(writer).n_statements == 2u);
+
+  SerdEnv* const second_env = serd_env_copy(env);
+  assert(!serd_writer_reset(writer, second_env));
+  assert(!serd_writer_get_stats(writer).n_statements);
+  serd_env_free(first_env);
+
+  // The second document is written exactly like it would be by a new writer
+  const size_t first_len = chunk.len;
+  write_unfinished(writer, 2u);
+  assert(!serd_writer_finish(writer));
+  assert(chunk.len - first_len == strlen(fresh));
+  assert(!strncmp((const char*)chunk.buf + first_len, fresh, strlen(fresh)));
+
+  serd_writer_free(writer);
+  serd_env_free(second_env);
+  serd_free(serd_chunk_sink_finish(&chunk));
+  serd_free(fresh);
+  serd_env_free(env);
+}
+
+/// Write many statements with `style` and return the output
+static uint8_t*
+write_many(const SerdStyle style, const bool finish)
+{
+  SerdChunk         chunk  = {NULL, 0};
+  SerdEnv* const    env    = serd_env_new(NULL);
+  SerdWriter* const writer = serd_writer_new(
+    SERD_NTRIPLES, style, env, NULL, serd_chunk_sink, &chunk);
+
+  const SerdNode p = serd_node_from_string(SERD_URI, USTR("http://ex.org/p"));
+
+  char buf[32];
+  for (unsigned i = 0u; i < 20000u; ++i) {
+    snprintf(buf, sizeof(buf), "http://ex.org/s%u", i);
+    const SerdNode s = serd_node_from_string(SERD_URI, USTR(buf));
+    SerdNode       o = serd_node_new_integer((int64_t)i);
+
+    assert(
+      !serd_writer_write_statement(writer, 0, NULL, &s, &p, &o, NULL, NULL));
+    serd_node_free(&o);
+  }
+
+  if (finish) {
+    // Finishing waits until everything has been written to the sink
+    assert(!serd_writer_finish(writer));
+    assert(chunk.len > 20000u * 40u);
+  }
+
+  serd_writer_free(writer);
+  serd_env_free(env);
+  return serd_chunk_sink_finish(&chunk);
+}
+
+static void
+test_write_async(void)
+{
+  uint8_t* const sync  = write_many(SERD_STYLE_BULK, false);
+  uint8_t* const async = write_many(SERD_STYLE_ASYNC, true);
+  uint8_t* const freed = write_many(SERD_STYLE_ASYNC, false);
+
+  assert(!strcmp((const char*)async, (const char*)sync));
+  assert(!strcmp((const char*)freed, (const char*)sync));
+
+  serd_free(freed);
+  serd_free(async);
+  serd_free(sync);
+}
+
+static void
+test_write_resolved(void)
+{
+  SerdChunk      chunk = {NULL, 0};
+  SerdEnv* const env   = serd_env_new(NULL);
+  SerdWriter*    writer = serd_writer_new(
+    SERD_NTRIPLES, SERD_STYLE_RESOLVED, env, NULL, serd_chunk_sink, &chunk);
+
+  const SerdNode a = serd_node_from_string(SERD_URI, USTR("http://ex.org/a/"));
+  const SerdNode b = serd_node_from_string(SERD_URI, USTR("http://ex.org/b/"));
+  const SerdNode c = serd_node_from_string(SERD_URI, USTR("http://ex.org/c/"));
+  const SerdNode s = serd_node_from_string(SERD_URI, USTR("s"));
+  const SerdNode p = serd_node_from_string(SERD_URI, USTR("p"));
+
+  // Changing the base URI invalidates the cache
+  assert(!serd_writer_set_base_uri(writer, &a));
+  assert(!serd_writer_write_statement(writer, 0, NULL, &s, &p, &s, NULL, NULL));
+  assert(!serd_writer_write_statement(writer, 0, NULL, &s, &p, &s, NULL, NULL));
+  assert(!serd_writer_set_base_uri(writer, &b));
+  assert(!serd_writer_write_statement(writer, 0, NULL, &s, &p, &s, NULL, NULL));
+  assert(!serd_writer_set_base_uri(writer, &c));
+  assert(!serd_writer_write_statement(writer, 0, NULL, &s, &p, &s, NULL, NULL));
+  serd_writer_free(writer);
+
+  uint8_t* out = serd_chunk_sink_finish(&chunk);
+  assert(!strcmp((const char*)out,
+                 "<http://ex.org/a/s> <http://ex.org/a/p> <http://ex.org/a/s> "
+                 ".\n"
+                 "<http://ex.org/a/s> <http://ex.org/a/p> <http://ex.org/a/s> "
+                 ".\n"
+                 "<http://ex.org/b/s> <http://ex.org/b/p> <http://ex.org/b/s> "
+                 ".\n"
+                 "<http://ex.org/c/s> <http://ex.org/c/p> <http://ex.org/c/s> "
+                 ".\n"));
+  serd_free(out);
+
+  // Changing the root URI invalidates the cache
+  const SerdNode base =
+    serd_node_from_string(SERD_URI, USTR("http://ex.org/a/b/"));
+  const SerdNode root =
+    serd_node_from_string(SERD_URI, USTR("http://ex.org/"));
+  const SerdNode y = serd_node_from_string(SERD_URI, USTR("http://ex.org/z/y"));
+
+  chunk  = (SerdChunk){NULL, 0};
+  writer = serd_writer_new(
+    SERD_TURTLE, SERD_STYLE_RESOLVED, env, NULL, serd_chunk_sink, &chunk);
+
+  assert(!serd_writer_set_base_uri(writer, &base));
+  assert(!serd_writer_set_root_uri(writer, &a));
+  assert(!serd_writer_write_statement(writer, 0, NULL, &y, &y, &y, NULL, NULL));
+  assert(!serd_writer_set_root_uri(writer, &root));
+  assert(!serd_writer_write_statement(writer, 0, NULL, &s, &y, &y, NULL, NULL));
+  serd_writer_free(writer);
+
+  out = serd_chunk_sink_finish(&chunk);
+  assert(
+    strstr((const char*)out, "<http://ex.org/z/y> <http://ex.org/z/y> .\n"));
+  assert(strstr((const char*)out, "<../../z/y> <../../z/y> .\n"));
+  serd_free(out);
+
+  serd_env_free(env);
+}
+
+typedef struct {
+  size_t n_allocations; ///< Number of blocks allocated
+  size_t n_frees;       ///< Number of blocks freed
+} CountingAllocator;
+
+static void*
+counting_malloc(void* handle, size_t size)
+{
+  ++((CountingAllocator*)handle)->n_allocations;
+  return malloc(size);
+}
+
+static void*
+counting_realloc(void* handle, void* ptr, size_t size)
+{
+  if (!ptr) {
+    ++((CountingAllocator*)handle)->n_allocations;
+  }
+
+  return realloc(ptr, size);
+}
+
+static void
+counting_free(void* handle, void* ptr)
+{
+  if (ptr) {
+    ++((CountingAllocator*)handle)->n_frees;
+  }
+
+  free(ptr);
+}
+
+static void
+test_allocator(void)
+{
+  static const char* const doc =
+    "@base <http://example.org/> .\n"
+    "@prefix eg: <http://example.org/> .\n"
+    "<s> eg:p [ eg:q \"x\"@en ] , ( 1 2 ) ; eg:r _:b1 .\n";
+
+  CountingAllocator   counts    = {0u, 0u};
+  const SerdAllocator allocator = {
+    &counts, counting_malloc, counting_realloc, counting_free};
+
+  SerdChunk      chunk = {NULL, 0};
+  SerdEnv* const env   = serd_env_new_with_allocator(&allocator, NULL);
+
+  SerdWriter* const writer = serd_writer_new_with_allocator(&allocator,
+                                                            SERD_TURTLE,
+                                                            SERD_STYLE_RESOLVED,
+                                                            env,
+                                                            NULL,
+                                                            serd_chunk_sink,
+                                                            &chunk);
+
+  SerdReader* const reader = serd_reader_new_with_allocator(
+    &allocator,
+    SERD_TURTLE,
+    writer,
+    NULL,
+    (SerdBaseSink)serd_writer_set_base_uri,
+    (SerdPrefixSink)serd_writer_set_prefix,
+    (SerdStatementSink)serd_writer_write_statement,
+    (SerdEndSink)serd_writer_end_anon);
+
+  serd_reader_add_blank_prefix(reader, USTR("b"));
+  serd_writer_chop_blank_prefix(writer, USTR("c"));
+  assert(!serd_env_set_prefix_from_strings(
+    env, USTR("eg"), USTR("http://example.org/")));
+
+  assert(!serd_reader_read_string(reader, USTR(doc)));
+  assert(!serd_writer_finish(writer));
+  assert(counts.n_allocations > 0u);
+
+  serd_reader_free(reader);
+  serd_writer_free(writer);
+  serd_env_free(env);
+
+  // Everything allocated with the allocator was freed with it
+  assert(counts.n_frees == counts.n_allocations);
+
+  uint8_t* const out = serd_chunk_sink_finish(&chunk);
+  assert(strstr((const char*)out, "eg:q \"x\"@en"));
+  serd_free(out);
+}
+
+/// Read a string or file in `syntax` and return it written as TriG
+static uint8_t*
+write_trig(const SerdSyntax syntax, const char* const str, FILE* const file)
+{
+  SerdChunk         chunk  = {NULL, 0};
+  SerdEnv* const    env    = serd_env_new(NULL);
+  SerdWriter* const writer = serd_writer_new(
+    SERD_TRIG, SERD_STYLE_ABBREVIATED, env, NULL, serd_chunk_sink, &chunk);
+
+  SerdReader* const reader =
+    serd_reader_new(syntax,
+                    writer,
+                    NULL,
+                    (SerdBaseSink)serd_writer_set_base_uri,
+                    (SerdPrefixSink)serd_writer_set_prefix,
+                    (SerdStatementSink)serd_writer_write_statement,
+                    (SerdEndSink)serd_writer_end_anon);
+
+  assert(!(str ? serd_reader_read_string(reader, USTR(str))
+               : serd_reader_read_file_handle(reader, file, USTR("test"))));
+
+  serd_reader_free(reader);
+  serd_writer_free(writer);
+  serd_env_free(env);
+  return serd_chunk_sink_finish(&chunk);
+}
+
+static void
+test_binary(void)
+{
+  static const char* const doc =
+    "@prefix eg: <http://example.org/> .\n"
+    "eg:s eg:p \"hello\"@en , \"1\"^^eg:int , [ eg:q eg:o ] ;\n"
+    "  eg:r \"line\\none\" .\n"
+    "eg:g { eg:s eg:p eg:o }\n";
+
+  // Write a document to binary
+  FILE* const       f      = tmpfile();
+  SerdEnv* const    env    = serd_env_new(NULL);
+  SerdWriter* const writer = serd_writer_new(
+    SERD_BINARY, SERD_STYLE_RESOLVED, env, NULL, serd_file_sink, f);
+
+  SerdReader* const reader =
+    serd_reader_new(SERD_TRIG,
+                    writer,
+                    NULL,
+                    (SerdBaseSink)serd_writer_set_base_uri,
+                    (SerdPrefixSink)serd_writer_set_prefix,
+                    (SerdStatementSink)serd_writer_write_statement,
+                    (SerdEndSink)serd_writer_end_anon);
+
+  assert(!serd_reader_read_string(reader, USTR(doc)));
+  serd_reader_free(reader);
+  serd_writer_free(writer);
+
+  // Reading it back produces the same events as reading the original
+  fseek(f, 0, SEEK_SET);
+  uint8_t* const direct = write_trig(SERD_TRIG, doc, NULL);
+  uint8_t* const loaded = write_trig(SERD_BINARY, NULL, f);
+  assert(!strcmp((const char*)loaded, (const char*)direct));
+  assert(strstr((const char*)loaded, "eg:q eg:o"));
+  serd_free(loaded);
+  serd_free(direct);
+
+  // The term table survives setting a batch sink between reads
+  SerdChunk         chunk = {NULL, 0};
+  BatchTest         bt    = {NULL, 4u, 0u};
+  SerdReader* const batch_reader =
+    serd_reader_new(SERD_BINARY, &bt, NULL, NULL, NULL, NULL, NULL);
+
+  bt.writer = serd_writer_new(
+    SERD_NQUADS, (SerdStyle)0, env, NULL, serd_chunk_sink, &chunk);
+
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_file_handle(batch_reader, f, USTR("test")));
+  serd_reader_set_batch_sink(batch_reader, bt.max_batch, batch_sink);
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_file_handle(batch_reader, f, USTR("test")));
+  assert(bt.n_batches > 0u);
+
+  serd_reader_free(batch_reader);
+  serd_writer_free(bt.writer);
+  serd_free(serd_chunk_sink_finish(&chunk));
+
+  // Truncated and invalid input is an error
+  ReaderTest* const rt = (ReaderTest*)calloc(1, sizeof(ReaderTest));
+  SerdReader* const bad =
+    serd_reader_new(SERD_BINARY, rt, free, NULL, NULL, test_sink, NULL);
+
+  serd_reader_set_error_sink(bad, quiet_error_sink, NULL);
+
+  const long size   = ftell(f);
+  unsigned   n_errs = 0u;
+  for (long i = 1; i < size; ++i) {
+    char* const buf = (char*)calloc(1, (size_t)i);
+    fseek(f, 0, SEEK_SET);
+    assert(fread(buf, 1, (size_t)i, f) == (size_t)i);
+
+    FILE* const truncated = tmpfile();
+    fwrite(buf, 1, (size_t)i, truncated);
+    fseek(truncated, 0, SEEK_SET);
+
+    const SerdStatus st =
+      serd_reader_read_file_handle(bad, truncated, USTR("test"));
+    assert(!st || st == SERD_ERR_BAD_SYNTAX);
+    n_errs += (st == SERD_ERR_BAD_SYNTAX);
+
+    fclose(truncated);
+    free(buf);
+  }
+
+  assert(n_errs > (unsigned)size / 2u);
+  assert(serd_reader_read_string(bad, USTR("SERDBIN\002")) ==
+         SERD_ERR_BAD_SYNTAX);
+  assert(serd_reader_read_string(bad, USTR("<a> <b> <c> .")) ==
+         SERD_ERR_BAD_SYNTAX);
+
+  // A node that claims to be huge is an error, not a huge allocation
+  static const char huge[] = "SERDBIN\001t\000\000\002\000"
+                             "\200\200\200\200\200\200\200\001"
+                             "\200\200\200\200\200\200\200\001abc";
+
+  for (unsigned i = 0u; i < 2u; ++i) {
+    FILE* const huge_file = tmpfile();
+    fwrite(huge, 1, sizeof(huge) - 1u, huge_file);
+    if (i) {
+      fseek(huge_file, 11, SEEK_SET);
+      fputc(0x42, huge_file); // Define the node as a term
+    }
+
+    fseek(huge_file, 0, SEEK_SET);
+    assert(serd_reader_read_file_handle(bad, huge_file, USTR("test")) ==
+           SERD_ERR_BAD_SYNTAX);
+    fclose(huge_file);
+  }
+
+  serd_reader_free(bad);
+  serd_env_free(env);
+  fclose(f);
+}
+
+/// Write to a compressed file with `style`, and read it back
+static void
+test_compressed(const SerdStyle style)
+{
+  FILE* const       f      = tmpfile();
+  SerdEnv* const    env    = serd_env_new(NULL);
+  SerdWriter* const writer = serd_writer_new(
+    SERD_NTRIPLES, style, env, NULL, serd_file_sink, f);
+
+  ReaderTest* const rt = (ReaderTest*)calloc(1, sizeof(ReaderTest));
+  SerdReader* const reader =
+    serd_reader_new(SERD_NTRIPLES, rt, free, NULL, NULL, test_sink, NULL);
+
+  serd_reader_set_error_sink(reader, quiet_error_sink, NULL);
+
+  if (!writer) {
+    // Compression isn't supported, so compressed input is an error
+    static const uint8_t gzip[] = {0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00};
+    static const uint8_t zstd[] = {0x28, 0xB5, 0x2F, 0xFD, 0x00, 0x00};
+
+    fwrite((style & SERD_STYLE_GZIP) ? gzip : zstd, 1, sizeof(gzip), f);
+    fseek(f, 0, SEEK_SET);
+    assert(serd_reader_read_file_handle(reader, f, USTR("test")) ==
+           SERD_ERR_BAD_ARG);
+
+    serd_reader_free(reader);
+    serd_env_free(env);
+    fclose(f);
+    return;
+  }
+
+  const SerdNode p = serd_node_from_string(SERD_URI, USTR("http://ex.org/p"));
+
+  char buf[32];
+  for (unsigned i = 0u; i < 10000u; ++i) {
+    snprintf(buf, sizeof(buf), "http://ex.org/s%u", i);
+    const SerdNode s = serd_node_from_string(SERD_URI, USTR(buf));
+    SerdNode       o = serd_node_new_integer((int64_t)i);
+
+    assert(
+      !serd_writer_write_statement(writer, 0, NULL, &s, &p, &o, NULL, NULL));
+    serd_node_free(&o);
+
+    if (i == 5000u) {
+      // Finishing ends a frame, and writing more starts another
+      assert(!serd_writer_finish(writer));
+    }
+  }
+
+  serd_writer_free(writer);
+
+  const long size = ftell(f);
+  assert(size > 0 && size < 10000 * 10);
+
+  // Compression is detected when reading normally, mapped, or in parallel
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_file_handle(reader, f, USTR("test")));
+  assert(rt->n_statements == 10000);
+
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_mapped_file_handle(reader, f, USTR("test")));
+  assert(rt->n_statements == 20000);
+
+  fseek(f, 0, SEEK_SET);
+  assert(!serd_reader_read_parallel(reader, f, USTR("test"), 2u, true));
+  assert(rt->n_statements == 30000);
+
+  // Truncated input is an error
+  char* const truncated_buf = (char*)calloc(1, (size_t)size / 2u);
+  fseek(f, 0, SEEK_SET);
+  assert(fread(truncated_buf, 1, (size_t)size / 2u, f) == (size_t)size / 2u);
+
+  FILE* const truncated = tmpfile();
+  fwrite(truncated_buf, 1, (size_t)size / 2u, truncated);
+  fseek(truncated, 0, SEEK_SET);
+  assert(serd_reader_read_file_handle(reader, truncated, USTR("test")) >
+         SERD_FAILURE);
+
+  fclose(truncated);
+  free(truncated_buf);
+  serd_reader_free(reader);
+  serd_env_free(env);
+  fclose(f);
+}
+
 static void
 test_reader(const char* path)
 {
@@ -353,9 +2706,40 @@ main(void)
 {
   test_read_chunks();
   test_read_string();
+  test_read_mapped();
+  test_read_prefetched();
+  test_read_runs();
+  test_read_parallel();
+  test_read_parallel_turtle();
+  test_read_inputs();
+  test_read_blank_clash();
+  test_read_batches();
+  test_read_stats();
+  test_read_lax_lines(SERD_NTRIPLES);
+  test_read_lax_lines(SERD_NQUADS);
+  test_read_literal_pieces(SERD_NTRIPLES);
+  test_read_literal_pieces(SERD_TURTLE);
+  test_read_literal_pieces(SERD_NQUADS);
+  test_read_literal_pieces(SERD_TRIG);
+  test_read_reset();
+  test_read_feed();
+  test_read_filtered();
+  test_read_validate();
+  test_read_lazy_positions();
 
   const char* const path = "serd_test.ttl";
   test_writer(path);
+  test_write_escapes();
+  test_write_repeated();
+  test_write_literal_pieces();
+  test_write_reordered();
+  test_write_async();
+  test_write_reset();
+  test_write_resolved();
+  test_allocator();
+  test_binary();
+  test_compressed(SERD_STYLE_GZIP);
+  test_compressed(SERD_STYLE_ZSTD);
   test_reader(path);
 
   printf("Success\n");
@@ -0,0 +1,206 @@
+/*
+  Copyright 2021 David Robillard <d@drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "serd/serd.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define USTR(s) ((const uint8_t*)(s))
+
+#define N_STATEMENTS 1000u
+
+typedef struct {
+  SerdEnv*    env;
+  SerdChunk   chunk;
+  SerdWriter* writer;
+  SerdSorter* sorter;
+} SortTest;
+
+static SerdStatus
+quiet_error_sink(void* handle, const SerdError* e)
+{
+  (void)e;
+
+  ++*(unsigned*)handle;
+  return SERD_SUCCESS;
+}
+
+static void
+sort_test_init(SortTest* const test, const size_t max_bytes)
+{
+  test->env       = serd_env_new(NULL);
+  test->chunk.buf = NULL;
+  test->chunk.len = 0u;
+
+  test->writer = serd_writer_new(
+    SERD_NQUADS, (SerdStyle)0, test->env, NULL, serd_chunk_sink, &test->chunk);
+
+  test->sorter =
+    serd_sorter_new(test->env,
+                    max_bytes,
+                    (SerdStatementSink)serd_writer_write_statement,
+                    test->writer);
+}
+
+/// Finish sorting and return the output, which must be freed
+static char*
+sort_test_finish(SortTest* const test)
+{
+  assert(!serd_sorter_finish(test->sorter));
+  assert(!serd_sorter_n_runs(test->sorter));
+
+  serd_sorter_free(test->sorter);
+  serd_writer_finish(test->writer);
+  serd_writer_free(test->writer);
+  serd_env_free(test->env);
+
+  return (char*)serd_chunk_sink_finish(&test->chunk);
+}
+
+static void
+test_sort(void)
+{
+  SortTest test;
+  sort_test_init(&test, 0u);
+
+  SerdSorter* const sorter = test.sorter;
+
+  const SerdNode p  = serd_node_from_string(SERD_URI, USTR("http://eg/p"));
+  const SerdNode s1 = serd_node_from_string(SERD_URI, USTR("http://eg/s1"));
+  const SerdNode s2 = serd_node_from_string(SERD_URI, USTR("http://eg/s2"));
+  const SerdNode g  = serd_node_from_string(SERD_URI, USTR("http://eg/g"));
+  const SerdNode b  = serd_node_from_string(SERD_BLANK, USTR("b1"));
+  const SerdNode o  = serd_node_from_string(SERD_LITERAL, USTR("o"));
+  const SerdNode ob = serd_node_from_string(SERD_LITERAL, USTR("o2"));
+  const SerdNode en = serd_node_from_string(SERD_LITERAL, USTR("en"));
+
+  // Statements are ordered by graph first, then by each node in turn
+  assert(!serd_sorter_write_statement(sorter, 0, &g, &s1, &p, &o, 0, 0));
+  assert(!serd_sorter_write_statement(sorter, 0, 0, &s2, &p, &o, 0, 0));
+  assert(!serd_sorter_write_statement(sorter, 0, 0, &s1, &p, &ob, 0, 0));
+  assert(!serd_sorter_write_statement(sorter, 0, 0, &s1, &p, &o, 0, &en));
+  assert(!serd_sorter_write_statement(sorter, 0, 0, &s1, &p, &o, 0, 0));
+  assert(!serd_sorter_write_statement(sorter, 0, 0, &b, &p, &o, 0, 0));
+  assert(!serd_sorter_write_statement(sorter, 0, 0, &s2, &p, &o, 0, 0));
+  assert(!serd_sorter_write_statement(sorter, 0, &g, &s1, &p, &o, 0, 0));
+
+  // Statements must be complete
+  assert(serd_sorter_write_statement(sorter, 0, 0, 0, &p, &o, 0, 0) ==
+         SERD_ERR_BAD_ARG);
+  assert(!serd_sorter_n_runs(sorter));
+
+  static const char* const expected =
+    "<http://eg/s1> <http://eg/p> \"o\" .\n"
+    "<http://eg/s1> <http://eg/p> \"o\"@en .\n"
+    "<http://eg/s1> <http://eg/p> \"o2\" .\n"
+    "<http://eg/s2> <http://eg/p> \"o\" .\n"
+    "_:b1 <http://eg/p> \"o\" .\n"
+    "<http://eg/s1> <http://eg/p> \"o\" <http://eg/g> .\n";
+
+  char* const out = sort_test_finish(&test);
+  assert(!strcmp(out, expected));
+  serd_free(out);
+}
+
+static void
+test_expand(void)
+{
+  SortTest test;
+  sort_test_init(&test, 0u);
+
+  SerdSorter* const sorter   = test.sorter;
+  unsigned          n_errors = 0u;
+  serd_sorter_set_error_sink(sorter, quiet_error_sink, &n_errors);
+
+  const SerdNode name = serd_node_from_string(SERD_LITERAL, USTR("eg"));
+  const SerdNode base = serd_node_from_string(SERD_URI, USTR("http://eg/"));
+  const SerdNode s    = serd_node_from_string(SERD_CURIE, USTR("eg:s"));
+  const SerdNode p    = serd_node_from_string(SERD_URI, USTR("p"));
+  const SerdNode o    = serd_node_from_string(SERD_CURIE, USTR("eg:o"));
+  const SerdNode bad  = serd_node_from_string(SERD_CURIE, USTR("no:o"));
+
+  assert(!serd_env_set_base_uri(test.env, &base));
+  assert(!serd_env_set_prefix(test.env, &name, &base));
+
+  // Nodes are expanded when written, so the environment may change later
+  assert(!serd_sorter_write_statement(sorter, 0, 0, &s, &p, &o, 0, 0));
+  assert(serd_sorter_write_statement(sorter, 0, 0, &s, &p, &bad, 0, 0) ==
+         SERD_ERR_BAD_CURIE);
+  assert(n_errors == 1u);
+
+  const SerdNode other = serd_node_from_string(SERD_URI, USTR("http://x/"));
+  assert(!serd_env_set_prefix(test.env, &name, &other));
+
+  char* const out = sort_test_finish(&test);
+  assert(!strcmp(out, "<http://eg/s> <http://eg/p> <http://eg/o> .\n"));
+  serd_free(out);
+}
+
+static void
+test_merge(void)
+{
+  SortTest test;
+  sort_test_init(&test, 4096u);
+
+  SerdSorter* const sorter = test.sorter;
+  const SerdNode    p = serd_node_from_string(SERD_URI, USTR("http://eg/p"));
+
+  // Write every statement twice, in a scrambled order
+  for (unsigned i = 0u; i < 2u * N_STATEMENTS; ++i) {
+    char           buf[32];
+    const unsigned n = (i * 7919u) % N_STATEMENTS;
+    snprintf(buf, sizeof(buf), "http://eg/s%04u", n);
+
+    const SerdNode s = serd_node_from_string(SERD_URI, USTR(buf));
+    const SerdNode o = serd_node_from_string(SERD_LITERAL, USTR(buf + 10));
+    assert(!serd_sorter_write_statement(sorter, 0, 0, &s, &p, &o, 0, 0));
+  }
+
+  assert(serd_sorter_n_runs(sorter) > 2u);
+
+  // The output has every statement once, in order
+  char* const out  = sort_test_finish(&test);
+  unsigned    n    = 0u;
+  const char* line = out;
+  for (const char* end = NULL; (end = strchr(line, '\n')); line = end + 1) {
+    char expected[64];
+    snprintf(expected,
+             sizeof(expected),
+             "<http://eg/s%04u> <http://eg/p> \"s%04u\" .",
+             n,
+             n);
+
+    assert(!strncmp(line, expected, strlen(expected)));
+    ++n;
+  }
+
+  assert(n == N_STATEMENTS);
+  serd_free(out);
+}
+
+int
+main(void)
+{
+  test_sort();
+  test_expand();
+  test_merge();
+  return 0;
+}